@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+}
+
+#include "codec/av_error.hpp"
+#include "codec/av_codec_context_ptr.hpp"
+
+/**
+ * @class AVCodecContextPool
+ * @brief 已打开解码器上下文的复用池
+ * @details 打开解码器需要分配上下文、复制参数并调用 avcodec_open2，开启帧线程时还要创建并回收解码线程。
+ *          连续打开大量编码参数相同的短文件时，关闭的上下文经 avcodec_flush_buffers 清空后放回池中，
+ *          下一个参数相同的文件直接取用。参数是否相同由解码器、编码类型、尺寸、像素格式、档次级别、
+ *          宽高比、附加数据与线程配置共同决定。
+ */
+class AVCodecContextPool
+{
+public:
+    /**
+     * @struct Stats
+     * @brief 复用统计
+     */
+    struct Stats
+    {
+        /// @brief 从池中取到上下文的次数
+        uint64_t hits = 0;
+        /// @brief 新建上下文的次数
+        uint64_t misses = 0;
+        /// @brief 因超出容量被释放的上下文数量
+        uint64_t evictions = 0;
+        /// @brief 当前空闲上下文数量
+        std::size_t idle = 0;
+    };
+public:
+    /**
+     * @brief 获取全局实例
+     */
+    static AVCodecContextPool& get_instance();
+    /**
+     * @brief 取得已打开的解码器上下文，池中没有匹配项时新建并打开
+     * @param codec 解码器
+     * @param parameters 流的编码参数
+     * @param time_base 数据包时间基
+     * @param thread_count 解码线程数
+     * @param is_shared_execute 是否把分片任务交给共享调度器（此时忽略 thread_count）
+     * @param codec_context 输出上下文
+     * @param key 输出复用键，归还时传回
+     */
+    AVError acquire(const AVCodec* codec, const AVCodecParameters* parameters, AVRational time_base, int thread_count, bool is_shared_execute, AVCodecContextPtr& codec_context, std::string& key);
+    /**
+     * @brief 归还上下文
+     * @param key acquire 给出的复用键
+     * @param codec_context 上下文，归还后置空
+     */
+    void release(const std::string& key, AVCodecContextPtr&& codec_context);
+    /**
+     * @brief 设置最多保留的空闲上下文数量（0 表示不保留）
+     */
+    void set_capacity(std::size_t capacity);
+    /**
+     * @brief 释放全部空闲上下文
+     */
+    void clear();
+    /**
+     * @brief 复用统计
+     */
+    Stats get_stats();
+    /**
+     * @brief 计算复用键
+     * @details 包含 avcodec_parameters_to_context 复制到上下文的全部视频字段与附加数据摘要，
+     *          键相同的上下文可直接复用而不必重新应用参数。
+     */
+    static std::string make_key(const AVCodec* codec, const AVCodecParameters* parameters, int thread_count, bool is_shared_execute);
+private:
+    AVCodecContextPool() = default;
+    /**
+     * @struct IdleContext
+     * @brief 空闲上下文
+     */
+    struct IdleContext
+    {
+        std::string key;
+        AVCodecContextPtr codec_context;
+    };
+private:
+    /// @brief 保护以下成员
+    std::mutex m_mutex;
+    /// @brief 空闲上下文，按归还先后排列（尾部最新）
+    std::list<IdleContext> m_idle_contexts;
+    /// @brief 最多保留的空闲上下文数量
+    std::size_t m_capacity = 8;
+    /// @brief 复用统计
+    Stats m_stats;
+};
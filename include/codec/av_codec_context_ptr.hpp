@@ -17,10 +17,33 @@ class AVCodecContextPtr
 public:
     AVCodecContextPtr();
     ~AVCodecContextPtr();
+    AVCodecContextPtr(const AVCodecContextPtr&) = delete;
+    AVCodecContextPtr& operator=(const AVCodecContextPtr&) = delete;
+    AVCodecContextPtr(AVCodecContextPtr&& other) noexcept;
+    AVCodecContextPtr& operator=(AVCodecContextPtr&& other) noexcept;
     AVCodecContext* get()const;
     void alloc_context3(const AVCodec* codec);
-    AVError send_packet(AVPacketPtr packet);
-    AVError receive_frame(AVFramePtr frame);
+    /**
+     * @brief 送入数据包；packet 为空指针时进入冲刷（drain）模式。
+     */
+    AVError send_packet(AVPacketPtr& packet);
+    AVError send_packet(const AVPacket* packet);
+    AVError receive_frame(AVFramePtr& frame);
+    /**
+     * @brief 送入待编码帧；frame 为空指针时进入冲刷（drain）模式。
+     */
+    AVError send_frame(AVFramePtr& frame);
+    AVError send_frame(const AVFrame* frame);
+    AVError receive_packet(AVPacketPtr& packet);
+    /**
+     * @brief 清空解码器内部缓冲（seek 后使用）。
+     */
+    void flush_buffers();
+    /**
+     * @brief 释放解码器上下文并置空。
+     */
+    void reset();
+    explicit operator bool()const;
     AVError parameters_to_context(const AVCodecParameters* parameters);
     AVError open2(const AVCodec* codec, AVDictionary** options);
     AVCodecContext* operator->()const;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 extern "C"
 {
 #include <libavformat/avformat.h>
@@ -15,10 +17,21 @@ class AVFormatContextPtr {
 public:
     AVFormatContextPtr();
     AVFormatContextPtr(AVFormatContext* av_format_context);
-    AVError open_input(const std::string& file_path, AVInputFormat* fmt, AVDictionary** options);
+    AVFormatContextPtr(const AVFormatContextPtr&) = delete;
+    AVFormatContextPtr& operator=(const AVFormatContextPtr&) = delete;
+    AVError open_input(const std::string& file_path, const AVInputFormat* fmt, AVDictionary** options);
+    /**
+     * @brief 通过自定义 AVIOContext 打开输入（io_context 由调用方持有，关闭时不释放）。
+     * @param url 仅用于格式探测与日志的名称
+     */
+    AVError open_input(AVIOContext* io_context, const std::string& url, const AVInputFormat* fmt, AVDictionary** options);
     void close_input();
     AVError find_stream_info(AVDictionary** options);
-    AVError read_frame(AVPacketPtr packet);
+    AVError read_frame(AVPacketPtr& packet);
+    /**
+     * @brief 按流时间基定位（等价 `av_seek_frame`）。
+     */
+    AVError seek_frame(int stream_index, int64_t timestamp, int flags);
     AVFormatContext* get()const;
     AVFormatContext* operator->()const;
     operator bool()const;
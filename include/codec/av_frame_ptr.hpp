@@ -123,4 +123,9 @@ private:
 };
 
 /// 非成员 swap，利于 ADL 与泛型算法
-inline void swap(AVFramePtr& a, AVFramePtr& b) noexcept { a.swap(b); }
\ No newline at end of file
+inline void swap(AVFramePtr& a, AVFramePtr& b) noexcept { a.swap(b); }
+
+/**
+ * @brief 帧的显示时间戳，无 pts 时回退到 best_effort_timestamp（与 AVFrameView::pts 一致）。
+ */
+int64_t frame_pts(const AVFrame* frame) noexcept;
\ No newline at end of file
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavutil/avutil.h>
+#include <libavutil/frame.h>
+#include <libavutil/buffer.h>
+}
+
+#include "codec/av_error.hpp"
+#include "codec/av_frame_ptr.hpp"
+#include "util/util_vector_2d.hpp"
+
+/**
+ * @class AVFrameView
+ * @brief 仅移动的零拷贝帧视图
+ * @details 从解码输出的 AVFrame 中接管 `AVBufferRef` 引用，只保留渲染所需的
+ *          平面指针、行字节数、像素格式、尺寸与时间戳。
+ *          构造与移动均不分配内存，缓冲在视图析构时归还给解码器缓冲池。
+ */
+class AVFrameView
+{
+public:
+    /// @brief 最大平面数量
+    static constexpr int MAX_PLANES = AV_NUM_DATA_POINTERS;
+public:
+    /**
+     * @brief 默认构造：空视图。
+     */
+    AVFrameView() noexcept;
+    /**
+     * @brief 从 AVFrame 接管缓冲引用。
+     * @param frame 解码输出帧；成功后其缓冲被取走并 `av_frame_unref`，结构体可继续复用。
+     * @note 不持有 `buf[]` 的帧（非引用计数帧）无法零拷贝，视图保持为空并记录错误码。
+     */
+    explicit AVFrameView(AVFrame* frame) noexcept;
+    /**
+     * @brief 从 AVFramePtr 接管缓冲引用（AVFramePtr 本身保留以供复用）。
+     */
+    explicit AVFrameView(AVFramePtr& frame) noexcept;
+    AVFrameView(const AVFrameView&) = delete;
+    AVFrameView& operator=(const AVFrameView&) = delete;
+    /**
+     * @brief 移动构造：接管源的缓冲引用，源置空。
+     */
+    AVFrameView(AVFrameView&& other) noexcept;
+    /**
+     * @brief 移动赋值：释放当前引用，接管源（noexcept）。
+     */
+    AVFrameView& operator=(AVFrameView&& other) noexcept;
+    /**
+     * @brief 析构：归还缓冲引用。
+     */
+    ~AVFrameView() noexcept;
+    /**
+     * @brief 获取平面数据指针。
+     */
+    const uint8_t* data(int plane) const noexcept;
+    /**
+     * @brief 获取平面行字节数。
+     */
+    int linesize(int plane) const noexcept;
+    /**
+     * @brief 像素格式。
+     */
+    AVPixelFormat format() const noexcept;
+    /**
+     * @brief 帧尺寸（像素）。
+     */
+    DaneJoe::Size<int> size() const noexcept;
+    /**
+     * @brief 显示时间戳（流时间基），无 pts 时回退到 best_effort_timestamp。
+     */
+    int64_t pts() const noexcept;
+    /**
+     * @brief 帧时长（流时间基，未知时为 0）。
+     */
+    int64_t duration() const noexcept;
+    /**
+     * @brief 时间基。
+     */
+    AVRational time_base() const noexcept;
+    /**
+     * @brief 显示时间（秒），无时间戳或时间基未知时为空。
+     */
+    std::optional<double> seconds() const noexcept;
+    /**
+     * @brief 设置时间基（解码端根据所属流设置）。
+     */
+    void set_time_base(AVRational time_base) noexcept;
+    /**
+     * @brief 重设时间戳与时长（播放列表把各文件的帧映射到连续时间轴时使用）。
+     * @param pts 显示时间戳
+     * @param duration 帧时长
+     * @param time_base 二者所用的时间基
+     */
+    void set_timing(int64_t pts, int64_t duration, AVRational time_base) noexcept;
+    /**
+     * @brief 是否为关键帧。
+     */
+    bool is_key_frame() const noexcept;
+    /**
+     * @brief 最近一次接管的错误码。
+     */
+    AVError get_error() const noexcept;
+    /**
+     * @brief 是否持有帧数据。
+     */
+    explicit operator bool() const noexcept;
+    /**
+     * @brief 归还缓冲引用并置空。
+     */
+    void reset() noexcept;
+    /**
+     * @brief 与另一视图交换（noexcept）。
+     */
+    void swap(AVFrameView& other) noexcept;
+private:
+    /**
+     * @brief 从帧中接管缓冲引用。
+     */
+    void take(AVFrame* frame) noexcept;
+private:
+    /// @brief 持有的缓冲引用
+    std::array<AVBufferRef*, MAX_PLANES> m_buffers = {};
+    /// @brief 平面数据指针（指向 m_buffers 所持有的内存）
+    std::array<uint8_t*, MAX_PLANES> m_data = {};
+    /// @brief 平面行字节数
+    std::array<int, MAX_PLANES> m_linesize = {};
+    /// @brief 像素格式
+    AVPixelFormat m_format = AV_PIX_FMT_NONE;
+    /// @brief 帧尺寸
+    DaneJoe::Size<int> m_size = { 0,0 };
+    /// @brief 显示时间戳
+    int64_t m_pts = AV_NOPTS_VALUE;
+    /// @brief 帧时长
+    int64_t m_duration = 0;
+    /// @brief 时间基
+    AVRational m_time_base = { 0,1 };
+    /// @brief 是否为关键帧
+    bool m_is_key_frame = false;
+    /// @brief 最近一次操作的错误码
+    AVError m_error;
+};
+
+/// 非成员 swap，利于 ADL 与泛型算法
+inline void swap(AVFrameView& a, AVFrameView& b) noexcept { a.swap(b); }
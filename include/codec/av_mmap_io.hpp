@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "codec/i_av_io.hpp"
+
+/**
+ * @class AVMmapIO
+ * @brief 基于内存映射文件的 AVIOContext
+ * @details 整个文件以只读方式映射，读回调直接从映射区拷贝，不产生 read 系统调用；
+ *          映射区设置 MADV_SEQUENTIAL，并随读取位置滚动地对前方窗口发出 MADV_WILLNEED 预读提示。
+ *          AVIOContext 内部缓冲较小，大于缓冲区的读取（如视频包数据）由 avio_read
+ *          直接调用读回调写入目标缓冲，只发生一次从页缓存到数据包的拷贝。
+ */
+class AVMmapIO : public IAVIO
+{
+public:
+    /**
+     * @struct Stats
+     * @brief 读取统计
+     */
+    struct Stats
+    {
+        /// @brief 读回调次数
+        uint64_t read_calls = 0;
+        /// @brief seek 回调次数
+        uint64_t seek_calls = 0;
+        /// @brief madvise 调用次数
+        uint64_t advise_calls = 0;
+        /// @brief 读取字节数
+        uint64_t bytes_read = 0;
+    };
+public:
+    AVMmapIO();
+    ~AVMmapIO()override;
+    AVMmapIO(const AVMmapIO&) = delete;
+    AVMmapIO& operator=(const AVMmapIO&) = delete;
+    AVError open(const std::string& file_path)override;
+    void close()override;
+    AVIOContext* get()override;
+    int64_t file_size()const override;
+    /**
+     * @brief 获取统计信息
+     */
+    Stats get_stats()const;
+private:
+    /**
+     * @brief AVIOContext 读回调
+     */
+    static int read_packet(void* opaque, uint8_t* buffer, int buffer_size);
+    /**
+     * @brief AVIOContext seek 回调
+     */
+    static int64_t seek(void* opaque, int64_t offset, int whence);
+    /**
+     * @brief 确保当前位置之后的预读窗口已发出 WILLNEED 提示
+     */
+    void advise_ahead();
+private:
+    /// @brief AVIOContext 内部缓冲大小
+    static constexpr int IO_BUFFER_SIZE = 32 * 1024;
+    /// @brief 每次预读提示的窗口大小
+    static constexpr int64_t ADVISE_WINDOW = 8 * 1024 * 1024;
+    /// @brief 映射区
+    const uint8_t* m_data = nullptr;
+    /// @brief 文件大小
+    int64_t m_size = 0;
+    /// @brief 当前读取位置
+    int64_t m_position = 0;
+    /// @brief 已发出预读提示的结束位置
+    int64_t m_advised_end = 0;
+    /// @brief AVIOContext
+    AVIOContext* m_io_context = nullptr;
+    /// @brief 统计信息
+    Stats m_stats;
+};
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(DANEJOE_HAS_IO_URING)
+#include <liburing.h>
+#endif
+
+#include "codec/i_av_io.hpp"
+#include "util/util_task_scheduler.hpp"
+
+/**
+ * @class AVReadAheadIO
+ * @brief 异步预读 AVIOContext
+ * @details 以 1 MiB 对齐块为单位，在当前读取位置之前保持一个预读窗口的读请求在途：
+ *          有 io_uring 时直接提交到内核队列，否则交给共享的 I/O 线程池执行 pread。
+ *          窗口大小按实测消费速率与读延迟动态调整（速率 x 延迟 x 2，缺块时立即扩大）；
+ *          跳出预读范围的 seek 会取消所有在途请求（线程池中尚未开始的直接丢弃，io_uring 发出取消请求）。
+ * @note 读与 seek 回调只允许在一个线程（解复用线程）中调用。
+ */
+class AVReadAheadIO : public IAVIO
+{
+public:
+    /**
+     * @struct Stats
+     * @brief 预读统计
+     */
+    struct Stats
+    {
+        /// @brief 发出的读请求数
+        uint64_t reads_issued = 0;
+        /// @brief 完成的读请求数
+        uint64_t reads_completed = 0;
+        /// @brief 被取消或作废的读请求数
+        uint64_t reads_cancelled = 0;
+        /// @brief 首次访问时已就绪的块数
+        uint64_t hits = 0;
+        /// @brief 首次访问时需要等待的块数
+        uint64_t misses = 0;
+        /// @brief 跳出预读范围的 seek 次数
+        uint64_t seeks = 0;
+        /// @brief 平均读延迟（毫秒）
+        double average_latency_ms = 0.;
+        /// @brief 最大读延迟（毫秒）
+        double max_latency_ms = 0.;
+        /// @brief 当前窗口块数
+        int window_blocks = 0;
+        /// @brief 是否使用 io_uring
+        bool is_io_uring = false;
+        /**
+         * @brief 命中率
+         */
+        double hit_rate()const;
+    };
+public:
+    AVReadAheadIO();
+    ~AVReadAheadIO()override;
+    AVReadAheadIO(const AVReadAheadIO&) = delete;
+    AVReadAheadIO& operator=(const AVReadAheadIO&) = delete;
+    AVError open(const std::string& file_path)override;
+    void close()override;
+    AVIOContext* get()override;
+    int64_t file_size()const override;
+    /**
+     * @brief 获取统计信息
+     */
+    Stats get_stats()const;
+private:
+    /**
+     * @enum BlockState
+     * @brief 块状态
+     */
+    enum class BlockState
+    {
+        FREE,
+        PENDING,
+        READY,
+        FAILED,
+    };
+    /**
+     * @struct Block
+     * @brief 预读块
+     */
+    struct Block
+    {
+        /// @brief 块缓冲（按页对齐）
+        uint8_t* data = nullptr;
+        /// @brief 文件偏移
+        int64_t offset = -1;
+        /// @brief 有效字节数
+        int64_t size = 0;
+        /// @brief 失败时的错误码
+        int error = 0;
+        /// @brief 状态
+        BlockState state = BlockState::FREE;
+        /// @brief 发出请求时的代数，与当前代数不同表示已作废
+        uint64_t generation = 0;
+        /// @brief 是否已被读取过
+        bool is_touched = false;
+        /// @brief 首次读取时是否需要等待
+        bool is_miss = false;
+        /// @brief 发出请求的时间
+        std::chrono::steady_clock::time_point issued_at;
+    };
+private:
+    static int read_packet(void* opaque, uint8_t* buffer, int buffer_size);
+    static int64_t seek(void* opaque, int64_t offset, int whence);
+    /**
+     * @brief 查找当前代中包含 offset 的块
+     */
+    Block* find_block(int64_t offset);
+    /**
+     * @brief 回收已读过的块并补足预读窗口
+     */
+    void fill_window();
+    /**
+     * @brief 对空闲块发出读请求
+     */
+    void issue(Block& block, int64_t offset);
+    /**
+     * @brief 读请求完成（调用方持锁）
+     */
+    void complete(Block& block, int64_t result);
+    /**
+     * @brief 等待块就绪
+     */
+    void wait_ready(Block& block, std::unique_lock<std::mutex>& lock);
+    /**
+     * @brief 作废所有块并取消在途请求
+     */
+    void cancel_all();
+    /**
+     * @brief 等待所有在途请求结束
+     */
+    void drain(std::unique_lock<std::mutex>& lock);
+    /**
+     * @brief 按消费速率与延迟调整窗口
+     * @param is_miss 刚消费完的块是否发生过等待
+     */
+    void adapt_window(bool is_miss);
+#if defined(DANEJOE_HAS_IO_URING)
+    /**
+     * @brief 收割 io_uring 完成事件
+     * @param is_wait 没有完成事件时是否阻塞等待
+     */
+    void reap(bool is_wait);
+#endif
+private:
+    /// @brief 块大小
+    static constexpr int64_t BLOCK_SIZE = 1024 * 1024;
+    /// @brief 最小窗口块数
+    static constexpr int MIN_WINDOW = 2;
+    /// @brief 最大窗口块数
+    static constexpr int MAX_WINDOW = 32;
+    /// @brief 初始窗口块数
+    static constexpr int INITIAL_WINDOW = 4;
+    /// @brief 每消费多少块重新计算一次速率
+    static constexpr int RATE_PERIOD_BLOCKS = 4;
+    /// @brief AVIOContext 内部缓冲大小
+    static constexpr int IO_BUFFER_SIZE = 32 * 1024;
+    /// @brief 文件描述符
+    int m_fd = -1;
+    /// @brief 文件大小
+    int64_t m_size = 0;
+    /// @brief 当前读取位置
+    int64_t m_position = 0;
+    /// @brief 下一个待预读块的偏移
+    int64_t m_next_offset = 0;
+    /// @brief 当前代数
+    uint64_t m_generation = 0;
+    /// @brief 在途请求数（含已作废的）
+    int m_in_flight = 0;
+    /// @brief 当前窗口块数
+    int m_window = INITIAL_WINDOW;
+    /// @brief 所有块槽位
+    std::vector<Block> m_blocks;
+    /// @brief 线程池请求的取消标记
+    DaneJoe::CancellationToken m_cancel_token;
+    /// @brief 速率统计周期起点
+    std::chrono::steady_clock::time_point m_rate_begin;
+    /// @brief 本周期消费的块数
+    int m_rate_blocks = 0;
+    /// @brief 本周期是否发生过等待
+    bool m_has_period_miss = false;
+    /// @brief 累计读延迟（毫秒）
+    double m_total_latency_ms = 0.;
+    /// @brief 统计信息
+    Stats m_stats;
+    /// @brief 状态锁（线程池完成回调来自其他线程）
+    mutable std::mutex m_mutex;
+    /// @brief 块就绪通知
+    std::condition_variable m_condition;
+    /// @brief AVIOContext
+    AVIOContext* m_io_context = nullptr;
+#if defined(DANEJOE_HAS_IO_URING)
+    /// @brief io_uring 实例
+    io_uring m_ring;
+    /// @brief io_uring 是否初始化成功
+    bool m_is_ring_ready = false;
+#endif
+};
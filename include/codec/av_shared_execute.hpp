@@ -0,0 +1,32 @@
+#pragma once
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavfilter/avfilter.h>
+}
+
+/**
+ * @brief 在 avcodec_open2 之前配置解码器使用共享线程池
+ * @details 关闭帧线程，只保留分片线程，分片上下文数量取共享调度器的并发数。
+ *          libavcodec 仍会按 thread_count 创建自己的分片线程，但 execute/execute2 被替换后这些线程保持空闲，
+ *          实际的分片任务全部在共享调度器上执行。
+ * @param codec_context 尚未打开的解码器上下文
+ */
+void prepare_shared_execute(AVCodecContext* codec_context);
+
+/**
+ * @brief 在 avcodec_open2 之后把 execute/execute2 替换为共享调度器实现
+ * @details execute2 的 threadnr 用于索引解码器按线程分配的临时缓冲，
+ *          因此同一次调用最多分成 thread_count 条并行通道，每条通道独占一个 threadnr。
+ * @param codec_context 已打开的解码器上下文
+ */
+void install_shared_execute(AVCodecContext* codec_context);
+
+/**
+ * @brief 让滤镜图的分片任务在共享调度器上执行
+ * @details 须在 avfilter_graph_alloc 之后、添加任何滤镜之前调用；
+ *          nb_threads 取共享调度器的并发数，决定支持分片的滤镜把一帧切成多少个任务。
+ * @param graph 刚分配的滤镜图
+ */
+void install_shared_filter_execute(AVFilterGraph* graph);
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+
+extern "C"
+{
+#include <libavfilter/avfilter.h>
+#include <libavutil/frame.h>
+}
+
+#include "codec/av_error.hpp"
+#include "codec/av_frame_ptr.hpp"
+
+/**
+ * @class AVVideoFilter
+ * @brief 由滤镜描述字符串构建的视频滤镜图（buffer -> 描述 -> buffersink）
+ * @details 滤镜图在收到第一帧时按该帧的尺寸、像素格式、宽高比与时间基构建，
+ *          只有这些输入参数变化时才重建；重建前先冲刷旧图，已进入旧图的帧照常输出。
+ *          送入与取出都是移交 `AVBufferRef` 引用，不复制像素数据：
+ *          null、crop、setpts 等只改元数据的滤镜输出的仍是解码器的缓冲，
+ *          只有 scale、yadif 等确实要写新像素的滤镜才分配新缓冲。
+ */
+class AVVideoFilter
+{
+public:
+    /**
+     * @struct Options
+     * @brief 滤镜参数
+     */
+    struct Options
+    {
+        /// @brief 滤镜描述（与 ffmpeg -vf 相同，为空时等价于 null）
+        std::string description;
+        /// @brief 是否把滤镜的分片任务交给进程共享的调度器
+        bool is_use_shared_thread_pool = true;
+    };
+public:
+    explicit AVVideoFilter(const Options& options);
+    ~AVVideoFilter();
+    AVVideoFilter(const AVVideoFilter&) = delete;
+    AVVideoFilter& operator=(const AVVideoFilter&) = delete;
+    /**
+     * @brief 送入一帧，输入参数变化时先冲刷并重建滤镜图
+     * @param frame 输入帧，成功后其缓冲引用移交给滤镜图，结构体可继续复用
+     */
+    AVError send_frame(AVFramePtr& frame);
+    /**
+     * @brief 送入结束标记，之后 receive_frame 取完剩余帧返回 AVERROR_EOF
+     */
+    AVError send_eof();
+    /**
+     * @brief 取出一帧
+     * @param frame 输出帧，时间基已设为输出时间基
+     * @return 需要更多输入时为 AVERROR(EAGAIN)；送入结束标记且取完时为 AVERROR_EOF
+     */
+    AVError receive_frame(AVFramePtr& frame);
+    /**
+     * @brief 滤镜描述
+     */
+    const std::string& description()const;
+    /**
+     * @brief 滤镜图构建次数
+     */
+    uint64_t build_count()const;
+private:
+    /**
+     * @struct InputParameters
+     * @brief 决定滤镜图结构的输入参数
+     */
+    struct InputParameters
+    {
+        int width = 0;
+        int height = 0;
+        int format = -1;
+        AVRational sample_aspect_ratio = { 0,1 };
+        AVRational time_base = { 0,1 };
+        bool operator==(const InputParameters& other)const;
+    };
+    /**
+     * @brief 按输入参数构建滤镜图
+     */
+    AVError build(const InputParameters& parameters);
+    /**
+     * @brief 冲刷当前滤镜图，剩余输出移入 m_pending
+     */
+    void drain();
+    /**
+     * @brief 释放滤镜图
+     */
+    void free_graph();
+private:
+    Options m_options;
+    AVFilterGraph* m_graph = nullptr;
+    /// @brief buffer 源（由滤镜图持有）
+    AVFilterContext* m_source = nullptr;
+    /// @brief buffersink 汇（由滤镜图持有）
+    AVFilterContext* m_sink = nullptr;
+    /// @brief 当前滤镜图的输入参数
+    std::optional<InputParameters> m_parameters;
+    /// @brief 重建前从旧滤镜图冲刷出的帧
+    std::deque<AVFramePtr> m_pending;
+    /// @brief 是否已送入结束标记
+    bool m_is_eof_sent = false;
+    /// @brief 滤镜图构建次数
+    uint64_t m_build_count = 0;
+};
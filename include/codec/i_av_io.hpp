@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+extern "C"
+{
+#include <libavformat/avformat.h>
+#include <libavformat/avio.h>
+}
+
+#include "codec/av_error.hpp"
+
+/**
+ * @enum AVIOBackend
+ * @brief 输入读取方式
+ */
+enum class AVIOBackend
+{
+    /// @brief FFmpeg 自带的 file 协议（read 系统调用）
+    DEFAULT,
+    /// @brief 内存映射文件
+    MMAP,
+    /// @brief 异步预读（io_uring 或线程池）
+    READ_AHEAD,
+};
+
+/**
+ * @class IAVIO
+ * @brief 自定义 AVIOContext 接口
+ * @details 实现类持有 AVIOContext 及其缓冲区，生命周期必须长于使用它的 AVFormatContext。
+ */
+class IAVIO
+{
+public:
+    virtual ~IAVIO() = default;
+    /**
+     * @brief 打开文件并创建 AVIOContext
+     */
+    virtual AVError open(const std::string& file_path) = 0;
+    /**
+     * @brief 关闭文件并释放 AVIOContext
+     */
+    virtual void close() = 0;
+    /**
+     * @brief 获取 AVIOContext（未打开时为空）
+     */
+    virtual AVIOContext* get() = 0;
+    /**
+     * @brief 文件大小（字节）
+     */
+    virtual int64_t file_size()const = 0;
+};
+
+/**
+ * @brief 按读取方式创建 IAVIO
+ * @return DEFAULT 返回空指针，表示直接使用 FFmpeg 的 file 协议
+ */
+std::unique_ptr<IAVIO> create_av_io(AVIOBackend backend);
+
+/**
+ * @brief 解析读取方式名称（default/mmap/readahead），未知名称返回 DEFAULT
+ */
+AVIOBackend parse_av_io_backend(const std::string& name);
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "codec/av_error.hpp"
+#include "util/util_task_scheduler.hpp"
+
+/**
+ * @class BatchProcessor
+ * @brief 批量离线处理（逐帧校验和）
+ * @details 每个文件拆分为三级任务交给工作窃取调度器：
+ *          解复用任务按关键帧把数据包切分成 GOP，每个 GOP 由独立的解码任务解码，
+ *          每个解码帧再作为后处理任务计算校验和。
+ *          优先级为 后处理 > 解码 > 解复用，使空闲线程优先消化下游任务。
+ *          每个文件的在途 GOP 达到上限时解复用任务挂起，由完成的解码任务恢复；在途帧达到上限时
+ *          解码任务直接在本线程后处理，缓存的数据包与帧数量因此有上限。
+ * @note 开放式 GOP 开头引用上一 GOP 的帧无法独立解码，会被计入 undecodable_packets。
+ */
+class BatchProcessor
+{
+public:
+    /**
+     * @struct FileResult
+     * @brief 单个文件的处理结果
+     */
+    struct FileResult
+    {
+        /// @brief 文件路径
+        std::string file_path;
+        /// @brief 打开或解复用错误
+        AVError error;
+        /// @brief GOP 数
+        uint64_t gops = 0;
+        /// @brief 解码帧数
+        uint64_t frames = 0;
+        /// @brief 无法独立解码的数据包数
+        uint64_t undecodable_packets = 0;
+        /// @brief 读取的数据包字节数
+        uint64_t bytes = 0;
+        /// @brief 与执行顺序无关的帧校验和
+        uint64_t checksum = 0;
+    };
+public:
+    /**
+     * @brief 构造函数
+     * @param scheduler 任务调度器
+     */
+    explicit BatchProcessor(DaneJoe::TaskScheduler& scheduler);
+    /**
+     * @brief 处理一组文件并等待全部完成
+     * @param file_paths 文件列表
+     * @param token 取消标记，取消后尚未开始的任务被跳过
+     * @return 与输入顺序一致的处理结果
+     */
+    std::vector<FileResult> run(const std::vector<std::string>& file_paths, DaneJoe::CancellationToken token = DaneJoe::CancellationToken());
+private:
+    /// @brief 任务调度器
+    DaneJoe::TaskScheduler& m_scheduler;
+};
+
+/**
+ * @brief 展开输入列表：目录递归收集其中的常规文件
+ */
+std::vector<std::string> collect_media_files(const std::vector<std::string>& inputs);
+
+/**
+ * @brief 批量处理扩展性基准
+ * @details 以 1、2、4…直至核心数个工作线程分别处理同一语料，输出吞吐、加速比与窃取次数，
+ *          并校验各轮校验和一致。
+ * @param inputs 文件或目录
+ * @param repeat 语料重复次数（用于用少量文件模拟大语料）
+ * @return 进程退出码
+ */
+int run_batch_benchmark(const std::vector<std::string>& inputs, int repeat);
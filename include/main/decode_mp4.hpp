@@ -3,13 +3,20 @@
 #define FFMPEG_VERSION 771
 
 #include <string>
+#include <memory>
 #include <deque>
 #include <mutex>
 #include <thread>
 
-#include "codec/av_frame_ptr.hpp"
-#include "concurrent/blocking/mpmc_bounded_queue.hpp"
+#include "main/frame_queue.hpp"
 
-using namespace DaneJoe::Concurrent::Blocking;
+class PlaybackRateControl;
 
-int decode_mp4(const std::string& file_path, std::weak_ptr<MpmcBoundedQueue<AVFramePtr>> frame_queue);
\ No newline at end of file
+/**
+ * @brief 解码文件并推入帧队列，直到文件结束或队列关闭
+ * @param file_path 文件路径
+ * @param frame_queue 帧队列
+ * @param rate_control 变速播放控制（为空时解码全部帧且不限制超前量）
+ * @param filter_description 滤镜描述（非空时在解码与帧队列之间插入独立线程上的滤镜阶段）
+ */
+int decode_mp4(const std::string& file_path, std::weak_ptr<FrameQueue> frame_queue, std::shared_ptr<PlaybackRateControl> rate_control = nullptr, const std::string& filter_description = std::string());
\ No newline at end of file
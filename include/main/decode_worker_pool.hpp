@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "main/frame_queue.hpp"
+#include "main/media_decoder.hpp"
+#include "codec/av_frame_view.hpp"
+
+/**
+ * @class DecodeWorkerPool
+ * @brief 多路流共享的固定大小解码线程池
+ * @details 每个流是一个可逐帧推进的解码状态机，工作线程按轮转顺序每次为一个流解码一个时间片，
+ *          保证各流获得公平的解码份额；帧队列满时该流被视为背压并跳过，直到消费端取走帧。
+ */
+class DecodeWorkerPool
+{
+public:
+    /**
+     * @struct StreamStats
+     * @brief 单个流的统计信息
+     */
+    struct StreamStats
+    {
+        /// @brief 文件路径
+        std::string file_path;
+        /// @brief 已解码帧数
+        uint64_t frames_decoded = 0;
+        /// @brief 因队列满而让出时间片的次数
+        uint64_t backpressure_events = 0;
+        /// @brief 当前是否处于背压状态
+        bool is_backpressured = false;
+        /// @brief 是否已结束
+        bool is_finished = false;
+    };
+public:
+    /**
+     * @brief 构造函数
+     * @param worker_count 工作线程数（0 表示使用硬件并发数）
+     * @param frames_per_slice 每个时间片最多解码的帧数
+     */
+    explicit DecodeWorkerPool(std::size_t worker_count = 0, std::size_t frames_per_slice = 2);
+    /**
+     * @brief 析构函数：停止并回收工作线程
+     */
+    ~DecodeWorkerPool();
+    DecodeWorkerPool(const DecodeWorkerPool&) = delete;
+    DecodeWorkerPool& operator=(const DecodeWorkerPool&) = delete;
+    /**
+     * @brief 添加一路流（文件在工作线程上首次调度时打开）
+     * @param file_path 文件路径
+     * @param frame_queue 输出帧队列
+     * @param is_loop 文件结束后是否从头循环
+     * @return 流编号
+     */
+    std::size_t add_stream(const std::string& file_path, std::weak_ptr<FrameQueue> frame_queue, bool is_loop = false);
+    /**
+     * @brief 启动工作线程
+     */
+    void start();
+    /**
+     * @brief 停止工作线程（等待当前时间片结束）
+     */
+    void stop();
+    /**
+     * @brief 工作线程数
+     */
+    std::size_t worker_count()const;
+    /**
+     * @brief 所有流累计解码帧数
+     */
+    uint64_t total_frames_decoded()const;
+    /**
+     * @brief 获取各流统计信息
+     */
+    std::vector<StreamStats> get_stream_stats();
+private:
+    /**
+     * @struct Stream
+     * @brief 流调度状态
+     */
+    struct Stream
+    {
+        /// @brief 文件路径
+        std::string file_path;
+        /// @brief 解码器
+        MediaDecoder decoder;
+        /// @brief 输出帧队列
+        std::weak_ptr<FrameQueue> frame_queue;
+        /// @brief 已解码但因背压尚未入队的帧
+        AVFrameView pending_frame;
+        /// @brief 是否循环播放
+        bool is_loop = false;
+        /// @brief 是否正被某个工作线程处理（受池互斥锁保护）
+        bool is_busy = false;
+        /// @brief 是否已结束（受池互斥锁保护）
+        bool is_finished = false;
+        /// @brief 当前是否处于背压状态
+        std::atomic<bool> is_backpressured = false;
+        /// @brief 已解码帧数
+        std::atomic<uint64_t> frames_decoded = 0;
+        /// @brief 背压次数
+        std::atomic<uint64_t> backpressure_events = 0;
+        /// @brief 上次回绕以来解码的帧数（用于识别空文件的无限循环）
+        uint64_t frames_since_rewind = 0;
+    };
+private:
+    /**
+     * @brief 工作线程主循环
+     */
+    void worker_loop(std::stop_token stop_token);
+    /**
+     * @brief 按轮转顺序选取下一个可调度的流（调用方持有互斥锁）
+     */
+    Stream* pick_stream();
+    /**
+     * @brief 为一个流执行一个解码时间片
+     * @return 流是否已结束
+     */
+    bool decode_slice(Stream& stream);
+private:
+    /// @brief 工作线程数
+    std::size_t m_worker_count;
+    /// @brief 每个时间片最多解码的帧数
+    std::size_t m_frames_per_slice;
+    /// @brief 调度互斥锁
+    std::mutex m_mutex;
+    /// @brief 调度条件变量
+    std::condition_variable_any m_condition;
+    /// @brief 所有流
+    std::vector<std::unique_ptr<Stream>> m_streams;
+    /// @brief 轮转游标
+    std::size_t m_cursor = 0;
+    /// @brief 工作线程
+    std::vector<std::jthread> m_workers;
+    /// @brief 累计解码帧数
+    std::atomic<uint64_t> m_total_frames = 0;
+};
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "codec/av_error.hpp"
+#include "codec/av_frame_ptr.hpp"
+#include "codec/av_video_filter.hpp"
+#include "main/frame_queue.hpp"
+#include "main/playback_rate.hpp"
+
+/**
+ * @class FilterStage
+ * @brief 解码与帧队列之间的滤镜阶段
+ * @details 在独立线程上运行 AVVideoFilter：解码线程把帧推入容量很小的输入队列后立即解码下一帧，
+ *          滤镜线程取出、过滤并推入帧队列，两者的耗时重叠。帧在两个队列之间只移交缓冲引用。
+ *          帧队列满时滤镜线程阻塞，输入队列随之填满，背压传回解码线程。
+ */
+class FilterStage
+{
+public:
+    /**
+     * @struct Options
+     * @brief 滤镜阶段参数
+     */
+    struct Options
+    {
+        /// @brief 滤镜参数
+        AVVideoFilter::Options filter;
+        /// @brief 输入队列容量（帧）
+        std::size_t input_capacity = 4;
+        /// @brief 变速播放控制（用于限制超前量，为空时不限制）
+        std::shared_ptr<PlaybackRateControl> rate_control;
+    };
+    /**
+     * @struct Stats
+     * @brief 运行统计
+     */
+    struct Stats
+    {
+        /// @brief 送入的帧数
+        uint64_t input_frames = 0;
+        /// @brief 推入帧队列的帧数
+        uint64_t output_frames = 0;
+        /// @brief 滤镜图构建次数
+        uint64_t graph_builds = 0;
+        /// @brief 滤镜耗时（毫秒）
+        double filter_ms = 0.;
+        /// @brief 解码线程因输入队列满而等待的耗时（毫秒）
+        double input_wait_ms = 0.;
+    };
+public:
+    /**
+     * @brief 构造并启动滤镜线程
+     * @param options 滤镜阶段参数
+     * @param frame_queue 输出帧队列
+     */
+    FilterStage(const Options& options, std::weak_ptr<FrameQueue> frame_queue);
+    /**
+     * @brief 析构函数
+     * @note 未调用 finish 时丢弃未处理的帧并等待滤镜线程退出
+     */
+    ~FilterStage();
+    FilterStage(const FilterStage&) = delete;
+    FilterStage& operator=(const FilterStage&) = delete;
+    /**
+     * @brief 推入一帧，输入队列满时阻塞
+     * @param frame 已解码帧，缓冲引用移交给滤镜阶段
+     * @return 滤镜阶段已停止（帧队列关闭或滤镜出错）时为 false
+     */
+    bool push(AVFramePtr&& frame);
+    /**
+     * @brief 输入结束：冲刷滤镜图并等待滤镜线程处理完剩余帧
+     * @return 滤镜线程的错误码
+     */
+    AVError finish();
+    /**
+     * @brief 立即停止，丢弃未处理的帧
+     */
+    void close();
+    /**
+     * @brief 运行统计
+     */
+    Stats get_stats()const;
+private:
+    /**
+     * @brief 滤镜线程
+     */
+    void run();
+    /**
+     * @brief 取出滤镜图的全部输出并推入帧队列
+     * @return 帧队列已关闭时为 false
+     */
+    bool emit(AVVideoFilter& filter, DecodeRateAdapter& rate_adapter);
+private:
+    Options m_options;
+    std::weak_ptr<FrameQueue> m_frame_queue;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    /// @brief 输入队列
+    std::deque<AVFramePtr> m_input;
+    /// @brief 输入是否已结束
+    bool m_is_input_end = false;
+    /// @brief 是否已停止
+    bool m_is_closed = false;
+    /// @brief 滤镜线程的错误码
+    AVError m_error;
+    Stats m_stats;
+    std::jthread m_thread;
+};
+
+/**
+ * @brief 滤镜阶段基准
+ * @details 对第一个输入文件分别在同一线程内先解码再过滤与使用滤镜阶段流水线两种方式下完整处理（不显示），
+ *          输出各自的帧率与解码、滤镜各自的耗时
+ * @param inputs 文件或目录
+ * @param filter_description 滤镜描述
+ * @return 进程退出码
+ */
+int run_filter_benchmark(const std::vector<std::string>& inputs, const std::string& filter_description);
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "codec/av_error.hpp"
+#include "codec/av_frame_ptr.hpp"
+#include "main/media_decoder.hpp"
+#include "util/util_task_scheduler.hpp"
+
+/**
+ * @class FrameHashVerifier
+ * @brief 逐帧逐平面哈希（framemd5 风格）与基准清单比对，用于解码回归校验
+ * @details 每个文件的解码作为低优先级任务交给调度器，每个解码帧作为高优先级任务逐平面计算 hash_plane，
+ *          哈希与解码并行，多个文件同时处理。单个文件已解码未哈希的帧达到 max_inflight_frames 时，
+ *          解码任务直接在本线程哈希下一帧，缓存的帧数有上限。
+ *          清单为文本格式，每个文件一节，每帧一行：显示时间戳、尺寸、像素格式与各平面哈希。
+ */
+class FrameHashVerifier
+{
+public:
+    /**
+     * @struct Options
+     * @brief 校验参数
+     */
+    struct Options
+    {
+        /// @brief 每个文件最多在途（已解码未哈希）的帧数
+        std::size_t max_inflight_frames = 8;
+        /// @brief 解码器参数（并行来自文件之间与帧之间，默认每个解码器单线程）
+        MediaDecoder::Options decoder_options = { .thread_count = 1 };
+    };
+    /**
+     * @struct FrameHash
+     * @brief 一帧的哈希
+     */
+    struct FrameHash
+    {
+        /// @brief 显示时间戳（流时间基）
+        int64_t pts = AV_NOPTS_VALUE;
+        int width = 0;
+        int height = 0;
+        /// @brief 像素格式名称
+        std::string format;
+        /// @brief 各平面哈希（调色板格式最后一项为调色板）
+        std::vector<uint64_t> planes;
+    };
+    /**
+     * @struct FileHashes
+     * @brief 一个文件的全部帧哈希
+     */
+    struct FileHashes
+    {
+        std::string file_path;
+        /// @brief 打开或解码错误
+        AVError error;
+        /// @brief 视频流时间基
+        AVRational time_base = { 0, 1 };
+        std::vector<FrameHash> frames;
+        /// @brief 参与哈希的字节数
+        uint64_t hashed_bytes = 0;
+    };
+    /**
+     * @enum Status
+     * @brief 比对结果
+     */
+    enum class Status
+    {
+        /// @brief 逐帧一致
+        MATCH,
+        /// @brief 存在差异
+        MISMATCH,
+        /// @brief 解码出错
+        ERROR,
+    };
+    /**
+     * @struct Difference
+     * @brief 第一处差异
+     */
+    struct Difference
+    {
+        Status status = Status::MATCH;
+        /// @brief 第一个不一致的帧序号
+        std::size_t frame_index = 0;
+        /// @brief 第一个不一致的平面（-1 表示帧属性或帧数不一致）
+        int plane = -1;
+        /// @brief 差异说明
+        std::string detail;
+    };
+public:
+    /**
+     * @brief 构造函数
+     * @param scheduler 任务调度器
+     * @param options 校验参数
+     */
+    FrameHashVerifier(DaneJoe::TaskScheduler& scheduler, const Options& options);
+    /**
+     * @brief 解码并哈希一组文件，等待全部完成
+     * @param file_paths 文件列表
+     * @param token 取消标记
+     * @return 与输入顺序一致的结果
+     */
+    std::vector<FileHashes> hash_files(const std::vector<std::string>& file_paths, DaneJoe::CancellationToken token = DaneJoe::CancellationToken());
+    /**
+     * @brief 计算一帧各平面的哈希
+     */
+    static FrameHash hash_frame(const AVFramePtr& frame, uint64_t* hashed_bytes = nullptr);
+    /**
+     * @brief 写出清单（解码出错的文件不写入）
+     */
+    static bool write_manifest(const std::string& manifest_path, const std::vector<FileHashes>& files);
+    /**
+     * @brief 读取清单
+     * @return 无法打开或格式错误时为空
+     */
+    static std::optional<std::vector<FileHashes>> read_manifest(const std::string& manifest_path);
+    /**
+     * @brief 与基准比对，返回第一处差异
+     */
+    static Difference compare(const FileHashes& golden, const FileHashes& actual);
+private:
+    /// @brief 任务调度器
+    DaneJoe::TaskScheduler& m_scheduler;
+    Options m_options;
+};
+
+/**
+ * @brief 逐帧哈希校验模式
+ * @details 解码并哈希全部输入文件；指定 write_path 时写出清单，指定 golden_path 时与基准清单比对，
+ *          输出每个不一致文件的第一处差异（帧与平面）以及吞吐
+ * @param inputs 文件或目录
+ * @param write_path 输出清单路径（为空时不写）
+ * @param golden_path 基准清单路径（为空时不比对）
+ * @param workers 工作线程数（0 表示硬件并发数）
+ * @return 进程退出码（存在差异、缺少基准或解码出错时为 1）
+ */
+int run_frame_hash(const std::vector<std::string>& inputs, const std::string& write_path, const std::string& golden_path, std::size_t workers);
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "codec/av_frame_view.hpp"
+#include "main/frame_queue.hpp"
+#include "main/playback_rate.hpp"
+
+/**
+ * @class RefreshClock
+ * @brief 显示刷新时钟
+ * @details 以固定间隔的刷新网格近似显示器的垂直同步。开启 vsync 时 SDL_RenderPresent 阻塞到下一次刷新，
+ *          返回时刻经 observe 校正网格相位（偏离超过四分之一间隔视为错过刷新并重新定相）；
+ *          无显示器时不调用 observe，网格即模拟的刷新时钟。
+ */
+class RefreshClock
+{
+public:
+    using Clock = std::chrono::steady_clock;
+public:
+    /**
+     * @brief 构造函数
+     * @param refresh_hz 刷新率（Hz，不大于 0 时按 60Hz）
+     */
+    explicit RefreshClock(double refresh_hz);
+    /**
+     * @brief 刷新率（Hz）
+     */
+    double refresh_hz()const;
+    /**
+     * @brief 刷新间隔
+     */
+    Clock::duration interval()const;
+    /**
+     * @brief 严格晚于 now 的下一次刷新时间（首次调用时以 now 定相）
+     */
+    Clock::time_point next_refresh(Clock::time_point now);
+    /**
+     * @brief 用实测的刷新时刻校正相位
+     * @param refresh_time 实测刷新时刻（vsync 呈现返回的时间）
+     * @return 对齐到网格后的刷新时刻
+     */
+    Clock::time_point observe(Clock::time_point refresh_time);
+private:
+    double m_refresh_hz = 60.;
+    Clock::duration m_interval;
+    /// @brief 网格上的某一次刷新
+    Clock::time_point m_phase;
+    bool m_has_phase = false;
+};
+
+/**
+ * @class FramePacer
+ * @brief 按显示刷新选帧的呈现调度器
+ * @details 每次刷新调用 take_frame，由 PlaybackClock 选出在该次刷新时刻（容差约半个刷新间隔）应显示的最新帧，
+ *          帧率与刷新率不成整数倍时（如 24fps@60Hz）自然形成 3:2 的稳定节奏，而不是随定时器抖动。
+ *          每个呈现的帧记录实际呈现间隔，与按帧时间戳计算的理想间隔比较得到抖动评分：
+ *          评分 = 间隔误差的均方根 / 理想间隔均值，0 表示完全均匀，24fps@60Hz 的 3:2 节奏约为 0.2。
+ *          丢帧不计入抖动（理想间隔同样按时间戳差计算），单独统计。
+ */
+class FramePacer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    /// @brief 间隔直方图的桶数（按刷新次数 1、2、3……，最后一桶包含更长的间隔）
+    static constexpr std::size_t HISTOGRAM_BUCKETS = 6;
+    /**
+     * @struct Report
+     * @brief 呈现节奏统计
+     */
+    struct Report
+    {
+        /// @brief 刷新率（Hz）
+        double refresh_hz = 0.;
+        /// @brief 调度过的刷新次数
+        uint64_t refreshes = 0;
+        /// @brief 呈现的新帧数
+        uint64_t presented_frames = 0;
+        /// @brief 沿用上一帧的刷新次数
+        uint64_t repeated_refreshes = 0;
+        /// @brief 实际呈现晚于目标刷新的次数（错过垂直同步）
+        uint64_t missed_refreshes = 0;
+        /// @brief 呈现间隔均值（毫秒）
+        double mean_interval_ms = 0.;
+        /// @brief 呈现间隔标准差（毫秒）
+        double interval_stddev_ms = 0.;
+        /// @brief 抖动评分
+        double judder_score = 0.;
+        /// @brief 按刷新次数统计的呈现间隔分布
+        std::array<uint64_t, HISTOGRAM_BUCKETS> interval_histogram = {};
+    };
+public:
+    /**
+     * @brief 构造函数
+     * @param control 与解码线程共享的变速播放控制（为空时以 1x 播放）
+     * @param refresh_interval 刷新间隔
+     */
+    FramePacer(std::shared_ptr<PlaybackRateControl> control, Clock::duration refresh_interval);
+    /**
+     * @brief 为一次刷新选帧
+     * @param frame_queue 帧队列
+     * @param refresh_time 帧将被显示的刷新时刻
+     * @return 该次刷新应呈现的新帧；继续显示上一帧时为空
+     */
+    std::optional<AVFrameView> take_frame(FrameQueue& frame_queue, Clock::time_point refresh_time);
+    /**
+     * @brief 记录一帧已呈现
+     * @param frame 呈现的帧
+     * @param target_time 选帧时的目标刷新时刻
+     * @param present_time 实际呈现的刷新时刻（无 vsync 反馈时等于目标时刻）
+     */
+    void record_presented(const AVFrameView& frame, Clock::time_point target_time, Clock::time_point present_time);
+    /**
+     * @brief 暂停：时钟重新定锚，暂停前后的间隔不计入统计
+     */
+    void pause();
+    /**
+     * @brief 呈现节奏统计
+     */
+    Report get_report()const;
+private:
+    PlaybackClock m_playback_clock;
+    std::shared_ptr<PlaybackRateControl> m_control;
+    Clock::duration m_refresh_interval;
+    /// @brief 上一个呈现帧的刷新时刻与帧时间（秒）
+    std::optional<Clock::time_point> m_last_present_time;
+    std::optional<double> m_last_frame_seconds;
+    Report m_report;
+    /// @brief 呈现间隔之和与平方和（秒）
+    double m_interval_sum = 0.;
+    double m_interval_square_sum = 0.;
+    /// @brief 理想间隔之和与误差平方和（秒）
+    double m_ideal_sum = 0.;
+    double m_error_square_sum = 0.;
+    uint64_t m_interval_count = 0;
+};
+
+/**
+ * @brief 呈现节奏基准
+ * @details 无显示器：以模拟的刷新时钟驱动 FramePacer 播放第一个输入文件，输出呈现间隔分布、抖动评分与丢帧数
+ * @param inputs 文件或目录
+ * @param refresh_hz 模拟刷新率（Hz）
+ * @param seconds 运行时长（秒）
+ * @return 进程退出码
+ */
+int run_pacing_benchmark(const std::vector<std::string>& inputs, double refresh_hz, int seconds);
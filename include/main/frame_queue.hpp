@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+
+#include "codec/av_frame_view.hpp"
+#include "concurrent/blocking/mpmc_bounded_queue.hpp"
+
+/**
+ * @class FrameQueue
+ * @brief 解码端到渲染端的帧队列
+ * @details 在 MpmcBoundedQueue 之上维护帧数量计数，
+ *          让共享解码线程池能够以非阻塞方式感知背压，而不是阻塞在 push 上；
+ *          队列由满变为不满时回调通知线程池，线程池不必轮询。
+ */
+class FrameQueue
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 队列容量
+     */
+    explicit FrameQueue(std::size_t capacity);
+    /**
+     * @brief 阻塞推入一帧
+     * @param frame 帧视图
+     * @return 队列已关闭而被拒绝时为false
+     */
+    bool push(AVFrameView&& frame);
+    /**
+     * @brief 非阻塞推入一帧
+     * @param frame 帧视图，失败时保持不变
+     * @return 队列已满或已关闭时为false
+     * @note 仅支持单生产者，多生产者请使用 push
+     */
+    bool try_push(AVFrameView& frame);
+    /**
+     * @brief 非阻塞取出一帧
+     */
+    std::optional<AVFrameView> try_pop();
+    /**
+     * @brief 关闭队列
+     */
+    void close();
+    /**
+     * @brief 队列是否仍在运行
+     */
+    bool is_running();
+    /**
+     * @brief 当前帧数量
+     */
+    std::size_t size()const;
+    /**
+     * @brief 队列容量
+     */
+    std::size_t capacity()const;
+    /**
+     * @brief 队列是否已满（背压信号）
+     */
+    bool is_full()const;
+    /**
+     * @brief 设置队列由满变为不满或关闭时的回调（为空时取消）
+     * @param callback 在取帧或关闭的线程上调用，应只做通知；取消返回后不再被调用
+     */
+    void set_on_not_full(std::function<void()> callback);
+private:
+    /**
+     * @brief 调用由满变为不满或关闭时的回调
+     */
+    void notify_not_full();
+private:
+    /// @brief 队列容量
+    const std::size_t m_capacity;
+    /// @brief 当前帧数量
+    std::atomic<std::size_t> m_size = 0;
+    /// @brief 底层队列
+    DaneJoe::Concurrent::Blocking::MpmcBoundedQueue<AVFrameView> m_queue;
+    /// @brief 保护回调，使取消与调用互斥
+    std::mutex m_callback_mutex;
+    /// @brief 由满变为不满或关闭时的回调
+    std::function<void()> m_on_not_full;
+};
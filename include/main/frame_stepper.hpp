@@ -0,0 +1,264 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "codec/av_error.hpp"
+#include "codec/av_frame_ptr.hpp"
+#include "codec/av_frame_view.hpp"
+#include "main/media_decoder.hpp"
+
+/**
+ * @class DecodedFrameCache
+ * @brief 按 PTS 索引、按内存上限淘汰的已解码帧 LRU 缓存
+ * @details 缓存中的 AVFramePtr 与解码器共享缓冲（`av_frame_ref`），不复制像素数据；
+ *          占用按帧缓冲的实际大小统计，超过上限时淘汰最久未使用的帧，但至少保留最近插入的一帧。
+ *          非线程安全，由持有它的播放器在同一线程中使用。
+ */
+class DecodedFrameCache
+{
+public:
+    /**
+     * @struct Stats
+     * @brief 缓存统计
+     */
+    struct Stats
+    {
+        /// @brief 命中次数
+        uint64_t hits = 0;
+        /// @brief 未命中次数
+        uint64_t misses = 0;
+        /// @brief 淘汰的帧数
+        uint64_t evictions = 0;
+        /// @brief 缓存的帧数
+        std::size_t entries = 0;
+        /// @brief 缓存帧占用的字节数
+        std::size_t bytes = 0;
+        /// @brief 占用的峰值字节数
+        std::size_t peak_bytes = 0;
+        /// @brief 内存上限（字节）
+        std::size_t capacity_bytes = 0;
+        /**
+         * @brief 命中率（尚无查询时为 0）
+         */
+        double hit_rate()const;
+    };
+    /// @brief 帧被淘汰时的回调（参数为被淘汰帧的 PTS）
+    using EvictCallback = std::function<void(int64_t pts)>;
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity_bytes 内存上限（字节）
+     */
+    explicit DecodedFrameCache(std::size_t capacity_bytes = 256 * 1024 * 1024);
+    /**
+     * @brief 设置帧被淘汰时的回调（clear 不触发）
+     */
+    void set_evict_callback(EvictCallback callback);
+    /**
+     * @brief 调整内存上限，超出部分立即淘汰
+     */
+    void set_capacity(std::size_t capacity_bytes);
+    /**
+     * @brief 插入一帧（共享缓冲），已存在时替换并标记为最近使用
+     * @param pts 显示时间戳（流时间基）
+     * @param frame 已解码帧
+     */
+    void insert(int64_t pts, const AVFramePtr& frame);
+    /**
+     * @brief 查找一帧并标记为最近使用，计入命中统计
+     * @return 与缓存共享缓冲的帧，未命中时为空
+     */
+    std::optional<AVFramePtr> find(int64_t pts);
+    /**
+     * @brief 是否缓存了该帧（不影响 LRU 顺序与统计）
+     */
+    bool contains(int64_t pts)const;
+    /**
+     * @brief 清空缓存（保留统计）
+     */
+    void clear();
+    /**
+     * @brief 缓存统计
+     */
+    Stats get_stats()const;
+    /**
+     * @brief 帧缓冲占用的字节数
+     */
+    static std::size_t frame_bytes(const AVFrame* frame);
+private:
+    /**
+     * @brief 淘汰最久未使用的帧直到不超过上限
+     */
+    void evict();
+private:
+    /**
+     * @struct Entry
+     * @brief 缓存项
+     */
+    struct Entry
+    {
+        AVFramePtr frame;
+        std::size_t bytes = 0;
+        /// @brief 在 m_lru 中的位置
+        std::list<int64_t>::iterator lru_iterator;
+    };
+    /// @brief 按使用先后排列的 PTS，表头为最近使用
+    std::list<int64_t> m_lru;
+    std::unordered_map<int64_t, Entry> m_entries;
+    EvictCallback m_evict_callback;
+    Stats m_stats;
+};
+
+/**
+ * @class FrameStepper
+ * @brief 逐帧单步（检查用）
+ * @details 持有独立的解码器与已解码帧缓存。向前单步时解码器通常正好停在当前帧之后，直接解码下一帧；
+ *          向后单步先查缓存，命中时立即返回；未命中时定位到当前帧之前的关键帧，把整个 GOP 解码一次并全部放入缓存，
+ *          之后在该 GOP 内继续后退都会命中。相邻关系在解码时按显示顺序记录，帧被淘汰时一并删除，使其占用与缓存一样有界。
+ */
+class FrameStepper
+{
+public:
+    /**
+     * @struct Options
+     * @brief 单步参数
+     */
+    struct Options
+    {
+        /// @brief 已解码帧缓存的内存上限（字节）
+        std::size_t cache_capacity_bytes = 256 * 1024 * 1024;
+        /// @brief 解码器参数
+        MediaDecoder::Options decoder_options;
+    };
+    /**
+     * @struct Stats
+     * @brief 单步统计
+     */
+    struct Stats
+    {
+        /// @brief 已解码帧缓存的统计
+        DecodedFrameCache::Stats cache;
+        /// @brief 向前单步次数
+        uint64_t forward_steps = 0;
+        /// @brief 向后单步次数
+        uint64_t back_steps = 0;
+        /// @brief 直接由缓存给出结果的单步次数
+        uint64_t cached_steps = 0;
+        /// @brief 为单步而定位并重新解码 GOP 的次数
+        uint64_t gop_decodes = 0;
+        /// @brief 解码出的帧数
+        uint64_t decoded_frames = 0;
+        /// @brief 最近一次单步的耗时（毫秒）
+        double last_step_ms = 0.;
+    };
+public:
+    FrameStepper();
+    explicit FrameStepper(const Options& options);
+    FrameStepper(const FrameStepper&) = delete;
+    FrameStepper& operator=(const FrameStepper&) = delete;
+    /**
+     * @brief 打开文件并清空缓存
+     * @param file_path 文件路径
+     */
+    AVError open(const std::string& file_path);
+    /**
+     * @brief 关闭文件并清空缓存
+     */
+    void close();
+    /**
+     * @brief 是否已打开
+     */
+    bool is_open()const;
+    /**
+     * @brief 文件路径
+     */
+    const std::string& file_path()const;
+    /**
+     * @brief 定位到不晚于指定时间的最后一帧并设为当前帧
+     * @param seconds 帧时间（秒，即 pts × 时间基）
+     * @param frame_view 输出当前帧
+     */
+    AVError seek(double seconds, AVFrameView& frame_view);
+    /**
+     * @brief 前进一帧
+     * @param frame_view 输出新的当前帧
+     * @return 已是最后一帧时为 AVERROR_EOF，当前帧不变
+     */
+    AVError step_forward(AVFrameView& frame_view);
+    /**
+     * @brief 后退一帧
+     * @param frame_view 输出新的当前帧
+     * @return 已是第一帧时为 AVERROR_EOF，当前帧不变
+     */
+    AVError step_back(AVFrameView& frame_view);
+    /**
+     * @brief 当前帧的显示时间戳（流时间基），尚未定位时为空
+     */
+    std::optional<int64_t> current_pts()const;
+    /**
+     * @brief 当前帧的时间（秒），尚未定位时为空
+     */
+    std::optional<double> current_seconds()const;
+    /**
+     * @brief 单步统计
+     */
+    Stats get_stats()const;
+private:
+    /**
+     * @brief 从解码器解码下一帧，放入缓存并记录与上一帧的相邻关系
+     * @param frame 输出帧
+     * @param pts 输出帧的显示时间戳
+     */
+    AVError decode_next(AVFramePtr& frame, int64_t& pts);
+    /**
+     * @brief 定位解码器到指定时间戳之前最近的关键帧
+     */
+    AVError seek_decoder(int64_t pts);
+    /**
+     * @brief 从关键帧解码到 end_pts（不含）之前的最后一帧
+     * @param end_pts 结束时间戳
+     * @param frame 输出 end_pts 之前的最后一帧
+     * @param pts 输出帧的显示时间戳
+     * @return 指定时间戳之前没有帧时为 AVERROR_EOF
+     */
+    AVError decode_before(int64_t end_pts, AVFramePtr& frame, int64_t& pts);
+    /**
+     * @brief 把帧设为当前帧并输出
+     */
+    AVError present(int64_t pts, const AVFramePtr& frame, AVFrameView& frame_view);
+    /**
+     * @brief 删除被淘汰帧的相邻关系
+     */
+    void forget_neighbours(int64_t pts);
+private:
+    Options m_options;
+    MediaDecoder m_decoder;
+    DecodedFrameCache m_cache;
+    /// @brief 显示顺序上的下一帧（pts -> 下一帧 pts）
+    std::map<int64_t, int64_t> m_next_pts;
+    /// @brief 显示顺序上的上一帧（pts -> 上一帧 pts）
+    std::map<int64_t, int64_t> m_previous_pts;
+    /// @brief 当前帧
+    std::optional<int64_t> m_current_pts;
+    /// @brief 解码器最近输出的帧，下一次解码紧接其后（定位后为空）
+    std::optional<int64_t> m_decoder_pts;
+    Stats m_stats;
+};
+
+/**
+ * @brief 单步基准
+ * @details 对第一个输入文件从指定位置连续后退再前进，输出每步耗时、缓存命中率与内存占用
+ * @param inputs 文件或目录
+ * @param steps 后退与前进的步数
+ * @param cache_mb 缓存上限（MB）
+ * @return 进程退出码
+ */
+int run_step_benchmark(const std::vector<std::string>& inputs, int steps, int cache_mb);
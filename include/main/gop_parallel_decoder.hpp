@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "codec/av_error.hpp"
+#include "codec/av_frame_ptr.hpp"
+#include "main/media_decoder.hpp"
+#include "util/util_bounded_queue.hpp"
+
+/**
+ * @class GopParallelDecoder
+ * @brief 单文件按 GOP 区间并行解码（离线分析用）
+ * @details 先只解封装一遍，记下每个关键帧数据包的时间戳，再把关键帧序列切成若干连续的 GOP 区间。
+ *          每个解码线程持有独立的 MediaDecoder，依次领取区间：定位到区间首个关键帧，
+ *          输出显示时间落在 [区间起点, 下一区间起点) 内的帧，遇到第一帧超出区间的帧即停止。
+ *          相邻区间按关键帧的显示时间精确分界：开放式 GOP 开头引用上一 GOP 的帧由上一区间解码输出，
+ *          本区间解码出的这些帧被丢弃，因此输出与顺序解码逐帧一致。
+ *          区间数多于线程数，先完成的线程继续领取后面的区间，长短不一的 GOP 也能均衡负载。
+ */
+class GopParallelDecoder
+{
+public:
+    /**
+     * @enum Order
+     * @brief 帧的交付顺序
+     */
+    enum class Order
+    {
+        /// @brief 各解码线程直接回调，区间内有序，区间之间并发
+        PER_RANGE,
+        /// @brief 在调用 run 的线程上按显示顺序回调，与顺序解码一致
+        GLOBAL,
+    };
+    /**
+     * @struct Options
+     * @brief 并行解码参数
+     */
+    struct Options
+    {
+        /// @brief 解码线程数（0 表示使用硬件并发数）
+        std::size_t workers = 0;
+        /// @brief 每个线程平均分到的区间数（越大负载越均衡，定位与区间首尾的多余解码越多）
+        std::size_t ranges_per_worker = 4;
+        /// @brief 交付顺序
+        Order order = Order::GLOBAL;
+        /// @brief 全局有序时每个区间最多缓存的帧数，内存上限约为 workers × reorder_frames 帧
+        std::size_t reorder_frames = 16;
+        /// @brief 解码器参数（并行来自多个解码器，默认每个解码器单线程）
+        MediaDecoder::Options decoder_options = { .thread_count = 1 };
+    };
+    /**
+     * @struct Range
+     * @brief 一个 GOP 区间
+     */
+    struct Range
+    {
+        /// @brief 定位时间戳（区间首个关键帧的解码时间戳，流时间基）
+        int64_t seek_timestamp = AV_NOPTS_VALUE;
+        /// @brief 区间起点（首个关键帧的显示时间戳，第一个区间为 INT64_MIN）
+        int64_t begin_pts = INT64_MIN;
+        /// @brief 区间终点（下一区间的起点，不含；最后一个区间为 INT64_MAX）
+        int64_t end_pts = INT64_MAX;
+        /// @brief 区间内的 GOP 数
+        std::size_t gops = 0;
+    };
+    /**
+     * @struct Stats
+     * @brief 运行统计
+     */
+    struct Stats
+    {
+        /// @brief 区间数
+        std::size_t ranges = 0;
+        /// @brief GOP 数
+        std::size_t gops = 0;
+        /// @brief 交付的帧数
+        uint64_t frames = 0;
+        /// @brief 解码出的帧数（含区间首尾被丢弃的帧）
+        uint64_t decoded_frames = 0;
+        /// @brief 解封装扫描关键帧的耗时（毫秒）
+        double scan_ms = 0.;
+        /// @brief 各线程解码耗时之和（毫秒，不含回调）
+        double decode_ms = 0.;
+        /// @brief 总耗时（毫秒，含扫描）
+        double wall_ms = 0.;
+    };
+    /**
+     * @brief 帧回调
+     * @details 参数为区间下标与帧（时间基已设为视频流时间基），帧的缓冲引用可移走。
+     *          PER_RANGE 时在解码线程上并发调用，须线程安全。返回 false 时中止解码。
+     */
+    using FrameCallback = std::function<bool(std::size_t range_index, AVFramePtr& frame)>;
+public:
+    /**
+     * @brief 构造函数
+     * @param file_path 文件路径
+     * @param options 并行解码参数
+     */
+    GopParallelDecoder(std::string file_path, const Options& options);
+    /**
+     * @brief 解码整个文件，把每一帧交给回调
+     * @return 回调中止时为 0；任一解码线程出错时为第一个错误
+     */
+    AVError run(const FrameCallback& callback);
+    /**
+     * @brief 本次运行划分的区间
+     */
+    const std::vector<Range>& ranges()const;
+    /**
+     * @brief 本次运行的统计
+     */
+    const Stats& get_stats()const;
+private:
+    /**
+     * @brief 解封装扫描关键帧并划分区间
+     */
+    AVError build_ranges();
+    /**
+     * @brief 解码线程：依次领取区间并解码
+     */
+    void decode_worker(const FrameCallback& callback);
+    /**
+     * @brief 解码一个区间
+     * @param emit 交付一帧，返回 false 时停止
+     */
+    AVError decode_range(MediaDecoder& decoder, const Range& range, const std::function<bool(AVFramePtr&)>& emit);
+    /**
+     * @brief 记录第一个错误并中止
+     */
+    void abort(AVError error);
+private:
+    std::string m_file_path;
+    Options m_options;
+    std::vector<Range> m_ranges;
+    /// @brief 全局有序时各区间的输出队列
+    std::vector<std::unique_ptr<DaneJoe::BoundedQueue<AVFramePtr>>> m_range_queues;
+    /// @brief 下一个待领取的区间
+    std::atomic<std::size_t> m_next_range = 0;
+    std::atomic<bool> m_is_aborted = false;
+    /// @brief 保护统计与错误码
+    std::mutex m_mutex;
+    AVError m_error;
+    Stats m_stats;
+};
+
+/**
+ * @brief GOP 并行解码基准
+ * @details 对第一个输入文件先顺序解码一遍作为基准，再以 1、2、4…直至 max_workers 个线程并行解码，
+ *          每帧计算平均亮度模拟逐帧分析，输出帧率、加速比，并校验全局有序输出与顺序解码逐帧一致
+ * @param inputs 文件或目录
+ * @param max_workers 最大线程数（0 表示硬件并发数）
+ * @param is_per_range 是否按区间交付（不校验顺序）
+ * @return 进程退出码
+ */
+int run_gop_parallel_benchmark(const std::vector<std::string>& inputs, std::size_t max_workers, bool is_per_range);
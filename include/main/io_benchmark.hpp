@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief 输入读取方式基准
+ * @details 对每个文件只做解复用（读出全部数据包，不解码），分别使用 FFmpeg 的 file 协议与自定义 AVIOContext，
+ *          输出吞吐、read 系统调用次数（来自 /proc/self/io）与缺页次数，预读方式另外输出命中率与读延迟。
+ *          热缓存模式下正式计时前先完整读一遍，使各方式都从页缓存读取；
+ *          冷缓存模式下每轮开始前丢弃各文件的页缓存，模拟慢速存储。
+ * @param inputs 文件或目录
+ * @param rounds 每种方式的轮数（取最快一轮）
+ * @param is_cold 是否每轮丢弃页缓存
+ * @return 进程退出码
+ */
+int run_io_benchmark(const std::vector<std::string>& inputs, int rounds, bool is_cold);
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <memory>
+
+extern "C"
+{
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+}
+
+#include "codec/av_error.hpp"
+#include "codec/av_packet_ptr.hpp"
+#include "codec/av_frame_ptr.hpp"
+#include "codec/av_frame_view.hpp"
+#include "codec/av_format_context_ptr.hpp"
+#include "codec/av_codec_context_ptr.hpp"
+#include "codec/i_av_io.hpp"
+
+class PacketDemuxer;
+
+/**
+ * @class MediaDecoder
+ * @brief 单文件视频解码器
+ * @details 将 decode_mp4 的打开/解码流程拆分为可逐帧驱动的状态机，
+ *          调用方每次取一帧，便于在共享线程池中分时调度多个流。
+ */
+class MediaDecoder
+{
+public:
+    /**
+     * @struct Options
+     * @brief 打开参数
+     */
+    struct Options
+    {
+        /// @brief 解码线程数（0 表示由 FFmpeg 自动决定）
+        int thread_count = 0;
+        /// @brief 跳帧策略（AVDISCARD_NONKEY 表示只解码关键帧）
+        AVDiscard skip_frame = AVDISCARD_DEFAULT;
+        /// @brief 输入读取方式
+        AVIOBackend io_backend = AVIOBackend::DEFAULT;
+        /// @brief 格式探测最多读取的字节数（0 表示使用 FFmpeg 默认值 5MB）
+        int64_t probe_size = 0;
+        /// @brief 流信息探测最多分析的时长（微秒，0 表示使用 FFmpeg 默认值）
+        int64_t analyze_duration_us = 0;
+        /// @brief 是否使用流信息缓存，命中时跳过 avformat_find_stream_info
+        bool is_use_stream_info_cache = false;
+        /// @brief 是否从解码器上下文池取用并在关闭时归还
+        bool is_use_context_pool = false;
+        /// @brief 是否把解码器的分片任务交给进程共享的调度器（忽略 thread_count）
+        bool is_use_shared_thread_pool = false;
+    };
+public:
+    MediaDecoder();
+    ~MediaDecoder();
+    MediaDecoder(const MediaDecoder&) = delete;
+    MediaDecoder& operator=(const MediaDecoder&) = delete;
+    /**
+     * @brief 打开文件、探测流信息并打开视频解码器
+     * @param file_path 文件路径
+     */
+    AVError open(const std::string& file_path);
+    /**
+     * @brief 以指定参数打开文件
+     * @param file_path 文件路径
+     * @param options 打开参数
+     */
+    AVError open(const std::string& file_path, const Options& options);
+    /**
+     * @brief 解码下一帧视频
+     * @param frame_view 输出帧视图
+     * @return 成功为0；文件结束且解码器冲刷完毕时为 AVERROR_EOF
+     */
+    AVError decode_frame(AVFrameView& frame_view);
+    /**
+     * @brief 解码下一帧视频，输出可共享的 AVFrame（用于缓存已解码帧）
+     * @param frame 输出帧，时间基已设为视频流时间基
+     * @return 成功为0；文件结束且解码器冲刷完毕时为 AVERROR_EOF
+     */
+    AVError decode_frame(AVFramePtr& frame);
+    /**
+     * @brief 定位到指定时间之前最近的关键帧并清空解码器
+     * @param timestamp_ms 目标时间（毫秒）
+     */
+    AVError seek(int64_t timestamp_ms);
+    /**
+     * @brief 定位到视频流时间基下指定时间戳之前最近的关键帧并清空解码器
+     * @param timestamp 目标时间戳（流时间基，含流起点偏移）
+     */
+    AVError seek_timestamp(int64_t timestamp);
+    /**
+     * @brief 改为从解封装线程的视频流队列取包（为空时恢复直接读取），定位经由解封装线程执行
+     * @param demuxer 已登记视频流的解封装线程，须在关闭解码器之前停止
+     */
+    void set_demuxer(PacketDemuxer* demuxer);
+    /**
+     * @brief 关闭文件与解码器
+     */
+    void close();
+    /**
+     * @brief 是否已打开
+     */
+    bool is_open()const;
+    /**
+     * @brief 文件路径
+     */
+    const std::string& file_path()const;
+    /**
+     * @brief 视频流下标
+     */
+    int video_stream_index()const;
+    /**
+     * @brief 视频流时间基
+     */
+    AVRational time_base()const;
+    /**
+     * @brief 视频流起点时间戳（流时间基，未知时为 0）
+     */
+    int64_t start_pts()const;
+    /**
+     * @brief 视频流平均帧率（未知时为 0）
+     */
+    double frame_rate()const;
+    /**
+     * @brief 文件总时长（毫秒，未知时为 0）
+     */
+    int64_t duration_ms()const;
+    /**
+     * @brief 已从输入读取的字节数
+     */
+    int64_t bytes_read()const;
+    /**
+     * @brief 格式上下文
+     */
+    AVFormatContextPtr& format_context();
+    /**
+     * @brief 视频解码器上下文
+     */
+    AVCodecContextPtr& codec_context();
+private:
+    /**
+     * @brief 读取流信息：缓存命中时直接填回，否则完整探测
+     */
+    AVError load_stream_info(const Options& options);
+    /**
+     * @brief 读取下一个视频数据包并送入解码器
+     * @return 成功为0；读到文件结尾时送入冲刷包并返回0；冲刷后再次调用返回 AVERROR_EOF
+     */
+    AVError feed_packet();
+    /**
+     * @brief 从解码器取出下一帧到 m_frame，需要更多数据时继续送包
+     */
+    AVError receive_next_frame();
+private:
+    /// @brief 文件路径
+    std::string m_file_path;
+    /// @brief 自定义输入（为空时使用 FFmpeg 的 file 协议），须在格式上下文关闭后释放
+    std::unique_ptr<IAVIO> m_io;
+    /// @brief 格式上下文
+    AVFormatContextPtr m_format_context = AVFormatContextPtr(nullptr);
+    /// @brief 视频解码器上下文
+    AVCodecContextPtr m_codec_context;
+    /// @brief 解码器上下文池的复用键（为空表示上下文不来自池）
+    std::string m_codec_pool_key;
+    /// @brief 复用的数据包
+    AVPacketPtr m_packet;
+    /// @brief 复用的解码输出帧
+    AVFramePtr m_frame;
+    /// @brief 解封装线程（为空时在解码线程直接读取）
+    PacketDemuxer* m_demuxer = nullptr;
+    /// @brief 视频流下标
+    int m_video_stream_index = -1;
+    /// @brief 是否已送入冲刷包
+    bool m_is_draining = false;
+};
+
+/**
+ * @class SeekBackoff
+ * @brief 定位的回退目标
+ * @details 索引不精确的容器定位可能落在目标之后，此时从更早的时间戳重新定位：
+ *          每次多退的步长从 0.5 秒起逐次加倍，不早于视频流起点。
+ */
+class SeekBackoff
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param decoder 已打开的解码器
+     * @param target 初始定位目标（流时间基，含流起点偏移）
+     */
+    SeekBackoff(const MediaDecoder& decoder, int64_t target);
+    /**
+     * @brief 当前定位目标（流时间基，含流起点偏移）
+     */
+    int64_t target()const;
+    /**
+     * @brief 是否还能继续向前退（尚未退到流起点）
+     */
+    bool can_retreat()const;
+    /**
+     * @brief 向前退一步并加倍步长
+     */
+    void retreat();
+private:
+    /// @brief 视频流起点
+    int64_t m_origin = 0;
+    /// @brief 当前定位目标
+    int64_t m_target = 0;
+    /// @brief 下一次多退的步长
+    int64_t m_step = 0;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 多路流解码吞吐基准
+ * @details 以不同的解码线程数运行同一组流（帧被立即丢弃），输出总解码帧率与相对单线程的加速比。
+ * @param file_paths 文件列表，按顺序循环分配给各路流
+ * @param stream_count 流数量
+ * @param seconds 每种线程数的运行时长（秒）
+ * @return 进程退出码
+ */
+int run_multi_stream_benchmark(const std::vector<std::string>& file_paths, std::size_t stream_count, int seconds);
+
+/**
+ * @brief 解码线程模型对比基准
+ * @details 每路流一个线程尽快解码（到结尾后从头循环），分别使用 FFmpeg 自带的线程（thread_count=0）
+ *          与共享调度器执行分片任务两种方式，输出总解码帧率、进程线程数与上下文切换次数。
+ * @param file_paths 文件列表，按顺序循环分配给各路流
+ * @param stream_count 流数量
+ * @param seconds 每种方式的运行时长（秒）
+ * @return 进程退出码
+ */
+int run_threading_benchmark(const std::vector<std::string>& file_paths, std::size_t stream_count, int seconds);
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C"
+{
+#include <libavformat/avformat.h>
+}
+
+#include "codec/av_error.hpp"
+#include "codec/av_format_context_ptr.hpp"
+#include "codec/av_packet_ptr.hpp"
+
+/**
+ * @class PacketDemuxer
+ * @brief 解封装线程：把数据包分发到各流独立的有界队列
+ * @details 单个 av_read_frame 循环按文件交织顺序读出各流的数据包，某一流连续的大段数据会让另一流的解码器饿死。
+ *          这里每个登记的流有自己的队列与字节、时长预算，解封装线程在独立线程上读取并分发：
+ *          只有某个队列超出预算时才可能阻塞，且只要缓冲时长最低的队列低于低水位就继续读取，
+ *          读取由最缺数据的流驱动；总字节数另有硬上限，防止某一流长期没有消费者时内存无限增长。
+ *          未登记的流的数据包直接丢弃，因此只应登记有消费者的流。
+ */
+class PacketDemuxer
+{
+public:
+    /**
+     * @struct Budget
+     * @brief 单个队列的预算
+     */
+    struct Budget
+    {
+        /// @brief 字节预算
+        int64_t max_bytes = 8 * 1024 * 1024;
+        /// @brief 时长预算（秒）
+        double max_seconds = 2.;
+        /// @brief 低水位（秒）：缓冲最少的队列低于此值时，即使其他队列超出预算也继续读取
+        double low_seconds = 0.5;
+    };
+    /**
+     * @struct Options
+     * @brief 解封装参数
+     */
+    struct Options
+    {
+        /// @brief 视频流队列预算
+        Budget video_budget;
+        /// @brief 音频流队列预算（音频数据包小而密，字节预算相应较小）
+        Budget audio_budget = Budget{ 1024 * 1024, 2., 0.5 };
+        /// @brief 其他流队列预算
+        Budget other_budget = Budget{ 1024 * 1024, 2., 0. };
+        /// @brief 全部队列的字节硬上限
+        int64_t hard_max_bytes = 64 * 1024 * 1024;
+    };
+    /**
+     * @struct StreamGauge
+     * @brief 单个流的缓冲状态
+     */
+    struct StreamGauge
+    {
+        /// @brief 流下标
+        int stream_index = -1;
+        /// @brief 媒体类型
+        AVMediaType media_type = AVMEDIA_TYPE_UNKNOWN;
+        /// @brief 缓冲的数据包数
+        std::size_t packets = 0;
+        /// @brief 缓冲的字节数
+        int64_t bytes = 0;
+        /// @brief 缓冲时长（秒）
+        double buffered_seconds = 0.;
+        /// @brief 时长预算（秒）
+        double max_seconds = 0.;
+        /// @brief 是否超出预算
+        bool is_over_budget = false;
+        /// @brief 消费者取包时队列为空而等待的次数
+        uint64_t underruns = 0;
+        /// @brief 是否已读到文件结尾
+        bool is_end = false;
+    };
+    /**
+     * @struct Stats
+     * @brief 运行统计
+     */
+    struct Stats
+    {
+        /// @brief 各登记流的缓冲状态
+        std::vector<StreamGauge> streams;
+        /// @brief 读取的数据包数
+        uint64_t packets_read = 0;
+        /// @brief 丢弃的未登记流数据包数
+        uint64_t packets_dropped = 0;
+        /// @brief 有队列超出预算、因最低队列低于低水位而继续读取的次数
+        uint64_t starvation_reads = 0;
+        /// @brief 解封装线程因预算阻塞的累计时长（毫秒）
+        double blocked_ms = 0.;
+    };
+public:
+    /**
+     * @brief 构造函数
+     * @param format_context 已打开的格式上下文，解封装线程运行期间其他线程不得直接读取或定位（定位使用 seek）
+     * @param stream_indices 要分发的流
+     * @param options 解封装参数
+     */
+    PacketDemuxer(AVFormatContextPtr& format_context, const std::vector<int>& stream_indices, const Options& options);
+    /**
+     * @brief 析构函数：停止并等待解封装线程退出
+     */
+    ~PacketDemuxer();
+    PacketDemuxer(const PacketDemuxer&) = delete;
+    PacketDemuxer& operator=(const PacketDemuxer&) = delete;
+    /**
+     * @brief 启动解封装线程
+     */
+    void start();
+    /**
+     * @brief 停止解封装线程并唤醒所有等待的消费者
+     */
+    void stop();
+    /**
+     * @brief 取出指定流的下一个数据包，队列为空时阻塞
+     * @param stream_index 流下标
+     * @param packet 输出数据包
+     * @return 成功为0；该流已读完为 AVERROR_EOF；已停止为 AVERROR_EXIT；未登记的流为 AVERROR(EINVAL)；
+     *         读取出错时在队列取空后返回读取错误
+     */
+    AVError pop(int stream_index, AVPacketPtr& packet);
+    /**
+     * @brief 定位：等待正在进行的读取结束后定位格式上下文，并清空全部队列
+     * @param stream_index 时间戳所属的流
+     * @param timestamp 时间戳（流时间基）
+     * @param flags av_seek_frame 标志
+     */
+    AVError seek(int stream_index, int64_t timestamp, int flags);
+    /**
+     * @brief 当前缓冲状态与统计
+     */
+    Stats get_stats()const;
+private:
+    /**
+     * @struct StreamQueue
+     * @brief 单个流的队列
+     */
+    struct StreamQueue
+    {
+        int stream_index = -1;
+        AVMediaType media_type = AVMEDIA_TYPE_UNKNOWN;
+        AVRational time_base = { 0, 1 };
+        /// @brief 数据包没有时长时使用的估计时长（秒）
+        double fallback_seconds = 0.;
+        Budget budget;
+        std::deque<AVPacketPtr> packets;
+        int64_t bytes = 0;
+        double seconds = 0.;
+        uint64_t underruns = 0;
+        bool is_end = false;
+    };
+    /**
+     * @brief 解封装线程
+     */
+    void run();
+    /**
+     * @brief 是否可以继续读取（调用方持有锁）
+     * @param is_starvation_read 输出：是否因最低队列低于低水位才允许读取
+     */
+    bool can_read(bool& is_starvation_read)const;
+    /**
+     * @brief 数据包时长（秒）
+     */
+    static double packet_seconds(const StreamQueue& queue, AVPacketPtr& packet);
+    /**
+     * @brief 按流下标查找队列（调用方持有锁）
+     */
+    StreamQueue* find_queue(int stream_index);
+    /**
+     * @brief 队列是否超出预算
+     */
+    static bool is_over_budget(const StreamQueue& queue);
+private:
+    AVFormatContextPtr& m_format_context;
+    Options m_options;
+    mutable std::mutex m_mutex;
+    /// @brief 消费者等待数据包
+    std::condition_variable m_packet_condition;
+    /// @brief 解封装线程等待队列低于预算或定位完成
+    std::condition_variable m_space_condition;
+    /// @brief 定位等待当前读取结束
+    std::condition_variable m_seek_condition;
+    std::vector<StreamQueue> m_queues;
+    /// @brief 全部队列的字节数
+    int64_t m_total_bytes = 0;
+    bool m_is_stopped = false;
+    /// @brief 解封装线程是否正在锁外读取
+    bool m_is_reading = false;
+    /// @brief 是否有定位请求在等待
+    bool m_is_seek_pending = false;
+    /// @brief 是否已读到文件结尾（定位后清除）
+    bool m_is_eof = false;
+    /// @brief 读取错误（文件结尾之外）
+    AVError m_error;
+    Stats m_stats;
+    std::jthread m_thread;
+};
+
+/**
+ * @brief 分流解封装基准
+ * @details 对第一个输入文件登记最佳视频流与音频流，各用一个消费线程按时间戳以 speed 倍速取包（模拟实时解码），
+ *          每秒输出各流缓冲时长，结束时输出欠载次数与解封装阻塞时长
+ * @param inputs 文件或目录
+ * @param speed 消费速度倍数
+ * @return 进程退出码
+ */
+int run_demux_benchmark(const std::vector<std::string>& inputs, double speed);
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "main/frame_queue.hpp"
+#include "main/playback_rate.hpp"
+#include "renderer/sdl_frame_renderer.hpp"
+
+/**
+ * @class PlaybackPreloader
+ * @brief 启动阶段的并行预加载
+ * @details 在创建 QApplication 之前启动解码线程，打开文件、探测流信息、打开解码器并把开头的帧预解码进帧队列；
+ *          同时在主线程提前初始化 SDL 视频子系统。Qt 控件与 SDL 渲染器的创建和这些工作重叠，
+ *          窗口显示时第一帧已经在队列中，可以立即提交。
+ */
+class PlaybackPreloader
+{
+public:
+    /**
+     * @brief 构造函数
+     * @param frame_queue_capacity 帧队列容量
+     */
+    explicit PlaybackPreloader(std::size_t frame_queue_capacity = 512);
+    /**
+     * @brief 析构函数
+     * @note 关闭帧队列并等待解码线程退出
+     */
+    ~PlaybackPreloader();
+    PlaybackPreloader(const PlaybackPreloader&) = delete;
+    PlaybackPreloader& operator=(const PlaybackPreloader&) = delete;
+    /**
+     * @brief 设置单文件播放时的滤镜（须在 start 之前调用）
+     * @param filter_description 滤镜描述，与 ffmpeg -vf 相同
+     */
+    void set_filter(const std::string& filter_description);
+    /**
+     * @brief 启动解码线程并初始化 SDL 视频子系统
+     * @param file_path 文件路径
+     */
+    void start(const std::string& file_path);
+    /**
+     * @brief 以无缝播放列表方式启动
+     * @param playlist 文件列表（只有一个文件时等价于 start(file_path)）
+     */
+    void start(const std::vector<std::string>& playlist);
+    /**
+     * @brief 从文件结尾开始倒放
+     * @param file_path 文件路径
+     * @param max_segment_frames 倒放每段最多缓存的帧数
+     */
+    void start_reverse(const std::string& file_path, std::size_t max_segment_frames);
+    /**
+     * @brief 帧队列
+     */
+    std::shared_ptr<FrameQueue> get_frame_queue();
+    /**
+     * @brief 变速播放控制，解码线程与显示控件共享
+     */
+    std::shared_ptr<PlaybackRateControl> get_rate_control();
+    /**
+     * @brief 单文件正向播放时的文件路径
+     * @note 播放列表与倒放的时间轴与文件时间不一致，此时为空（不支持单步）
+     */
+    const std::string& get_file_path()const;
+private:
+    /**
+     * @brief 提前初始化 SDL 视频子系统
+     */
+    void init_video_system();
+private:
+    /// @brief 帧队列
+    std::shared_ptr<FrameQueue> m_frame_queue;
+    /// @brief 变速播放控制
+    std::shared_ptr<PlaybackRateControl> m_rate_control;
+    /// @brief 提前持有 SDL 视频子系统，渲染器创建时只增加引用计数
+    std::unique_ptr<SDLVideoSystem> m_video_system;
+    /// @brief 单文件正向播放时的文件路径
+    std::string m_file_path;
+    /// @brief 单文件播放时的滤镜描述
+    std::string m_filter_description;
+    /// @brief 解码线程
+    std::jthread m_decode_thread;
+};
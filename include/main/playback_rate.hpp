@@ -0,0 +1,294 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+}
+
+#include "codec/av_error.hpp"
+#include "codec/av_frame_view.hpp"
+#include "main/frame_queue.hpp"
+#include "main/media_decoder.hpp"
+
+/**
+ * @enum DecodeStrategy
+ * @brief 解码策略，按跳过的帧由少到多排列
+ */
+enum class DecodeStrategy
+{
+    /// @brief 解码全部帧
+    ALL_FRAMES,
+    /// @brief 跳过非参考帧（AVDISCARD_NONREF）
+    SKIP_NON_REFERENCE,
+    /// @brief 只解码关键帧（AVDISCARD_NONKEY）
+    KEYFRAMES_ONLY,
+    /// @brief 策略数量
+    COUNT,
+};
+
+/**
+ * @brief 策略对应的 AVCodecContext::skip_frame
+ */
+AVDiscard to_av_discard(DecodeStrategy strategy);
+
+/**
+ * @brief 策略名称
+ */
+const char* decode_strategy_name(DecodeStrategy strategy);
+
+/**
+ * @class PlaybackRateControl
+ * @brief 播放速率控制，解码线程与显示线程共享
+ * @details 显示端按请求的速率推进呈现时钟并上报实际呈现的进度，解码端据此选择解码策略并限制超前量。
+ *          速率与策略的读写都是原子操作，实际速率的统计窗口由互斥锁保护（每次呈现更新一次）。
+ */
+class PlaybackRateControl
+{
+public:
+    /**
+     * @struct Options
+     * @brief 策略切换参数
+     */
+    struct Options
+    {
+        /// @brief 速率超过该值时至少跳过非参考帧
+        double skip_non_reference_rate = 2.;
+        /// @brief 速率超过该值时只解码关键帧
+        double keyframe_only_rate = 6.;
+        /// @brief 解码最多领先呈现位置的墙钟时长（秒，按当前速率换算成媒体时长）
+        double lookahead_seconds = 1.;
+    };
+    /**
+     * @struct Report
+     * @brief 速率报告
+     */
+    struct Report
+    {
+        /// @brief 请求的速率
+        double requested_rate = 1.;
+        /// @brief 最近统计窗口内实际达到的速率（媒体时长 / 墙钟时长）
+        double achieved_rate = 0.;
+        /// @brief 当前解码策略
+        DecodeStrategy strategy = DecodeStrategy::ALL_FRAMES;
+        /// @brief 已呈现帧数
+        uint64_t presented_frames = 0;
+        /// @brief 到期但被更新的帧取代而未呈现的帧数
+        uint64_t dropped_frames = 0;
+    };
+    /// @brief 最低速率
+    static constexpr double MIN_RATE = 0.25;
+    /// @brief 最高速率
+    static constexpr double MAX_RATE = 16.;
+public:
+    PlaybackRateControl();
+    explicit PlaybackRateControl(const Options& options);
+    /**
+     * @brief 设置请求的速率，超出范围时截断
+     */
+    void set_rate(double rate);
+    /**
+     * @brief 在 0.25x、0.5x、1x、2x、4x、8x、16x 之间按档位调整速率
+     * @param steps 正数加速，负数减速
+     */
+    void step_rate(int steps);
+    /**
+     * @brief 请求的速率
+     */
+    double rate()const;
+    /**
+     * @brief 策略切换参数
+     */
+    const Options& options()const;
+    /**
+     * @brief 解码端报告当前策略
+     */
+    void set_strategy(DecodeStrategy strategy);
+    /**
+     * @brief 当前解码策略
+     */
+    DecodeStrategy strategy()const;
+    /**
+     * @brief 解码端已定位到 media_seconds 之前的关键帧，显示端应丢弃队列中定位前解码的帧
+     */
+    void request_resync(double media_seconds);
+    /**
+     * @brief 重定位次数，显示端据此判断是否发生了新的重定位
+     */
+    uint64_t resync_generation()const;
+    /**
+     * @brief 最近一次重定位的目标位置（秒）
+     */
+    double resync_target()const;
+    /**
+     * @brief 显示端记录一次呈现
+     * @param media_seconds 帧的时间（秒）
+     * @param now 呈现时刻
+     */
+    void record_presented(double media_seconds, std::chrono::steady_clock::time_point now);
+    /**
+     * @brief 显示端记录丢弃的帧
+     */
+    void record_dropped(uint64_t count);
+    /**
+     * @brief 最近呈现的帧的时间（秒），尚未呈现时为空
+     */
+    std::optional<double> presented_seconds()const;
+    /**
+     * @brief 速率报告
+     */
+    Report get_report();
+private:
+    const Options m_options;
+    std::atomic<double> m_rate = 1.;
+    std::atomic<DecodeStrategy> m_strategy = DecodeStrategy::ALL_FRAMES;
+    std::atomic<uint64_t> m_resync_generation = 0;
+    std::atomic<double> m_resync_target = 0.;
+    std::atomic<bool> m_is_presented = false;
+    std::atomic<double> m_presented_seconds = 0.;
+    std::atomic<uint64_t> m_presented_frames = 0;
+    std::atomic<uint64_t> m_dropped_frames = 0;
+    /// @brief 保护 m_present_window
+    std::mutex m_mutex;
+    /// @brief 最近约两秒的呈现记录（墙钟时刻，帧时间）
+    std::deque<std::pair<std::chrono::steady_clock::time_point, double>> m_present_window;
+};
+
+/**
+ * @class DecodeRateAdapter
+ * @brief 解码线程侧的速率适配
+ * @details 每次解码前根据请求的速率选择策略：速率阈值给出允许的最低跳帧程度，
+ *          若该策略实测的解码速度（媒体时长 / 解码耗时，不含入队等待）达不到请求速率，
+ *          则继续升级到跳过更多帧的策略；实测结果 10 秒后过期重新测量。
+ *          策略降级（减速）时队列中可能积压了大量稀疏的关键帧，积压超过新速率下的超前上限时定位回当前呈现位置重新解码。
+ *          control 为空时直接转发给解码器。
+ */
+class DecodeRateAdapter
+{
+public:
+    explicit DecodeRateAdapter(std::shared_ptr<PlaybackRateControl> control);
+    /**
+     * @brief 按当前策略解码下一帧
+     * @param decoder 解码器
+     * @param frame_view 输出帧视图
+     * @param timeline_shift_seconds 输出时间轴与帧原始时间之差（秒），用于把呈现位置换算回解码器时间定位
+     */
+    AVError decode_frame(MediaDecoder& decoder, AVFrameView& frame_view, double timeline_shift_seconds = 0.);
+    /**
+     * @brief 按当前策略解码下一帧，输出可共享的 AVFrame（交给滤镜阶段时使用）
+     * @param decoder 解码器
+     * @param frame 输出帧
+     * @param timeline_shift_seconds 输出时间轴与帧原始时间之差（秒）
+     */
+    AVError decode_frame(MediaDecoder& decoder, AVFramePtr& frame, double timeline_shift_seconds = 0.);
+    /**
+     * @brief 解码领先呈现位置过多时等待
+     * @param frame_view 即将入队的帧（输出时间轴）
+     * @param is_running 返回 false 时立即停止等待
+     */
+    void throttle(const AVFrameView& frame_view, const std::function<bool()>& is_running);
+private:
+    /**
+     * @struct SpeedSample
+     * @brief 某策略最近一次实测的解码速度
+     */
+    struct SpeedSample
+    {
+        double speed = 0.;
+        std::chrono::steady_clock::time_point measured_at;
+        bool is_valid = false;
+    };
+    /**
+     * @brief 选择策略
+     */
+    DecodeStrategy select_strategy(double rate, std::chrono::steady_clock::time_point now)const;
+    /**
+     * @brief 定位回当前呈现位置
+     */
+    void resync(MediaDecoder& decoder, double timeline_shift_seconds);
+    /**
+     * @brief 两种输出形式共用的解码与测速流程
+     */
+    template<class Frame>
+    AVError decode_with_strategy(MediaDecoder& decoder, Frame& frame, double timeline_shift_seconds);
+private:
+    std::shared_ptr<PlaybackRateControl> m_control;
+    DecodeStrategy m_strategy = DecodeStrategy::ALL_FRAMES;
+    std::array<SpeedSample, static_cast<std::size_t>(DecodeStrategy::COUNT)> m_speeds;
+    /// @brief 上一帧的原始时间（秒）
+    std::optional<double> m_last_frame_seconds;
+    /// @brief 当前测量窗口内解码出的媒体时长
+    double m_window_media_seconds = 0.;
+    /// @brief 当前测量窗口内的解码耗时
+    double m_window_wall_seconds = 0.;
+};
+
+/**
+ * @class PlaybackClock
+ * @brief 显示端的呈现时钟
+ * @details 媒体时间 = 锚点媒体时间 + (当前墙钟 - 锚点墙钟) × 速率，速率变化时重新设锚点。
+ *          每次调用取出所有已到期的帧，只返回最新的一帧，其余计为丢弃；
+ *          呈现的帧落后时钟超过 0.25 秒（墙钟）说明解码跟不上，时钟退回到该帧继续，
+ *          实际速率因此低于请求速率并体现在报告中。
+ */
+class PlaybackClock
+{
+public:
+    explicit PlaybackClock(std::shared_ptr<PlaybackRateControl> control);
+    /**
+     * @brief 取出当前应呈现的帧
+     * @param lookahead 在 now 之后 lookahead 内到期的帧也视为到期（按显示刷新选最近的帧）
+     * @return 没有到期的帧时为空
+     */
+    std::optional<AVFrameView> take_due_frame(FrameQueue& frame_queue, std::chrono::steady_clock::time_point now,
+        std::chrono::steady_clock::duration lookahead = std::chrono::steady_clock::duration::zero());
+    /**
+     * @brief 暂停：清除锚点，恢复后以下一帧重新设锚点，暂停期间的墙钟时长不计入媒体时间
+     */
+    void pause();
+private:
+    /**
+     * @brief 当前媒体时间（秒）
+     */
+    double media_seconds(std::chrono::steady_clock::time_point now)const;
+    /**
+     * @brief 设置锚点
+     */
+    void anchor(double media_seconds, double rate, std::chrono::steady_clock::time_point now);
+private:
+    std::shared_ptr<PlaybackRateControl> m_control;
+    /// @brief 已出队但尚未到期的帧
+    std::optional<AVFrameView> m_pending;
+    bool m_is_anchored = false;
+    double m_anchor_media_seconds = 0.;
+    double m_anchor_rate = 1.;
+    std::chrono::steady_clock::time_point m_anchor_time;
+    /// @brief 已处理的重定位次数
+    uint64_t m_resync_generation = 0;
+    /// @brief 是否正在丢弃重定位前解码的帧
+    bool m_is_resyncing = false;
+    double m_resync_target = 0.;
+    /// @brief 重定位后追赶呈现位置的截止时间，期间落后的帧直接丢弃而不回退时钟
+    std::optional<std::chrono::steady_clock::time_point> m_catch_up_deadline;
+};
+
+/**
+ * @brief 变速播放基准
+ * @details 对第一个输入文件依次以 0.25x 到 16x 播放（不显示），输出请求速率、实际速率、最终解码策略与丢帧数
+ * @param inputs 文件或目录
+ * @param seconds 每个速率的运行时长（秒）
+ * @return 进程退出码
+ */
+int run_rate_benchmark(const std::vector<std::string>& inputs, int seconds);
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "codec/av_error.hpp"
+#include "codec/av_frame_view.hpp"
+#include "main/frame_queue.hpp"
+#include "main/media_decoder.hpp"
+#include "main/playback_rate.hpp"
+
+/**
+ * @class PlaylistDecoder
+ * @brief 无缝播放列表解码
+ * @details 在同一个解码线程上依次解码播放列表中的文件并推入同一个帧队列。
+ *          当前文件播放时，下一个文件在后台线程中打开、探测并预解码开头若干帧；
+ *          当前文件到达结束时间后立即改从预解码的帧继续推送，不需要重建解码线程。
+ *          所有帧映射到以微秒为单位的连续时间轴：每个文件的第一帧恰好落在上一个文件的结束时间上。
+ */
+class PlaylistDecoder
+{
+public:
+    /**
+     * @struct Options
+     * @brief 播放参数
+     */
+    struct Options
+    {
+        /// @brief 是否在后台预加载下一个文件
+        bool is_preload = true;
+        /// @brief 预加载时预解码的帧数
+        int preroll_frames = 8;
+        /// @brief 解码器参数
+        MediaDecoder::Options decoder_options;
+        /// @brief 变速播放控制（为空时解码全部帧）
+        std::shared_ptr<PlaybackRateControl> rate_control;
+    };
+    /**
+     * @struct Transition
+     * @brief 一次文件切换
+     */
+    struct Transition
+    {
+        /// @brief 切换前的文件下标
+        std::size_t from_index = 0;
+        /// @brief 切换后的文件下标
+        std::size_t to_index = 0;
+        /// @brief 切换时间点（时间轴毫秒）
+        double handover_ms = 0.;
+        /// @brief 上一个文件最后一帧与下一个文件第一帧入队之间的间隔（毫秒）
+        double gap_ms = 0.;
+        /// @brief 下一个文件是否已预加载
+        bool is_preloaded = false;
+    };
+public:
+    /**
+     * @brief 构造函数
+     * @param playlist 文件列表
+     * @param options 播放参数
+     */
+    PlaylistDecoder(std::vector<std::string> playlist, const Options& options);
+    /**
+     * @brief 依次解码全部文件并推入帧队列，直到播放完毕或队列关闭
+     * @param frame_queue 帧队列
+     * @return 至少播放了一个文件时为0
+     */
+    AVError run(std::weak_ptr<FrameQueue> frame_queue);
+    /**
+     * @brief 本次运行的文件切换记录
+     */
+    const std::vector<Transition>& get_transitions()const;
+private:
+    /**
+     * @struct PreparedItem
+     * @brief 已打开并预解码的文件
+     */
+    struct PreparedItem
+    {
+        /// @brief 文件下标
+        std::size_t index = 0;
+        /// @brief 解码器
+        std::unique_ptr<MediaDecoder> decoder;
+        /// @brief 预解码的帧
+        std::deque<AVFrameView> frames;
+        /// @brief 打开或预解码时的错误
+        AVError error;
+        /// @brief 预解码时是否已到文件结尾
+        bool is_eof = false;
+    };
+    /**
+     * @brief 打开文件并预解码开头的帧
+     */
+    static PreparedItem prepare_item(std::size_t index, const std::string& file_path, const Options& options);
+private:
+    /// @brief 文件列表
+    std::vector<std::string> m_playlist;
+    /// @brief 播放参数
+    Options m_options;
+    /// @brief 文件切换记录
+    std::vector<Transition> m_transitions;
+};
+
+/**
+ * @brief 播放列表切换基准
+ * @details 以尽可能快的消费端排空帧队列，分别在重启解码（不预加载）与预加载下一个文件两种方式下
+ *          播放整个列表，输出每次切换时帧队列断流的平均与最大时长。
+ * @param inputs 文件或目录
+ * @param preroll_frames 预解码帧数
+ * @return 进程退出码
+ */
+int run_playlist_benchmark(const std::vector<std::string>& inputs, int preroll_frames);
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "codec/av_frame_view.hpp"
+#include "main/frame_queue.hpp"
+#include "main/frame_pacer.hpp"
+#include "main/playback_rate.hpp"
+#include "renderer/i_frame_renderer.hpp"
+#include "util/util_precise_timer.hpp"
+#include "util/util_vector_2d.hpp"
+
+/**
+ * @class PresentThread
+ * @brief 专用呈现线程
+ * @details 一个线程驱动一个或多个输出（渲染器 + 帧队列）：每次刷新先由各输出的 FramePacer 为下一次刷新选帧，
+ *          再用 PreciseTimer 等到刷新时刻依次绘制；只有一个输出且开启 vsync 时由 present 阻塞对齐刷新。
+ *          视频墙的所有分块共用一个呈现线程，刷新等待与自旋只发生一次，而不是每路流一个线程。
+ *          GUI 线程只发布控制：添加/移除输出、暂停、单步帧与窗口尺寸。
+ * @note SDL 不是线程安全的（X11 下 SDL 自己的显示连接未启用 XInitThreads），
+ *       因此 SDL 的全部调用都在呈现线程上：视频子系统初始化、关联原生窗口、创建渲染器、绘制、调整窗口尺寸、
+ *       轮询事件，以及释放渲染器与 SDL 窗口。GUI 线程从不调用 SDL。
+ *       同一进程中只应有一个呈现线程使用 SDL。
+ */
+class PresentThread
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    /// @brief 输出标识
+    using OutputId = uint64_t;
+public:
+    /**
+     * @brief 构造并启动呈现线程
+     */
+    PresentThread();
+    /**
+     * @brief 析构函数：停止并等待呈现线程退出，线程退出前释放所有输出的渲染器
+     */
+    ~PresentThread();
+    PresentThread(const PresentThread&) = delete;
+    PresentThread& operator=(const PresentThread&) = delete;
+    /**
+     * @brief 添加输出
+     * @param renderer 尚未关联窗口的渲染器，移交给呈现线程，之后只在呈现线程上使用与析构
+     * @param window_name 窗口名称
+     * @param window_size 初始窗口尺寸
+     * @param window 原生窗口句柄，须在 remove_output 返回前保持有效
+     * @param frame_queue 帧队列
+     * @param rate_control 变速播放控制（为空时以 1x 播放）
+     * @return 输出标识
+     */
+    OutputId add_output(std::unique_ptr<IFrameRenderer> renderer, std::string window_name, DaneJoe::Size<int> window_size, void* window,
+        std::shared_ptr<FrameQueue> frame_queue, std::shared_ptr<PlaybackRateControl> rate_control);
+    /**
+     * @brief 移除输出，等待呈现线程释放其渲染器与 SDL 窗口后返回
+     */
+    void remove_output(OutputId id);
+    /**
+     * @brief 暂停或恢复某个输出从帧队列呈现
+     */
+    void set_paused(OutputId id, bool is_paused);
+    /**
+     * @brief 暂停时单步显示一帧
+     * @param frame_view 帧视图，缓冲引用移交给呈现线程，在下一次循环中绘制
+     */
+    void show_frame(OutputId id, AVFrameView&& frame_view);
+    /**
+     * @brief 更新输出的窗口尺寸（SDL 调用在呈现线程的下一次循环中执行）
+     */
+    void update_window_size(OutputId id, DaneJoe::Size<int> window_size);
+    /**
+     * @brief 呈现线程是否收到了 SDL 的退出事件
+     */
+    bool is_exit()const;
+    /**
+     * @brief 请求停止呈现线程
+     */
+    void close();
+    /**
+     * @brief 某个输出最近一次呈现后的节奏统计
+     */
+    FramePacer::Report get_report(OutputId id)const;
+private:
+    /**
+     * @struct Output
+     * @brief 一个输出的状态
+     * @details 控制字段由 m_mutex 保护；渲染器、呈现调度器等只在呈现线程上访问
+     */
+    struct Output
+    {
+        OutputId id = 0;
+        /// @brief 渲染器（仅呈现线程访问）
+        std::unique_ptr<IFrameRenderer> renderer;
+        std::string window_name;
+        void* window = nullptr;
+        std::shared_ptr<FrameQueue> frame_queue;
+        std::shared_ptr<PlaybackRateControl> rate_control;
+        /// @brief 呈现调度器（仅呈现线程访问）
+        std::unique_ptr<FramePacer> frame_pacer;
+        /// @brief 呈现调度器是否已按暂停重新定锚（仅呈现线程访问）
+        bool is_pacer_paused = false;
+        /// @brief 是否暂停
+        bool is_paused = false;
+        /// @brief 待绘制的单步帧
+        std::optional<AVFrameView> step_frame;
+        /// @brief 待应用的窗口尺寸
+        std::optional<DaneJoe::Size<int>> window_size;
+        /// @brief 是否已请求移除
+        bool is_removed = false;
+        /// @brief 呈现线程是否已释放渲染器
+        bool is_released = false;
+        /// @brief 发布给 GUI 线程的节奏统计
+        FramePacer::Report report;
+    };
+    /**
+     * @struct OutputWork
+     * @brief 一次循环从某个输出的控制状态中取出的工作
+     */
+    struct OutputWork
+    {
+        Output* output = nullptr;
+        /// @brief 单步帧
+        std::optional<AVFrameView> step_frame;
+        /// @brief 待应用的窗口尺寸
+        std::optional<DaneJoe::Size<int>> window_size;
+        /// @brief 是否暂停
+        bool is_paused = false;
+    };
+    /**
+     * @struct Work
+     * @brief 一次循环从控制状态中取出的工作
+     */
+    struct Work
+    {
+        /// @brief 待初始化的输出
+        std::vector<std::shared_ptr<Output>> added;
+        /// @brief 待释放的输出
+        std::vector<std::shared_ptr<Output>> removed;
+        /// @brief 已初始化输出的控制
+        std::vector<OutputWork> outputs;
+    };
+private:
+    /**
+     * @brief 呈现线程
+     */
+    void run();
+    /**
+     * @brief 等待并取出控制状态中的工作
+     * @return 是否继续运行
+     */
+    bool take_work(Work& work);
+    /**
+     * @brief 在呈现线程上关联窗口、创建渲染器与呈现调度器
+     */
+    bool init_output(Output& output);
+    /**
+     * @brief 在呈现线程上释放输出的渲染器并通知等待的 remove_output
+     */
+    void release_output(Output& output);
+    /**
+     * @brief 为下一次刷新给所有未暂停的输出选帧，等到刷新时刻依次绘制并记录
+     */
+    void present_next_frame(const std::vector<OutputWork>& outputs);
+private:
+    /// @brief 显示刷新时钟（仅呈现线程访问，第一个输出的渲染器创建后按显示器刷新率建立）
+    std::unique_ptr<RefreshClock> m_refresh_clock;
+    /// @brief 等待刷新时刻的精确定时器（仅呈现线程访问，最后 100us 自旋）
+    DaneJoe::PreciseTimer m_present_timer{ DaneJoe::PreciseTimer::Options{ .spin = std::chrono::microseconds(100) } };
+    /// @brief 已初始化的输出（仅呈现线程访问）
+    std::vector<std::shared_ptr<Output>> m_outputs;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    /// @brief 通知 remove_output 渲染器已释放
+    std::condition_variable m_released_condition;
+    /// @brief 所有输出（按标识索引）
+    std::map<OutputId, std::shared_ptr<Output>> m_output_map;
+    /// @brief 待呈现线程初始化的输出
+    std::vector<std::shared_ptr<Output>> m_added_outputs;
+    /// @brief 下一个输出标识
+    OutputId m_next_id = 1;
+    /// @brief 是否已请求停止
+    bool m_is_closed = false;
+    /// @brief 呈现线程是否已退出（之后添加的输出不再有线程释放）
+    bool m_is_stopped = false;
+    /// @brief 是否收到 SDL 退出事件
+    bool m_is_exit = false;
+    std::jthread m_thread;
+};
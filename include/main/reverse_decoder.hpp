@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "codec/av_error.hpp"
+#include "codec/av_frame_view.hpp"
+#include "main/frame_queue.hpp"
+#include "main/media_decoder.hpp"
+#include "main/playback_rate.hpp"
+
+/**
+ * @class ReverseDecoder
+ * @brief 倒放解码
+ * @details 解码器只能向前解码，倒放按段进行：定位到段结束时间之前最近的关键帧，向前解码到段结束时间，
+ *          把这一段的帧逆序推入帧队列；下一段的结束时间就是本段关键帧的时间。
+ *          推送当前段的同时在另一个线程上解码前一段，两者重叠。
+ *          每段最多缓存 max_segment_frames 帧：GOP 更长时只保留靠后的帧，较早的部分作为新的一段从同一关键帧重新解码，
+ *          内存上限约为两段（正在推送的与正在预取的）加帧队列。
+ *          输出帧映射到以微秒为单位、从起点向前递增的时间轴（起点时间 - 帧结束时间），可直接交给正向的呈现时钟。
+ */
+class ReverseDecoder
+{
+public:
+    /**
+     * @struct Options
+     * @brief 倒放参数
+     */
+    struct Options
+    {
+        /// @brief 每段最多缓存的帧数
+        std::size_t max_segment_frames = 64;
+        /// @brief 是否在推送当前段时预取前一段
+        bool is_prefetch = true;
+        /// @brief 解码器参数
+        MediaDecoder::Options decoder_options;
+        /// @brief 变速播放控制（用于限制超前量，为空时不限制）
+        std::shared_ptr<PlaybackRateControl> rate_control;
+    };
+    /**
+     * @struct Stats
+     * @brief 运行统计
+     */
+    struct Stats
+    {
+        /// @brief 解码的段数
+        std::size_t segments = 0;
+        /// @brief 解码出的帧数（含段外被丢弃与超出缓存被重新解码的帧）
+        std::size_t decoded_frames = 0;
+        /// @brief 推入队列的帧数
+        std::size_t emitted_frames = 0;
+        /// @brief 解码耗时（毫秒）
+        double decode_ms = 0.;
+        /// @brief 推送线程等待预取结果的耗时（毫秒）
+        double prefetch_wait_ms = 0.;
+    };
+public:
+    /**
+     * @brief 构造函数
+     * @param file_path 文件路径
+     * @param options 倒放参数
+     */
+    ReverseDecoder(std::string file_path, const Options& options);
+    /**
+     * @brief 从指定位置倒放到文件开头，直到播放完毕或队列关闭
+     * @param frame_queue 帧队列
+     * @param start_ms 起点（毫秒，负数表示文件结尾）
+     */
+    AVError run(std::weak_ptr<FrameQueue> frame_queue, int64_t start_ms = -1);
+    /**
+     * @brief 本次运行的统计
+     */
+    const Stats& get_stats()const;
+private:
+    /**
+     * @struct Segment
+     * @brief 一段已解码的帧
+     */
+    struct Segment
+    {
+        /// @brief 段内的帧，按时间升序
+        std::vector<AVFrameView> frames;
+        /// @brief 各帧相对流起点的时间（微秒）
+        std::vector<int64_t> times_us;
+        /// @brief 段起点，即下一段的结束时间（微秒）
+        int64_t begin_us = 0;
+        /// @brief 是否已到达文件开头
+        bool is_start = false;
+        /// @brief 解码出的帧数
+        std::size_t decoded_frames = 0;
+        /// @brief 解码耗时（毫秒）
+        double decode_ms = 0.;
+        AVError error;
+    };
+    /**
+     * @brief 解码结束时间之前的一段
+     * @param end_us 段结束时间（微秒，不含）
+     */
+    Segment decode_segment(int64_t end_us);
+    /**
+     * @brief 帧相对流起点的时间（微秒），无时间戳时为空
+     */
+    std::optional<int64_t> frame_time_us(const AVFrameView& frame_view);
+private:
+    std::string m_file_path;
+    Options m_options;
+    MediaDecoder m_decoder;
+    /// @brief 帧时长未知时使用的时长（微秒）
+    int64_t m_fallback_duration_us = 40000;
+    Stats m_stats;
+};
+
+/**
+ * @brief 倒放基准
+ * @details 对第一个输入文件分别在不预取与预取两种方式下完整倒放（不显示、不限速），
+ *          输出倒放帧率相对源帧率的倍数（不小于 1 即可流畅 1x 倒放）与解码放大倍数
+ * @param inputs 文件或目录
+ * @param max_segment_frames 每段最多缓存的帧数
+ * @return 进程退出码
+ */
+int run_reverse_benchmark(const std::vector<std::string>& inputs, std::size_t max_segment_frames);
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct StartupBenchmarkOptions
+ * @brief 首帧耗时基准参数
+ */
+struct StartupBenchmarkOptions
+{
+    /// @brief 每个文件每种配置的测量次数
+    int rounds = 5;
+    /// @brief 调优配置的格式探测字节数
+    int64_t probe_size = 65536;
+    /// @brief 调优配置的流信息分析时长（微秒）
+    int64_t analyze_duration_us = 100000;
+    /// @brief 是否创建 SDL 窗口并计到第一次 SDL_RenderPresent，否则计到第一帧解码完成
+    bool is_present = false;
+};
+
+/**
+ * @brief 首帧耗时基准
+ * @details 依次以默认探测、缩小探测范围、流信息缓存未命中、流信息缓存命中四种配置打开每个文件，
+ *          从 open 调用开始计时到第一帧提交显示（或解码完成），输出各阶段耗时的中位数。
+ *          基准使用独立的缓存文件，不影响播放时的缓存。
+ * @param inputs 文件或目录
+ * @param options 基准参数
+ * @return 进程退出码
+ */
+int run_startup_benchmark(const std::vector<std::string>& inputs, const StartupBenchmarkOptions& options);
+
+/**
+ * @brief 解码器打开耗时基准
+ * @details 针对大量短文件，分别以每次新建解码器上下文和从上下文池复用两种方式反复打开每个文件并解码第一帧，
+ *          输出打开总耗时、其中解码器打开部分与首帧耗时的中位数，以及池的命中率。
+ * @param inputs 文件或目录
+ * @param rounds 轮数
+ * @param thread_count 解码线程数（0 表示由 FFmpeg 自动决定）
+ * @return 进程退出码
+ */
+int run_open_benchmark(const std::vector<std::string>& inputs, int rounds, int thread_count);
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C"
+{
+#include <libavformat/avformat.h>
+}
+
+/**
+ * @class StreamInfoCache
+ * @brief 流信息持久化缓存
+ * @details avformat_find_stream_info 需要读取并试解码若干数据包，是打开文件时最慢的一步。
+ *          首次完整探测后按“规范路径 + 文件大小 + 修改时间”记录视频流的解码参数并写入磁盘，
+ *          再次打开同一文件时读完容器头即可直接填回，跳过探测。
+ *          文件被修改或容器头与记录不一致时视为未命中，回退到完整探测。
+ *          缓存文件默认位于用户缓存目录（$XDG_CACHE_HOME 或 $HOME/.cache 下的 danejoe/stream_info.cache），
+ *          与工作目录无关；两者都不可用时只在内存中缓存。
+ *          store 只更新内存并标记待写盘，由后台线程延迟合并后整体写盘，析构时写入剩余的记录。
+ */
+class StreamInfoCache
+{
+public:
+    /**
+     * @struct StreamEntry
+     * @brief 单个视频流的探测结果
+     */
+    struct StreamEntry
+    {
+        /// @brief 流下标
+        int index = -1;
+        /// @brief 编码类型
+        int codec_id = 0;
+        /// @brief 编码标签
+        uint32_t codec_tag = 0;
+        /// @brief 像素格式
+        int format = -1;
+        /// @brief 宽
+        int width = 0;
+        /// @brief 高
+        int height = 0;
+        /// @brief 编码档次
+        int profile = 0;
+        /// @brief 编码级别
+        int level = 0;
+        /// @brief 像素宽高比
+        AVRational sample_aspect_ratio = { 0, 1 };
+        /// @brief 码率
+        int64_t bit_rate = 0;
+        /// @brief 解码延迟帧数
+        int video_delay = 0;
+        /// @brief 场序
+        int field_order = 0;
+        /// @brief 色彩范围
+        int color_range = 0;
+        /// @brief 色彩原色
+        int color_primaries = 0;
+        /// @brief 传输特性
+        int color_trc = 0;
+        /// @brief 色彩空间
+        int color_space = 0;
+        /// @brief 色度位置
+        int chroma_location = 0;
+        /// @brief 流时间基（只用于校验）
+        AVRational time_base = { 0, 1 };
+        /// @brief 平均帧率
+        AVRational avg_frame_rate = { 0, 1 };
+        /// @brief 基础帧率
+        AVRational r_frame_rate = { 0, 1 };
+        /// @brief 起始时间（流时间基）
+        int64_t start_time = AV_NOPTS_VALUE;
+        /// @brief 时长（流时间基）
+        int64_t duration = AV_NOPTS_VALUE;
+        /// @brief 帧数
+        int64_t nb_frames = 0;
+        /// @brief 编码器附加数据
+        std::vector<uint8_t> extradata;
+    };
+    /**
+     * @struct Entry
+     * @brief 单个文件的探测结果
+     */
+    struct Entry
+    {
+        /// @brief 文件大小
+        int64_t file_size = 0;
+        /// @brief 修改时间（纳秒）
+        int64_t modify_time_ns = 0;
+        /// @brief 容器流数量
+        unsigned int stream_count = 0;
+        /// @brief 容器起始时间（AV_TIME_BASE）
+        int64_t start_time = AV_NOPTS_VALUE;
+        /// @brief 容器时长（AV_TIME_BASE）
+        int64_t duration = AV_NOPTS_VALUE;
+        /// @brief 容器码率
+        int64_t bit_rate = 0;
+        /// @brief 视频流
+        std::vector<StreamEntry> streams;
+        /// @brief 最近使用序号，用于淘汰
+        uint64_t last_used = 0;
+    };
+    /**
+     * @struct Stats
+     * @brief 命中统计
+     */
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        /// @brief 文件已修改或容器头不一致而作废的次数
+        uint64_t invalidations = 0;
+        uint64_t stores = 0;
+    };
+public:
+    /**
+     * @brief 获取全局实例
+     */
+    static StreamInfoCache& get_instance();
+    /**
+     * @brief 设置缓存文件路径（会丢弃已加载的内容，为空时只在内存中缓存）
+     */
+    void set_path(const std::string& path);
+    /**
+     * @brief 缓存文件路径
+     */
+    std::string path();
+    /**
+     * @brief 查找文件的缓存并填回格式上下文
+     * @param file_path 文件路径
+     * @param format_context 已读完容器头、尚未探测的格式上下文
+     * @return 是否命中且已填回
+     */
+    bool apply(const std::string& file_path, AVFormatContext* format_context);
+    /**
+     * @brief 记录完整探测后的流信息（延迟写盘）
+     * @param file_path 文件路径
+     * @param format_context 已完成 avformat_find_stream_info 的格式上下文
+     */
+    void store(const std::string& file_path, const AVFormatContext* format_context);
+    /**
+     * @brief 清空缓存并删除缓存文件
+     */
+    void clear();
+    /**
+     * @brief 立即写入尚未落盘的记录（先写唯一命名的临时文件再改名）
+     */
+    void flush();
+    /**
+     * @brief 命中统计
+     */
+    Stats get_stats();
+private:
+    StreamInfoCache();
+    /**
+     * @brief 析构函数：停止后台写盘线程并写入剩余的记录
+     */
+    ~StreamInfoCache();
+    /**
+     * @brief 首次使用时从磁盘加载
+     */
+    void ensure_loaded();
+    /**
+     * @brief 后台写盘线程：有待写盘的记录时等待一段时间再合并写盘
+     */
+    void run_saver();
+private:
+    /// @brief 串行化写盘，保证 clear 与 set_path 之后不会有旧的写盘完成
+    std::mutex m_save_mutex;
+    /// @brief 保护以下成员
+    std::mutex m_mutex;
+    /// @brief 缓存文件路径（为空时不读写磁盘）
+    std::string m_path;
+    /// @brief 规范路径到探测结果
+    std::map<std::string, Entry> m_entries;
+    /// @brief 是否已加载
+    bool m_is_loaded = false;
+    /// @brief 使用序号
+    uint64_t m_sequence = 0;
+    /// @brief 命中统计
+    Stats m_stats;
+    /// @brief 是否有尚未落盘的记录
+    bool m_is_dirty = false;
+    /// @brief 是否正在析构
+    bool m_is_stopping = false;
+    /// @brief 通知后台写盘线程
+    std::condition_variable m_save_condition;
+    /// @brief 后台写盘线程（首次 store 时启动）
+    std::jthread m_saver;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "codec/av_error.hpp"
+#include "util/util_task_scheduler.hpp"
+
+/**
+ * @class ThumbnailExtractor
+ * @brief 批量生成预览条
+ * @details 每个文件由一个任务完成：以 AVDISCARD_NONKEY 打开 MediaDecoder，
+ *          在均匀分布的采样点之间 seek，只解码采样点前最近的关键帧，
+ *          先用 SIMD 做 2x2 均值逐级缩小，再由 swscale 缩放到最终尺寸；
+ *          拼接与 JPEG 编码作为高优先级任务提交给调度器，不阻塞下一个文件的解码。
+ */
+class ThumbnailExtractor
+{
+public:
+    /**
+     * @struct Options
+     * @brief 生成参数
+     */
+    struct Options
+    {
+        /// @brief 每个文件的采样点数量
+        int sample_count = 8;
+        /// @brief 单张缩略图宽度（像素）
+        int thumbnail_width = 160;
+        /// @brief 输出目录
+        std::string output_directory = ".";
+    };
+    /**
+     * @struct Result
+     * @brief 单个文件的处理结果
+     */
+    struct Result
+    {
+        /// @brief 输入文件
+        std::string file_path;
+        /// @brief 输出的预览条文件
+        std::string output_path;
+        /// @brief 错误
+        AVError error;
+        /// @brief 成功生成的缩略图数量
+        int thumbnails = 0;
+        /// @brief 从输入读取的字节数
+        int64_t bytes_read = 0;
+        /// @brief 输入文件大小
+        int64_t file_size = 0;
+    };
+public:
+    /**
+     * @brief 构造函数
+     * @param scheduler 任务调度器
+     * @param options 生成参数
+     */
+    ThumbnailExtractor(DaneJoe::TaskScheduler& scheduler, const Options& options);
+    /**
+     * @brief 处理一组文件并等待全部完成
+     * @return 与输入顺序一致的处理结果
+     */
+    std::vector<Result> run(const std::vector<std::string>& file_paths);
+private:
+    /// @brief 任务调度器
+    DaneJoe::TaskScheduler& m_scheduler;
+    /// @brief 生成参数
+    Options m_options;
+};
+
+/**
+ * @brief 无界面批量生成预览条，输出 files/s 与每张缩略图读取的字节数
+ * @param inputs 文件或目录
+ * @param options 生成参数
+ * @param worker_count 工作线程数（0 表示使用硬件并发数）
+ * @return 进程退出码
+ */
+int run_thumbnail_batch(const std::vector<std::string>& inputs, const ThumbnailExtractor::Options& options, std::size_t worker_count);
@@ -0,0 +1,13 @@
+#pragma once
+
+/**
+ * @brief 定时器唤醒精度基准
+ * @details 以固定周期的绝对截止时间连续等待 count 次，分别测量原先循环 sleep_for(1ms) 的等待方式
+ *          与 PreciseTimer 各后端（是否自旋）的唤醒误差分位数（p50/p90/p99/p99.9/最大值），
+ *          以及线程 CPU 占用与每次等待的主动上下文切换次数（唤醒次数）。
+ * @param count 每种方式的等待次数
+ * @param period_us 等待周期（微秒）
+ * @param spin_us 自旋方式的自旋时长（微秒）
+ * @return 进程退出码
+ */
+int run_timer_benchmark(int count, int period_us, int spin_us);
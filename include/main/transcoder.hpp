@@ -0,0 +1,245 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+#include "codec/av_error.hpp"
+#include "codec/av_codec_context_ptr.hpp"
+#include "codec/av_frame_ptr.hpp"
+#include "codec/av_packet_ptr.hpp"
+#include "main/media_decoder.hpp"
+#include "util/util_bounded_queue.hpp"
+
+/**
+ * @class Transcoder
+ * @brief 导出片段：解封装/解码 -> （滤镜）-> 编码 -> 封装 的流水线
+ * @details 每个阶段运行在自己的线程上，阶段之间是有界队列，帧与数据包只移交缓冲引用。
+ *          解封装与解码复用 MediaDecoder（内部逐包读取并解码），滤镜复用 AVVideoFilter。
+ *          编码阶段由多个编码线程组成：帧按 segment_frames 切成段，各段轮流交给编码线程，
+ *          每段用独立的编码器从关键帧开始编码（编码器自身也按 encoder_threads 多线程），
+ *          封装线程按段的顺序写出数据包，输出与串行编码一样按时间顺序排列。
+ *          并行编码需要同时缓存约 encoder_workers 段原始帧，内存上限约为 encoder_workers × segment_frames 帧。
+ */
+class Transcoder
+{
+public:
+    /**
+     * @struct Options
+     * @brief 导出参数
+     */
+    struct Options
+    {
+        /// @brief 编码器名称（mpeg4、ffv1 等 FFmpeg 内置编码器）
+        std::string codec_name = "mpeg4";
+        /// @brief 滤镜描述（为空时不过滤；编码器不支持解码输出的像素格式时自动追加格式转换）
+        std::string filter_description;
+        /// @brief 片段起点（毫秒，相对流起点）
+        int64_t start_ms = 0;
+        /// @brief 片段时长（毫秒，0 表示到文件结尾）
+        int64_t duration_ms = 0;
+        /// @brief 目标码率（bit/s，无损编码器忽略）
+        int64_t bit_rate = 8000000;
+        /// @brief 并行编码线程数
+        std::size_t encoder_workers = 2;
+        /// @brief 每个编码器内部的线程数（0 表示由 FFmpeg 自动决定）
+        int encoder_threads = 0;
+        /// @brief 并行编码时每段的帧数（每段以关键帧开始）
+        std::size_t segment_frames = 48;
+        /// @brief 解码、滤镜阶段之间的队列容量（帧）
+        std::size_t queue_capacity = 8;
+        /// @brief 解码器参数
+        MediaDecoder::Options decoder_options;
+    };
+    /**
+     * @struct StageStats
+     * @brief 阶段统计
+     */
+    struct StageStats
+    {
+        /// @brief 阶段名称
+        std::string name;
+        /// @brief 线程数
+        std::size_t lanes = 1;
+        /// @brief 各线程实际工作（不含队列等待）的累计耗时（毫秒）
+        double busy_ms = 0.;
+        /**
+         * @brief 利用率：工作耗时 / (总耗时 × 线程数)
+         */
+        double utilization(double wall_ms)const;
+    };
+    /**
+     * @struct Report
+     * @brief 导出报告
+     */
+    struct Report
+    {
+        /// @brief 编码的帧数
+        uint64_t frames = 0;
+        /// @brief 写出的数据包数
+        uint64_t packets = 0;
+        /// @brief 写出的数据包字节数
+        int64_t output_bytes = 0;
+        /// @brief 编码的段数
+        uint64_t segments = 0;
+        /// @brief 端到端耗时（毫秒，从打开输入到写完文件尾）
+        double wall_ms = 0.;
+        /// @brief 各阶段统计
+        std::vector<StageStats> stages;
+        /**
+         * @brief 端到端帧率
+         */
+        double fps()const;
+    };
+public:
+    /**
+     * @brief 构造函数
+     * @param input_path 输入文件
+     * @param output_path 输出文件（按扩展名选择封装格式）
+     * @param options 导出参数
+     */
+    Transcoder(std::string input_path, std::string output_path, const Options& options);
+    ~Transcoder();
+    Transcoder(const Transcoder&) = delete;
+    Transcoder& operator=(const Transcoder&) = delete;
+    /**
+     * @brief 执行导出，直到片段结束或出错
+     */
+    AVError run();
+    /**
+     * @brief 导出报告
+     */
+    const Report& get_report()const;
+private:
+    /**
+     * @struct EncodeItem
+     * @brief 交给编码线程的一项：一帧，或一段的结束标记
+     */
+    struct EncodeItem
+    {
+        AVFramePtr frame;
+        /// @brief 所属段
+        int64_t segment = 0;
+        /// @brief 是否为段结束标记
+        bool is_segment_end = false;
+    };
+    /**
+     * @struct SegmentOutput
+     * @brief 一段已编码、尚未写出的数据包
+     */
+    struct SegmentOutput
+    {
+        std::deque<AVPacketPtr> packets;
+        bool is_complete = false;
+    };
+    /**
+     * @brief 打开输入、确定编码时间基与滤镜、创建输出文件
+     */
+    AVError prepare();
+    /**
+     * @brief 解码阶段：定位到片段起点，解码到片段结束
+     */
+    AVError decode_stage();
+    /**
+     * @brief 滤镜阶段
+     */
+    AVError filter_stage();
+    /**
+     * @brief 把一帧分配给编码线程（由最后一个上游阶段调用）
+     * @return 流水线已中止时为 false
+     */
+    bool dispatch(AVFramePtr&& frame);
+    /**
+     * @brief 上游结束：发出最后一段的结束标记并结束各编码队列
+     */
+    void finish_dispatch();
+    /**
+     * @brief 编码线程
+     * @param worker 编码线程下标
+     */
+    AVError encode_stage(std::size_t worker);
+    /**
+     * @brief 为一段打开编码器
+     * @param first_frame 段的第一帧（决定尺寸与像素格式）
+     * @param segment 段下标
+     */
+    AVError open_encoder(AVCodecContextPtr& encoder, const AVFramePtr& first_frame, int64_t segment);
+    /**
+     * @brief 取出编码器的全部输出交给封装阶段
+     */
+    AVError drain_encoder(AVCodecContextPtr& encoder, int64_t segment);
+    /**
+     * @brief 封装阶段：写文件头，按段顺序写出数据包，写文件尾
+     */
+    AVError mux_stage();
+    /**
+     * @brief 记录第一个错误并中止全部阶段
+     */
+    void abort(AVError error);
+    /**
+     * @brief 累加阶段耗时
+     */
+    void add_busy(std::size_t stage, std::chrono::steady_clock::duration duration);
+private:
+    std::string m_input_path;
+    std::string m_output_path;
+    Options m_options;
+    Report m_report;
+    MediaDecoder m_decoder;
+    const AVCodec* m_codec = nullptr;
+    /// @brief 实际使用的滤镜描述（为空表示没有滤镜阶段）
+    std::string m_filter_description;
+    /// @brief 编码器时间基（帧率的倒数）
+    AVRational m_encoder_time_base = { 1, 25 };
+    /// @brief 编码器帧率
+    AVRational m_frame_rate = { 25, 1 };
+    /// @brief 输出封装上下文
+    AVFormatContext* m_output = nullptr;
+    /// @brief 解码到滤镜的队列
+    std::unique_ptr<DaneJoe::BoundedQueue<AVFramePtr>> m_decoded_queue;
+    /// @brief 各编码线程的输入队列
+    std::vector<std::unique_ptr<DaneJoe::BoundedQueue<EncodeItem>>> m_encode_queues;
+    /// @brief 已分配的帧数（只由最后一个上游阶段访问）
+    uint64_t m_dispatched_frames = 0;
+    /// @brief 上一个分配的帧的编码时间戳（只由最后一个上游阶段访问）
+    int64_t m_last_encoder_pts = AV_NOPTS_VALUE;
+    /// @brief 第一帧的编码时间戳，输出时间轴从 0 开始（只由最后一个上游阶段访问）
+    int64_t m_first_encoder_pts = AV_NOPTS_VALUE;
+    /// @brief 保护以下封装阶段共享状态与错误码
+    std::mutex m_mutex;
+    std::condition_variable m_mux_condition;
+    /// @brief 各段的输出
+    std::map<int64_t, SegmentOutput> m_segments;
+    /// @brief 第一段编码器的参数，封装阶段据此写文件头
+    AVCodecParameters* m_stream_parameters = nullptr;
+    /// @brief 总段数（上游结束前为 -1）
+    int64_t m_segment_count = -1;
+    bool m_is_aborted = false;
+    AVError m_error;
+    /// @brief 各阶段工作耗时（解码、滤镜、编码、封装）
+    std::array<std::chrono::steady_clock::duration, 4> m_busy = {};
+};
+
+/**
+ * @brief 导出模式
+ * @details 导出第一个输入文件的片段并输出端到端帧率与各阶段利用率
+ * @param inputs 文件或目录
+ * @param output_path 输出文件
+ * @param options 导出参数
+ * @return 进程退出码
+ */
+int run_transcode(const std::vector<std::string>& inputs, const std::string& output_path, const Transcoder::Options& options);
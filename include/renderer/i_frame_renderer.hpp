@@ -1,16 +1,14 @@
 #pragma once
 
-#include <queue>
 #include <memory>
 #include <cstdint>
-#include <vector>
 #include <mutex>
-#include <atomic>
 #include <string>
 
 #include "util/util_vector_2d.hpp"
+#include "util/util_triple_buffer.hpp"
 #include "logger/logger_manager.hpp"
-#include "codec/av_frame_ptr.hpp"
+#include "codec/av_frame_view.hpp"
 
 /**
  * @class IFrameRenderer
@@ -31,27 +29,24 @@ public:
         YUV420P,
     };
     /**
-     * @struct Frame
-     * @brief 帧结构体
+     * @struct RenderConfig
+     * @brief 渲染配置快照
+     * @details 由写端整体发布的不可变配置，绘制路径通过 version 判断是否需要重建GPU状态
      */
-    struct Frame
+    struct RenderConfig
     {
-        /// @brief 是否有效
-        bool is_valid;
+        /// @brief 配置版本，每次发布递增
+        uint64_t version = 0;
+        /// @brief 窗口尺寸
+        DaneJoe::Size<int> window_size = { 0,0 };
+        /// @brief 视口位置
+        DaneJoe::Pos<int> viewport_pos = { 0,0 };
+        /// @brief 视口尺寸
+        DaneJoe::Size<int> viewport_size = { 0,0 };
+        /// @brief 是否指定了帧格式
+        bool has_fmt = false;
         /// @brief 帧格式
-        FrameFmt fmt;
-        /// @brief 帧数据
-        std::vector<uint8_t> data;
-        /// @brief 帧大小
-        DaneJoe::Size<int> size;
-        /// @brief 帧行像素字节数
-        int pitch;
-        /// @brief 像素字节数
-        int pixel_size;
-        /**
-         * @brief 初始化pitch等帧信息
-         */
-        void init_info();
+        FrameFmt fmt = FrameFmt::YUV420P;
     };
 public:
     IFrameRenderer();
@@ -69,10 +64,9 @@ public:
     virtual bool is_exit() = 0;
     /**
      * @brief 绘制
-     * @param frame 帧数据
+     * @param frame 帧视图（借用解码缓冲，不发生拷贝）
      */
-    virtual bool draw(std::shared_ptr<Frame> frame) = 0;
-    virtual bool draw(AVFramePtr frame) = 0;
+    virtual bool draw(const AVFrameView& frame) = 0;
     /**
      * @brief 设置窗口
      * @param window_name 窗口名
@@ -85,25 +79,59 @@ public:
      * @param window_size 窗口大小
      */
     virtual bool update_window_size(DaneJoe::Size<int> window_size) = 0;
+    /**
+     * @brief 窗口所在显示器的刷新率
+     * @return 刷新率（Hz），未知时为 0
+     */
+    virtual double refresh_rate();
+    /**
+     * @brief 呈现是否与垂直同步对齐（呈现阻塞到下一次刷新）
+     */
+    virtual bool is_vsync();
     /**
      * @brief 析构函数
      */
     virtual ~IFrameRenderer();
     /**
-     * @brief 设置窗口尺寸
+     * @brief 设置窗口尺寸（视口同步为整个窗口）
      * @param size 窗口尺寸
      */
     bool set_window_size(const DaneJoe::Size<int>& size);
+    /**
+     * @brief 获取最近一次发布的配置（写端视角）
+     */
+    RenderConfig get_config();
+
+protected:
+    /**
+     * @brief 修改并发布配置
+     * @param modify 在待发布配置上执行的修改
+     * @note 写端之间互斥，不阻塞绘制路径
+     */
+    template<typename Modify>
+    void publish_config(Modify&& modify)
+    {
+        std::lock_guard<std::mutex> lock(m_config_write_mutex);
+        modify(m_pending_config);
+        m_pending_config.version++;
+        m_config.publish(m_pending_config);
+    }
+    /**
+     * @brief 取得最新配置（绘制路径，无等待）
+     * @return 当前配置快照
+     */
+    const RenderConfig& acquire_config();
 
 protected:
     const int BASE_ERROR_CODE_QUANTITY = 2;
 protected:
-    /// @brief 窗口尺寸
-    DaneJoe::Size<int> m_window_size = { 0,0 };
     /// @brief 窗口名称
     std::string m_window_name;
-    /// @brief 窗口尺寸互斥锁
-    std::mutex m_window_size_mutex;
-    /// @brief 帧绘制互斥锁
-    std::mutex m_draw_mutex;
+private:
+    /// @brief 配置三缓冲
+    DaneJoe::TripleBuffer<RenderConfig> m_config;
+    /// @brief 写端待发布配置
+    RenderConfig m_pending_config;
+    /// @brief 写端互斥锁
+    std::mutex m_config_write_mutex;
 };
\ No newline at end of file
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+#include <SDL2/SDL.h>
+
+#include "renderer/sdl_frame_renderer.hpp"
+#include "codec/av_frame_view.hpp"
+#include "util/util_vector_2d.hpp"
+
+/**
+ * @class SDLCompositorRenderer
+ * @brief 多路流合成渲染器
+ * @details 所有流共用一个SDL窗口与渲染器：各路帧按网格打包进一张图集纹理的不同分块，
+ *          只对有新帧的分块做局部纹理更新，每次刷新只调用一次 SDL_RenderPresent。
+ *          图集超过显卡最大纹理尺寸时退化为每个分块一张纹理，但仍只提交一次。
+ *          submit 只在锁内替换分块的待显示帧；present 在锁内取走所有待显示帧，纹理上传与提交都在锁外进行。
+ * @note 除 submit 外的所有接口都应在渲染线程中调用。
+ */
+class SDLCompositorRenderer
+{
+public:
+    /**
+     * @struct Stats
+     * @brief 合成统计
+     */
+    struct Stats
+    {
+        /// @brief 提交（present）次数
+        uint64_t presents = 0;
+        /// @brief 分块上传次数
+        uint64_t tile_uploads = 0;
+        /// @brief 被新帧覆盖而未显示的帧数
+        uint64_t dropped_frames = 0;
+        /// @brief 图集重建次数
+        uint64_t atlas_rebuilds = 0;
+    };
+public:
+    SDLCompositorRenderer();
+    ~SDLCompositorRenderer();
+    /**
+     * @brief 设置窗口
+     * @param window_name 窗口名称
+     * @param window_size 窗口大小
+     * @param window 原生窗口句柄（为空时创建新窗口）
+     */
+    bool set_window(std::string window_name, DaneJoe::Size<int> window_size, void* window);
+    /**
+     * @brief 初始化渲染器
+     * @param tile_count 分块数量
+     * @param is_vsync 是否按垂直同步提交（默认关闭：在 GUI 线程上提交时 vsync 会让 present 阻塞事件循环到下一次刷新）
+     */
+    bool init(std::size_t tile_count, bool is_vsync = false);
+    /**
+     * @brief 更新窗口大小
+     */
+    bool update_window_size(DaneJoe::Size<int> window_size);
+    /**
+     * @brief 提交某个分块的新帧（覆盖尚未显示的旧帧）
+     * @param tile_index 分块下标
+     * @param frame 帧视图
+     */
+    bool submit(std::size_t tile_index, AVFrameView&& frame);
+    /**
+     * @brief 上传有新帧的分块并提交一次画面
+     */
+    bool present();
+    /**
+     * @brief 分块数量
+     */
+    std::size_t tile_count()const;
+    /**
+     * @brief 获取统计信息
+     */
+    Stats get_stats()const;
+private:
+    /**
+     * @struct Tile
+     * @brief 分块状态（仅渲染线程访问）
+     */
+    struct Tile
+    {
+        /// @brief 最近取走的一帧（保留以便图集重建后重新上传）
+        AVFrameView frame;
+        /// @brief 是否有尚未上传的新帧
+        bool is_dirty = false;
+        /// @brief 独立纹理（仅在图集不可用时使用）
+        SDL_texture_ptr texture = nullptr;
+        /// @brief 独立纹理尺寸
+        DaneJoe::Size<int> texture_size = { 0,0 };
+    };
+private:
+    /**
+     * @brief 确保图集能容纳所有分块当前帧，必要时重建
+     */
+    bool ensure_atlas();
+    /**
+     * @brief 上传一个分块
+     */
+    bool upload_tile(std::size_t tile_index);
+    /**
+     * @brief 分块在图集中的区域
+     */
+    SDL_Rect atlas_rect(std::size_t tile_index, DaneJoe::Size<int> frame_size)const;
+    /**
+     * @brief 分块在窗口中的区域
+     */
+    SDL_Rect window_rect(std::size_t tile_index)const;
+private:
+    /// @brief SDL视频系统
+    SDLVideoSystem m_video_system;
+    /// @brief SDL窗口
+    SDL_window_ptr m_window = nullptr;
+    /// @brief SDL渲染器
+    SDL_renderer_ptr m_renderer = nullptr;
+    /// @brief 图集纹理
+    SDL_texture_ptr m_atlas = nullptr;
+    /// @brief 是否使用图集（否则每个分块独立纹理）
+    bool m_is_atlas_mode = true;
+    /// @brief 图集中单个分块的尺寸
+    DaneJoe::Size<int> m_tile_size = { 0,0 };
+    /// @brief 显卡支持的最大纹理尺寸
+    DaneJoe::Size<int> m_max_texture_size = { 0,0 };
+    /// @brief 网格列数
+    int m_columns = 1;
+    /// @brief 网格行数
+    int m_rows = 1;
+    /// @brief 窗口尺寸
+    DaneJoe::Size<int> m_window_size = { 0,0 };
+    /// @brief 所有分块（仅渲染线程访问）
+    std::vector<Tile> m_tiles;
+    /// @brief present 取走的待显示帧（仅渲染线程访问，与 m_pending_frames 交换以复用存储）
+    std::vector<std::optional<AVFrameView>> m_taken_frames;
+    /// @brief 渲染线程的统计（present 结束时发布到 m_stats）
+    Stats m_render_stats;
+    /// @brief 待显示帧与统计的保护锁（submit 可能来自其他线程）
+    mutable std::mutex m_tile_mutex;
+    /// @brief 各分块最近提交、尚未被 present 取走的帧
+    std::vector<std::optional<AVFrameView>> m_pending_frames;
+    /// @brief 统计信息
+    Stats m_stats;
+};
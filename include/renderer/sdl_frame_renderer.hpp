@@ -2,6 +2,7 @@
 
 #include <string>
 #include <memory>
+#include <optional>
 
 #include <SDL2/SDL.h>
 
@@ -65,7 +66,8 @@ using SDL_texture_ptr = std::unique_ptr<SDL_Texture, SDL_texture_deleter>;
 /**
  * @class SDLFrameRenderer
  * @brief SDL渲染器
- * @note 使用SDL渲染图像
+ * @note 使用SDL渲染图像；SDL 视频子系统在 set_window 时初始化，
+ *       set_window 之后的所有调用与析构都须在同一线程上（见 PresentThread）
  */
 class SDLFrameRenderer : public IFrameRenderer {
 public:
@@ -89,19 +91,9 @@ public:
     bool init() override;
     /**
      * @brief 绘制帧
-     * @param frame 帧
-     */
-    bool draw(std::shared_ptr<Frame> frame) override;
-    bool draw(AVFramePtr frame)override;
-    bool draw(
-        uint8_t* y,
-        int y_pitch,
-        uint8_t* u,
-        int u_pitch,
-        uint8_t* v,
-        int v_pitch,
-        int width,
-        int height);
+     * @param frame 帧视图
+     */
+    bool draw(const AVFrameView& frame) override;
     /**
      * @brief 设置窗口
      * @param window_name 窗口名称
@@ -120,6 +112,20 @@ public:
      * @param fmt 帧格式
      */
     void set_fmt(FrameFmt fmt) override;
+    /**
+     * @brief 窗口所在显示器的刷新率
+     * @return 刷新率（Hz），未知时为 0
+     */
+    double refresh_rate() override;
+    /**
+     * @brief 渲染器是否开启了垂直同步
+     */
+    bool is_vsync() override;
+    /**
+     * @brief 设置下一次 init 时是否请求垂直同步（默认不请求）
+     * @note 开启后 draw 阻塞到下一次刷新，多个渲染器在同一呈现线程上轮流绘制时会互相拖慢，只应用于独占呈现线程的单个窗口
+     */
+    void set_vsync(bool is_vsync);
 private:
     /**
      * @brief 帧格式转换
@@ -127,14 +133,33 @@ private:
      * @return SDL_PixelFormatEnum
      */
     SDL_PixelFormatEnum fmt_convert(FrameFmt fmt);
-    bool update_texture(std::shared_ptr<Frame> frame);
+    /**
+     * @brief FFmpeg像素格式转换
+     * @param fmt FFmpeg像素格式
+     * @return SDL_PixelFormatEnum，不支持时为 SDL_PIXELFORMAT_UNKNOWN
+     */
+    SDL_PixelFormatEnum fmt_convert(AVPixelFormat fmt);
+    /**
+     * @brief 当帧格式或尺寸与纹理不一致时重建纹理
+     * @param frame 帧视图
+     */
+    bool update_texture(const AVFrameView& frame);
+    /**
+     * @brief 将帧平面直接上传到纹理
+     * @param frame 帧视图
+     */
+    bool upload_texture(const AVFrameView& frame);
+    /**
+     * @brief 将配置快照应用到SDL窗口与渲染器
+     * @param config 配置快照
+     * @note 只在绘制线程中调用
+     */
+    void apply_config(const RenderConfig& config);
 private:
     const DaneJoe::Size<int> m_default_size = { 640, 480 };
 private:
-    /// @brief SDL视频系统
-    SDLVideoSystem m_video_system;
-    /// @brief 帧格式设置互斥锁
-    std::mutex m_set_pixel_fmt_mutex;
+    /// @brief SDL视频系统（在关联窗口的线程上初始化）
+    std::optional<SDLVideoSystem> m_video_system;
     /// @brief SDL窗口
     /// @details 此处必须初始化为nullptr
     SDL_window_ptr m_window = nullptr;
@@ -145,9 +170,16 @@ private:
     SDL_texture_ptr m_texture = nullptr;
     /// @brief SDL像素格式
     SDL_PixelFormatEnum m_pixel_format = SDL_PIXELFORMAT_UNKNOWN;
-    /// @brief SDL初始化锁
+    /// @brief SDL初始化锁（仅用于窗口与渲染器创建）
     std::mutex m_sdl_init_mutex;
-    /// @brief SDL窗口锁
-    std::mutex m_set_window_mutex;
+    /// @brief 纹理尺寸
     DaneJoe::Size<int> m_texture_size = { 0,0 };
+    /// @brief 绘制线程已应用的配置
+    RenderConfig m_applied_config;
+    /// @brief 是否已应用过配置
+    bool m_is_config_applied = false;
+    /// @brief 创建渲染器时是否请求垂直同步
+    bool m_is_request_vsync = false;
+    /// @brief 渲染器是否开启了垂直同步
+    bool m_is_vsync = false;
 };
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+/// @brief DaneJoe namespace
+namespace DaneJoe
+{
+    /**
+     * @class BoundedQueue
+     * @brief 流水线阶段之间的有界阻塞队列
+     * @details 满时 push 阻塞、空时 pop 阻塞，两端的阻塞时长分别累计，用于计算各阶段的利用率。
+     *          finish 表示生产端正常结束，消费端取完剩余元素后 pop 返回空；
+     *          close 表示异常中止，丢弃剩余元素并立即唤醒两端。
+     */
+    template<typename T>
+    class BoundedQueue
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param capacity 队列容量（至少为 1）
+         */
+        explicit BoundedQueue(std::size_t capacity) :m_capacity(capacity > 0 ? capacity : 1) {}
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+        /**
+         * @brief 推入一个元素，满时阻塞
+         * @return 队列已结束或已关闭时为 false
+         */
+        bool push(T&& value)
+        {
+            auto begin = std::chrono::steady_clock::now();
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_not_full.wait(lock, [this]() { return m_is_closed || m_is_finished || m_items.size() < m_capacity; });
+            m_push_wait += std::chrono::steady_clock::now() - begin;
+            if (m_is_closed || m_is_finished)
+            {
+                return false;
+            }
+            m_items.push_back(std::move(value));
+            m_not_empty.notify_one();
+            return true;
+        }
+        /**
+         * @brief 取出一个元素，空时阻塞
+         * @return 已结束且取完或已关闭时为空
+         */
+        std::optional<T> pop()
+        {
+            auto begin = std::chrono::steady_clock::now();
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_not_empty.wait(lock, [this]() { return m_is_closed || m_is_finished || !m_items.empty(); });
+            m_pop_wait += std::chrono::steady_clock::now() - begin;
+            if (m_is_closed || m_items.empty())
+            {
+                return std::nullopt;
+            }
+            std::optional<T> value(std::move(m_items.front()));
+            m_items.pop_front();
+            m_not_full.notify_one();
+            return value;
+        }
+        /**
+         * @brief 生产端正常结束
+         */
+        void finish()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_is_finished = true;
+            }
+            m_not_empty.notify_all();
+            m_not_full.notify_all();
+        }
+        /**
+         * @brief 中止：丢弃剩余元素并唤醒两端
+         */
+        void close()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_is_closed = true;
+                m_items.clear();
+            }
+            m_not_empty.notify_all();
+            m_not_full.notify_all();
+        }
+        /**
+         * @brief 是否已中止
+         */
+        bool is_closed()const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_is_closed;
+        }
+        /**
+         * @brief 当前元素数量
+         */
+        std::size_t size()const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_items.size();
+        }
+        /**
+         * @brief 生产端因队列满而阻塞的累计时长
+         */
+        std::chrono::steady_clock::duration push_wait()const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_push_wait;
+        }
+        /**
+         * @brief 消费端因队列空而阻塞的累计时长
+         */
+        std::chrono::steady_clock::duration pop_wait()const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_pop_wait;
+        }
+    private:
+        const std::size_t m_capacity;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_not_empty;
+        std::condition_variable m_not_full;
+        std::deque<T> m_items;
+        bool m_is_finished = false;
+        bool m_is_closed = false;
+        std::chrono::steady_clock::duration m_push_wait{};
+        std::chrono::steady_clock::duration m_pop_wait{};
+    };
+}
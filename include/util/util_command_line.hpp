@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/// @brief DaneJoe namespace
+namespace DaneJoe
+{
+    /**
+     * @class CommandLine
+     * @brief 简单命令行解析
+     * @details 形如 `--name=value` 的参数为选项，单独的 `--name` 为开关，
+     *          其余参数按顺序作为位置参数。
+     */
+    class CommandLine
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param argc 参数个数
+         * @param argv 参数列表
+         */
+        CommandLine(int argc, char* argv[]);
+        /**
+         * @brief 是否存在选项或开关
+         * @param name 选项名（不含前缀 `--`）
+         */
+        bool has(const std::string& name)const;
+        /**
+         * @brief 获取选项值
+         * @param name 选项名（不含前缀 `--`）
+         * @param default_value 缺省值
+         */
+        std::string get(const std::string& name, const std::string& default_value = "")const;
+        /**
+         * @brief 获取整数选项值，解析失败时返回缺省值
+         */
+        long long get_int(const std::string& name, long long default_value)const;
+        /**
+         * @brief 获取浮点选项值，解析失败时返回缺省值
+         */
+        double get_double(const std::string& name, double default_value)const;
+        /**
+         * @brief 位置参数
+         */
+        const std::vector<std::string>& positional()const;
+    private:
+        /// @brief 选项名
+        std::vector<std::string> m_names;
+        /// @brief 选项值（开关为空字符串）
+        std::vector<std::string> m_values;
+        /// @brief 位置参数
+        std::vector<std::string> m_positional;
+    };
+}
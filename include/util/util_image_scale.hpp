@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+/// @brief DaneJoe namespace
+namespace DaneJoe
+{
+    /**
+     * @brief 8 位单平面 2x2 均值缩小为一半
+     * @details 有 SSE2/NEON 时每次处理 16 个输出像素，其余部分走标量路径；
+     *          输出尺寸为 source_width / 2 x source_height / 2（奇数边舍去最后一行/列）。
+     * @param source 源平面
+     * @param source_stride 源行跨度（字节）
+     * @param source_width 源宽度
+     * @param source_height 源高度
+     * @param target 目标平面
+     * @param target_stride 目标行跨度（字节）
+     */
+    void halve_plane(const uint8_t* source, int source_stride, int source_width, int source_height, uint8_t* target, int target_stride);
+}
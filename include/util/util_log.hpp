@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "logger/logger_manager.hpp"
+
+/**
+ * @file util_log.hpp
+ * @brief 带编译期级别与分类的日志封装
+ * @details DANEJOE_CLOG(级别, 分类, 模块, 格式, 参数...) 转发到 DaneJoeLogger 的 "default" 日志器。
+ *          级别低于该分类编译期阈值的调用位于 if constexpr 的丢弃分支中，不生成任何代码，
+ *          参数表达式与格式化也只在启用时才求值。
+ *          阈值：DANEJOE_LOG_LEVEL 为全局阈值（0 TRACE，1 DEBUG，2 INFO，3 WARN，4 ERROR，5 FATAL，6 全部关闭），
+ *          未定义时调试构建为 0、发布构建（NDEBUG）为 2；DANEJOE_LOG_LEVEL_<分类> 可单独覆盖某个分类。
+ *          逐帧路径上的告警使用 DANEJOE_CLOG_RATE_LIMITED，在间隔内只输出一次并附带被抑制的次数。
+ */
+
+#if !defined(DANEJOE_LOG_LEVEL)
+#if defined(NDEBUG)
+#define DANEJOE_LOG_LEVEL 2
+#else
+#define DANEJOE_LOG_LEVEL 0
+#endif
+#endif
+
+#if !defined(DANEJOE_LOG_LEVEL_APP)
+#define DANEJOE_LOG_LEVEL_APP DANEJOE_LOG_LEVEL
+#endif
+#if !defined(DANEJOE_LOG_LEVEL_DECODE)
+#define DANEJOE_LOG_LEVEL_DECODE DANEJOE_LOG_LEVEL
+#endif
+#if !defined(DANEJOE_LOG_LEVEL_IO)
+#define DANEJOE_LOG_LEVEL_IO DANEJOE_LOG_LEVEL
+#endif
+#if !defined(DANEJOE_LOG_LEVEL_RENDER)
+#define DANEJOE_LOG_LEVEL_RENDER DANEJOE_LOG_LEVEL
+#endif
+#if !defined(DANEJOE_LOG_LEVEL_VIEW)
+#define DANEJOE_LOG_LEVEL_VIEW DANEJOE_LOG_LEVEL
+#endif
+
+/// @brief DaneJoe namespace
+namespace DaneJoe
+{
+    /// @brief 日志封装
+    namespace Log
+    {
+        /**
+         * @enum Level
+         * @brief 日志级别，与 DANEJOE_LOG_LEVEL 的数值一致
+         */
+        enum class Level : int
+        {
+            TRACE = 0,
+            DEBUG = 1,
+            INFO = 2,
+            WARN = 3,
+            ERROR = 4,
+            FATAL = 5,
+        };
+
+        /**
+         * @enum Category
+         * @brief 日志分类（子系统）
+         */
+        enum class Category
+        {
+            /// @brief 程序入口、基准与批处理
+            APP,
+            /// @brief 解封装、解码与帧队列
+            DECODE,
+            /// @brief 文件读取与缓存
+            IO,
+            /// @brief SDL 渲染器
+            RENDER,
+            /// @brief Qt 界面
+            VIEW,
+        };
+
+        /**
+         * @brief 分类的编译期阈值
+         */
+        constexpr int category_threshold(Category category)
+        {
+            switch (category)
+            {
+            case Category::APP: return DANEJOE_LOG_LEVEL_APP;
+            case Category::DECODE: return DANEJOE_LOG_LEVEL_DECODE;
+            case Category::IO: return DANEJOE_LOG_LEVEL_IO;
+            case Category::RENDER: return DANEJOE_LOG_LEVEL_RENDER;
+            case Category::VIEW: return DANEJOE_LOG_LEVEL_VIEW;
+            }
+            return DANEJOE_LOG_LEVEL;
+        }
+
+        /**
+         * @brief 所有分类中最低的编译期阈值
+         * @details 运行时日志器级别应取该值，否则单独调低阈值的分类编译进程序的日志会被日志器再次过滤
+         */
+        constexpr int min_threshold()
+        {
+            return std::min({ DANEJOE_LOG_LEVEL_APP, DANEJOE_LOG_LEVEL_DECODE, DANEJOE_LOG_LEVEL_IO, DANEJOE_LOG_LEVEL_RENDER, DANEJOE_LOG_LEVEL_VIEW });
+        }
+
+        /**
+         * @brief 该级别与分类的日志是否编译进程序
+         */
+        constexpr bool is_enabled(Level level, Category category)
+        {
+            return static_cast<int>(level) >= category_threshold(category);
+        }
+
+        /**
+         * @class RateLimiter
+         * @brief 单个日志点的限流器
+         * @details 每个调用点一个静态实例；间隔内的后续调用只做一次原子读和一次计数，
+         *          下次放行时带出期间被抑制的次数。
+         */
+        class RateLimiter
+        {
+        public:
+            explicit constexpr RateLimiter(int64_t interval_ms) :m_interval_ns(interval_ms * 1000000) {}
+            /**
+             * @brief 尝试放行一次输出
+             * @param suppressed 放行时输出上次放行以来被抑制的次数
+             * @return 是否应输出
+             */
+            bool try_acquire(uint64_t& suppressed)
+            {
+                int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+                int64_t next_ns = m_next_ns.load(std::memory_order_relaxed);
+                if (now_ns < next_ns || !m_next_ns.compare_exchange_strong(next_ns, now_ns + m_interval_ns, std::memory_order_relaxed))
+                {
+                    m_suppressed.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+                return true;
+            }
+        private:
+            const int64_t m_interval_ns;
+            /// @brief 下次允许输出的时间（steady_clock 纳秒）
+            std::atomic<int64_t> m_next_ns = 0;
+            /// @brief 上次输出以来被抑制的次数
+            std::atomic<uint64_t> m_suppressed = 0;
+        };
+    }
+}
+
+/**
+ * @brief 按分类输出日志
+ * @param level TRACE/DEBUG/INFO/WARN/ERROR/FATAL
+ * @param category DaneJoe::Log::Category 的枚举值名
+ * @param module 模块名
+ */
+#define DANEJOE_CLOG(level, category, module, ...) \
+    do \
+    { \
+        if constexpr (DaneJoe::Log::is_enabled(DaneJoe::Log::Level::level, DaneJoe::Log::Category::category)) \
+        { \
+            DANEJOE_LOG_##level("default", module, __VA_ARGS__); \
+        } \
+    } while (0)
+
+/**
+ * @brief 按分类输出日志，每个调用点在 interval_ms 内最多输出一次
+ * @note format 必须是字符串字面量，末尾会追加被抑制的次数
+ */
+#define DANEJOE_CLOG_RATE_LIMITED(level, category, module, interval_ms, format, ...) \
+    do \
+    { \
+        if constexpr (DaneJoe::Log::is_enabled(DaneJoe::Log::Level::level, DaneJoe::Log::Category::category)) \
+        { \
+            static DaneJoe::Log::RateLimiter danejoe_log_limiter(interval_ms); \
+            uint64_t danejoe_log_suppressed = 0; \
+            if (danejoe_log_limiter.try_acquire(danejoe_log_suppressed)) \
+            { \
+                DANEJOE_LOG_##level("default", module, format " (suppressed {})", __VA_ARGS__ __VA_OPT__(,) danejoe_log_suppressed); \
+            } \
+        } \
+    } while (0)
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+/// @brief DaneJoe namespace
+namespace DaneJoe
+{
+    /**
+     * @brief 图像平面的 64 位快速哈希（用于逐帧回归校验，非密码学哈希）
+     * @details 每 32 字节为一组，按 4 路 64 位累加器处理：每个 64 位字与随组序号递增的密钥异或，
+     *          高低 32 位相乘后连同原值累加，组序号参与密钥使交换数据块的位置也会改变结果。
+     *          有 SSE2/NEON 时两个向量寄存器同时处理一组，其余平台走标量路径，各路径结果逐位一致
+     *          （按小端序读取），可跨平台比较。只哈希每行的 row_bytes 字节，不含行尾填充。
+     * @param data 平面首行
+     * @param stride 行跨度（字节）
+     * @param row_bytes 每行有效字节数
+     * @param rows 行数
+     * @return 哈希值
+     */
+    uint64_t hash_plane(const uint8_t* data, int stride, int row_bytes, int rows);
+}
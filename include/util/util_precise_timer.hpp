@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+
+/// @brief DaneJoe namespace
+namespace DaneJoe
+{
+    /**
+     * @class PreciseTimer
+     * @brief 按绝对时间唤醒的高精度定时器
+     * @details 以 steady_clock 的绝对截止时间等待，不会像循环 sleep_for 那样累积误差或频繁唤醒。
+     *          Linux 上使用 clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME) 或 timerfd（steady_clock 即 CLOCK_MONOTONIC），
+     *          并把调用线程的 timer slack 降到 1ns，去掉内核默认的 50us 合并延迟；其他平台退化为 std::this_thread::sleep_until。
+     *          spin 大于 0 时内核等待提前 spin 结束，最后一段自旋到截止时间，以少量 CPU 换取微秒级精度。
+     *          实例不可跨线程同时使用（timerfd 后端每个实例持有一个描述符）。
+     * @note timer slack 的修改在调用线程上一直有效，应只在专用线程（如呈现线程）上等待，不要在 GUI 线程上使用。
+     */
+    class PreciseTimer
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+        /**
+         * @enum Backend
+         * @brief 内核等待方式
+         */
+        enum class Backend
+        {
+            /// @brief std::this_thread::sleep_until
+            SLEEP_UNTIL,
+            /// @brief clock_nanosleep 绝对时间
+            ABSOLUTE_NANOSLEEP,
+            /// @brief timerfd 绝对时间
+            TIMERFD,
+        };
+        /**
+         * @struct Options
+         * @brief 定时器参数
+         */
+        struct Options
+        {
+            /// @brief 内核等待方式（不支持时退化为 SLEEP_UNTIL）
+            Backend backend = Backend::ABSOLUTE_NANOSLEEP;
+            /// @brief 截止前自旋的时长（0 表示不自旋）
+            std::chrono::microseconds spin = std::chrono::microseconds(0);
+        };
+    public:
+        PreciseTimer();
+        /**
+         * @brief 构造函数
+         * @param options 定时器参数
+         */
+        explicit PreciseTimer(const Options& options);
+        ~PreciseTimer();
+        PreciseTimer(const PreciseTimer&) = delete;
+        PreciseTimer& operator=(const PreciseTimer&) = delete;
+        /**
+         * @brief 等待到截止时间（已过期时立即返回）
+         * @param deadline 截止时间
+         */
+        void sleep_until(Clock::time_point deadline);
+        /**
+         * @brief 等待指定时长
+         * @param duration 时长
+         */
+        void sleep_for(Clock::duration duration);
+        /**
+         * @brief 实际使用的内核等待方式
+         */
+        Backend backend()const;
+        /**
+         * @brief 当前平台是否支持该等待方式
+         */
+        static bool is_supported(Backend backend);
+        /**
+         * @brief 等待方式名称
+         */
+        static const char* backend_name(Backend backend);
+    private:
+        /**
+         * @brief 用内核定时器等待到 wake_time，可能因信号提前返回
+         */
+        void wait_kernel(Clock::time_point wake_time);
+    private:
+        Options m_options;
+        /// @brief timerfd 描述符（其他后端为 -1）
+        int m_timer_fd = -1;
+    };
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/// @brief DaneJoe namespace
+namespace DaneJoe
+{
+    /**
+     * @class StartupMetrics
+     * @brief 首帧耗时（time to first frame）统计
+     * @details 从打开文件开始，记录各启动阶段第一次到达的时间点；每个阶段只记录首次，
+     *          后续调用只是一次原子读，可放在逐帧路径上。首帧提交时输出一次汇总日志。
+     */
+    class StartupMetrics
+    {
+    public:
+        /**
+         * @enum Stage
+         * @brief 启动阶段
+         */
+        enum class Stage
+        {
+            /// @brief 开始打开文件
+            OPEN_BEGIN,
+            /// @brief 容器头读取完成
+            INPUT_OPENED,
+            /// @brief 流信息就绪（探测或缓存）
+            STREAM_INFO_READY,
+            /// @brief 解码器打开
+            DECODER_OPENED,
+            /// @brief 第一帧解码完成
+            FIRST_FRAME_DECODED,
+            /// @brief 第一帧提交显示（SDL_RenderPresent）
+            FIRST_FRAME_PRESENTED,
+            /// @brief 阶段数量
+            COUNT,
+        };
+    public:
+        /**
+         * @brief 获取全局实例
+         */
+        static StartupMetrics& get_instance();
+        /**
+         * @brief 清空所有阶段，开始新一次测量
+         */
+        void reset();
+        /**
+         * @brief 记录阶段首次到达的时间
+         * @note OPEN_BEGIN 之前的其它阶段被忽略
+         */
+        void mark(Stage stage);
+        /**
+         * @brief 阶段相对 OPEN_BEGIN 的耗时（毫秒），未到达时为空
+         */
+        std::optional<double> elapsed_ms(Stage stage)const;
+        /**
+         * @brief 各阶段耗时汇总
+         */
+        std::string summary()const;
+        /**
+         * @brief 阶段名称
+         */
+        static const char* stage_name(Stage stage);
+    private:
+        StartupMetrics() = default;
+    private:
+        /// @brief 各阶段时间点（steady_clock 纳秒，0 表示未到达）
+        std::array<std::atomic<int64_t>, static_cast<std::size_t>(Stage::COUNT)> m_stage_ns = {};
+    };
+}
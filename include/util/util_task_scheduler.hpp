@@ -0,0 +1,221 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief DaneJoe namespace
+namespace DaneJoe
+{
+    /**
+     * @enum TaskPriority
+     * @brief 任务优先级
+     */
+    enum class TaskPriority
+    {
+        HIGH,
+        NORMAL,
+        LOW,
+    };
+
+    /**
+     * @class CancellationToken
+     * @brief 可共享的取消标记
+     * @details 拷贝共享同一状态；任务在开始前检查，长任务也可在执行中主动轮询。
+     */
+    class CancellationToken
+    {
+    public:
+        CancellationToken();
+        /**
+         * @brief 请求取消
+         */
+        void cancel();
+        /**
+         * @brief 是否已请求取消
+         */
+        bool is_cancelled()const;
+    private:
+        /// @brief 共享的取消状态
+        std::shared_ptr<std::atomic<bool>> m_is_cancelled;
+    };
+
+    /**
+     * @class TaskGroup
+     * @brief 任务组：统计未完成任务数并提供统一的取消与等待
+     */
+    class TaskGroup
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param token 取消标记（缺省时新建）
+         */
+        explicit TaskGroup(CancellationToken token = CancellationToken());
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+        /**
+         * @brief 取消组内尚未开始的任务
+         */
+        void cancel();
+        /**
+         * @brief 是否已取消
+         */
+        bool is_cancelled()const;
+        /**
+         * @brief 取消标记
+         */
+        const CancellationToken& token()const;
+        /**
+         * @brief 未完成任务数
+         */
+        std::size_t pending()const;
+    private:
+        friend class TaskScheduler;
+        /// @brief 取消标记
+        CancellationToken m_token;
+        /// @brief 未完成任务数
+        std::atomic<std::size_t> m_pending = 0;
+        /// @brief 完成通知锁
+        std::mutex m_mutex;
+        /// @brief 完成通知条件变量
+        std::condition_variable m_condition;
+    };
+
+    /**
+     * @class TaskScheduler
+     * @brief 工作窃取任务调度器
+     * @details 每个工作线程按优先级维护本地双端队列：本线程提交的任务从尾部取（LIFO，缓存友好），
+     *          空闲线程从其他线程队列头部窃取（FIFO，先窃取较大的早期任务）；
+     *          外部线程提交的任务进入共享注入队列。等待任务组的线程会帮忙执行任务，
+     *          因此在任务内部等待子任务不会死锁。
+     */
+    class TaskScheduler
+    {
+    public:
+        /// @brief 任务类型（允许捕获仅移动对象，如 AVFrameView）
+        using Task = std::move_only_function<void()>;
+        /**
+         * @struct Stats
+         * @brief 调度统计
+         */
+        struct Stats
+        {
+            /// @brief 已执行任务数
+            uint64_t executed = 0;
+            /// @brief 通过窃取执行的任务数
+            uint64_t stolen = 0;
+            /// @brief 因取消而跳过的任务数
+            uint64_t cancelled = 0;
+        };
+    public:
+        /**
+         * @brief 构造函数
+         * @param worker_count 工作线程数（0 表示使用硬件并发数）
+         */
+        explicit TaskScheduler(std::size_t worker_count = 0);
+        /**
+         * @brief 析构函数：丢弃未执行的任务并回收线程
+         */
+        ~TaskScheduler();
+        TaskScheduler(const TaskScheduler&) = delete;
+        TaskScheduler& operator=(const TaskScheduler&) = delete;
+        /**
+         * @brief 获取进程共享的调度器（工作线程数为硬件并发数）
+         * @details 解码器的分片任务与其它计算任务都提交到这里，总并发数不超过核心数。
+         */
+        static TaskScheduler& get_instance();
+        /**
+         * @brief 提交独立任务
+         */
+        void submit(Task task, TaskPriority priority = TaskPriority::NORMAL);
+        /**
+         * @brief 提交属于任务组的任务（组已取消时任务被跳过）
+         */
+        void submit(TaskGroup& group, Task task, TaskPriority priority = TaskPriority::NORMAL);
+        /**
+         * @brief 等待任务组完成，等待期间当前线程参与执行任务
+         */
+        void wait(TaskGroup& group);
+        /**
+         * @brief 并行执行 func(0) ... func(count - 1) 并等待全部完成
+         * @details 各通道按原子计数领取：当前线程与至多 worker_count() 个高优先级辅助任务一起领取执行，
+         *          当前线程领取不到后只阻塞等待已被领取的通道，不执行其他任务，
+         *          因此可在解码器 execute 回调等延迟敏感的位置调用。
+         *          当前线程执行的通道抛出异常时停止领取，等待已领取的通道结束后重新抛出；辅助任务中的异常只记录日志。
+         */
+        void parallel_for(std::size_t count, const std::function<void(std::size_t)>& func);
+        /**
+         * @brief 尝试执行一个任务
+         * @return 是否执行了任务
+         */
+        bool try_run_one();
+        /**
+         * @brief 工作线程数
+         */
+        std::size_t worker_count()const;
+        /**
+         * @brief 当前线程是否为本调度器的工作线程
+         */
+        bool is_worker_thread()const;
+        /**
+         * @brief 获取统计信息
+         */
+        Stats get_stats()const;
+    private:
+        /// @brief 优先级数量
+        static constexpr std::size_t PRIORITY_COUNT = 3;
+        /**
+         * @struct WorkQueue
+         * @brief 按优先级划分的任务队列
+         */
+        struct WorkQueue
+        {
+            /// @brief 队列锁
+            std::mutex mutex;
+            /// @brief 各优先级任务
+            std::array<std::deque<Task>, PRIORITY_COUNT> tasks;
+        };
+    private:
+        /**
+         * @brief 工作线程主循环
+         */
+        void worker_loop(std::size_t worker_index);
+        /**
+         * @brief 放入队列并唤醒空闲线程
+         */
+        void push(Task task, TaskPriority priority);
+        /**
+         * @brief 按优先级依次尝试本地队列、注入队列与其他线程队列
+         * @param task 输出任务
+         * @param is_stolen 是否取自其他工作线程
+         */
+        bool pop(Task& task, bool& is_stolen);
+    private:
+        /// @brief 各工作线程队列，最后一个为外部提交使用的注入队列
+        std::vector<std::unique_ptr<WorkQueue>> m_queues;
+        /// @brief 工作线程
+        std::vector<std::thread> m_workers;
+        /// @brief 排队中的任务数
+        std::atomic<std::size_t> m_queued = 0;
+        /// @brief 是否停止
+        std::atomic<bool> m_is_stopped = false;
+        /// @brief 空闲等待锁
+        std::mutex m_idle_mutex;
+        /// @brief 空闲等待条件变量
+        std::condition_variable m_idle_condition;
+        /// @brief 已执行任务数
+        std::atomic<uint64_t> m_executed = 0;
+        /// @brief 窃取次数
+        std::atomic<uint64_t> m_stolen = 0;
+        /// @brief 取消次数
+        std::atomic<uint64_t> m_cancelled = 0;
+    };
+}
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// @brief DaneJoe namespace
+namespace DaneJoe
+{
+    /**
+     * @enum TraceTrack
+     * @brief 追踪事件所属的轨道
+     */
+    enum class TraceTrack : uint8_t
+    {
+        /// @brief 解封装（读取数据包）
+        DEMUX,
+        /// @brief 解码（送包与取帧）
+        DECODE,
+        /// @brief 帧队列等待
+        QUEUE_WAIT,
+        /// @brief 纹理上传
+        UPLOAD,
+        /// @brief 提交显示
+        PRESENT,
+        /// @brief 音频回调
+        AUDIO_CALLBACK,
+        /// @brief 滤镜图处理
+        FILTER,
+        /// @brief 编码（送帧与取包）
+        ENCODE,
+        /// @brief 封装（写出数据包）
+        MUX,
+        /// @brief 轨道数量
+        COUNT,
+    };
+
+    /**
+     * @struct TraceRecord
+     * @brief 定长二进制追踪记录
+     * @note name 必须指向静态存储期的字符串（通常为字面量），记录时只保存指针
+     */
+    struct TraceRecord
+    {
+        /// @brief 开始时间（steady_clock 纳秒）
+        int64_t begin_ns = 0;
+        /// @brief 结束时间（steady_clock 纳秒）
+        int64_t end_ns = 0;
+        /// @brief 附加参数（如 pts），不需要时为 0
+        int64_t arg = 0;
+        /// @brief 事件名称
+        const char* name = nullptr;
+        /// @brief 记录线程编号（进程内从 1 开始递增）
+        uint32_t thread_id = 0;
+        /// @brief 所属轨道
+        TraceTrack track = TraceTrack::DEMUX;
+    };
+
+    /**
+     * @class TraceRecorder
+     * @brief 低开销追踪记录器
+     * @details 每个线程第一次记录时取得自己的环形缓冲，之后写入只有一次数组赋值和一次原子存储，
+     *          不加锁、不格式化字符串；缓冲写满后覆盖最旧的记录。线程退出时缓冲归还空闲列表，
+     *          由之后第一次记录的线程复用（旧记录保留到被覆盖为止，每条记录自带线程编号），
+     *          因此频繁创建短命线程时缓冲数量只取决于同时记录的线程数。记录可保存为二进制文件，
+     *          再由 convert_to_chrome_json 转换为 Chrome trace-event JSON，在 Perfetto 或 chrome://tracing 中查看。
+     *          默认关闭，关闭时每个追踪点只有一次原子读。
+     */
+    class TraceRecorder
+    {
+    public:
+        /**
+         * @brief 获取全局实例
+         */
+        static TraceRecorder& get_instance();
+        /**
+         * @brief 开启或关闭记录
+         */
+        void set_enabled(bool is_enabled);
+        /**
+         * @brief 是否正在记录
+         */
+        bool is_enabled()const
+        {
+            return m_is_enabled.load(std::memory_order_relaxed);
+        }
+        /**
+         * @brief 设置之后新建的线程缓冲可容纳的记录数
+         */
+        void set_buffer_capacity(std::size_t capacity);
+        /**
+         * @brief 为当前线程命名，导出后作为 Perfetto 中的线程名
+         * @details 只保存到线程局部变量，不分配缓冲；线程在开启记录后第一次写入时才创建缓冲并带上该名称。
+         */
+        void set_thread_name(const std::string& name);
+        /**
+         * @brief 写入一条记录
+         */
+        void record(TraceTrack track, const char* name, int64_t begin_ns, int64_t end_ns, int64_t arg = 0);
+        /**
+         * @brief 按时间顺序取出所有线程缓冲中的记录
+         * @note 读取记录时不与写入同步，调用方须保证被追踪的线程已停止写入（关闭记录并等待进行中的作用域结束，
+         *       或线程已退出），否则正被覆盖的记录可能不完整
+         */
+        std::vector<TraceRecord> collect();
+        /**
+         * @brief 清空所有线程缓冲
+         * @note 只记下各缓冲当前的写入计数，之后导出从该处开始，不修改写线程使用的计数，可与写入并发调用
+         */
+        void clear();
+        /**
+         * @brief 保存为二进制追踪文件
+         */
+        bool save_binary(const std::string& file_path);
+        /**
+         * @brief 直接导出为 Chrome trace-event JSON
+         */
+        bool save_chrome_json(const std::string& file_path);
+        /**
+         * @brief 把 save_binary 写出的文件转换为 Chrome trace-event JSON
+         */
+        static bool convert_to_chrome_json(const std::string& binary_path, const std::string& json_path);
+        /**
+         * @brief 轨道名称
+         */
+        static const char* track_name(TraceTrack track);
+        /**
+         * @brief 当前时间（steady_clock 纳秒）
+         */
+        static int64_t now_ns()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+    private:
+        TraceRecorder() = default;
+        /**
+         * @struct ThreadBuffer
+         * @brief 单个线程的环形缓冲，只有持有它的线程写入
+         */
+        struct ThreadBuffer
+        {
+            /// @brief 当前持有缓冲的线程编号
+            uint32_t thread_id = 0;
+            std::vector<TraceRecord> records;
+            /// @brief 累计写入的记录数，对容量取模得到写入位置
+            std::atomic<uint64_t> write_count = 0;
+            /// @brief 最近一次 clear 时的写入计数，导出只取之后的记录
+            std::atomic<uint64_t> clear_count = 0;
+        };
+        /**
+         * @struct ThreadBufferOwner
+         * @brief 线程局部的缓冲持有者，线程退出时把缓冲归还空闲列表
+         */
+        struct ThreadBufferOwner
+        {
+            ThreadBuffer* buffer = nullptr;
+            ~ThreadBufferOwner();
+        };
+        /**
+         * @brief 当前线程的缓冲，第一次调用时从空闲列表取得或新建
+         */
+        ThreadBuffer& thread_buffer();
+        /**
+         * @brief 当前线程的缓冲持有者
+         */
+        static ThreadBufferOwner& thread_buffer_owner();
+        /**
+         * @brief 线程退出时归还缓冲
+         */
+        void release_thread_buffer(ThreadBuffer* buffer);
+    private:
+        std::atomic<bool> m_is_enabled = false;
+        std::atomic<std::size_t> m_buffer_capacity = 16384;
+        std::atomic<uint32_t> m_next_thread_id = 1;
+        /// @brief 保护以下成员
+        std::mutex m_mutex;
+        /// @brief 所有线程缓冲，线程退出后仍保留以便导出
+        std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+        /// @brief 持有线程已退出、可复用的缓冲
+        std::vector<ThreadBuffer*> m_free_buffers;
+        /// @brief 线程编号到线程名称
+        std::map<uint32_t, std::string> m_thread_names;
+    };
+
+    /**
+     * @class TraceScope
+     * @brief 作用域追踪：构造时记下开始时间，析构时写入一条记录
+     */
+    class TraceScope
+    {
+    public:
+        TraceScope(TraceTrack track, const char* name, int64_t arg = 0) :
+            m_track(track), m_name(name), m_arg(arg),
+            m_begin_ns(TraceRecorder::get_instance().is_enabled() ? TraceRecorder::now_ns() : 0) {}
+        ~TraceScope()
+        {
+            if (m_begin_ns != 0)
+            {
+                TraceRecorder::get_instance().record(m_track, m_name, m_begin_ns, TraceRecorder::now_ns(), m_arg);
+            }
+        }
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+    private:
+        TraceTrack m_track;
+        const char* m_name;
+        int64_t m_arg;
+        /// @brief 开始时间，未开启记录时为 0
+        int64_t m_begin_ns;
+    };
+
+    /**
+     * @class TraceSession
+     * @brief 在作用域内开启记录，结束时写出追踪文件
+     * @details 文件扩展名为 .json 时直接导出 Chrome trace-event JSON，否则保存为二进制文件
+     */
+    class TraceSession
+    {
+    public:
+        explicit TraceSession(const std::string& file_path);
+        ~TraceSession();
+        TraceSession(const TraceSession&) = delete;
+        TraceSession& operator=(const TraceSession&) = delete;
+    private:
+        std::string m_file_path;
+    };
+}
+
+#define DANEJOE_TRACE_CONCAT_INNER(a, b) a##b
+#define DANEJOE_TRACE_CONCAT(a, b) DANEJOE_TRACE_CONCAT_INNER(a, b)
+
+#if defined(DANEJOE_DISABLE_TRACE)
+#define DANEJOE_TRACE_SCOPE(track, name) ((void)0)
+#define DANEJOE_TRACE_SCOPE_ARG(track, name, arg) ((void)0)
+#else
+/// @brief 追踪当前作用域，track 为 DaneJoe::TraceTrack 的枚举值名，name 必须是字符串字面量
+#define DANEJOE_TRACE_SCOPE(track, name) \
+    DaneJoe::TraceScope DANEJOE_TRACE_CONCAT(danejoe_trace_scope_, __LINE__)(DaneJoe::TraceTrack::track, name)
+/// @brief 追踪当前作用域并附带一个整数参数
+#define DANEJOE_TRACE_SCOPE_ARG(track, name, arg) \
+    DaneJoe::TraceScope DANEJOE_TRACE_CONCAT(danejoe_trace_scope_, __LINE__)(DaneJoe::TraceTrack::track, name, static_cast<int64_t>(arg))
+#endif
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/// @brief DaneJoe namespace
+namespace DaneJoe
+{
+    /**
+     * @class TripleBuffer
+     * @brief 单写单读的无等待三缓冲
+     * @details 写端写入私有槽后与中间槽原子交换并置脏位，读端仅在脏位存在时与中间槽交换。
+     *          双方均只做一次原子交换，互不阻塞；读端看到的始终是某一次完整发布的值。
+     * @note 同一时刻只允许一个写端与一个读端，多个写端需由调用方串行化。
+     */
+    template<typename T>
+    class TripleBuffer
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param value 初始值
+         */
+        explicit TripleBuffer(const T& value = T{})
+        {
+            m_slots.fill(value);
+        }
+        TripleBuffer(const TripleBuffer&) = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+        /**
+         * @brief 发布新值（写端）
+         * @param value 新值
+         */
+        void publish(const T& value)
+        {
+            m_slots[m_write_index] = value;
+            uint8_t previous = m_middle.exchange(static_cast<uint8_t>(m_write_index | DIRTY_BIT), std::memory_order_acq_rel);
+            m_write_index = previous & INDEX_MASK;
+        }
+        /**
+         * @brief 取得最新发布的值（读端）
+         * @return 有新值时为true
+         */
+        bool update()
+        {
+            if ((m_middle.load(std::memory_order_relaxed) & DIRTY_BIT) == 0)
+            {
+                return false;
+            }
+            uint8_t previous = m_middle.exchange(m_read_index, std::memory_order_acq_rel);
+            m_read_index = previous & INDEX_MASK;
+            return true;
+        }
+        /**
+         * @brief 读端当前持有的值
+         */
+        const T& read() const
+        {
+            return m_slots[m_read_index];
+        }
+    private:
+        /// @brief 脏位
+        static constexpr uint8_t DIRTY_BIT = 0x4;
+        /// @brief 槽下标掩码
+        static constexpr uint8_t INDEX_MASK = 0x3;
+    private:
+        /// @brief 三个数据槽
+        std::array<T, 3> m_slots;
+        /// @brief 中间槽下标与脏位
+        std::atomic<uint8_t> m_middle = 1;
+        /// @brief 写端私有槽下标
+        uint8_t m_write_index = 2;
+        /// @brief 读端私有槽下标
+        uint8_t m_read_index = 0;
+    };
+}
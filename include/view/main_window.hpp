@@ -1,9 +1,16 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
 #include <thread>
 
 #include <QMainWindow>
 
+#include "main/playback_preloader.hpp"
+#include "main/frame_stepper.hpp"
+
 class SDLVideoWidget;
 
 class MainWindow : public QMainWindow
@@ -12,8 +19,65 @@ class MainWindow : public QMainWindow
 public:
     MainWindow(QWidget* parent = nullptr);
     ~MainWindow();
-    void init();
+    /**
+     * @brief 初始化
+     * @param preloader 已在 QApplication 创建前启动的预加载器，窗口接管其生命周期
+     */
+    void init(std::unique_ptr<PlaybackPreloader> preloader);
+protected:
+    /**
+     * @brief 播放速率快捷键：] 或 + 加速，[ 或 - 减速，Backspace 恢复 1x；
+     *        单步快捷键：空格暂停/继续，. 前进一帧，, 后退一帧（暂停后生效）
+     */
+    void keyPressEvent(QKeyEvent* event)override;
+private:
+    /**
+     * @struct StepResult
+     * @brief 工作线程上一次单步的结果
+     */
+    struct StepResult
+    {
+        /// @brief 新的当前帧，失败或已到首尾时为空
+        std::optional<AVFrameView> frame;
+        /// @brief 本次是否完成了到暂停位置的定位
+        bool is_positioned = false;
+    };
+private:
+    /**
+     * @brief 暂停并在工作线程上单步
+     * @param is_forward 是否前进
+     * @return 是否处理了按键（不支持单步时为 false）
+     */
+    bool step_frame(bool is_forward);
+    /**
+     * @brief 单步（工作线程）：按需打开单步器、定位并解码
+     * @param file_path 文件路径
+     * @param is_forward 是否前进
+     * @param seek_seconds 需要先定位时的目标时间（秒）
+     */
+    StepResult run_step(const std::string& file_path, bool is_forward, std::optional<double> seek_seconds);
+    /**
+     * @brief 在 GUI 线程上显示单步结果
+     * @param result 单步结果
+     * @param generation 发起单步时的代数，与当前不一致说明期间已恢复播放
+     */
+    void finish_step(StepResult result, uint64_t generation);
+    /**
+     * @brief 在窗口标题中显示当前帧与缓存统计
+     */
+    void update_step_status();
 private:
-    std::jthread m_decode_thread;
-    SDLVideoWidget* m_video_widget;
-};
\ No newline at end of file
+    /// @brief 预加载器（持有解码线程），须在视频控件之后析构
+    std::unique_ptr<PlaybackPreloader> m_preloader;
+    SDLVideoWidget* m_video_widget = nullptr;
+    /// @brief 单步解码器与已解码帧缓存，首次单步时打开
+    FrameStepper m_frame_stepper;
+    /// @brief 单步器是否已定位到暂停时呈现的帧（恢复播放后失效）
+    bool m_is_step_positioned = false;
+    /// @brief 是否有单步正在工作线程上进行
+    bool m_is_stepping = false;
+    /// @brief 单步代数，每次恢复播放递增
+    uint64_t m_step_generation = 0;
+    /// @brief 单步工作线程（析构时先等待其结束）
+    std::jthread m_step_thread;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <chrono>
+
+#include <QWidget>
+
+#include "renderer/sdl_compositor_renderer.hpp"
+#include "main/frame_queue.hpp"
+
+class QVBoxLayout;
+class QLabel;
+
+/**
+ * @class SDLCompositorWidget
+ * @brief 多路流合成显示控件
+ * @details 所有流共用一个SDL窗口，每次定时器触发时各路流按自身帧时长取帧，
+ *          由 SDLCompositorRenderer 合成后只提交一次。
+ */
+class SDLCompositorWidget : public QWidget
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief 构造函数
+     * @param parent 父窗口
+     */
+    explicit SDLCompositorWidget(QWidget* parent = nullptr);
+    /**
+     * @brief 析构函数
+     */
+    ~SDLCompositorWidget();
+    /**
+     * @brief 初始化
+     * @param stream_count 流数量
+     * @param frame_queue_capacity 每路流的帧队列容量
+     */
+    void init(std::size_t stream_count, std::size_t frame_queue_capacity = 8);
+    /**
+     * @brief 关闭所有帧队列并停止刷新
+     */
+    void close();
+    /**
+     * @brief 获取某路流的帧队列
+     */
+    std::weak_ptr<FrameQueue> get_frame_queue(std::size_t stream_index);
+    /**
+     * @brief 获取合成统计
+     */
+    SDLCompositorRenderer::Stats get_stats()const;
+private:
+    /**
+     * @brief 定时器事件：取帧、合成并提交
+     */
+    void timerEvent(QTimerEvent* event)override;
+    /**
+     * @brief 窗口大小改变事件
+     */
+    void resizeEvent(QResizeEvent* event)override;
+    /**
+     * @brief 窗口显示事件：延后创建渲染器
+     */
+    void showEvent(QShowEvent* event)override;
+    /**
+     * @brief 窗口关闭事件
+     */
+    void closeEvent(QCloseEvent* event)override;
+    void init_renderer();
+private:
+    /**
+     * @struct StreamState
+     * @brief 单路流的显示节奏
+     */
+    struct StreamState
+    {
+        /// @brief 帧队列
+        std::shared_ptr<FrameQueue> frame_queue;
+        /// @brief 下一帧应显示的时间
+        std::chrono::steady_clock::time_point next_due;
+    };
+private:
+    /// @brief 缺省帧间隔（帧时长未知时使用）
+    static constexpr std::chrono::milliseconds DEFAULT_FRAME_INTERVAL = std::chrono::milliseconds(40);
+private:
+    /// @brief 是否初始化
+    bool m_is_init = false;
+    /// @brief 内部定时器
+    int m_timer_id = -1;
+    /// @brief SDL标签
+    QLabel* m_sdl_label = nullptr;
+    /// @brief 窗口布局
+    QVBoxLayout* m_main_layout = nullptr;
+    /// @brief 合成渲染器
+    std::unique_ptr<SDLCompositorRenderer> m_renderer;
+    /// @brief 各路流
+    std::vector<StreamState> m_streams;
+};
@@ -4,16 +4,18 @@
 #include <cstdint>
 #include <fstream>
 #include <chrono>
+#include <optional>
 
+#include <QString>
 #include <QWidget>
 
 #include <SDL2/SDL.h>
 
 #include "renderer/i_frame_renderer.hpp"
-#include "codec/av_frame_ptr.hpp"
-#include "concurrent/blocking/mpmc_bounded_queue.hpp"
-
-using namespace DaneJoe::Concurrent::Blocking;
+#include "codec/av_frame_view.hpp"
+#include "main/frame_queue.hpp"
+#include "main/playback_rate.hpp"
+#include "main/present_thread.hpp"
 
 /// @brief 前向声明
 class IFrameRenderer;
@@ -39,10 +41,50 @@ public:
      * @note 释放资源
      */
     ~SDLVideoWidget();
-    void init();
+    /**
+     * @brief 初始化
+     * @param frame_queue_capacity 帧队列容量
+     */
+    void init(std::size_t frame_queue_capacity = 512);
+    /**
+     * @brief 使用外部帧队列初始化
+     * @param frame_queue 帧队列（可能已由预加载线程填入帧）
+     * @param rate_control 与解码线程共享的变速播放控制（为空时以 1x 播放）
+     */
+    void init(std::shared_ptr<FrameQueue> frame_queue, std::shared_ptr<PlaybackRateControl> rate_control = nullptr);
     void close();
-    void sleep(std::chrono::milliseconds ms);
-    std::weak_ptr<MpmcBoundedQueue<AVFramePtr>> get_frame_queue();
+    std::weak_ptr<FrameQueue> get_frame_queue();
+    /**
+     * @brief 暂停或恢复从帧队列呈现
+     * @note 暂停期间解码线程在队列满后阻塞，恢复后从暂停处继续
+     */
+    void set_paused(bool is_paused);
+    /**
+     * @brief 是否暂停
+     */
+    bool is_paused()const;
+    /**
+     * @brief 最近一次统计的速率状态：请求速率、实际速率、解码策略、丢帧数与抖动评分
+     * @note 每秒更新一次；控件是顶层主窗口的中心控件时同时显示在窗口标题中
+     */
+    QString rate_status()const;
+    /**
+     * @brief 暂停时显示一帧（单步）
+     * @param frame_view 帧视图，移交给呈现线程绘制
+     * @return 呈现线程是否已启动并接收该帧
+     */
+    bool show_frame(AVFrameView&& frame_view);
+    /**
+     * @brief 设置是否请求垂直同步（须在控件显示、创建渲染器之前调用，默认关闭）
+     * @note 开启后呈现线程上该输出的每次 present 都阻塞到显示刷新，只适用于独占呈现线程的单个控件；
+     *       视频墙的控件共用一个呈现线程，开启后一路输出的 present 会推迟其余输出的绘制，不应开启
+     */
+    void set_vsync(bool is_vsync);
+    /**
+     * @brief 使用共享的呈现线程（须在控件显示之前调用，未设置时控件显示后创建独占的呈现线程）
+     * @param present_thread 呈现线程，视频墙的所有控件共用一个
+     */
+    void set_present_thread(std::shared_ptr<PresentThread> present_thread);
 private:
     /**
      * @brief 定时器事件
@@ -64,14 +106,23 @@ private:
      * @param event 事件
      */
     void closeEvent(QCloseEvent* event)override;
+    /**
+     * @brief 把渲染器与原生窗口交给呈现线程，由其关联 SDL 窗口并创建渲染器
+     */
     void init_renderer();
+    /**
+     * @brief 更新速率状态（请求速率、实际速率与抖动评分）
+     */
+    void update_rate_status();
 private:
     /// @brief 是否初始化
     bool m_is_init = false;
+    /// @brief 是否暂停
+    bool m_is_paused = false;
+    /// @brief 创建渲染器时是否请求垂直同步
+    bool m_is_request_vsync = false;
     /// @brief 内部定时器
     int m_timer_id = -1;
-    /// @brief 渲染器
-    std::shared_ptr<IFrameRenderer> m_renderer = nullptr;
     /// @brief SDL标签
     QLabel* m_sdl_label;
     /// @brief 视频帧率
@@ -79,5 +130,15 @@ private:
     /// @brief 窗口布局
     QVBoxLayout* m_main_layout;
     /// @brief 帧队列
-    std::shared_ptr<MpmcBoundedQueue<AVFramePtr>> m_frame_queue;
+    std::shared_ptr<FrameQueue> m_frame_queue;
+    /// @brief 变速播放控制
+    std::shared_ptr<PlaybackRateControl> m_rate_control;
+    /// @brief 呈现线程（持有渲染器、刷新时钟、呈现调度器与精确定时器）
+    std::shared_ptr<PresentThread> m_present_thread;
+    /// @brief 本控件在呈现线程上的输出（0 表示尚未添加）
+    PresentThread::OutputId m_output_id = 0;
+    /// @brief 上次更新速率状态的时间
+    std::chrono::steady_clock::time_point m_last_status_time;
+    /// @brief 最近一次统计的速率状态
+    QString m_rate_status;
 };
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <QWidget>
+
+class SDLVideoWidget;
+class SDLCompositorWidget;
+class QGridLayout;
+class DecodeWorkerPool;
+class PresentThread;
+
+/**
+ * @class VideoWallWindow
+ * @brief 多路视频墙窗口
+ * @details 以网格方式排列多个 SDLVideoWidget（共用一个呈现线程），或由单个 SDLCompositorWidget 合成所有流；
+ *          所有流共享同一个固定大小的解码线程池。
+ */
+class VideoWallWindow : public QWidget
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief 构造函数
+     * @param parent 父窗口
+     */
+    explicit VideoWallWindow(QWidget* parent = nullptr);
+    /**
+     * @brief 析构函数：先停止解码线程池再释放子控件
+     */
+    ~VideoWallWindow();
+    /**
+     * @brief 初始化视频墙
+     * @param file_paths 各路流的文件路径
+     * @param worker_count 解码线程数（0 表示使用硬件并发数）
+     * @param is_compositor 是否使用单窗口合成渲染
+     */
+    void init(const std::vector<std::string>& file_paths, std::size_t worker_count = 0, bool is_compositor = false);
+private:
+    /**
+     * @brief 定时器事件：刷新解码统计
+     */
+    void timerEvent(QTimerEvent* event)override;
+private:
+    /// @brief 每路流的帧队列容量（较小的容量让背压尽早生效）
+    static constexpr std::size_t STREAM_QUEUE_CAPACITY = 8;
+private:
+    /// @brief 网格布局
+    QGridLayout* m_grid_layout = nullptr;
+    /// @brief 各路视频控件（非合成模式）
+    std::vector<SDLVideoWidget*> m_video_widgets;
+    /// @brief 各路视频控件共用的呈现线程（非合成模式，控件销毁时才释放）
+    std::shared_ptr<PresentThread> m_present_thread;
+    /// @brief 合成控件（合成模式）
+    SDLCompositorWidget* m_compositor_widget = nullptr;
+    /// @brief 流数量
+    std::size_t m_stream_count = 0;
+    /// @brief 共享解码线程池
+    std::unique_ptr<DecodeWorkerPool> m_decode_pool;
+    /// @brief 统计定时器
+    int m_stats_timer_id = -1;
+    /// @brief 上次统计时的累计帧数
+    uint64_t m_last_frames = 0;
+};
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "codec/av_codec_context_pool.hpp"
+#include "codec/av_shared_execute.hpp"
+#include "util/util_log.hpp"
+
+AVCodecContextPool& AVCodecContextPool::get_instance()
+{
+    static AVCodecContextPool instance;
+    return instance;
+}
+
+std::string AVCodecContextPool::make_key(const AVCodec* codec, const AVCodecParameters* parameters, int thread_count, bool is_shared_execute)
+{
+    // 附加数据（如 H.264 的 SPS/PPS）在 avcodec_open2 时解析，内容不同的上下文不能互换，以 FNV-1a 摘要区分
+    uint64_t extradata_hash = 14695981039346656037ull;
+    for (int i = 0; i < parameters->extradata_size; i++)
+    {
+        extradata_hash = (extradata_hash ^ parameters->extradata[i]) * 1099511628211ull;
+    }
+    std::ostringstream key;
+    key << codec->name << ":" << parameters->codec_id << ":" << parameters->codec_tag
+        << ":" << parameters->width << "x" << parameters->height << ":" << parameters->format
+        << ":" << parameters->profile << ":" << parameters->level
+        << ":" << parameters->sample_aspect_ratio.num << "/" << parameters->sample_aspect_ratio.den
+        // parameters_to_context 复制的其余视频字段：影响输出帧的色彩属性、场序与解码器的位深/延迟判断
+        << ":" << parameters->color_range << ":" << parameters->color_space << ":" << parameters->color_primaries
+        << ":" << parameters->color_trc << ":" << parameters->chroma_location << ":" << parameters->field_order
+        << ":" << parameters->bits_per_coded_sample << ":" << parameters->bits_per_raw_sample << ":" << parameters->video_delay
+        << ":" << parameters->extradata_size << ":" << std::hex << extradata_hash << std::dec;
+    if (is_shared_execute)
+    {
+        key << ":shared";
+    }
+    else
+    {
+        key << ":t" << thread_count;
+    }
+    return key.str();
+}
+
+AVError AVCodecContextPool::acquire(const AVCodec* codec, const AVCodecParameters* parameters, AVRational time_base, int thread_count, bool is_shared_execute, AVCodecContextPtr& codec_context, std::string& key)
+{
+    if (!codec || !parameters)
+    {
+        return AVError(AVERROR(EINVAL));
+    }
+    key = make_key(codec, parameters, thread_count, is_shared_execute);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // 从最近归还的开始找，最近用过的上下文缓存更热
+        auto it = std::find_if(m_idle_contexts.rbegin(), m_idle_contexts.rend(), [&key](const IdleContext& idle) { return idle.key == key; });
+        if (it != m_idle_contexts.rend())
+        {
+            codec_context = std::move(it->codec_context);
+            m_idle_contexts.erase(std::next(it).base());
+            m_stats.hits++;
+            codec_context->pkt_timebase = time_base;
+            return AVError(0);
+        }
+        m_stats.misses++;
+    }
+    codec_context.alloc_context3(codec);
+    if (!codec_context)
+    {
+        return AVError(AVERROR(ENOMEM));
+    }
+    AVError error = codec_context.parameters_to_context(parameters);
+    if (error.failed())
+    {
+        codec_context.reset();
+        return error;
+    }
+    codec_context->thread_count = thread_count;
+    codec_context->pkt_timebase = time_base;
+    if (is_shared_execute)
+    {
+        prepare_shared_execute(codec_context.get());
+    }
+    error = codec_context.open2(codec, nullptr);
+    if (error.failed())
+    {
+        codec_context.reset();
+        return error;
+    }
+    if (is_shared_execute)
+    {
+        install_shared_execute(codec_context.get());
+    }
+    return error;
+}
+
+void AVCodecContextPool::release(const std::string& key, AVCodecContextPtr&& codec_context)
+{
+    if (!codec_context)
+    {
+        return;
+    }
+    // 清空解码状态（包括冲刷结束标志与帧线程中的待处理帧），并恢复调用方可能改过的选项
+    codec_context.flush_buffers();
+    codec_context->skip_frame = AVDISCARD_DEFAULT;
+    std::list<IdleContext> evicted;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_idle_contexts.push_back(IdleContext{ key, std::move(codec_context) });
+        while (m_idle_contexts.size() > m_capacity)
+        {
+            evicted.splice(evicted.end(), m_idle_contexts, m_idle_contexts.begin());
+            m_stats.evictions++;
+        }
+    }
+    // 释放帧线程上下文需要等待线程退出，放在锁外
+    if (!evicted.empty())
+    {
+        DANEJOE_CLOG(TRACE, DECODE, "AVCodecContextPool", "Evicted {} decoder contexts", evicted.size());
+    }
+}
+
+void AVCodecContextPool::set_capacity(std::size_t capacity)
+{
+    std::list<IdleContext> evicted;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_capacity = capacity;
+        while (m_idle_contexts.size() > m_capacity)
+        {
+            evicted.splice(evicted.end(), m_idle_contexts, m_idle_contexts.begin());
+            m_stats.evictions++;
+        }
+    }
+}
+
+void AVCodecContextPool::clear()
+{
+    std::list<IdleContext> evicted;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        evicted.swap(m_idle_contexts);
+    }
+}
+
+AVCodecContextPool::Stats AVCodecContextPool::get_stats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.idle = m_idle_contexts.size();
+    return stats;
+}
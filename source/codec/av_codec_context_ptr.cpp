@@ -6,6 +6,28 @@ AVCodecContextPtr::AVCodecContextPtr()
 }
 
 AVCodecContextPtr::~AVCodecContextPtr()
+{
+    reset();
+}
+
+AVCodecContextPtr::AVCodecContextPtr(AVCodecContextPtr&& other) noexcept :m_codec_context(other.m_codec_context)
+{
+    other.m_codec_context = nullptr;
+}
+
+AVCodecContextPtr& AVCodecContextPtr::operator=(AVCodecContextPtr&& other) noexcept
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+    reset();
+    m_codec_context = other.m_codec_context;
+    other.m_codec_context = nullptr;
+    return *this;
+}
+
+void AVCodecContextPtr::reset()
 {
     if (m_codec_context)
     {
@@ -14,9 +36,14 @@ AVCodecContextPtr::~AVCodecContextPtr()
     }
 }
 
+AVCodecContextPtr::operator bool()const
+{
+    return m_codec_context != nullptr;
+}
+
 AVCodecContext* AVCodecContextPtr::get()const
 {
-    return AVCodecContextPtr::get();
+    return m_codec_context;
 }
 
 AVCodecContext* AVCodecContextPtr::operator->()const
@@ -26,6 +53,7 @@ AVCodecContext* AVCodecContextPtr::operator->()const
 
 void AVCodecContextPtr::alloc_context3(const AVCodec* codec)
 {
+    reset();
     m_codec_context = avcodec_alloc_context3(codec);
 }
 
@@ -39,12 +67,40 @@ AVError AVCodecContextPtr::parameters_to_context(const AVCodecParameters* parame
     return AVError(avcodec_parameters_to_context(m_codec_context, parameters));
 }
 
-AVError AVCodecContextPtr::send_packet(AVPacketPtr packet)
+AVError AVCodecContextPtr::send_packet(AVPacketPtr& packet)
 {
     return AVError(avcodec_send_packet(m_codec_context, packet.get()));
 }
 
-AVError AVCodecContextPtr::receive_frame(AVFramePtr frame)
+AVError AVCodecContextPtr::send_packet(const AVPacket* packet)
+{
+    return AVError(avcodec_send_packet(m_codec_context, packet));
+}
+
+AVError AVCodecContextPtr::receive_frame(AVFramePtr& frame)
 {
     return AVError(avcodec_receive_frame(m_codec_context, frame.get()));
+}
+
+AVError AVCodecContextPtr::send_frame(AVFramePtr& frame)
+{
+    return AVError(avcodec_send_frame(m_codec_context, frame.get()));
+}
+
+AVError AVCodecContextPtr::send_frame(const AVFrame* frame)
+{
+    return AVError(avcodec_send_frame(m_codec_context, frame));
+}
+
+AVError AVCodecContextPtr::receive_packet(AVPacketPtr& packet)
+{
+    return AVError(avcodec_receive_packet(m_codec_context, packet.get()));
+}
+
+void AVCodecContextPtr::flush_buffers()
+{
+    if (m_codec_context)
+    {
+        avcodec_flush_buffers(m_codec_context);
+    }
 }
\ No newline at end of file
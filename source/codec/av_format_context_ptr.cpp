@@ -8,10 +8,24 @@ AVFormatContextPtr::AVFormatContextPtr(AVFormatContext* av_format_context)
 {
     m_av_format_context = av_format_context;
 }
-AVError AVFormatContextPtr::open_input(const std::string& file_path, AVInputFormat* fmt, AVDictionary** options)
+AVError AVFormatContextPtr::open_input(const std::string& file_path, const AVInputFormat* fmt, AVDictionary** options)
 {
     return AVError(avformat_open_input(&m_av_format_context, file_path.c_str(), fmt, options));
 }
+AVError AVFormatContextPtr::open_input(AVIOContext* io_context, const std::string& url, const AVInputFormat* fmt, AVDictionary** options)
+{
+    if (!m_av_format_context)
+    {
+        m_av_format_context = avformat_alloc_context();
+    }
+    if (!m_av_format_context)
+    {
+        return AVError(AVERROR(ENOMEM));
+    }
+    m_av_format_context->pb = io_context;
+    m_av_format_context->flags |= AVFMT_FLAG_CUSTOM_IO;
+    return AVError(avformat_open_input(&m_av_format_context, url.c_str(), fmt, options));
+}
 void AVFormatContextPtr::close_input()
 {
     if (m_av_format_context)
@@ -46,7 +60,12 @@ AVError AVFormatContextPtr::find_stream_info(AVDictionary** options)
     return AVError(avformat_find_stream_info(m_av_format_context, options));
 }
 
-AVError AVFormatContextPtr::read_frame(AVPacketPtr packet)
+AVError AVFormatContextPtr::read_frame(AVPacketPtr& packet)
 {
     return AVError(av_read_frame(m_av_format_context, packet.get()));
+}
+
+AVError AVFormatContextPtr::seek_frame(int stream_index, int64_t timestamp, int flags)
+{
+    return AVError(av_seek_frame(m_av_format_context, stream_index, timestamp, flags));
 }
\ No newline at end of file
@@ -236,4 +236,9 @@ void AVFramePtr::swap(AVFramePtr& other) noexcept
 {
     std::swap(m_frame, other.m_frame);
     std::swap(m_error, other.m_error);
-}
\ No newline at end of file
+}
+
+int64_t frame_pts(const AVFrame* frame) noexcept
+{
+    return frame->pts != AV_NOPTS_VALUE ? frame->pts : frame->best_effort_timestamp;
+}
@@ -0,0 +1,179 @@
+#include <utility>
+
+#include "codec/av_frame_view.hpp"
+
+AVFrameView::AVFrameView() noexcept {}
+
+AVFrameView::AVFrameView(AVFrame* frame) noexcept
+{
+    take(frame);
+}
+
+AVFrameView::AVFrameView(AVFramePtr& frame) noexcept
+{
+    take(frame.get());
+}
+
+void AVFrameView::take(AVFrame* frame) noexcept
+{
+    if (!frame)
+    {
+        m_error = AVError(AVERROR(EINVAL));
+        return;
+    }
+    // 非引用计数帧或使用扩展缓冲的帧无法仅靠 buf[] 持有全部平面
+    if (!frame->buf[0] || frame->nb_extended_buf > 0)
+    {
+        m_error = AVError(AVERROR(EINVAL));
+        return;
+    }
+    for (int i = 0; i < MAX_PLANES; i++)
+    {
+        // 直接接管缓冲引用，不增加引用计数也不分配新的 AVBufferRef
+        m_buffers[i] = frame->buf[i];
+        frame->buf[i] = nullptr;
+        m_data[i] = frame->data[i];
+        m_linesize[i] = frame->linesize[i];
+    }
+    m_format = static_cast<AVPixelFormat>(frame->format);
+    m_size = { frame->width, frame->height };
+    m_pts = frame_pts(frame);
+    m_duration = frame->duration;
+    m_time_base = frame->time_base;
+    m_is_key_frame = (frame->flags & AV_FRAME_FLAG_KEY) != 0;
+    m_error = AVError(0);
+    // 释放帧内剩余的附加数据（side data 等），结构体保留给调用方复用
+    av_frame_unref(frame);
+}
+
+AVFrameView::AVFrameView(AVFrameView&& other) noexcept
+{
+    swap(other);
+}
+
+AVFrameView& AVFrameView::operator=(AVFrameView&& other) noexcept
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+    reset();
+    swap(other);
+    return *this;
+}
+
+AVFrameView::~AVFrameView() noexcept
+{
+    reset();
+}
+
+const uint8_t* AVFrameView::data(int plane) const noexcept
+{
+    if (plane < 0 || plane >= MAX_PLANES)
+    {
+        return nullptr;
+    }
+    return m_data[plane];
+}
+
+int AVFrameView::linesize(int plane) const noexcept
+{
+    if (plane < 0 || plane >= MAX_PLANES)
+    {
+        return 0;
+    }
+    return m_linesize[plane];
+}
+
+AVPixelFormat AVFrameView::format() const noexcept
+{
+    return m_format;
+}
+
+DaneJoe::Size<int> AVFrameView::size() const noexcept
+{
+    return m_size;
+}
+
+int64_t AVFrameView::pts() const noexcept
+{
+    return m_pts;
+}
+
+int64_t AVFrameView::duration() const noexcept
+{
+    return m_duration;
+}
+
+AVRational AVFrameView::time_base() const noexcept
+{
+    return m_time_base;
+}
+
+std::optional<double> AVFrameView::seconds() const noexcept
+{
+    if (m_pts == AV_NOPTS_VALUE || m_time_base.den == 0)
+    {
+        return std::nullopt;
+    }
+    return m_pts * av_q2d(m_time_base);
+}
+
+void AVFrameView::set_time_base(AVRational time_base) noexcept
+{
+    m_time_base = time_base;
+}
+
+void AVFrameView::set_timing(int64_t pts, int64_t duration, AVRational time_base) noexcept
+{
+    m_pts = pts;
+    m_duration = duration;
+    m_time_base = time_base;
+}
+
+bool AVFrameView::is_key_frame() const noexcept
+{
+    return m_is_key_frame;
+}
+
+AVError AVFrameView::get_error() const noexcept
+{
+    return m_error;
+}
+
+AVFrameView::operator bool() const noexcept
+{
+    return m_buffers[0] != nullptr;
+}
+
+void AVFrameView::reset() noexcept
+{
+    for (auto& buffer : m_buffers)
+    {
+        if (buffer)
+        {
+            av_buffer_unref(&buffer);
+        }
+    }
+    m_data.fill(nullptr);
+    m_linesize.fill(0);
+    m_format = AV_PIX_FMT_NONE;
+    m_size = { 0,0 };
+    m_pts = AV_NOPTS_VALUE;
+    m_duration = 0;
+    m_is_key_frame = false;
+}
+
+void AVFrameView::swap(AVFrameView& other) noexcept
+{
+    std::swap(m_buffers, other.m_buffers);
+    std::swap(m_data, other.m_data);
+    std::swap(m_linesize, other.m_linesize);
+    std::swap(m_format, other.m_format);
+    std::swap(m_size, other.m_size);
+    std::swap(m_pts, other.m_pts);
+    std::swap(m_duration, other.m_duration);
+    std::swap(m_time_base, other.m_time_base);
+    std::swap(m_is_key_frame, other.m_is_key_frame);
+    std::swap(m_error, other.m_error);
+}
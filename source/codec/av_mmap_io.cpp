@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cstring>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DANEJOE_HAS_MMAP 1
+#endif
+
+extern "C"
+{
+#include <libavutil/mem.h>
+}
+
+#include "codec/av_mmap_io.hpp"
+#include "util/util_log.hpp"
+
+AVMmapIO::AVMmapIO() {}
+
+AVMmapIO::~AVMmapIO()
+{
+    close();
+}
+
+AVError AVMmapIO::open(const std::string& file_path)
+{
+    close();
+#if defined(DANEJOE_HAS_MMAP)
+    int fd = ::open(file_path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return AVError(AVERROR(errno));
+    }
+    struct stat file_stat = {};
+    int error_code = fstat(fd, &file_stat) != 0 ? errno : (file_stat.st_size <= 0 ? EINVAL : 0);
+    void* data = MAP_FAILED;
+    if (error_code == 0)
+    {
+        data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        error_code = data == MAP_FAILED ? errno : 0;
+    }
+    // 映射建立后即可关闭文件描述符
+    ::close(fd);
+    if (error_code != 0)
+    {
+        DANEJOE_CLOG(WARN, IO, "AVMmapIO", "mmap {} failed: {}", file_path, std::strerror(error_code));
+        return AVError(AVERROR(error_code));
+    }
+    m_data = static_cast<const uint8_t*>(data);
+    m_size = file_stat.st_size;
+    madvise(data, m_size, MADV_SEQUENTIAL);
+    m_stats.advise_calls++;
+    advise_ahead();
+
+    uint8_t* buffer = static_cast<uint8_t*>(av_malloc(IO_BUFFER_SIZE));
+    if (buffer)
+    {
+        m_io_context = avio_alloc_context(buffer, IO_BUFFER_SIZE, 0, this, &AVMmapIO::read_packet, nullptr, &AVMmapIO::seek);
+    }
+    if (!m_io_context)
+    {
+        av_free(buffer);
+        close();
+        return AVError(AVERROR(ENOMEM));
+    }
+    return AVError(0);
+#else
+    (void)file_path;
+    return AVError(AVERROR(ENOSYS));
+#endif
+}
+
+void AVMmapIO::close()
+{
+    if (m_io_context)
+    {
+        // 缓冲区可能已被 FFmpeg 重新分配，必须通过上下文释放
+        av_freep(&m_io_context->buffer);
+        avio_context_free(&m_io_context);
+    }
+#if defined(DANEJOE_HAS_MMAP)
+    if (m_data)
+    {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_position = 0;
+    m_advised_end = 0;
+    m_stats = Stats();
+}
+
+AVIOContext* AVMmapIO::get()
+{
+    return m_io_context;
+}
+
+int64_t AVMmapIO::file_size()const
+{
+    return m_size;
+}
+
+AVMmapIO::Stats AVMmapIO::get_stats()const
+{
+    return m_stats;
+}
+
+void AVMmapIO::advise_ahead()
+{
+#if defined(DANEJOE_HAS_MMAP)
+    // 剩余预读量不足半个窗口时，再提示下一个窗口
+    if (m_advised_end - m_position > ADVISE_WINDOW / 2 || m_advised_end >= m_size)
+    {
+        return;
+    }
+    static const int64_t page_size = sysconf(_SC_PAGESIZE);
+    int64_t begin = std::max(m_position, m_advised_end) & ~(page_size - 1);
+    int64_t end = std::min(m_size, begin + ADVISE_WINDOW);
+    madvise(const_cast<uint8_t*>(m_data) + begin, end - begin, MADV_WILLNEED);
+    m_stats.advise_calls++;
+    m_advised_end = end;
+#endif
+}
+
+int AVMmapIO::read_packet(void* opaque, uint8_t* buffer, int buffer_size)
+{
+    AVMmapIO* self = static_cast<AVMmapIO*>(opaque);
+    int64_t remaining = self->m_size - self->m_position;
+    if (remaining <= 0)
+    {
+        return AVERROR_EOF;
+    }
+    int size = static_cast<int>(std::min<int64_t>(buffer_size, remaining));
+    std::memcpy(buffer, self->m_data + self->m_position, size);
+    self->m_position += size;
+    self->m_stats.read_calls++;
+    self->m_stats.bytes_read += size;
+    self->advise_ahead();
+    return size;
+}
+
+int64_t AVMmapIO::seek(void* opaque, int64_t offset, int whence)
+{
+    AVMmapIO* self = static_cast<AVMmapIO*>(opaque);
+    whence &= ~AVSEEK_FORCE;
+    if (whence == AVSEEK_SIZE)
+    {
+        return self->m_size;
+    }
+    int64_t position = 0;
+    switch (whence)
+    {
+    case SEEK_SET:
+        position = offset;
+        break;
+    case SEEK_CUR:
+        position = self->m_position + offset;
+        break;
+    case SEEK_END:
+        position = self->m_size + offset;
+        break;
+    default:
+        return AVERROR(EINVAL);
+    }
+    if (position < 0 || position > self->m_size)
+    {
+        return AVERROR(EINVAL);
+    }
+    self->m_stats.seek_calls++;
+    // 跳转后预读窗口从新位置重新开始
+    if (position < self->m_position || position > self->m_advised_end)
+    {
+        self->m_advised_end = position;
+    }
+    self->m_position = position;
+    self->advise_ahead();
+    return position;
+}
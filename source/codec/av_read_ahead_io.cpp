@@ -0,0 +1,518 @@
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+extern "C"
+{
+#include <libavutil/mem.h>
+}
+
+#include "codec/av_read_ahead_io.hpp"
+#include "util/util_log.hpp"
+
+namespace
+{
+    /// @brief 块缓冲对齐（页大小，满足 O_DIRECT 与 DMA 的对齐要求）
+    constexpr std::size_t BLOCK_ALIGNMENT = 4096;
+
+    /**
+     * @brief 所有预读实例共享的 I/O 线程池（未启用 io_uring 时使用）
+     * @details 与计算用的调度器分开，阻塞的 pread 不会占用解码线程。
+     */
+    DaneJoe::TaskScheduler& io_thread_pool()
+    {
+        static DaneJoe::TaskScheduler pool(4);
+        return pool;
+    }
+}
+
+double AVReadAheadIO::Stats::hit_rate()const
+{
+    uint64_t total = hits + misses;
+    return total > 0 ? static_cast<double>(hits) / total : 0.;
+}
+
+AVReadAheadIO::AVReadAheadIO() {}
+
+AVReadAheadIO::~AVReadAheadIO()
+{
+    close();
+}
+
+AVError AVReadAheadIO::open(const std::string& file_path)
+{
+    close();
+    m_fd = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (m_fd < 0)
+    {
+        return AVError(AVERROR(errno));
+    }
+    struct stat file_stat = {};
+    if (fstat(m_fd, &file_stat) != 0)
+    {
+        int error_code = errno;
+        close();
+        return AVError(AVERROR(error_code));
+    }
+    m_size = file_stat.st_size;
+    // 留出与窗口同样多的槽位给 seek 后尚未结束的作废请求
+    m_blocks.resize(MAX_WINDOW * 2);
+#if defined(DANEJOE_HAS_IO_URING)
+    m_is_ring_ready = io_uring_queue_init(static_cast<unsigned>(m_blocks.size() * 2), &m_ring, 0) == 0;
+    if (!m_is_ring_ready)
+    {
+        DANEJOE_CLOG(WARN, IO, "AVReadAheadIO", "io_uring unavailable, using thread pool");
+    }
+    m_stats.is_io_uring = m_is_ring_ready;
+#endif
+    uint8_t* buffer = static_cast<uint8_t*>(av_malloc(IO_BUFFER_SIZE));
+    if (buffer)
+    {
+        m_io_context = avio_alloc_context(buffer, IO_BUFFER_SIZE, 0, this, &AVReadAheadIO::read_packet, nullptr, &AVReadAheadIO::seek);
+    }
+    if (!m_io_context)
+    {
+        av_free(buffer);
+        close();
+        return AVError(AVERROR(ENOMEM));
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_rate_begin = std::chrono::steady_clock::now();
+    fill_window();
+    return AVError(0);
+}
+
+void AVReadAheadIO::close()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        cancel_all();
+        drain(lock);
+    }
+    if (m_io_context)
+    {
+        av_freep(&m_io_context->buffer);
+        avio_context_free(&m_io_context);
+    }
+    for (auto& block : m_blocks)
+    {
+        std::free(block.data);
+    }
+    m_blocks.clear();
+#if defined(DANEJOE_HAS_IO_URING)
+    if (m_is_ring_ready)
+    {
+        io_uring_queue_exit(&m_ring);
+        m_is_ring_ready = false;
+    }
+#endif
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    m_size = 0;
+    m_position = 0;
+    m_next_offset = 0;
+    m_window = INITIAL_WINDOW;
+    m_rate_blocks = 0;
+    m_has_period_miss = false;
+    m_total_latency_ms = 0.;
+    m_stats = Stats();
+}
+
+AVIOContext* AVReadAheadIO::get()
+{
+    return m_io_context;
+}
+
+int64_t AVReadAheadIO::file_size()const
+{
+    return m_size;
+}
+
+AVReadAheadIO::Stats AVReadAheadIO::get_stats()const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.window_blocks = m_window;
+    return stats;
+}
+
+AVReadAheadIO::Block* AVReadAheadIO::find_block(int64_t offset)
+{
+    for (auto& block : m_blocks)
+    {
+        if (block.state == BlockState::FREE || block.generation != m_generation)
+        {
+            continue;
+        }
+        int64_t end = block.offset + (block.state == BlockState::READY ? block.size : BLOCK_SIZE);
+        if (offset >= block.offset && offset < end)
+        {
+            return &block;
+        }
+    }
+    return nullptr;
+}
+
+void AVReadAheadIO::fill_window()
+{
+    int active = 0;
+    for (auto& block : m_blocks)
+    {
+        if (block.generation != m_generation || block.state == BlockState::FREE || block.state == BlockState::PENDING)
+        {
+            active += block.state == BlockState::PENDING && block.generation == m_generation;
+            continue;
+        }
+        // 读取位置已越过的块直接回收
+        if (block.offset + std::max<int64_t>(block.size, 1) <= m_position)
+        {
+            block.state = BlockState::FREE;
+            continue;
+        }
+        active++;
+    }
+    for (auto& block : m_blocks)
+    {
+        if (active >= m_window || m_next_offset >= m_size)
+        {
+            break;
+        }
+        if (block.state != BlockState::FREE)
+        {
+            continue;
+        }
+        issue(block, m_next_offset);
+        m_next_offset += BLOCK_SIZE;
+        active++;
+    }
+}
+
+void AVReadAheadIO::issue(Block& block, int64_t offset)
+{
+    block.offset = offset;
+    block.size = 0;
+    block.error = 0;
+    block.generation = m_generation;
+    block.is_touched = false;
+    block.is_miss = false;
+    if (!block.data)
+    {
+        block.data = static_cast<uint8_t*>(std::aligned_alloc(BLOCK_ALIGNMENT, BLOCK_SIZE));
+    }
+    if (!block.data)
+    {
+        block.state = BlockState::FAILED;
+        block.error = AVERROR(ENOMEM);
+        return;
+    }
+    block.state = BlockState::PENDING;
+    block.issued_at = std::chrono::steady_clock::now();
+    m_in_flight++;
+    m_stats.reads_issued++;
+    int64_t length = std::min(BLOCK_SIZE, m_size - offset);
+#if defined(DANEJOE_HAS_IO_URING)
+    if (m_is_ring_ready)
+    {
+        io_uring_sqe* sqe = io_uring_get_sqe(&m_ring);
+        if (!sqe)
+        {
+            // 提交队列容量为槽位数的两倍，正常情况下不会用尽
+            complete(block, -EBUSY);
+            return;
+        }
+        io_uring_prep_read(sqe, m_fd, block.data, static_cast<unsigned>(length), static_cast<uint64_t>(offset));
+        io_uring_sqe_set_data(sqe, &block);
+        io_uring_submit(&m_ring);
+        return;
+    }
+#endif
+    Block* target = &block;
+    int fd = m_fd;
+    DaneJoe::CancellationToken token = m_cancel_token;
+    io_thread_pool().submit([this, target, fd, offset, length, token]()
+        {
+            int64_t result = -ECANCELED;
+            if (!token.is_cancelled())
+            {
+                result = 0;
+                while (result < length)
+                {
+                    ssize_t count = pread(fd, target->data + result, length - result, offset + result);
+                    if (count < 0 && errno == EINTR)
+                    {
+                        continue;
+                    }
+                    if (count < 0)
+                    {
+                        result = -errno;
+                        break;
+                    }
+                    if (count == 0)
+                    {
+                        break;
+                    }
+                    result += count;
+                }
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            complete(*target, result);
+            m_condition.notify_all();
+        }, DaneJoe::TaskPriority::HIGH);
+}
+
+void AVReadAheadIO::complete(Block& block, int64_t result)
+{
+    m_in_flight--;
+    if (block.generation != m_generation || result == -ECANCELED)
+    {
+        block.state = BlockState::FREE;
+        m_stats.reads_cancelled++;
+        return;
+    }
+    double latency_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - block.issued_at).count();
+    m_stats.reads_completed++;
+    m_total_latency_ms += latency_ms;
+    m_stats.average_latency_ms = m_total_latency_ms / m_stats.reads_completed;
+    m_stats.max_latency_ms = std::max(m_stats.max_latency_ms, latency_ms);
+    if (result < 0)
+    {
+        block.state = BlockState::FAILED;
+        block.error = static_cast<int>(result);
+        return;
+    }
+    block.size = result;
+    block.state = BlockState::READY;
+}
+
+void AVReadAheadIO::wait_ready(Block& block, std::unique_lock<std::mutex>& lock)
+{
+    while (block.state == BlockState::PENDING)
+    {
+#if defined(DANEJOE_HAS_IO_URING)
+        if (m_is_ring_ready)
+        {
+            // io_uring 模式下完成事件只在本线程收割，持锁等待不会阻塞其他线程
+            reap(true);
+            continue;
+        }
+#endif
+        m_condition.wait(lock);
+    }
+}
+
+void AVReadAheadIO::cancel_all()
+{
+    m_generation++;
+    m_cancel_token.cancel();
+    m_cancel_token = DaneJoe::CancellationToken();
+#if defined(DANEJOE_HAS_IO_URING)
+    bool has_cancel_request = false;
+#endif
+    for (auto& block : m_blocks)
+    {
+        if (block.state != BlockState::PENDING)
+        {
+            block.state = BlockState::FREE;
+            continue;
+        }
+#if defined(DANEJOE_HAS_IO_URING)
+        // 在途请求完成（或被取消）后由 complete 回收
+        if (m_is_ring_ready)
+        {
+            io_uring_sqe* sqe = io_uring_get_sqe(&m_ring);
+            if (sqe)
+            {
+                io_uring_prep_cancel64(sqe, reinterpret_cast<uint64_t>(&block), 0);
+                io_uring_sqe_set_data(sqe, nullptr);
+                has_cancel_request = true;
+            }
+        }
+#endif
+    }
+#if defined(DANEJOE_HAS_IO_URING)
+    if (has_cancel_request)
+    {
+        io_uring_submit(&m_ring);
+    }
+#endif
+}
+
+void AVReadAheadIO::drain(std::unique_lock<std::mutex>& lock)
+{
+    while (m_in_flight > 0)
+    {
+#if defined(DANEJOE_HAS_IO_URING)
+        if (m_is_ring_ready)
+        {
+            reap(true);
+            continue;
+        }
+#endif
+        m_condition.wait(lock);
+    }
+}
+
+#if defined(DANEJOE_HAS_IO_URING)
+void AVReadAheadIO::reap(bool is_wait)
+{
+    io_uring_cqe* cqe = nullptr;
+    int ret = is_wait ? io_uring_wait_cqe(&m_ring, &cqe) : io_uring_peek_cqe(&m_ring, &cqe);
+    while (ret == 0 && cqe)
+    {
+        Block* block = static_cast<Block*>(io_uring_cqe_get_data(cqe));
+        int64_t result = cqe->res;
+        io_uring_cqe_seen(&m_ring, cqe);
+        // 取消请求自身的完成事件不携带块
+        if (block)
+        {
+            complete(*block, result);
+        }
+        ret = io_uring_peek_cqe(&m_ring, &cqe);
+    }
+}
+#endif
+
+void AVReadAheadIO::adapt_window(bool is_miss)
+{
+    // 缺块说明窗口不足，立即扩大
+    if (is_miss)
+    {
+        m_window = std::min(MAX_WINDOW, m_window + 1);
+    }
+    m_rate_blocks++;
+    if (m_rate_blocks < RATE_PERIOD_BLOCKS)
+    {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - m_rate_begin).count();
+    if (seconds > 0.)
+    {
+        // 窗口需覆盖两倍读延迟内的消费量
+        double bytes_per_second = m_rate_blocks * static_cast<double>(BLOCK_SIZE) / seconds;
+        double latency_seconds = m_stats.average_latency_ms / 1000.;
+        int target = static_cast<int>(std::ceil(bytes_per_second * latency_seconds * 2. / BLOCK_SIZE)) + 1;
+        if (target > m_window)
+        {
+            m_window = target;
+        }
+        else if (target < m_window && !m_has_period_miss)
+        {
+            m_window--;
+        }
+        m_window = std::clamp(m_window, MIN_WINDOW, MAX_WINDOW);
+    }
+    m_rate_begin = now;
+    m_rate_blocks = 0;
+    m_has_period_miss = false;
+}
+
+int AVReadAheadIO::read_packet(void* opaque, uint8_t* buffer, int buffer_size)
+{
+    AVReadAheadIO* self = static_cast<AVReadAheadIO*>(opaque);
+    std::unique_lock<std::mutex> lock(self->m_mutex);
+#if defined(DANEJOE_HAS_IO_URING)
+    if (self->m_is_ring_ready)
+    {
+        self->reap(false);
+    }
+#endif
+    if (self->m_position >= self->m_size)
+    {
+        return AVERROR_EOF;
+    }
+    Block* block = self->find_block(self->m_position);
+    if (!block)
+    {
+        // 读取位置不在预读范围内：从所在块重新开始预读，槽位被作废请求占满时先等待其结束
+        self->m_next_offset = self->m_position & ~(BLOCK_SIZE - 1);
+        self->fill_window();
+        block = self->find_block(self->m_position);
+        if (!block)
+        {
+            self->drain(lock);
+            self->fill_window();
+            block = self->find_block(self->m_position);
+        }
+        if (!block)
+        {
+            return AVERROR(ENOMEM);
+        }
+    }
+    if (!block->is_touched)
+    {
+        block->is_touched = true;
+        block->is_miss = block->state == BlockState::PENDING;
+        block->is_miss ? self->m_stats.misses++ : self->m_stats.hits++;
+        self->m_has_period_miss = self->m_has_period_miss || block->is_miss;
+    }
+    self->wait_ready(*block, lock);
+    if (block->state == BlockState::FAILED)
+    {
+        return block->error;
+    }
+    int64_t available = block->offset + block->size - self->m_position;
+    if (available <= 0)
+    {
+        return AVERROR_EOF;
+    }
+    int size = static_cast<int>(std::min<int64_t>(buffer_size, available));
+    std::memcpy(buffer, block->data + (self->m_position - block->offset), size);
+    self->m_position += size;
+    if (self->m_position >= block->offset + block->size)
+    {
+        block->state = BlockState::FREE;
+        self->adapt_window(block->is_miss);
+    }
+    self->fill_window();
+    return size;
+}
+
+int64_t AVReadAheadIO::seek(void* opaque, int64_t offset, int whence)
+{
+    AVReadAheadIO* self = static_cast<AVReadAheadIO*>(opaque);
+    std::lock_guard<std::mutex> lock(self->m_mutex);
+    whence &= ~AVSEEK_FORCE;
+    if (whence == AVSEEK_SIZE)
+    {
+        return self->m_size;
+    }
+    int64_t position = 0;
+    switch (whence)
+    {
+    case SEEK_SET:
+        position = offset;
+        break;
+    case SEEK_CUR:
+        position = self->m_position + offset;
+        break;
+    case SEEK_END:
+        position = self->m_size + offset;
+        break;
+    default:
+        return AVERROR(EINVAL);
+    }
+    if (position < 0 || position > self->m_size)
+    {
+        return AVERROR(EINVAL);
+    }
+    // 目标仍在预读范围内时只移动读取位置，否则作废整个窗口
+    if (!self->find_block(position) && !(position >= self->m_position && position < self->m_next_offset))
+    {
+        self->m_stats.seeks++;
+        self->cancel_all();
+        self->m_next_offset = position & ~(BLOCK_SIZE - 1);
+    }
+    self->m_position = position;
+    self->fill_window();
+    return position;
+}
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <atomic>
+
+#include "codec/av_shared_execute.hpp"
+#include "util/util_task_scheduler.hpp"
+
+namespace
+{
+    /**
+     * @brief execute 回调：各任务相互独立，按原子计数领取
+     */
+    int shared_execute(AVCodecContext* codec_context, int (*func)(AVCodecContext* context, void* arg), void* arg, int* ret, int count, int size)
+    {
+        DaneJoe::TaskScheduler& scheduler = DaneJoe::TaskScheduler::get_instance();
+        std::size_t lanes = std::min<std::size_t>(count, scheduler.worker_count() + 1);
+        std::atomic<int> next_job = 0;
+        scheduler.parallel_for(lanes, [&](std::size_t)
+            {
+                for (int job = next_job.fetch_add(1, std::memory_order_relaxed); job < count; job = next_job.fetch_add(1, std::memory_order_relaxed))
+                {
+                    int result = func(codec_context, static_cast<char*>(arg) + static_cast<std::size_t>(job) * size);
+                    if (ret)
+                    {
+                        ret[job] = result;
+                    }
+                }
+            });
+        return 0;
+    }
+
+    /**
+     * @brief execute2 回调：每条通道使用固定的 threadnr
+     */
+    int shared_execute2(AVCodecContext* codec_context, int (*func)(AVCodecContext* context, void* arg, int jobnr, int threadnr), void* arg, int* ret, int count)
+    {
+        DaneJoe::TaskScheduler& scheduler = DaneJoe::TaskScheduler::get_instance();
+        std::size_t lanes = std::min<std::size_t>({ static_cast<std::size_t>(count), static_cast<std::size_t>(std::max(1, codec_context->thread_count)), scheduler.worker_count() + 1 });
+        std::atomic<int> next_job = 0;
+        scheduler.parallel_for(lanes, [&](std::size_t lane)
+            {
+                for (int job = next_job.fetch_add(1, std::memory_order_relaxed); job < count; job = next_job.fetch_add(1, std::memory_order_relaxed))
+                {
+                    int result = func(codec_context, arg, job, static_cast<int>(lane));
+                    if (ret)
+                    {
+                        ret[job] = result;
+                    }
+                }
+            });
+        return 0;
+    }
+
+    /**
+     * @brief 滤镜图 execute 回调：任务相互独立，按原子计数领取
+     */
+    int shared_filter_execute(AVFilterContext* filter_context, avfilter_action_func* func, void* arg, int* ret, int nb_jobs)
+    {
+        DaneJoe::TaskScheduler& scheduler = DaneJoe::TaskScheduler::get_instance();
+        std::size_t lanes = std::min<std::size_t>(nb_jobs, scheduler.worker_count() + 1);
+        std::atomic<int> next_job = 0;
+        scheduler.parallel_for(lanes, [&](std::size_t)
+            {
+                for (int job = next_job.fetch_add(1, std::memory_order_relaxed); job < nb_jobs; job = next_job.fetch_add(1, std::memory_order_relaxed))
+                {
+                    int result = func(filter_context, arg, job, nb_jobs);
+                    if (ret)
+                    {
+                        ret[job] = result;
+                    }
+                }
+            });
+        return 0;
+    }
+}
+
+void prepare_shared_execute(AVCodecContext* codec_context)
+{
+    codec_context->thread_type = FF_THREAD_SLICE;
+    codec_context->thread_count = static_cast<int>(DaneJoe::TaskScheduler::get_instance().worker_count());
+}
+
+void install_shared_execute(AVCodecContext* codec_context)
+{
+    codec_context->execute = shared_execute;
+    codec_context->execute2 = shared_execute2;
+}
+
+void install_shared_filter_execute(AVFilterGraph* graph)
+{
+    graph->thread_type = AVFILTER_THREAD_SLICE;
+    graph->nb_threads = static_cast<int>(DaneJoe::TaskScheduler::get_instance().worker_count() + 1);
+    graph->execute = shared_filter_execute;
+}
@@ -0,0 +1,212 @@
+#include <string>
+
+extern "C"
+{
+#include <libavfilter/buffersink.h>
+#include <libavfilter/buffersrc.h>
+#include <libavutil/mem.h>
+}
+
+#include "codec/av_video_filter.hpp"
+#include "codec/av_shared_execute.hpp"
+
+bool AVVideoFilter::InputParameters::operator==(const InputParameters& other)const
+{
+    return width == other.width && height == other.height && format == other.format
+        && av_cmp_q(sample_aspect_ratio, other.sample_aspect_ratio) == 0
+        && av_cmp_q(time_base, other.time_base) == 0;
+}
+
+AVVideoFilter::AVVideoFilter(const Options& options) :m_options(options)
+{
+    if (m_options.description.empty())
+    {
+        m_options.description = "null";
+    }
+}
+
+AVVideoFilter::~AVVideoFilter()
+{
+    free_graph();
+}
+
+void AVVideoFilter::free_graph()
+{
+    if (m_graph)
+    {
+        avfilter_graph_free(&m_graph);
+    }
+    m_graph = nullptr;
+    m_source = nullptr;
+    m_sink = nullptr;
+    m_parameters.reset();
+}
+
+AVError AVVideoFilter::build(const InputParameters& parameters)
+{
+    free_graph();
+    m_graph = avfilter_graph_alloc();
+    if (!m_graph)
+    {
+        return AVError(AVERROR(ENOMEM));
+    }
+    // 须在添加滤镜之前设置，滤镜创建时读取图的线程实现
+    if (m_options.is_use_shared_thread_pool)
+    {
+        install_shared_filter_execute(m_graph);
+    }
+    AVRational sample_aspect_ratio = parameters.sample_aspect_ratio.num > 0 ? parameters.sample_aspect_ratio : AVRational{ 1, 1 };
+    std::string arguments = "video_size=" + std::to_string(parameters.width) + "x" + std::to_string(parameters.height)
+        + ":pix_fmt=" + std::to_string(parameters.format)
+        + ":time_base=" + std::to_string(parameters.time_base.num) + "/" + std::to_string(parameters.time_base.den)
+        + ":pixel_aspect=" + std::to_string(sample_aspect_ratio.num) + "/" + std::to_string(sample_aspect_ratio.den);
+    AVError error = avfilter_graph_create_filter(&m_source, avfilter_get_by_name("buffer"), "in", arguments.c_str(), nullptr, m_graph);
+    if (error.failed())
+    {
+        free_graph();
+        return error;
+    }
+    error = avfilter_graph_create_filter(&m_sink, avfilter_get_by_name("buffersink"), "out", nullptr, nullptr, m_graph);
+    if (error.failed())
+    {
+        free_graph();
+        return error;
+    }
+    // 描述的输入端接 buffer 源，输出端接 buffersink
+    AVFilterInOut* outputs = avfilter_inout_alloc();
+    AVFilterInOut* inputs = avfilter_inout_alloc();
+    if (!outputs || !inputs)
+    {
+        avfilter_inout_free(&outputs);
+        avfilter_inout_free(&inputs);
+        free_graph();
+        return AVError(AVERROR(ENOMEM));
+    }
+    outputs->name = av_strdup("in");
+    outputs->filter_ctx = m_source;
+    outputs->pad_idx = 0;
+    outputs->next = nullptr;
+    inputs->name = av_strdup("out");
+    inputs->filter_ctx = m_sink;
+    inputs->pad_idx = 0;
+    inputs->next = nullptr;
+    error = avfilter_graph_parse_ptr(m_graph, m_options.description.c_str(), &inputs, &outputs, nullptr);
+    avfilter_inout_free(&outputs);
+    avfilter_inout_free(&inputs);
+    if (error.failed())
+    {
+        free_graph();
+        return error;
+    }
+    error = avfilter_graph_config(m_graph, nullptr);
+    if (error.failed())
+    {
+        free_graph();
+        return error;
+    }
+    m_parameters = parameters;
+    m_build_count++;
+    return AVError(0);
+}
+
+void AVVideoFilter::drain()
+{
+    if (!m_graph)
+    {
+        return;
+    }
+    if (av_buffersrc_add_frame_flags(m_source, nullptr, 0) < 0)
+    {
+        return;
+    }
+    while (true)
+    {
+        AVFramePtr frame;
+        if (frame.ensure_allocated().failed() || av_buffersink_get_frame(m_sink, frame.get()) < 0)
+        {
+            break;
+        }
+        frame->time_base = av_buffersink_get_time_base(m_sink);
+        m_pending.push_back(std::move(frame));
+    }
+}
+
+AVError AVVideoFilter::send_frame(AVFramePtr& frame)
+{
+    if (!frame)
+    {
+        return AVError(AVERROR(EINVAL));
+    }
+    if (m_is_eof_sent)
+    {
+        return AVError(AVERROR_EOF);
+    }
+    InputParameters parameters;
+    parameters.width = frame->width;
+    parameters.height = frame->height;
+    parameters.format = frame->format;
+    parameters.sample_aspect_ratio = frame->sample_aspect_ratio;
+    parameters.time_base = frame->time_base;
+    if (!m_parameters || !(*m_parameters == parameters))
+    {
+        drain();
+        AVError error = build(parameters);
+        if (error.failed())
+        {
+            return error;
+        }
+    }
+    // 不带 KEEP_REF：帧的缓冲引用直接移交给滤镜图，frame 被重置
+    return AVError(av_buffersrc_add_frame_flags(m_source, frame.get(), AV_BUFFERSRC_FLAG_NO_CHECK_FORMAT));
+}
+
+AVError AVVideoFilter::send_eof()
+{
+    if (m_is_eof_sent)
+    {
+        return AVError(0);
+    }
+    m_is_eof_sent = true;
+    if (!m_graph)
+    {
+        return AVError(0);
+    }
+    return AVError(av_buffersrc_add_frame_flags(m_source, nullptr, 0));
+}
+
+AVError AVVideoFilter::receive_frame(AVFramePtr& frame)
+{
+    if (!m_pending.empty())
+    {
+        frame = std::move(m_pending.front());
+        m_pending.pop_front();
+        return AVError(0);
+    }
+    if (!m_graph)
+    {
+        return AVError(m_is_eof_sent ? AVERROR_EOF : AVERROR(EAGAIN));
+    }
+    AVError error = frame.ensure_allocated();
+    if (error.failed())
+    {
+        return error;
+    }
+    frame.unref();
+    error = av_buffersink_get_frame(m_sink, frame.get());
+    if (error.failed())
+    {
+        return error;
+    }
+    frame->time_base = av_buffersink_get_time_base(m_sink);
+    return AVError(0);
+}
+
+const std::string& AVVideoFilter::description()const
+{
+    return m_options.description;
+}
+
+uint64_t AVVideoFilter::build_count()const
+{
+    return m_build_count;
+}
@@ -0,0 +1,30 @@
+#include "codec/i_av_io.hpp"
+#include "codec/av_mmap_io.hpp"
+#include "codec/av_read_ahead_io.hpp"
+
+std::unique_ptr<IAVIO> create_av_io(AVIOBackend backend)
+{
+    switch (backend)
+    {
+    case AVIOBackend::MMAP:
+        return std::make_unique<AVMmapIO>();
+    case AVIOBackend::READ_AHEAD:
+        return std::make_unique<AVReadAheadIO>();
+    case AVIOBackend::DEFAULT:
+    default:
+        return nullptr;
+    }
+}
+
+AVIOBackend parse_av_io_backend(const std::string& name)
+{
+    if (name == "mmap")
+    {
+        return AVIOBackend::MMAP;
+    }
+    if (name == "readahead")
+    {
+        return AVIOBackend::READ_AHEAD;
+    }
+    return AVIOBackend::DEFAULT;
+}
@@ -0,0 +1,442 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+extern "C"
+{
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/imgutils.h>
+}
+
+#include "main/batch_processor.hpp"
+#include "codec/av_packet_ptr.hpp"
+#include "codec/av_frame_ptr.hpp"
+#include "codec/av_frame_view.hpp"
+#include "codec/av_format_context_ptr.hpp"
+#include "codec/av_codec_context_ptr.hpp"
+#include "util/util_log.hpp"
+
+namespace
+{
+    /// @brief 各 GOP 解码任务共享的解码参数
+    using CodecParametersPtr = std::shared_ptr<const AVCodecParameters>;
+
+    /// @brief 每个文件最多在途（已切分未解码完）的 GOP 数
+    constexpr std::size_t MAX_INFLIGHT_GOPS = 4;
+    /// @brief 每个文件最多在途（已解码未后处理）的帧数
+    constexpr std::size_t MAX_INFLIGHT_FRAMES = 8;
+
+    /**
+     * @struct FileJob
+     * @brief 单个文件在各级任务间共享的状态
+     */
+    struct FileJob
+    {
+        /// @brief 文件路径
+        std::string file_path;
+        /// @brief 打开或解复用错误（仅由解复用任务写入）
+        AVError error;
+        /// @brief 视频流解码参数
+        CodecParametersPtr codec_parameters;
+        /// @brief 视频流时间基
+        AVRational time_base = { 0, 1 };
+        /// @brief GOP 数
+        std::atomic<uint64_t> gops = 0;
+        /// @brief 解码帧数
+        std::atomic<uint64_t> frames = 0;
+        /// @brief 无法独立解码的数据包数
+        std::atomic<uint64_t> undecodable_packets = 0;
+        /// @brief 数据包字节数
+        std::atomic<uint64_t> bytes = 0;
+        /// @brief 帧校验和（按加法累积，与执行顺序无关）
+        std::atomic<uint64_t> checksum = 0;
+        /// @brief 在途 GOP 数
+        std::atomic<std::size_t> inflight_gops = 0;
+        /// @brief 在途帧数
+        std::atomic<std::size_t> inflight_frames = 0;
+        /// @brief 解复用因在途 GOP 达到上限而挂起，由腾出名额的解码任务恢复
+        std::atomic<bool> is_demux_parked = false;
+        /// @brief 解复用上下文（同一时刻只有一个解复用任务访问）
+        AVFormatContextPtr format_context;
+        /// @brief 视频流索引
+        int stream_index = -1;
+        /// @brief 尚未切分完的 GOP
+        std::vector<AVPacketPtr> gop;
+    };
+
+    void demux_gops(DaneJoe::TaskScheduler& scheduler, DaneJoe::TaskGroup& group, std::shared_ptr<FileJob> job);
+
+    CodecParametersPtr copy_codec_parameters(const AVCodecParameters* source)
+    {
+        AVCodecParameters* parameters = avcodec_parameters_alloc();
+        if (!parameters)
+        {
+            return nullptr;
+        }
+        if (avcodec_parameters_copy(parameters, source) < 0)
+        {
+            avcodec_parameters_free(&parameters);
+            return nullptr;
+        }
+        return CodecParametersPtr(parameters, [](const AVCodecParameters* parameters)
+            {
+                AVCodecParameters* owned = const_cast<AVCodecParameters*>(parameters);
+                avcodec_parameters_free(&owned);
+            });
+    }
+
+    /**
+     * @brief 后处理：对亮度平面可见区域做 FNV-1a 哈希并混入时间戳
+     */
+    void process_frame(FileJob& job, const AVFrameView& frame)
+    {
+        const uint64_t FNV_OFFSET = 14695981039346656037ull;
+        const uint64_t FNV_PRIME = 1099511628211ull;
+        uint64_t hash = FNV_OFFSET;
+        int row_bytes = av_image_get_linesize(frame.format(), frame.size().x, 0);
+        row_bytes = std::min(row_bytes, frame.linesize(0));
+        const uint8_t* row = frame.data(0);
+        for (int y = 0; row && row_bytes > 0 && y < frame.size().y; y++, row += frame.linesize(0))
+        {
+            for (int x = 0; x < row_bytes; x++)
+            {
+                hash = (hash ^ row[x]) * FNV_PRIME;
+            }
+        }
+        hash ^= static_cast<uint64_t>(frame.pts()) * FNV_PRIME;
+        job.checksum.fetch_add(hash, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 解码一个 GOP，每个输出帧提交为后处理任务
+     * @details 该文件在途帧达到 MAX_INFLIGHT_FRAMES 时直接在本线程后处理，限制缓存的帧数。
+     */
+    void decode_gop(DaneJoe::TaskScheduler& scheduler, DaneJoe::TaskGroup& group, std::shared_ptr<FileJob> job, std::vector<AVPacketPtr> packets)
+    {
+        const AVCodec* codec = avcodec_find_decoder(job->codec_parameters->codec_id);
+        AVCodecContextPtr codec_context;
+        codec_context.alloc_context3(codec);
+        if (!codec || !codec_context)
+        {
+            job->undecodable_packets.fetch_add(packets.size(), std::memory_order_relaxed);
+            return;
+        }
+        AVError error = codec_context.parameters_to_context(job->codec_parameters.get());
+        if (error.ok())
+        {
+            // 并行度来自 GOP 之间，单个解码器只用一个线程
+            codec_context->thread_count = 1;
+            codec_context->pkt_timebase = job->time_base;
+            error = codec_context.open2(codec, nullptr);
+        }
+        AVFramePtr frame;
+        if (error.ok())
+        {
+            error = frame.ensure_allocated();
+        }
+        if (error.failed())
+        {
+            DANEJOE_CLOG(WARN, APP, "BatchProcessor", "Failed to open decoder for {}: {}", job->file_path, error.message());
+            job->undecodable_packets.fetch_add(packets.size(), std::memory_order_relaxed);
+            return;
+        }
+        auto drain = [&]()
+            {
+                while (codec_context.receive_frame(frame).ok())
+                {
+                    AVFrameView frame_view(frame);
+                    if (!frame_view)
+                    {
+                        continue;
+                    }
+                    frame_view.set_time_base(job->time_base);
+                    job->frames.fetch_add(1, std::memory_order_relaxed);
+                    if (job->inflight_frames.load(std::memory_order_acquire) >= MAX_INFLIGHT_FRAMES)
+                    {
+                        process_frame(*job, frame_view);
+                        continue;
+                    }
+                    job->inflight_frames.fetch_add(1, std::memory_order_relaxed);
+                    scheduler.submit(group, [job, frame_view = std::move(frame_view)]()
+                        {
+                            process_frame(*job, frame_view);
+                            job->inflight_frames.fetch_sub(1, std::memory_order_release);
+                        }, DaneJoe::TaskPriority::HIGH);
+                }
+            };
+        for (auto& packet : packets)
+        {
+            if (group.is_cancelled())
+            {
+                return;
+            }
+            error = codec_context.send_packet(packet);
+            if (error == AVERROR(EAGAIN))
+            {
+                drain();
+                error = codec_context.send_packet(packet);
+            }
+            if (error.failed())
+            {
+                job->undecodable_packets.fetch_add(1, std::memory_order_relaxed);
+            }
+            packet.reset();
+            drain();
+        }
+        codec_context.send_packet(nullptr);
+        drain();
+    }
+
+    /**
+     * @brief 提交一个 GOP 的解码任务，完成后若解复用已挂起则恢复它
+     */
+    void submit_gop(DaneJoe::TaskScheduler& scheduler, DaneJoe::TaskGroup& group, std::shared_ptr<FileJob> job, std::vector<AVPacketPtr> gop)
+    {
+        job->gops.fetch_add(1, std::memory_order_relaxed);
+        job->inflight_gops.fetch_add(1);
+        scheduler.submit(group, [&scheduler, &group, job, gop = std::move(gop)]() mutable
+            {
+                decode_gop(scheduler, group, job, std::move(gop));
+                job->inflight_gops.fetch_sub(1);
+                if (job->is_demux_parked.exchange(false))
+                {
+                    scheduler.submit(group, [&scheduler, &group, job]()
+                        {
+                            demux_gops(scheduler, group, job);
+                        }, DaneJoe::TaskPriority::LOW);
+                }
+            }, DaneJoe::TaskPriority::NORMAL);
+    }
+
+    /**
+     * @brief 继续读取数据包，按关键帧切分 GOP 并提交解码任务
+     * @details 在途 GOP 达到 MAX_INFLIGHT_GOPS 时挂起（任务返回，不占用工作线程），
+     *          由之后完成的解码任务重新提交，限制缓存的数据包数量。
+     */
+    void demux_gops(DaneJoe::TaskScheduler& scheduler, DaneJoe::TaskGroup& group, std::shared_ptr<FileJob> job)
+    {
+        while (!group.is_cancelled())
+        {
+            if (job->inflight_gops.load() >= MAX_INFLIGHT_GOPS)
+            {
+                job->is_demux_parked.store(true);
+                // 挂起后再检查一次：期间若有解码任务完成却没看到挂起标记，由本任务收回标记继续读取
+                if (job->inflight_gops.load() >= MAX_INFLIGHT_GOPS || !job->is_demux_parked.exchange(false))
+                {
+                    return;
+                }
+            }
+            AVPacketPtr packet;
+            AVError error = packet.ensure_allocated();
+            if (error.ok())
+            {
+                error = job->format_context.read_frame(packet);
+            }
+            if (error == AVERROR_EOF)
+            {
+                break;
+            }
+            if (error.failed())
+            {
+                job->error = error;
+                break;
+            }
+            if (packet->stream_index != job->stream_index)
+            {
+                continue;
+            }
+            job->bytes.fetch_add(packet->size, std::memory_order_relaxed);
+            if ((packet->flags & AV_PKT_FLAG_KEY) && !job->gop.empty())
+            {
+                submit_gop(scheduler, group, job, std::move(job->gop));
+                job->gop.clear();
+            }
+            job->gop.push_back(std::move(packet));
+        }
+        if (!job->gop.empty() && !group.is_cancelled())
+        {
+            submit_gop(scheduler, group, job, std::move(job->gop));
+            job->gop.clear();
+        }
+        job->format_context.close_input();
+    }
+
+    /**
+     * @brief 打开一个文件并开始解复用
+     */
+    void demux_file(DaneJoe::TaskScheduler& scheduler, DaneJoe::TaskGroup& group, std::shared_ptr<FileJob> job)
+    {
+        job->error = job->format_context.open_input(job->file_path, nullptr, nullptr);
+        if (job->error.ok())
+        {
+            job->error = job->format_context.find_stream_info(nullptr);
+        }
+        if (job->error.failed())
+        {
+            DANEJOE_CLOG(WARN, APP, "BatchProcessor", "Failed to open {}: {}", job->file_path, job->error.message());
+            return;
+        }
+        job->stream_index = av_find_best_stream(job->format_context.get(), AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+        if (job->stream_index < 0)
+        {
+            job->error = AVError(job->stream_index);
+            return;
+        }
+        AVStream* stream = job->format_context->streams[job->stream_index];
+        job->codec_parameters = copy_codec_parameters(stream->codecpar);
+        job->time_base = stream->time_base;
+        if (!job->codec_parameters)
+        {
+            job->error = AVError(AVERROR(ENOMEM));
+            return;
+        }
+        demux_gops(scheduler, group, job);
+    }
+}
+
+BatchProcessor::BatchProcessor(DaneJoe::TaskScheduler& scheduler) :m_scheduler(scheduler) {}
+
+std::vector<BatchProcessor::FileResult> BatchProcessor::run(const std::vector<std::string>& file_paths, DaneJoe::CancellationToken token)
+{
+    DaneJoe::TaskGroup group(token);
+    std::vector<std::shared_ptr<FileJob>> jobs;
+    for (const auto& file_path : file_paths)
+    {
+        auto job = std::make_shared<FileJob>();
+        job->file_path = file_path;
+        jobs.push_back(job);
+        m_scheduler.submit(group, [this, &group, job]()
+            {
+                demux_file(m_scheduler, group, job);
+            }, DaneJoe::TaskPriority::LOW);
+    }
+    m_scheduler.wait(group);
+
+    std::vector<FileResult> results;
+    for (const auto& job : jobs)
+    {
+        FileResult result;
+        result.file_path = job->file_path;
+        result.error = job->error;
+        result.gops = job->gops.load();
+        result.frames = job->frames.load();
+        result.undecodable_packets = job->undecodable_packets.load();
+        result.bytes = job->bytes.load();
+        result.checksum = job->checksum.load();
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+std::vector<std::string> collect_media_files(const std::vector<std::string>& inputs)
+{
+    std::vector<std::string> file_paths;
+    for (const auto& input : inputs)
+    {
+        std::error_code error_code;
+        if (!std::filesystem::is_directory(input, error_code))
+        {
+            file_paths.push_back(input);
+            continue;
+        }
+        std::vector<std::string> directory_files;
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(input, error_code))
+        {
+            if (entry.is_regular_file())
+            {
+                directory_files.push_back(entry.path().string());
+            }
+        }
+        std::sort(directory_files.begin(), directory_files.end());
+        file_paths.insert(file_paths.end(), directory_files.begin(), directory_files.end());
+    }
+    return file_paths;
+}
+
+int run_batch_benchmark(const std::vector<std::string>& inputs, int repeat)
+{
+    std::vector<std::string> corpus = collect_media_files(inputs);
+    if (corpus.empty() || repeat <= 0)
+    {
+        DANEJOE_CLOG(ERROR, APP, "BatchBenchmark", "Invalid arguments");
+        return -1;
+    }
+    std::vector<std::string> file_paths;
+    for (int i = 0; i < repeat; i++)
+    {
+        file_paths.insert(file_paths.end(), corpus.begin(), corpus.end());
+    }
+    std::size_t core_count = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::size_t> worker_counts;
+    for (std::size_t count = 1; count < core_count; count *= 2)
+    {
+        worker_counts.push_back(count);
+    }
+    worker_counts.push_back(core_count);
+
+    // 预热一轮，使各轮都从页缓存读取，避免首轮被磁盘 I/O 拖慢
+    uint64_t expected_checksum = 0;
+    {
+        DaneJoe::TaskScheduler scheduler(core_count);
+        BatchProcessor processor(scheduler);
+        for (const auto& result : processor.run(file_paths))
+        {
+            expected_checksum += result.checksum;
+            if (result.error.failed())
+            {
+                std::cout << "skip " << result.file_path << ": " << result.error.message() << "\n";
+            }
+        }
+    }
+
+    std::cout << "files: " << file_paths.size() << " (" << corpus.size() << " x " << repeat << "), cores: " << core_count << "\n";
+    std::cout << std::setw(8) << "workers" << std::setw(10) << "seconds" << std::setw(10) << "files/s"
+        << std::setw(12) << "frames/s" << std::setw(10) << "speedup" << std::setw(12) << "efficiency"
+        << std::setw(10) << "tasks" << std::setw(10) << "stolen" << "\n";
+    double baseline_seconds = 0.;
+    bool is_consistent = true;
+    for (std::size_t worker_count : worker_counts)
+    {
+        DaneJoe::TaskScheduler scheduler(worker_count);
+        BatchProcessor processor(scheduler);
+        auto begin = std::chrono::steady_clock::now();
+        std::vector<BatchProcessor::FileResult> results = processor.run(file_paths);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        uint64_t frames = 0;
+        uint64_t checksum = 0;
+        for (const auto& result : results)
+        {
+            frames += result.frames;
+            checksum += result.checksum;
+        }
+        is_consistent = is_consistent && checksum == expected_checksum;
+        if (baseline_seconds <= 0.)
+        {
+            baseline_seconds = seconds;
+        }
+        double speedup = seconds > 0. ? baseline_seconds / seconds : 0.;
+        DaneJoe::TaskScheduler::Stats stats = scheduler.get_stats();
+        std::cout << std::fixed << std::setprecision(2)
+            << std::setw(8) << worker_count
+            << std::setw(10) << seconds
+            << std::setw(10) << std::setprecision(1) << (seconds > 0. ? file_paths.size() / seconds : 0.)
+            << std::setw(12) << (seconds > 0. ? frames / seconds : 0.)
+            << std::setw(10) << std::setprecision(2) << speedup
+            << std::setw(11) << std::setprecision(0) << speedup / worker_count * 100. << "%"
+            << std::setw(10) << stats.executed
+            << std::setw(10) << stats.stolen
+            << "\n";
+    }
+    if (!is_consistent)
+    {
+        std::cout << "checksum mismatch between rounds\n";
+        return 1;
+    }
+    return 0;
+}
@@ -1,11 +1,15 @@
 #include <memory>
 
 #include "main/decode_mp4.hpp"
-#include "logger/logger_manager.hpp"
+#include "main/media_decoder.hpp"
+#include "main/playback_rate.hpp"
+#include "main/filter_stage.hpp"
+#include "main/packet_demuxer.hpp"
+#include "util/util_log.hpp"
 #include "codec/av_common.hpp"
 #include "codec/av_error.hpp"
 #include "codec/av_packet_ptr.hpp"
-#include "concurrent/blocking/mpmc_bounded_queue.hpp"
+#include "util/util_trace_recorder.hpp"
 
 extern "C"
 {
@@ -16,273 +20,187 @@ extern "C"
 #include <libswresample/swresample.h>
 }
 
-int decode_mp4(const std::string& file_path, std::weak_ptr<MpmcBoundedQueue<AVFramePtr>> frame_queue)
+int decode_mp4(const std::string& file_path, std::weak_ptr<FrameQueue> frame_queue, std::shared_ptr<PlaybackRateControl> rate_control, const std::string& filter_description)
 {
 #if FFMPEG_VERSION<771
     av_register_all();
 #endif
     /// @note 新版本ffmpeg采用自动注册机制，无需调用av_register_all();
-    DANEJOE_LOG_TRACE("default", "decode_mp4", "version: {}", av_version_info());
-    /// @brief 创建AVFormatContext
-    AVFormatContext* ic = avformat_alloc_context(); // 正确初始化
-
-    if (!ic)
+    DANEJOE_CLOG(TRACE, DECODE, "decode_mp4", "version: {}", av_version_info());
+    DaneJoe::TraceRecorder::get_instance().set_thread_name("decode");
+    MediaDecoder decoder;
+    /// @brief 打开输入流、探测流信息并打开视频解码器，再次打开同一文件时使用缓存的流信息
+    MediaDecoder::Options options;
+    options.is_use_stream_info_cache = true;
+    AVError error = decoder.open(file_path, options);
+    if (error.failed())
     {
-        DANEJOE_LOG_ERROR("default", "decode_mp4", "无法分配 AVFormatContext！");
+        DANEJOE_CLOG(ERROR, DECODE, "decode_mp4", "错误信息: {}", error.message());
+        DANEJOE_CLOG(ERROR, DECODE, "decode_mp4", "视频打开失败！");
         return -1;
     }
-    /// @brief 打开输入流并读取标头。编解码器未打开。流必须使用 avformat 关闭_关闭_input()
-    AVError error = avformat_open_input(&ic, file_path.c_str(), nullptr, nullptr);
-    if (error == 0)
-    {
-        uint64_t duration = ic->duration;
-#if FFMPEG_VERSION>=771
-        /// @brief 新增：探测流信息,不调用不能获取duration
-        error = avformat_find_stream_info(ic, nullptr);
-#endif
-        if (error.failed())
+    /// @brief 通过duration获取总时长
+    int total_seconds = decoder.duration_ms() / 1000;
+    DANEJOE_CLOG(TRACE, DECODE, "decode_mp4", "视频文件打开成功,视频总时长为：{}分{}秒", total_seconds / 60, total_seconds % 60);
+    /// @brief 解封装在独立线程上进行，数据包按流分发到有界队列（音频解码接入后再登记音频流）
+    /// @note 声明在 decoder 之后，先于解码器析构停止
+    PacketDemuxer demuxer(decoder.format_context(), { decoder.video_stream_index() }, PacketDemuxer::Options());
+    decoder.set_demuxer(&demuxer);
+    demuxer.start();
+    auto log_demux_gauges = [&demuxer]()
         {
-            DANEJOE_LOG_ERROR("default", "decode_mp4", "错误信息: {}", AVError(error).message());
-            /// @brief 关闭输入流
-            avformat_close_input(&ic);
-            return -1;
-        }
-        /// @brief 通过duration获取总时长
-        int total_seconds = ic->duration / AV_TIME_BASE;
-        DANEJOE_LOG_TRACE("default", "decode_mp4", "视频文件打开成功,视频总时长为：{}分{}秒", total_seconds / 60, total_seconds % 60);
-
-        /// @brief 视频流下标
-        int video_stream_index = 0;
-        int audio_stream_index = 0;
+            for (const PacketDemuxer::StreamGauge& gauge : demuxer.get_stats().streams)
+            {
+                DANEJOE_CLOG_RATE_LIMITED(DEBUG, DECODE, "decode_mp4", 1000, "stream {} buffered {}s/{}s, {} packets, {} underruns",
+                    gauge.stream_index, gauge.buffered_seconds, gauge.max_seconds, gauge.packets, gauge.underruns);
+            }
+        };
 
 #ifdef REFERENCE
 
-        //==================================================
-
-        AVCodec* acodec = avcodec_find_decoder(ic->streams[audio_stream_index]->codecpar->codec_id);
+    //==================================================
 
-        AVCodecContext* audio_codec_context = avcodec_alloc_context3()
+    AVCodec* acodec = avcodec_find_decoder(ic->streams[audio_stream_index]->codecpar->codec_id);
 
-            /// @brief 音频解码器上下文
-            SwrContext * swr_context = swr_alloc();
-
-        // 设置输出参数
-        int out_channels = 2; // 输出通道数
-        int out_sample_rate = ic->sample_rate; // 输出采样率
-        enum AVSampleFormat out_sample_fmt = AV_SAMPLE_FMT_S16; // 输出样本格式
-
-        // 设置输入参数
-        int in_channels = ac->channels; // 输入通道数
-        int in_sample_rate = ac->sample_rate; // 输入采样率
-        enum AVSampleFormat in_sample_fmt = ac->sample_fmt; // 输入样本格式
-
-        // 配置 SwrContext
-        av_opt_set_int(actx, "in_channel_count", in_channels, 0);
-        av_opt_set_int(actx, "out_channel_count", out_channels, 0);
-        av_opt_set_int(actx, "in_sample_rate", in_sample_rate, 0);
-        av_opt_set_int(actx, "out_sample_rate", out_sample_rate, 0);
-        av_opt_set_sample_fmt(actx, "in_sample_fmt", in_sample_fmt, 0);
-        av_opt_set_sample_fmt(actx, "out_sample_fmt", out_sample_fmt, 0);
-        av_opt_set_int(actx, "out_channel_layout", AV_CHANNEL_LAYOUT_STEREO, 0); // 输出通道布局
-
-        // 初始化 SwrContext
-        if (swr_init(actx) < 0)
-        {
-            // 错误处理
-            swr_free(&actx);
-            return -1;
-        }
-
-        //===========================================
-#endif
+    AVCodecContext* audio_codec_context = avcodec_alloc_context3()
 
-        /// @brief 视频解码器上下文 
-        AVCodecContext* video_codec_context = nullptr;
         /// @brief 音频解码器上下文
-        AVCodecContext* audio_codec_context = nullptr;
+        SwrContext * swr_context = swr_alloc();
+
+    // 设置输出参数
+    int out_channels = 2; // 输出通道数
+    int out_sample_rate = ic->sample_rate; // 输出采样率
+    enum AVSampleFormat out_sample_fmt = AV_SAMPLE_FMT_S16; // 输出样本格式
+
+    // 设置输入参数
+    int in_channels = ac->channels; // 输入通道数
+    int in_sample_rate = ac->sample_rate; // 输入采样率
+    enum AVSampleFormat in_sample_fmt = ac->sample_fmt; // 输入样本格式
+
+    // 配置 SwrContext
+    av_opt_set_int(actx, "in_channel_count", in_channels, 0);
+    av_opt_set_int(actx, "out_channel_count", out_channels, 0);
+    av_opt_set_int(actx, "in_sample_rate", in_sample_rate, 0);
+    av_opt_set_int(actx, "out_sample_rate", out_sample_rate, 0);
+    av_opt_set_sample_fmt(actx, "in_sample_fmt", in_sample_fmt, 0);
+    av_opt_set_sample_fmt(actx, "out_sample_fmt", out_sample_fmt, 0);
+    av_opt_set_int(actx, "out_channel_layout", AV_CHANNEL_LAYOUT_STEREO, 0); // 输出通道布局
+
+    // 初始化 SwrContext
+    if (swr_init(actx) < 0)
+    {
+        // 错误处理
+        swr_free(&actx);
+        return -1;
+    }
 
-        /// @brief 遍历媒体流
-        for (int i = 0;i < ic->nb_streams;i++)
-        {
-#if FFMPEG_VERSION>=771
-            /// @brief 获取当前下标的媒体流
-            AVStream* stream = ic->streams[i];
-            /// @brief 获取当前下标媒体流的参数
-            /// @note 高版本无法直接通过nb_streams[i]获取参数
-            auto codecpar = stream->codecpar;
-#elif FFMPEG_VERSION<771
-            AVCodecContext* codec = ic->nb_streams[i]->codec;
+    //===========================================
 #endif
-            /// @brief 判断媒体流类型是否为视频流
-            if (codecpar->codec_type == AVMEDIA_TYPE_VIDEO)
-            {
-                video_stream_index = i;
-                /// @brief 寻找解码器
-                const AVCodec* codec = avcodec_find_decoder(codecpar->codec_id);
-                if (!codec)
-                {
-                    DANEJOE_LOG_ERROR("default", "decode_mp4", "无法找到解码器！");
-                    return -1;
-                }
-                /// @brief 创建解码器上下文
-                video_codec_context = avcodec_alloc_context3(codec);
-                /// @brief 将解码参数复制到解码器上下文
-                error = avcodec_parameters_to_context(video_codec_context, stream->codecpar);
-                if (error.failed())
-                {
-                    DANEJOE_LOG_ERROR("default", "decode_mp4", "错误信息: {}", AVError(error).message());
-                    return -3;
-                }
-                error = avcodec_open2(video_codec_context, codec, nullptr);
-                if (error.failed())
-                {
-                    DANEJOE_LOG_ERROR("default", "decode_mp4", "错误信息: {}", AVError(error).message());
-                    return -2;
-                }
-                DANEJOE_LOG_TRACE("default", "decode_mp4", "视频解码器名称：{}", codec->name);
-            }
-            else if (codecpar->codec_type == AVMEDIA_TYPE_AUDIO)
-            {
-                audio_stream_index = i;
-                const AVCodec* acodec = avcodec_find_decoder(codecpar->codec_id);
-                if (!acodec)
-                {
-                    DANEJOE_LOG_ERROR("default", "decode_mp4", "无法找到音频解码器！");
-                    return -1;
-                }
-                audio_codec_context = avcodec_alloc_context3(acodec);
-            }
-        }
-        /// @brief 循环计算每一帧的播放位置
+
+    /// @brief 按播放速率选择跳帧策略
+    DecodeRateAdapter rate_adapter(rate_control);
+    /// @brief 有滤镜时解码线程只负责解码，过滤与入队在滤镜阶段的线程上进行
+    if (!filter_description.empty())
+    {
+        FilterStage::Options filter_options;
+        filter_options.filter.description = filter_description;
+        filter_options.rate_control = rate_control;
+        FilterStage filter_stage(filter_options, frame_queue);
         while (true)
         {
-            /// @brief 视频压缩数据
-            // AVPacket* packet = av_packet_alloc();
-            AVPacketPtr packet;
-            packet.ensure_allocated();
-            if (!packet)
-            {
-                DANEJOE_LOG_ERROR("default", "decode_mp4", "无法分配AVPacket");
-            }
-            /// @brief 读取视频数据
-            error = av_read_frame(ic, packet.get());
-            if (error != 0)
+            AVFramePtr frame;
+            error = rate_adapter.decode_frame(decoder, frame);
+            if (error == AVERROR_EOF)
             {
-                DANEJOE_LOG_ERROR("default", "decode_mp4", "错误信息: {}", AVError(error).message());
+                DANEJOE_CLOG(INFO, DECODE, "decode_mp4", "AVERROR_EOF");
                 break;
             }
-            /// @brief 添加此判断避免处理非视频流数据包
-            if (packet->stream_index != video_stream_index)
+            else if (error.failed())
             {
-                continue;
-            }
-            /// @brief 计算播放位置
-            int pts = packet->pts * AVRationalInfo(ic->streams[packet->stream_index]->time_base).get_double() * 1000;
-            // DANEJOE_LOG_TRACE("default", "decode_mp4", "packet pts: {}", pts);
-#if FFMPEG_VERSION < 771
-            int got_picture = 0;
-            ret = avcodec_decode_video2(video_codec_context, frame, &got_picture, packet);
-#endif
-            /// @brief 解码队列接收数据包待解码
-            /// @note 非传统意义异步方式
-            error = avcodec_send_packet(video_codec_context, packet.get());
-            if (error.failed())
-            {
-                DANEJOE_LOG_ERROR("default", "decode_mp4", "错误信息: {}", AVError(error).message());
-                // av_packet_free(&packet);
-                continue;
+                DANEJOE_CLOG(ERROR, DECODE, "decode_mp4", "错误信息: {}", error.message());
+                break;
             }
-            /// @brief 循环解码数据包队列，确保队列中的数据包全部解码完毕
-            while (error.ok())
+            log_demux_gauges();
+            DANEJOE_TRACE_SCOPE_ARG(QUEUE_WAIT, "filter_push", frame->pts);
+            if (!filter_stage.push(std::move(frame)))
             {
-                AVFramePtr frame;
-                frame.ensure_allocated();
-                /// @brief 获取解码后的数据帧
-                error = avcodec_receive_frame(video_codec_context, frame.get());
-                if (error.ok())
-                {
-                    if (frame_queue.expired())
-                    {
-                        return 0;
-                    }
-                    auto frame_queue_shared_ptr = frame_queue.lock();
-                    if (!frame_queue_shared_ptr->is_running())
-                    {
-                        DANEJOE_LOG_INFO("default", "decode_mp4", "frame_queue is not running");
-                        return 0;
-                    }
-                    frame_queue_shared_ptr->push(std::move(frame));
-                    DANEJOE_LOG_TRACE("default", "decode_mp4", "end to push");
-                }
-                /// @note EAGAIN 表示需要更多数据才能继续解码
-                /// @note AVERROR_EOF 表示数据包队列已空
-                if (error == AVERROR(EAGAIN))
-                {
-                    break;
-                }
-                else if (error == AVERROR_EOF)
-                {
-                    DANEJOE_LOG_INFO("default", "decode_mp4", "AVERROR_EOF");
-                    break;
-                }
-                else if (error.failed())
-                {
-                    DANEJOE_LOG_ERROR("default", "decode_mp4", "错误信息: {}", AVError(error).message());
-                    // av_packet_free(&packet);
-                    continue;
-                }
+                DANEJOE_CLOG(INFO, DECODE, "decode_mp4", "filter stage is not running");
+                return 0;
             }
-            /// @brief 释放数据包
-            // av_packet_unref(packet);
         }
+        error = filter_stage.finish();
+        return error.ok() ? 0 : -1;
+    }
+    /// @brief 循环解码直到文件结束
+    while (true)
+    {
+        AVFrameView frame_view;
+        error = rate_adapter.decode_frame(decoder, frame_view);
+        /// @note AVERROR_EOF 表示文件读完且解码器已冲刷完毕
+        if (error == AVERROR_EOF)
+        {
+            DANEJOE_CLOG(INFO, DECODE, "decode_mp4", "AVERROR_EOF");
+            break;
+        }
+        else if (error.failed())
+        {
+            DANEJOE_CLOG(ERROR, DECODE, "decode_mp4", "错误信息: {}", error.message());
+            break;
+        }
+        auto frame_queue_shared_ptr = frame_queue.lock();
+        if (!frame_queue_shared_ptr)
+        {
+            return 0;
+        }
+        if (!frame_queue_shared_ptr->is_running())
+        {
+            DANEJOE_CLOG(INFO, DECODE, "decode_mp4", "frame_queue is not running");
+            return 0;
+        }
+        log_demux_gauges();
+        rate_adapter.throttle(frame_view, [&frame_queue_shared_ptr]() { return frame_queue_shared_ptr->is_running(); });
+        // 队列满时阻塞，等待时间记录在 queue_wait 轨道
+        DANEJOE_TRACE_SCOPE_ARG(QUEUE_WAIT, "push", frame_view.pts());
+        frame_queue_shared_ptr->push(std::move(frame_view));
+    }
 
 #ifdef TEST_AV_SEEK
-        auto video_stream = av_find_best_stream(ic, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
-        AVPacketPtr packet;
-        packet.ensure_allocated();
-        int times = 1000;
-        while (true)
+    AVFormatContext* ic = decoder.format_context().get();
+    auto video_stream = decoder.video_stream_index();
+    int video_stream_index = video_stream;
+    int audio_stream_index = av_find_best_stream(ic, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+    AVPacketPtr packet;
+    packet.ensure_allocated();
+    int times = 1000;
+    while (true)
+    {
+        AVError error = av_read_frame(ic, packet.get());
+        times--;
+        if (times == 0 && error.ok())
         {
-            AVError error = av_read_frame(ic, packet.get());
-            times--;
-            if (times == 0 && error.ok())
-            {
-                int time = 3000;
-                long long pos = (double)time / (double)1000 * AVRationalInfo(ic->streams[packet->stream_index]->time_base).get_double();
-                DANEJOE_LOG_TRACE("default", "decode_mp4", "pos: {}", pos);
-                av_seek_frame(ic, video_stream, pos, AVSEEK_FLAG_BACKWARD | AVSEEK_FLAG_FRAME);
-            }
-            if (error.failed())
-            {
-                break;
-            }
-            DANEJOE_LOG_TRACE("default", "decode_mp4", "packet size:{}", packet->size);
-            DANEJOE_LOG_TRACE("default", "decode_mp4", "packet pts:{}", packet->pts);
-            DANEJOE_LOG_TRACE("default", "decode_mp4", "packet dts:{}", packet->dts);
-            if (packet->stream_index == video_stream_index)
-            {
-                DANEJOE_LOG_TRACE("default", "decode_mp4", "Video packet");
-            }
-            else if (packet->stream_index == audio_stream_index)
-            {
-                DANEJOE_LOG_TRACE("default", "decode_mp4", "Audio packet");
-            }
-            packet.unref();
+            int time = 3000;
+            long long pos = (double)time / (double)1000 * AVRationalInfo(ic->streams[packet->stream_index]->time_base).get_double();
+            DANEJOE_CLOG(TRACE, DECODE, "decode_mp4", "pos: {}", pos);
+            av_seek_frame(ic, video_stream, pos, AVSEEK_FLAG_BACKWARD | AVSEEK_FLAG_FRAME);
         }
+        if (error.failed())
+        {
+            break;
+        }
+        DANEJOE_CLOG(TRACE, DECODE, "decode_mp4", "packet size:{}", packet->size);
+        DANEJOE_CLOG(TRACE, DECODE, "decode_mp4", "packet pts:{}", packet->pts);
+        DANEJOE_CLOG(TRACE, DECODE, "decode_mp4", "packet dts:{}", packet->dts);
+        if (packet->stream_index == video_stream_index)
+        {
+            DANEJOE_CLOG(TRACE, DECODE, "decode_mp4", "Video packet");
+        }
+        else if (packet->stream_index == audio_stream_index)
+        {
+            DANEJOE_CLOG(TRACE, DECODE, "decode_mp4", "Audio packet");
+        }
+        packet.unref();
+    }
 #endif
 
-        /// @brief 释放解码器上下文
-        avcodec_free_context(&video_codec_context);
-        /// @brief 关闭输入流
-        avformat_close_input(&ic);
-    }
-    else
-    {
-        DANEJOE_LOG_ERROR("default", "decode_mp4", "错误信息: {}", AVError(error).message());
-        DANEJOE_LOG_ERROR("default", "decode_mp4", "视频打开失败！");
-        /// @brief 释放内存
-        avformat_free_context(ic);
-        return -1;
-    }
     return 0;
 }
\ No newline at end of file
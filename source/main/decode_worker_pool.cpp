@@ -0,0 +1,217 @@
+#include <algorithm>
+
+#include "main/decode_worker_pool.hpp"
+#include "util/util_log.hpp"
+
+DecodeWorkerPool::DecodeWorkerPool(std::size_t worker_count, std::size_t frames_per_slice) :
+    m_worker_count(worker_count),
+    m_frames_per_slice(frames_per_slice > 0 ? frames_per_slice : 1)
+{
+    if (m_worker_count == 0)
+    {
+        m_worker_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+DecodeWorkerPool::~DecodeWorkerPool()
+{
+    stop();
+    // 帧队列可能比线程池活得久，取消回调后不再访问本对象
+    for (auto& stream : m_streams)
+    {
+        if (auto frame_queue = stream->frame_queue.lock())
+        {
+            frame_queue->set_on_not_full(nullptr);
+        }
+    }
+}
+
+std::size_t DecodeWorkerPool::add_stream(const std::string& file_path, std::weak_ptr<FrameQueue> frame_queue, bool is_loop)
+{
+    auto stream = std::make_unique<Stream>();
+    stream->file_path = file_path;
+    stream->frame_queue = frame_queue;
+    stream->is_loop = is_loop;
+    if (auto queue = frame_queue.lock())
+    {
+        // 消费端取帧腾出空间或关闭队列时唤醒背压中等待的工作线程
+        queue->set_on_not_full([this]()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                }
+                m_condition.notify_all();
+            });
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_streams.push_back(std::move(stream));
+    m_condition.notify_one();
+    return m_streams.size() - 1;
+}
+
+void DecodeWorkerPool::start()
+{
+    if (!m_workers.empty())
+    {
+        DANEJOE_CLOG(WARN, DECODE, "DecodeWorkerPool", "Already started");
+        return;
+    }
+    for (std::size_t i = 0; i < m_worker_count; i++)
+    {
+        m_workers.emplace_back([this](std::stop_token stop_token)
+            {
+                worker_loop(stop_token);
+            });
+    }
+    DANEJOE_CLOG(INFO, DECODE, "DecodeWorkerPool", "Started {} workers for {} streams", m_worker_count, m_streams.size());
+}
+
+void DecodeWorkerPool::stop()
+{
+    for (auto& worker : m_workers)
+    {
+        worker.request_stop();
+    }
+    m_condition.notify_all();
+    // jthread 析构时自动 join
+    m_workers.clear();
+}
+
+std::size_t DecodeWorkerPool::worker_count()const
+{
+    return m_worker_count;
+}
+
+uint64_t DecodeWorkerPool::total_frames_decoded()const
+{
+    return m_total_frames.load(std::memory_order_relaxed);
+}
+
+std::vector<DecodeWorkerPool::StreamStats> DecodeWorkerPool::get_stream_stats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<StreamStats> stats;
+    stats.reserve(m_streams.size());
+    for (const auto& stream : m_streams)
+    {
+        StreamStats stream_stats;
+        stream_stats.file_path = stream->file_path;
+        stream_stats.frames_decoded = stream->frames_decoded.load(std::memory_order_relaxed);
+        stream_stats.backpressure_events = stream->backpressure_events.load(std::memory_order_relaxed);
+        stream_stats.is_backpressured = stream->is_backpressured.load(std::memory_order_relaxed);
+        stream_stats.is_finished = stream->is_finished;
+        stats.push_back(std::move(stream_stats));
+    }
+    return stats;
+}
+
+DecodeWorkerPool::Stream* DecodeWorkerPool::pick_stream()
+{
+    std::size_t count = m_streams.size();
+    for (std::size_t i = 0; i < count; i++)
+    {
+        std::size_t index = (m_cursor + i) % count;
+        Stream& stream = *m_streams[index];
+        if (stream.is_busy || stream.is_finished)
+        {
+            continue;
+        }
+        // 背压中的流只有在队列腾出空间后才重新参与调度
+        if (stream.is_backpressured.load(std::memory_order_relaxed))
+        {
+            auto frame_queue = stream.frame_queue.lock();
+            if (frame_queue && frame_queue->is_running() && frame_queue->is_full())
+            {
+                continue;
+            }
+        }
+        m_cursor = (index + 1) % count;
+        return &stream;
+    }
+    return nullptr;
+}
+
+void DecodeWorkerPool::worker_loop(std::stop_token stop_token)
+{
+    while (!stop_token.stop_requested())
+    {
+        Stream* stream = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            // 背压中的流由帧队列腾出空间时的回调唤醒，无需轮询
+            m_condition.wait(lock, stop_token, [this, &stream]()
+                {
+                    stream = pick_stream();
+                    return stream != nullptr;
+                });
+            if (!stream)
+            {
+                continue;
+            }
+            stream->is_busy = true;
+        }
+        bool is_finished = decode_slice(*stream);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            stream->is_busy = false;
+            stream->is_finished = is_finished;
+        }
+        m_condition.notify_one();
+    }
+}
+
+bool DecodeWorkerPool::decode_slice(Stream& stream)
+{
+    auto frame_queue = stream.frame_queue.lock();
+    if (!frame_queue || !frame_queue->is_running())
+    {
+        return true;
+    }
+    if (!stream.decoder.is_open())
+    {
+        // 共享线程池已经提供了并行度，解码器内部不再额外创建线程
+        MediaDecoder::Options options;
+        options.thread_count = 1;
+        if (stream.decoder.open(stream.file_path, options).failed())
+        {
+            DANEJOE_CLOG(ERROR, DECODE, "DecodeWorkerPool", "Failed to open stream {}", stream.file_path);
+            return true;
+        }
+    }
+    for (std::size_t i = 0; i < m_frames_per_slice; i++)
+    {
+        if (!stream.pending_frame)
+        {
+            AVError error = stream.decoder.decode_frame(stream.pending_frame);
+            if (error == AVERROR_EOF && stream.is_loop && stream.frames_since_rewind > 0)
+            {
+                stream.frames_since_rewind = 0;
+                if (stream.decoder.seek(0).failed())
+                {
+                    return true;
+                }
+                continue;
+            }
+            if (error.failed())
+            {
+                if (error != AVERROR_EOF)
+                {
+                    DANEJOE_CLOG(ERROR, DECODE, "DecodeWorkerPool", "Decode {} failed: {}", stream.file_path, error.message());
+                }
+                return true;
+            }
+            stream.frames_since_rewind++;
+            stream.frames_decoded.fetch_add(1, std::memory_order_relaxed);
+            m_total_frames.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (!frame_queue->try_push(stream.pending_frame))
+        {
+            // 队列已满：保留已解码帧并让出时间片
+            stream.is_backpressured.store(true, std::memory_order_relaxed);
+            stream.backpressure_events.fetch_add(1, std::memory_order_relaxed);
+            return !frame_queue->is_running();
+        }
+        stream.is_backpressured.store(false, std::memory_order_relaxed);
+    }
+    return false;
+}
@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include "main/filter_stage.hpp"
+#include "main/batch_processor.hpp"
+#include "main/media_decoder.hpp"
+#include "util/util_log.hpp"
+#include "util/util_trace_recorder.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double elapsed_ms(Clock::time_point begin)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    }
+}
+
+FilterStage::FilterStage(const Options& options, std::weak_ptr<FrameQueue> frame_queue) :
+    m_options(options), m_frame_queue(std::move(frame_queue))
+{
+    m_options.input_capacity = std::max<std::size_t>(m_options.input_capacity, 1);
+    m_thread = std::jthread(&FilterStage::run, this);
+}
+
+FilterStage::~FilterStage()
+{
+    close();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+bool FilterStage::push(AVFramePtr&& frame)
+{
+    Clock::time_point begin = Clock::now();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_not_full.wait(lock, [this]() { return m_is_closed || m_input.size() < m_options.input_capacity; });
+    if (m_is_closed)
+    {
+        return false;
+    }
+    m_input.push_back(std::move(frame));
+    m_stats.input_frames++;
+    m_stats.input_wait_ms += elapsed_ms(begin);
+    m_not_empty.notify_one();
+    return true;
+}
+
+AVError FilterStage::finish()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_is_input_end = true;
+    }
+    m_not_empty.notify_one();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_error;
+}
+
+void FilterStage::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_is_closed = true;
+        m_input.clear();
+    }
+    m_not_empty.notify_all();
+    m_not_full.notify_all();
+}
+
+FilterStage::Stats FilterStage::get_stats()const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void FilterStage::run()
+{
+    DaneJoe::TraceRecorder::get_instance().set_thread_name("filter");
+    AVVideoFilter filter(m_options.filter);
+    // 只用于按呈现位置限制超前量，不参与解码
+    DecodeRateAdapter rate_adapter(m_options.rate_control);
+    while (true)
+    {
+        AVFramePtr frame;
+        bool is_end = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_not_empty.wait(lock, [this]() { return m_is_closed || m_is_input_end || !m_input.empty(); });
+            if (m_is_closed)
+            {
+                return;
+            }
+            if (!m_input.empty())
+            {
+                frame = std::move(m_input.front());
+                m_input.pop_front();
+                m_not_full.notify_one();
+            }
+            else
+            {
+                is_end = true;
+            }
+        }
+        AVError error;
+        {
+            DANEJOE_TRACE_SCOPE(FILTER, "send_frame");
+            Clock::time_point begin = Clock::now();
+            error = is_end ? filter.send_eof() : filter.send_frame(frame);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.filter_ms += elapsed_ms(begin);
+            m_stats.graph_builds = filter.build_count();
+        }
+        if (error.failed())
+        {
+            DANEJOE_CLOG(ERROR, DECODE, "FilterStage", "Filter \"{}\" failed: {}", filter.description(), error.message());
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_error = error;
+            break;
+        }
+        if (!emit(filter, rate_adapter) || is_end)
+        {
+            break;
+        }
+    }
+    close();
+}
+
+bool FilterStage::emit(AVVideoFilter& filter, DecodeRateAdapter& rate_adapter)
+{
+    while (true)
+    {
+        AVFramePtr frame;
+        AVError error;
+        {
+            // libavfilter 在取帧时才真正处理，滤镜耗时主要计在这里
+            DANEJOE_TRACE_SCOPE(FILTER, "receive_frame");
+            Clock::time_point begin = Clock::now();
+            error = filter.receive_frame(frame);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.filter_ms += elapsed_ms(begin);
+        }
+        if (error == AVERROR(EAGAIN) || error == AVERROR_EOF)
+        {
+            return true;
+        }
+        if (error.failed())
+        {
+            DANEJOE_CLOG(ERROR, DECODE, "FilterStage", "Filter \"{}\" failed: {}", filter.description(), error.message());
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_error = error;
+            return false;
+        }
+        AVFrameView frame_view(frame);
+        if (frame_view.get_error().failed())
+        {
+            DANEJOE_CLOG_RATE_LIMITED(WARN, DECODE, "FilterStage", 1000, "Filtered frame is not reference counted: {}", frame_view.get_error().message());
+            continue;
+        }
+        auto frame_queue_shared_ptr = m_frame_queue.lock();
+        if (!frame_queue_shared_ptr || !frame_queue_shared_ptr->is_running())
+        {
+            DANEJOE_CLOG(INFO, DECODE, "FilterStage", "frame_queue is not running");
+            return false;
+        }
+        rate_adapter.throttle(frame_view, [&frame_queue_shared_ptr]() { return frame_queue_shared_ptr->is_running(); });
+        {
+            DANEJOE_TRACE_SCOPE_ARG(QUEUE_WAIT, "push", frame_view.pts());
+            frame_queue_shared_ptr->push(std::move(frame_view));
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.output_frames++;
+    }
+}
+
+int run_filter_benchmark(const std::vector<std::string>& inputs, const std::string& filter_description)
+{
+    std::vector<std::string> file_paths = collect_media_files(inputs);
+    if (file_paths.empty())
+    {
+        DANEJOE_CLOG(ERROR, APP, "FilterBenchmark", "Invalid arguments");
+        return -1;
+    }
+    const std::string& file_path = file_paths.front();
+    std::cout << "file: " << file_path << ", filter: " << (filter_description.empty() ? "null" : filter_description) << "\n";
+    std::cout << std::setw(12) << "mode" << std::setw(10) << "frames" << std::setw(10) << "fps"
+        << std::setw(12) << "decode ms" << std::setw(12) << "filter ms" << std::setw(12) << "wall ms" << "\n";
+    auto print_row = [](const char* mode, uint64_t frames, double decode_ms, double filter_ms, double wall_ms)
+        {
+            std::cout << std::fixed << std::setprecision(1)
+                << std::setw(12) << mode
+                << std::setw(10) << frames
+                << std::setw(10) << (wall_ms > 0. ? frames * 1000. / wall_ms : 0.)
+                << std::setw(12) << decode_ms
+                << std::setw(12) << filter_ms
+                << std::setw(12) << wall_ms
+                << "\n";
+        };
+    // 串行：同一线程内解码一帧、过滤一帧
+    {
+        MediaDecoder decoder;
+        AVError error = decoder.open(file_path);
+        if (error.failed())
+        {
+            DANEJOE_CLOG(ERROR, APP, "FilterBenchmark", "Failed to open {}: {}", file_path, error.message());
+            return -1;
+        }
+        AVVideoFilter filter(AVVideoFilter::Options{ filter_description });
+        double decode_ms = 0., filter_ms = 0.;
+        uint64_t frames = 0;
+        Clock::time_point begin = Clock::now();
+        bool is_end = false;
+        while (!is_end)
+        {
+            AVFramePtr frame;
+            Clock::time_point decode_begin = Clock::now();
+            error = decoder.decode_frame(frame);
+            decode_ms += elapsed_ms(decode_begin);
+            Clock::time_point filter_begin = Clock::now();
+            if (error == AVERROR_EOF)
+            {
+                is_end = true;
+                error = filter.send_eof();
+            }
+            else if (error.ok())
+            {
+                error = filter.send_frame(frame);
+            }
+            if (error.failed())
+            {
+                DANEJOE_CLOG(ERROR, APP, "FilterBenchmark", "Serial run failed: {}", error.message());
+                return -1;
+            }
+            AVFramePtr filtered;
+            while (filter.receive_frame(filtered).ok())
+            {
+                frames++;
+            }
+            filter_ms += elapsed_ms(filter_begin);
+        }
+        print_row("serial", frames, decode_ms, filter_ms, elapsed_ms(begin));
+    }
+    // 流水线：解码在当前线程，滤镜在滤镜阶段线程
+    {
+        MediaDecoder decoder;
+        AVError error = decoder.open(file_path);
+        if (error.failed())
+        {
+            DANEJOE_CLOG(ERROR, APP, "FilterBenchmark", "Failed to open {}: {}", file_path, error.message());
+            return -1;
+        }
+        auto frame_queue = std::make_shared<FrameQueue>(16);
+        std::atomic<bool> is_done = false;
+        std::jthread consumer([&frame_queue, &is_done]()
+            {
+                while (!is_done.load(std::memory_order_acquire) || frame_queue->size() > 0)
+                {
+                    if (!frame_queue->try_pop())
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        FilterStage::Options options;
+        options.filter.description = filter_description;
+        double decode_ms = 0.;
+        Clock::time_point begin = Clock::now();
+        AVError filter_error;
+        FilterStage::Stats stats;
+        {
+            FilterStage filter_stage(options, frame_queue);
+            while (true)
+            {
+                AVFramePtr frame;
+                Clock::time_point decode_begin = Clock::now();
+                error = decoder.decode_frame(frame);
+                decode_ms += elapsed_ms(decode_begin);
+                if (error.failed() || !filter_stage.push(std::move(frame)))
+                {
+                    break;
+                }
+            }
+            filter_error = filter_stage.finish();
+            stats = filter_stage.get_stats();
+        }
+        double wall_ms = elapsed_ms(begin);
+        is_done.store(true, std::memory_order_release);
+        consumer.join();
+        if (filter_error.failed() || (error.failed() && error != AVERROR_EOF))
+        {
+            DANEJOE_CLOG(ERROR, APP, "FilterBenchmark", "Pipelined run failed: {}", (filter_error.failed() ? filter_error : error).message());
+            return -1;
+        }
+        print_row("pipelined", stats.output_frames, decode_ms, stats.filter_ms, wall_ms);
+        std::cout << "graph builds: " << stats.graph_builds << ", decoder blocked on filter: " << stats.input_wait_ms << " ms\n";
+    }
+    return 0;
+}
@@ -0,0 +1,393 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+extern "C"
+{
+#include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
+}
+
+#include "main/frame_hash_verifier.hpp"
+#include "main/batch_processor.hpp"
+#include "util/util_log.hpp"
+#include "util/util_plane_hash.hpp"
+#include "util/util_trace_recorder.hpp"
+
+namespace
+{
+    /// @brief 清单文件标识
+    constexpr const char* MANIFEST_MAGIC = "framehash";
+    /// @brief 清单格式版本，哈希算法或记录格式变化时递增
+    constexpr int MANIFEST_VERSION = 1;
+
+    /**
+     * @struct FileJob
+     * @brief 单个文件在解码任务与哈希任务之间共享的状态
+     */
+    struct FileJob
+    {
+        FrameHashVerifier::FileHashes result;
+        /// @brief 按解码顺序排列的帧哈希，哈希任务各自写入自己的元素（deque 追加不会移动已有元素）
+        std::deque<FrameHashVerifier::FrameHash> frames;
+        /// @brief 保护 frames 的追加
+        std::mutex mutex;
+        /// @brief 已解码未哈希的帧数
+        std::atomic<std::size_t> inflight = 0;
+        std::atomic<uint64_t> hashed_bytes = 0;
+    };
+
+    std::string format_hash(uint64_t hash)
+    {
+        std::ostringstream stream;
+        stream << std::hex << std::setw(16) << std::setfill('0') << hash;
+        return stream.str();
+    }
+}
+
+FrameHashVerifier::FrameHashVerifier(DaneJoe::TaskScheduler& scheduler, const Options& options) :
+    m_scheduler(scheduler), m_options(options)
+{
+    m_options.max_inflight_frames = std::max<std::size_t>(m_options.max_inflight_frames, 1);
+}
+
+FrameHashVerifier::FrameHash FrameHashVerifier::hash_frame(const AVFramePtr& frame, uint64_t* hashed_bytes)
+{
+    FrameHash result;
+    result.pts = frame_pts(frame.get());
+    result.width = frame->width;
+    result.height = frame->height;
+    AVPixelFormat format = static_cast<AVPixelFormat>(frame->format);
+    const AVPixFmtDescriptor* descriptor = av_pix_fmt_desc_get(format);
+    result.format = descriptor ? descriptor->name : "unknown";
+    int linesizes[4] = {};
+    // 硬件帧没有可读的平面数据
+    if (!descriptor || (descriptor->flags & AV_PIX_FMT_FLAG_HWACCEL) || av_image_fill_linesizes(linesizes, format, frame->width) < 0)
+    {
+        return result;
+    }
+    int plane_count = av_pix_fmt_count_planes(format);
+    for (int plane = 0; plane < plane_count; plane++)
+    {
+        // 平面 1、2 为色度平面，按色度下采样向上取整
+        int rows = plane == 1 || plane == 2 ? -((-frame->height) >> descriptor->log2_chroma_h) : frame->height;
+        result.planes.push_back(DaneJoe::hash_plane(frame->data[plane], frame->linesize[plane], linesizes[plane], rows));
+        if (hashed_bytes)
+        {
+            *hashed_bytes += static_cast<uint64_t>(linesizes[plane]) * rows;
+        }
+    }
+    if (descriptor->flags & AV_PIX_FMT_FLAG_PAL)
+    {
+        constexpr int PALETTE_BYTES = 256 * 4;
+        result.planes.push_back(DaneJoe::hash_plane(frame->data[1], PALETTE_BYTES, PALETTE_BYTES, 1));
+    }
+    return result;
+}
+
+std::vector<FrameHashVerifier::FileHashes> FrameHashVerifier::hash_files(const std::vector<std::string>& file_paths, DaneJoe::CancellationToken token)
+{
+    DaneJoe::TaskGroup group(token);
+    std::vector<std::shared_ptr<FileJob>> jobs;
+    for (const auto& file_path : file_paths)
+    {
+        auto job = std::make_shared<FileJob>();
+        job->result.file_path = file_path;
+        jobs.push_back(job);
+        m_scheduler.submit(group, [this, &group, job]()
+            {
+                DANEJOE_TRACE_SCOPE(DECODE, "framehash_file");
+                MediaDecoder decoder;
+                job->result.error = decoder.open(job->result.file_path, m_options.decoder_options);
+                if (job->result.error.failed())
+                {
+                    DANEJOE_CLOG(WARN, DECODE, "FrameHashVerifier", "Failed to open {}: {}", job->result.file_path, job->result.error.message());
+                    return;
+                }
+                job->result.time_base = decoder.time_base();
+                while (!group.is_cancelled())
+                {
+                    AVFramePtr frame;
+                    AVError error = decoder.decode_frame(frame);
+                    if (error == AVERROR_EOF)
+                    {
+                        break;
+                    }
+                    if (error.failed())
+                    {
+                        DANEJOE_CLOG(WARN, DECODE, "FrameHashVerifier", "Decoding {} failed: {}", job->result.file_path, error.message());
+                        job->result.error = error;
+                        break;
+                    }
+                    FrameHash* slot = nullptr;
+                    {
+                        std::lock_guard<std::mutex> lock(job->mutex);
+                        slot = &job->frames.emplace_back();
+                    }
+                    // 哈希跟不上解码时在解码线程上直接哈希这一帧，限制缓存的帧数，也不必等待其他线程
+                    if (job->inflight.load(std::memory_order_acquire) >= m_options.max_inflight_frames)
+                    {
+                        uint64_t hashed_bytes = 0;
+                        *slot = hash_frame(frame, &hashed_bytes);
+                        job->hashed_bytes.fetch_add(hashed_bytes, std::memory_order_relaxed);
+                        continue;
+                    }
+                    job->inflight.fetch_add(1, std::memory_order_relaxed);
+                    m_scheduler.submit(group, [job, slot, frame = std::move(frame)]()
+                        {
+                            uint64_t hashed_bytes = 0;
+                            *slot = hash_frame(frame, &hashed_bytes);
+                            job->hashed_bytes.fetch_add(hashed_bytes, std::memory_order_relaxed);
+                            job->inflight.fetch_sub(1, std::memory_order_release);
+                        }, DaneJoe::TaskPriority::HIGH);
+                }
+            }, DaneJoe::TaskPriority::LOW);
+    }
+    m_scheduler.wait(group);
+
+    std::vector<FileHashes> results;
+    results.reserve(jobs.size());
+    for (const auto& job : jobs)
+    {
+        FileHashes result = std::move(job->result);
+        result.frames.assign(std::make_move_iterator(job->frames.begin()), std::make_move_iterator(job->frames.end()));
+        result.hashed_bytes = job->hashed_bytes.load();
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+bool FrameHashVerifier::write_manifest(const std::string& manifest_path, const std::vector<FileHashes>& files)
+{
+    std::ofstream file(manifest_path, std::ios::trunc);
+    if (!file)
+    {
+        DANEJOE_CLOG(ERROR, APP, "FrameHashVerifier", "Failed to write manifest {}", manifest_path);
+        return false;
+    }
+    // 每个文件一行 file 记录（路径放在行尾，可含空格），后跟每帧一行 frame 记录
+    file << MANIFEST_MAGIC << " " << MANIFEST_VERSION << "\n";
+    for (const FileHashes& hashes : files)
+    {
+        if (hashes.error.failed())
+        {
+            continue;
+        }
+        file << "file " << hashes.time_base.num << " " << hashes.time_base.den << " " << hashes.frames.size() << " " << hashes.file_path << "\n";
+        for (const FrameHash& frame : hashes.frames)
+        {
+            file << "frame " << frame.pts << " " << frame.width << " " << frame.height << " " << frame.format << " " << frame.planes.size();
+            for (uint64_t plane : frame.planes)
+            {
+                file << " " << format_hash(plane);
+            }
+            file << "\n";
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+std::optional<std::vector<FrameHashVerifier::FileHashes>> FrameHashVerifier::read_manifest(const std::string& manifest_path)
+{
+    std::ifstream file(manifest_path);
+    if (!file)
+    {
+        DANEJOE_CLOG(ERROR, APP, "FrameHashVerifier", "Failed to open manifest {}", manifest_path);
+        return std::nullopt;
+    }
+    std::string line;
+    std::string magic;
+    int version = 0;
+    if (!std::getline(file, line) || !(std::istringstream(line) >> magic >> version) || magic != MANIFEST_MAGIC || version != MANIFEST_VERSION)
+    {
+        DANEJOE_CLOG(ERROR, APP, "FrameHashVerifier", "Incompatible manifest {}", manifest_path);
+        return std::nullopt;
+    }
+    std::vector<FileHashes> files;
+    std::size_t line_number = 1;
+    while (std::getline(file, line))
+    {
+        line_number++;
+        std::istringstream stream(line);
+        std::string tag;
+        stream >> tag;
+        if (tag == "file")
+        {
+            FileHashes hashes;
+            std::size_t frame_count = 0;
+            stream >> hashes.time_base.num >> hashes.time_base.den >> frame_count;
+            if (!stream || !std::getline(stream >> std::ws, hashes.file_path) || hashes.file_path.empty())
+            {
+                DANEJOE_CLOG(ERROR, APP, "FrameHashVerifier", "Malformed file record at {}:{}", manifest_path, line_number);
+                return std::nullopt;
+            }
+            hashes.frames.reserve(frame_count);
+            files.push_back(std::move(hashes));
+        }
+        else if (tag == "frame" && !files.empty())
+        {
+            FrameHash frame;
+            std::size_t plane_count = 0;
+            stream >> frame.pts >> frame.width >> frame.height >> frame.format >> plane_count >> std::hex;
+            for (std::size_t i = 0; stream && i < plane_count; i++)
+            {
+                uint64_t plane = 0;
+                stream >> plane;
+                frame.planes.push_back(plane);
+            }
+            if (!stream)
+            {
+                DANEJOE_CLOG(ERROR, APP, "FrameHashVerifier", "Malformed frame record at {}:{}", manifest_path, line_number);
+                return std::nullopt;
+            }
+            files.back().frames.push_back(std::move(frame));
+        }
+    }
+    return files;
+}
+
+FrameHashVerifier::Difference FrameHashVerifier::compare(const FileHashes& golden, const FileHashes& actual)
+{
+    Difference difference;
+    if (actual.error.failed())
+    {
+        difference.status = Status::ERROR;
+        difference.frame_index = actual.frames.size();
+        difference.detail = actual.error.message();
+        return difference;
+    }
+    difference.status = Status::MISMATCH;
+    std::size_t common = std::min(golden.frames.size(), actual.frames.size());
+    for (std::size_t i = 0; i < common; i++)
+    {
+        const FrameHash& expected = golden.frames[i];
+        const FrameHash& frame = actual.frames[i];
+        difference.frame_index = i;
+        if (expected.pts != frame.pts)
+        {
+            difference.detail = "pts " + std::to_string(frame.pts) + " != golden " + std::to_string(expected.pts);
+            return difference;
+        }
+        if (expected.width != frame.width || expected.height != frame.height || expected.format != frame.format)
+        {
+            difference.detail = std::to_string(frame.width) + "x" + std::to_string(frame.height) + " " + frame.format
+                + " != golden " + std::to_string(expected.width) + "x" + std::to_string(expected.height) + " " + expected.format;
+            return difference;
+        }
+        if (expected.planes.size() != frame.planes.size())
+        {
+            difference.detail = std::to_string(frame.planes.size()) + " planes != golden " + std::to_string(expected.planes.size());
+            return difference;
+        }
+        for (std::size_t plane = 0; plane < frame.planes.size(); plane++)
+        {
+            if (expected.planes[plane] != frame.planes[plane])
+            {
+                difference.plane = static_cast<int>(plane);
+                difference.detail = "pts " + std::to_string(frame.pts) + ", hash " + format_hash(frame.planes[plane]) + " != golden " + format_hash(expected.planes[plane]);
+                return difference;
+            }
+        }
+    }
+    if (golden.frames.size() != actual.frames.size())
+    {
+        difference.frame_index = common;
+        difference.detail = std::to_string(actual.frames.size()) + " frames != golden " + std::to_string(golden.frames.size());
+        return difference;
+    }
+    return Difference();
+}
+
+int run_frame_hash(const std::vector<std::string>& inputs, const std::string& write_path, const std::string& golden_path, std::size_t workers)
+{
+    std::vector<std::string> file_paths = collect_media_files(inputs);
+    if (file_paths.empty() || (write_path.empty() && golden_path.empty()))
+    {
+        DANEJOE_CLOG(ERROR, APP, "FrameHash", "Usage: framehash <files|dirs> [--write=manifest] [--golden=manifest]");
+        return -1;
+    }
+    std::optional<std::vector<FrameHashVerifier::FileHashes>> golden;
+    if (!golden_path.empty())
+    {
+        golden = FrameHashVerifier::read_manifest(golden_path);
+        if (!golden)
+        {
+            return -1;
+        }
+    }
+    DaneJoe::TaskScheduler scheduler(workers);
+    FrameHashVerifier verifier(scheduler, FrameHashVerifier::Options());
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<FrameHashVerifier::FileHashes> results = verifier.hash_files(file_paths);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    uint64_t frames = 0;
+    uint64_t hashed_bytes = 0;
+    std::size_t errors = 0;
+    for (const auto& result : results)
+    {
+        frames += result.frames.size();
+        hashed_bytes += result.hashed_bytes;
+        errors += result.error.failed() ? 1 : 0;
+    }
+    std::cout << std::fixed << std::setprecision(1)
+        << "files: " << results.size() << ", frames: " << frames << ", workers: " << scheduler.worker_count()
+        << ", seconds: " << std::setprecision(2) << seconds << ", frames/s: " << std::setprecision(1) << (seconds > 0. ? frames / seconds : 0.)
+        << ", hashed MB/s: " << (seconds > 0. ? hashed_bytes / seconds / (1024. * 1024.) : 0.) << "\n";
+    if (!write_path.empty())
+    {
+        if (!FrameHashVerifier::write_manifest(write_path, results))
+        {
+            return -1;
+        }
+        std::cout << "manifest written: " << write_path << "\n";
+    }
+    if (!golden)
+    {
+        return errors > 0 ? 1 : 0;
+    }
+    std::unordered_map<std::string, const FrameHashVerifier::FileHashes*> golden_files;
+    for (const auto& hashes : *golden)
+    {
+        golden_files[hashes.file_path] = &hashes;
+    }
+    std::size_t matched = 0, mismatched = 0, missing = 0;
+    errors = 0;
+    for (const auto& result : results)
+    {
+        auto iterator = golden_files.find(result.file_path);
+        if (iterator == golden_files.end())
+        {
+            missing++;
+            std::cout << "MISSING  " << result.file_path << ": not in golden manifest\n";
+            continue;
+        }
+        FrameHashVerifier::Difference difference = FrameHashVerifier::compare(*iterator->second, result);
+        switch (difference.status)
+        {
+        case FrameHashVerifier::Status::MATCH:
+            matched++;
+            break;
+        case FrameHashVerifier::Status::ERROR:
+            errors++;
+            std::cout << "ERROR    " << result.file_path << ": " << difference.detail << " after " << difference.frame_index << " frames\n";
+            break;
+        case FrameHashVerifier::Status::MISMATCH:
+            mismatched++;
+            std::cout << "MISMATCH " << result.file_path << ": frame " << difference.frame_index
+                << (difference.plane >= 0 ? ", plane " + std::to_string(difference.plane) : std::string())
+                << " (" << difference.detail << ")\n";
+            break;
+        }
+    }
+    std::cout << "matched: " << matched << ", mismatched: " << mismatched << ", missing: " << missing << ", errors: " << errors << "\n";
+    return mismatched + missing + errors > 0 ? 1 : 0;
+}
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "main/frame_pacer.hpp"
+#include "main/batch_processor.hpp"
+#include "main/decode_mp4.hpp"
+#include "util/util_log.hpp"
+#include "util/util_precise_timer.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief 未知刷新率时的默认值（Hz）
+    constexpr double DEFAULT_REFRESH_HZ = 60.;
+    /// @brief 选帧容差占刷新间隔的比例：略小于一半，使 24fps@60Hz 这类恰好落在两次刷新正中的帧稳定地归到后一次刷新
+    constexpr double REFRESH_LOOKAHEAD_RATIO = 0.45;
+    /// @brief 实测刷新偏离网格超过该比例的间隔时重新定相
+    constexpr double REPHASE_RATIO = 0.25;
+}
+
+RefreshClock::RefreshClock(double refresh_hz) :
+    m_refresh_hz(refresh_hz > 0. ? refresh_hz : DEFAULT_REFRESH_HZ),
+    m_interval(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1. / m_refresh_hz)))
+{}
+
+double RefreshClock::refresh_hz()const
+{
+    return m_refresh_hz;
+}
+
+RefreshClock::Clock::duration RefreshClock::interval()const
+{
+    return m_interval;
+}
+
+RefreshClock::Clock::time_point RefreshClock::next_refresh(Clock::time_point now)
+{
+    if (!m_has_phase)
+    {
+        m_phase = now;
+        m_has_phase = true;
+    }
+    if (now < m_phase)
+    {
+        return m_phase;
+    }
+    auto count = (now - m_phase) / m_interval + 1;
+    return m_phase + count * m_interval;
+}
+
+RefreshClock::Clock::time_point RefreshClock::observe(Clock::time_point refresh_time)
+{
+    if (!m_has_phase)
+    {
+        m_phase = refresh_time;
+        m_has_phase = true;
+        return refresh_time;
+    }
+    double offset = std::chrono::duration<double>(refresh_time - m_phase).count() / std::chrono::duration<double>(m_interval).count();
+    Clock::time_point nearest = m_phase + std::llround(offset) * m_interval;
+    Clock::duration error = refresh_time - nearest;
+    if (std::abs(std::chrono::duration<double>(error).count()) > std::chrono::duration<double>(m_interval).count() * REPHASE_RATIO)
+    {
+        // 偏离过大（呈现被阻塞或未真正等待垂直同步），以实测时刻重新定相
+        m_phase = refresh_time;
+        return refresh_time;
+    }
+    // 小偏差只部分修正，跟随显示器时钟的缓慢漂移而不放大调度抖动
+    m_phase = nearest + error / 8;
+    return nearest;
+}
+
+FramePacer::FramePacer(std::shared_ptr<PlaybackRateControl> control, Clock::duration refresh_interval) :
+    m_playback_clock(control), m_control(std::move(control)), m_refresh_interval(refresh_interval)
+{
+    m_report.refresh_hz = 1. / std::chrono::duration<double>(m_refresh_interval).count();
+}
+
+std::optional<AVFrameView> FramePacer::take_frame(FrameQueue& frame_queue, Clock::time_point refresh_time)
+{
+    m_report.refreshes++;
+    auto lookahead = std::chrono::duration_cast<Clock::duration>(m_refresh_interval * REFRESH_LOOKAHEAD_RATIO);
+    std::optional<AVFrameView> frame = m_playback_clock.take_due_frame(frame_queue, refresh_time, lookahead);
+    if (!frame && m_last_present_time)
+    {
+        m_report.repeated_refreshes++;
+    }
+    return frame;
+}
+
+void FramePacer::record_presented(const AVFrameView& frame, Clock::time_point target_time, Clock::time_point present_time)
+{
+    m_report.presented_frames++;
+    if (present_time - target_time > m_refresh_interval / 2)
+    {
+        m_report.missed_refreshes++;
+    }
+    std::optional<double> seconds = frame.seconds();
+    if (m_last_present_time && m_last_frame_seconds && seconds)
+    {
+        double interval = std::chrono::duration<double>(present_time - *m_last_present_time).count();
+        double rate = m_control ? m_control->rate() : 1.;
+        double ideal = (*seconds - *m_last_frame_seconds) / rate;
+        // 定位后时间戳回退的一对帧不计入
+        if (interval > 0. && ideal > 0.)
+        {
+            m_interval_sum += interval;
+            m_interval_square_sum += interval * interval;
+            m_ideal_sum += ideal;
+            m_error_square_sum += (interval - ideal) * (interval - ideal);
+            m_interval_count++;
+            double refreshes = interval / std::chrono::duration<double>(m_refresh_interval).count();
+            std::size_t bucket = static_cast<std::size_t>(std::clamp<long long>(std::llround(refreshes), 1, HISTOGRAM_BUCKETS)) - 1;
+            m_report.interval_histogram[bucket]++;
+        }
+    }
+    m_last_present_time = present_time;
+    m_last_frame_seconds = seconds;
+}
+
+void FramePacer::pause()
+{
+    m_playback_clock.pause();
+    m_last_present_time.reset();
+    m_last_frame_seconds.reset();
+}
+
+FramePacer::Report FramePacer::get_report()const
+{
+    Report report = m_report;
+    if (m_interval_count > 0)
+    {
+        double count = static_cast<double>(m_interval_count);
+        double mean = m_interval_sum / count;
+        report.mean_interval_ms = mean * 1000.;
+        report.interval_stddev_ms = std::sqrt(std::max(m_interval_square_sum / count - mean * mean, 0.)) * 1000.;
+        double ideal_mean = m_ideal_sum / count;
+        report.judder_score = ideal_mean > 0. ? std::sqrt(m_error_square_sum / count) / ideal_mean : 0.;
+    }
+    return report;
+}
+
+int run_pacing_benchmark(const std::vector<std::string>& inputs, double refresh_hz, int seconds)
+{
+    std::vector<std::string> file_paths = collect_media_files(inputs);
+    if (file_paths.empty() || seconds <= 0)
+    {
+        DANEJOE_CLOG(ERROR, APP, "PacingBench", "Usage: pacing-bench <input> [--refresh=60] [--seconds=10]");
+        return -1;
+    }
+    const std::string& file_path = file_paths.front();
+    auto control = std::make_shared<PlaybackRateControl>();
+    auto frame_queue = std::make_shared<FrameQueue>(64);
+    RefreshClock refresh_clock(refresh_hz);
+    FramePacer pacer(control, refresh_clock.interval());
+    DaneJoe::PreciseTimer::Options timer_options;
+    timer_options.spin = std::chrono::microseconds(100);
+    DaneJoe::PreciseTimer present_timer(timer_options);
+    {
+        std::jthread decode_thread(decode_mp4, file_path, std::weak_ptr<FrameQueue>(frame_queue), control, std::string());
+        Clock::time_point deadline = Clock::now() + std::chrono::seconds(seconds);
+        while (Clock::now() < deadline)
+        {
+            // 先为下一次刷新选帧，再等到该刷新时刻“呈现”，与开启 vsync 时阻塞在 present 的顺序一致
+            Clock::time_point target = refresh_clock.next_refresh(Clock::now());
+            std::optional<AVFrameView> frame = pacer.take_frame(*frame_queue, target);
+            present_timer.sleep_until(target);
+            if (frame)
+            {
+                Clock::time_point now = Clock::now();
+                Clock::time_point present_time = now - target > refresh_clock.interval() / 2 ? refresh_clock.next_refresh(now) : target;
+                pacer.record_presented(*frame, target, present_time);
+            }
+        }
+        frame_queue->close();
+    }
+    FramePacer::Report report = pacer.get_report();
+    PlaybackRateControl::Report rate_report = control->get_report();
+    std::cout << std::fixed << std::setprecision(2)
+        << "file: " << file_path << ", simulated refresh: " << report.refresh_hz << " Hz, seconds: " << seconds << "\n"
+        << "refreshes: " << report.refreshes << ", presented: " << report.presented_frames
+        << ", repeated: " << report.repeated_refreshes << ", missed: " << report.missed_refreshes
+        << ", dropped: " << rate_report.dropped_frames << "\n"
+        << "interval: " << report.mean_interval_ms << " ms (stddev " << report.interval_stddev_ms << " ms)"
+        << ", judder score: " << std::setprecision(3) << report.judder_score << "\n";
+    std::cout << "refreshes/frame:";
+    for (std::size_t i = 0; i < report.interval_histogram.size(); i++)
+    {
+        std::cout << "  " << i + 1 << (i + 1 == report.interval_histogram.size() ? "+" : "") << ": " << report.interval_histogram[i];
+    }
+    std::cout << "\n";
+    return 0;
+}
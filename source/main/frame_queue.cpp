@@ -0,0 +1,76 @@
+#include "main/frame_queue.hpp"
+
+FrameQueue::FrameQueue(std::size_t capacity) :m_capacity(capacity), m_queue(capacity) {}
+
+bool FrameQueue::push(AVFrameView&& frame)
+{
+    // 先计数再入队，保证消费端的递减不会先于递增；队列已关闭而被拒绝时撤回计数
+    m_size.fetch_add(1, std::memory_order_acq_rel);
+    if (!m_queue.push(std::move(frame)))
+    {
+        m_size.fetch_sub(1, std::memory_order_acq_rel);
+        return false;
+    }
+    return true;
+}
+
+bool FrameQueue::try_push(AVFrameView& frame)
+{
+    if (!is_running() || is_full())
+    {
+        return false;
+    }
+    return push(std::move(frame));
+}
+
+std::optional<AVFrameView> FrameQueue::try_pop()
+{
+    auto frame = m_queue.try_pop();
+    if (frame.has_value() && m_size.fetch_sub(1, std::memory_order_acq_rel) >= m_capacity)
+    {
+        // 只在腾出空间时通知，未满时取帧不产生额外开销
+        notify_not_full();
+    }
+    return frame;
+}
+
+void FrameQueue::close()
+{
+    m_queue.close();
+    notify_not_full();
+}
+
+bool FrameQueue::is_running()
+{
+    return m_queue.is_running();
+}
+
+std::size_t FrameQueue::size()const
+{
+    return m_size.load(std::memory_order_acquire);
+}
+
+std::size_t FrameQueue::capacity()const
+{
+    return m_capacity;
+}
+
+bool FrameQueue::is_full()const
+{
+    return size() >= m_capacity;
+}
+
+void FrameQueue::set_on_not_full(std::function<void()> callback)
+{
+    std::lock_guard<std::mutex> lock(m_callback_mutex);
+    m_on_not_full = std::move(callback);
+}
+
+void FrameQueue::notify_not_full()
+{
+    std::lock_guard<std::mutex> lock(m_callback_mutex);
+    if (m_on_not_full)
+    {
+        m_on_not_full();
+    }
+}
@@ -0,0 +1,505 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+#include "main/frame_stepper.hpp"
+#include "main/batch_processor.hpp"
+#include "util/util_log.hpp"
+#include "util/util_trace_recorder.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double elapsed_ms(Clock::time_point begin)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    }
+}
+
+double DecodedFrameCache::Stats::hit_rate()const
+{
+    uint64_t lookups = hits + misses;
+    return lookups > 0 ? static_cast<double>(hits) / lookups : 0.;
+}
+
+DecodedFrameCache::DecodedFrameCache(std::size_t capacity_bytes)
+{
+    m_stats.capacity_bytes = capacity_bytes;
+}
+
+void DecodedFrameCache::set_evict_callback(EvictCallback callback)
+{
+    m_evict_callback = std::move(callback);
+}
+
+void DecodedFrameCache::set_capacity(std::size_t capacity_bytes)
+{
+    m_stats.capacity_bytes = capacity_bytes;
+    evict();
+}
+
+void DecodedFrameCache::insert(int64_t pts, const AVFramePtr& frame)
+{
+    AVFramePtr shared(frame);
+    if (!shared)
+    {
+        return;
+    }
+    std::size_t bytes = frame_bytes(shared.get());
+    auto iterator = m_entries.find(pts);
+    if (iterator != m_entries.end())
+    {
+        m_stats.bytes -= iterator->second.bytes;
+        iterator->second.frame = std::move(shared);
+        iterator->second.bytes = bytes;
+        m_lru.splice(m_lru.begin(), m_lru, iterator->second.lru_iterator);
+    }
+    else
+    {
+        m_lru.push_front(pts);
+        m_entries.emplace(pts, Entry{ std::move(shared), bytes, m_lru.begin() });
+    }
+    m_stats.bytes += bytes;
+    m_stats.peak_bytes = std::max(m_stats.peak_bytes, m_stats.bytes);
+    evict();
+}
+
+std::optional<AVFramePtr> DecodedFrameCache::find(int64_t pts)
+{
+    auto iterator = m_entries.find(pts);
+    if (iterator == m_entries.end())
+    {
+        m_stats.misses++;
+        return std::nullopt;
+    }
+    m_stats.hits++;
+    m_lru.splice(m_lru.begin(), m_lru, iterator->second.lru_iterator);
+    return iterator->second.frame;
+}
+
+bool DecodedFrameCache::contains(int64_t pts)const
+{
+    return m_entries.contains(pts);
+}
+
+void DecodedFrameCache::clear()
+{
+    m_entries.clear();
+    m_lru.clear();
+    m_stats.bytes = 0;
+}
+
+DecodedFrameCache::Stats DecodedFrameCache::get_stats()const
+{
+    Stats stats = m_stats;
+    stats.entries = m_entries.size();
+    return stats;
+}
+
+std::size_t DecodedFrameCache::frame_bytes(const AVFrame* frame)
+{
+    if (!frame)
+    {
+        return 0;
+    }
+    std::size_t bytes = 0;
+    for (int i = 0; i < AV_NUM_DATA_POINTERS && frame->buf[i]; i++)
+    {
+        bytes += frame->buf[i]->size;
+    }
+    for (int i = 0; i < frame->nb_extended_buf; i++)
+    {
+        bytes += frame->extended_buf[i]->size;
+    }
+    return bytes;
+}
+
+void DecodedFrameCache::evict()
+{
+    // 至少保留最近使用的一帧，上限小于单帧大小时缓存退化为只保存当前帧
+    while (m_stats.bytes > m_stats.capacity_bytes && m_lru.size() > 1)
+    {
+        int64_t pts = m_lru.back();
+        auto iterator = m_entries.find(pts);
+        m_stats.bytes -= iterator->second.bytes;
+        m_entries.erase(iterator);
+        m_lru.pop_back();
+        m_stats.evictions++;
+        if (m_evict_callback)
+        {
+            m_evict_callback(pts);
+        }
+    }
+}
+
+FrameStepper::FrameStepper() :FrameStepper(Options()) {}
+
+FrameStepper::FrameStepper(const Options& options) :m_options(options), m_cache(options.cache_capacity_bytes)
+{
+    m_cache.set_evict_callback([this](int64_t pts) { forget_neighbours(pts); });
+}
+
+AVError FrameStepper::open(const std::string& file_path)
+{
+    close();
+    return m_decoder.open(file_path, m_options.decoder_options);
+}
+
+void FrameStepper::close()
+{
+    m_decoder.close();
+    m_cache.clear();
+    m_next_pts.clear();
+    m_previous_pts.clear();
+    m_current_pts.reset();
+    m_decoder_pts.reset();
+}
+
+bool FrameStepper::is_open()const
+{
+    return m_decoder.is_open();
+}
+
+const std::string& FrameStepper::file_path()const
+{
+    return m_decoder.file_path();
+}
+
+AVError FrameStepper::decode_next(AVFramePtr& frame, int64_t& pts)
+{
+    while (true)
+    {
+        AVError error = m_decoder.decode_frame(frame);
+        if (error.failed())
+        {
+            return error;
+        }
+        m_stats.decoded_frames++;
+        pts = frame_pts(frame.get());
+        if (pts == AV_NOPTS_VALUE)
+        {
+            continue;
+        }
+        // 解码器按显示顺序输出，同一次定位后连续解码出的两帧即为相邻帧
+        if (m_decoder_pts && *m_decoder_pts < pts)
+        {
+            m_next_pts[*m_decoder_pts] = pts;
+            m_previous_pts[pts] = *m_decoder_pts;
+        }
+        m_decoder_pts = pts;
+        m_cache.insert(pts, frame);
+        return AVError(0);
+    }
+}
+
+AVError FrameStepper::seek_decoder(int64_t pts)
+{
+    int64_t timestamp_ms = av_rescale_q_rnd(pts - m_decoder.start_pts(), m_decoder.time_base(), AVRational{ 1, 1000 }, AV_ROUND_DOWN);
+    m_decoder_pts.reset();
+    return m_decoder.seek(std::max<int64_t>(timestamp_ms, 0));
+}
+
+AVError FrameStepper::decode_before(int64_t end_pts, AVFramePtr& frame, int64_t& pts)
+{
+    DANEJOE_TRACE_SCOPE_ARG(DECODE, "step_gop", end_pts);
+    m_stats.gop_decodes++;
+    SeekBackoff backoff(m_decoder, end_pts - 1);
+    while (true)
+    {
+        AVError error = seek_decoder(backoff.target());
+        if (error.failed())
+        {
+            return error;
+        }
+        bool is_found = false;
+        AVFramePtr decoded;
+        int64_t decoded_pts = 0;
+        while (true)
+        {
+            error = decode_next(decoded, decoded_pts);
+            if (error == AVERROR_EOF)
+            {
+                break;
+            }
+            if (error.failed())
+            {
+                return error;
+            }
+            if (decoded_pts >= end_pts)
+            {
+                break;
+            }
+            frame = decoded;
+            pts = decoded_pts;
+            is_found = true;
+        }
+        if (is_found)
+        {
+            return AVError(0);
+        }
+        if (!backoff.can_retreat())
+        {
+            // 已从文件开头解码，结束时间之前没有帧
+            return AVError(AVERROR_EOF);
+        }
+        // 定位落在了目标上或之后（索引不精确的容器），继续向前退
+        backoff.retreat();
+    }
+}
+
+AVError FrameStepper::present(int64_t pts, const AVFramePtr& frame, AVFrameView& frame_view)
+{
+    AVFramePtr shared(frame);
+    frame_view = AVFrameView(shared);
+    frame_view.set_time_base(m_decoder.time_base());
+    if (frame_view.get_error().ok())
+    {
+        m_current_pts = pts;
+    }
+    return frame_view.get_error();
+}
+
+void FrameStepper::forget_neighbours(int64_t pts)
+{
+    auto next = m_next_pts.find(pts);
+    if (next != m_next_pts.end())
+    {
+        auto reverse = m_previous_pts.find(next->second);
+        if (reverse != m_previous_pts.end() && reverse->second == pts)
+        {
+            m_previous_pts.erase(reverse);
+        }
+        m_next_pts.erase(next);
+    }
+    auto previous = m_previous_pts.find(pts);
+    if (previous != m_previous_pts.end())
+    {
+        auto reverse = m_next_pts.find(previous->second);
+        if (reverse != m_next_pts.end() && reverse->second == pts)
+        {
+            m_next_pts.erase(reverse);
+        }
+        m_previous_pts.erase(previous);
+    }
+}
+
+AVError FrameStepper::seek(double seconds, AVFrameView& frame_view)
+{
+    if (!is_open())
+    {
+        return AVError(AVERROR(EINVAL));
+    }
+    Clock::time_point begin = Clock::now();
+    int64_t target_pts = std::llround(seconds / av_q2d(m_decoder.time_base()));
+    AVError error = seek_decoder(target_pts);
+    if (error.failed())
+    {
+        return error;
+    }
+    std::optional<AVFramePtr> selected;
+    int64_t selected_pts = 0;
+    while (true)
+    {
+        AVFramePtr decoded;
+        int64_t decoded_pts = 0;
+        error = decode_next(decoded, decoded_pts);
+        if (error == AVERROR_EOF)
+        {
+            break;
+        }
+        if (error.failed())
+        {
+            return error;
+        }
+        // 目标早于第一帧时取第一帧；解码器停在目标之后的一帧，向前单步直接命中缓存
+        if (decoded_pts > target_pts && selected)
+        {
+            break;
+        }
+        selected = std::move(decoded);
+        selected_pts = decoded_pts;
+        if (selected_pts >= target_pts)
+        {
+            break;
+        }
+    }
+    if (!selected)
+    {
+        return AVError(AVERROR_EOF);
+    }
+    m_stats.last_step_ms = elapsed_ms(begin);
+    return present(selected_pts, *selected, frame_view);
+}
+
+AVError FrameStepper::step_forward(AVFrameView& frame_view)
+{
+    if (!m_current_pts)
+    {
+        return AVError(AVERROR(EINVAL));
+    }
+    DANEJOE_TRACE_SCOPE_ARG(DECODE, "step_forward", *m_current_pts);
+    Clock::time_point begin = Clock::now();
+    m_stats.forward_steps++;
+    int64_t current_pts = *m_current_pts;
+    auto next = m_next_pts.find(current_pts);
+    if (next != m_next_pts.end())
+    {
+        std::optional<AVFramePtr> cached = m_cache.find(next->second);
+        if (cached)
+        {
+            m_stats.cached_steps++;
+            m_stats.last_step_ms = elapsed_ms(begin);
+            return present(next->second, *cached, frame_view);
+        }
+    }
+    AVFramePtr frame;
+    int64_t pts = 0;
+    if (m_decoder_pts != current_pts)
+    {
+        // 解码器不在当前帧之后，从当前帧所在 GOP 的关键帧重新解码到当前帧
+        m_stats.gop_decodes++;
+        AVError error = seek_decoder(current_pts);
+        if (error.failed())
+        {
+            return error;
+        }
+    }
+    while (true)
+    {
+        AVError error = decode_next(frame, pts);
+        if (error.failed())
+        {
+            return error;
+        }
+        if (pts > current_pts)
+        {
+            break;
+        }
+    }
+    m_stats.last_step_ms = elapsed_ms(begin);
+    return present(pts, frame, frame_view);
+}
+
+AVError FrameStepper::step_back(AVFrameView& frame_view)
+{
+    if (!m_current_pts)
+    {
+        return AVError(AVERROR(EINVAL));
+    }
+    DANEJOE_TRACE_SCOPE_ARG(DECODE, "step_back", *m_current_pts);
+    Clock::time_point begin = Clock::now();
+    m_stats.back_steps++;
+    int64_t current_pts = *m_current_pts;
+    auto previous = m_previous_pts.find(current_pts);
+    if (previous != m_previous_pts.end())
+    {
+        std::optional<AVFramePtr> cached = m_cache.find(previous->second);
+        if (cached)
+        {
+            m_stats.cached_steps++;
+            m_stats.last_step_ms = elapsed_ms(begin);
+            return present(previous->second, *cached, frame_view);
+        }
+    }
+    // 未命中：解码一次包含上一帧的 GOP，GOP 内的帧全部进入缓存，之后的后退直接命中
+    AVFramePtr frame;
+    int64_t pts = 0;
+    AVError error = decode_before(current_pts, frame, pts);
+    if (error.failed())
+    {
+        return error;
+    }
+    m_stats.last_step_ms = elapsed_ms(begin);
+    DANEJOE_CLOG(DEBUG, DECODE, "FrameStepper", "Decoded GOP before {} in {} ms", current_pts, m_stats.last_step_ms);
+    return present(pts, frame, frame_view);
+}
+
+std::optional<int64_t> FrameStepper::current_pts()const
+{
+    return m_current_pts;
+}
+
+std::optional<double> FrameStepper::current_seconds()const
+{
+    if (!m_current_pts)
+    {
+        return std::nullopt;
+    }
+    return *m_current_pts * av_q2d(m_decoder.time_base());
+}
+
+FrameStepper::Stats FrameStepper::get_stats()const
+{
+    Stats stats = m_stats;
+    stats.cache = m_cache.get_stats();
+    return stats;
+}
+
+int run_step_benchmark(const std::vector<std::string>& inputs, int steps, int cache_mb)
+{
+    std::vector<std::string> file_paths = collect_media_files(inputs);
+    if (file_paths.empty() || steps <= 0 || cache_mb < 0)
+    {
+        DANEJOE_CLOG(ERROR, APP, "StepBenchmark", "Invalid arguments");
+        return -1;
+    }
+    const std::string& file_path = file_paths.front();
+    std::cout << "file: " << file_path << ", steps: " << steps << "\n";
+    std::cout << std::setw(10) << "cache MB" << std::setw(12) << "back avg" << std::setw(12) << "back max"
+        << std::setw(12) << "fwd avg" << std::setw(12) << "fwd max" << std::setw(10) << "hit rate"
+        << std::setw(8) << "GOPs" << std::setw(10) << "frames" << std::setw(10) << "peak MB" << "\n";
+    // 不缓存（只保留当前帧）时每次后退都要重新解码 GOP，作为对照
+    for (int capacity_mb : { 0, cache_mb })
+    {
+        FrameStepper::Options options;
+        options.cache_capacity_bytes = static_cast<std::size_t>(capacity_mb) * 1024 * 1024;
+        FrameStepper frame_stepper(options);
+        AVError error = frame_stepper.open(file_path);
+        if (error.failed())
+        {
+            DANEJOE_CLOG(ERROR, APP, "StepBenchmark", "Failed to open {}: {}", file_path, error.message());
+            return -1;
+        }
+        MediaDecoder probe;
+        double start_seconds = 0.;
+        if (probe.open(file_path).ok())
+        {
+            start_seconds = probe.start_pts() * av_q2d(probe.time_base()) + probe.duration_ms() / 2000.;
+        }
+        AVFrameView frame_view;
+        error = frame_stepper.seek(start_seconds, frame_view);
+        if (error.failed())
+        {
+            DANEJOE_CLOG(ERROR, APP, "StepBenchmark", "Seek failed: {}", error.message());
+            return -1;
+        }
+        double back_total = 0., back_max = 0., forward_total = 0., forward_max = 0.;
+        int back_steps = 0, forward_steps = 0;
+        for (int i = 0; i < steps && frame_stepper.step_back(frame_view).ok(); i++, back_steps++)
+        {
+            back_total += frame_stepper.get_stats().last_step_ms;
+            back_max = std::max(back_max, frame_stepper.get_stats().last_step_ms);
+        }
+        for (int i = 0; i < steps && frame_stepper.step_forward(frame_view).ok(); i++, forward_steps++)
+        {
+            forward_total += frame_stepper.get_stats().last_step_ms;
+            forward_max = std::max(forward_max, frame_stepper.get_stats().last_step_ms);
+        }
+        FrameStepper::Stats stats = frame_stepper.get_stats();
+        std::cout << std::fixed << std::setprecision(2)
+            << std::setw(10) << capacity_mb
+            << std::setw(12) << (back_steps > 0 ? back_total / back_steps : 0.)
+            << std::setw(12) << back_max
+            << std::setw(12) << (forward_steps > 0 ? forward_total / forward_steps : 0.)
+            << std::setw(12) << forward_max
+            << std::setw(9) << std::setprecision(1) << stats.cache.hit_rate() * 100. << "%"
+            << std::setw(8) << stats.gop_decodes
+            << std::setw(10) << stats.decoded_frames
+            << std::setw(10) << stats.cache.peak_bytes / (1024. * 1024.)
+            << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,421 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "main/gop_parallel_decoder.hpp"
+#include "main/batch_processor.hpp"
+#include "util/util_log.hpp"
+#include "util/util_trace_recorder.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    double elapsed_ms(Clock::time_point begin)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    }
+
+    /**
+     * @struct KeyFrame
+     * @brief 扫描到的关键帧数据包
+     */
+    struct KeyFrame
+    {
+        int64_t pts = AV_NOPTS_VALUE;
+        int64_t dts = AV_NOPTS_VALUE;
+    };
+}
+
+GopParallelDecoder::GopParallelDecoder(std::string file_path, const Options& options) :
+    m_file_path(std::move(file_path)), m_options(options)
+{
+    if (m_options.workers == 0)
+    {
+        m_options.workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    m_options.ranges_per_worker = std::max<std::size_t>(m_options.ranges_per_worker, 1);
+    m_options.reorder_frames = std::max<std::size_t>(m_options.reorder_frames, 1);
+}
+
+const std::vector<GopParallelDecoder::Range>& GopParallelDecoder::ranges()const
+{
+    return m_ranges;
+}
+
+const GopParallelDecoder::Stats& GopParallelDecoder::get_stats()const
+{
+    return m_stats;
+}
+
+AVError GopParallelDecoder::build_ranges()
+{
+    DANEJOE_TRACE_SCOPE(DEMUX, "scan_keyframes");
+    // 容器的定位索引按格式存放解码或显示时间戳，区间要按显示时间精确分界，因此只解封装扫一遍数据包取两者
+    MediaDecoder decoder;
+    AVError error = decoder.open(m_file_path, m_options.decoder_options);
+    if (error.failed())
+    {
+        return error;
+    }
+    std::vector<KeyFrame> key_frames;
+    while (true)
+    {
+        AVPacketPtr packet;
+        error = packet.ensure_allocated();
+        if (error.ok())
+        {
+            error = decoder.format_context().read_frame(packet);
+        }
+        if (error == AVERROR_EOF)
+        {
+            break;
+        }
+        if (error.failed())
+        {
+            return error;
+        }
+        if (packet->stream_index != decoder.video_stream_index() || !(packet->flags & AV_PKT_FLAG_KEY) || packet->pts == AV_NOPTS_VALUE)
+        {
+            continue;
+        }
+        // 分界点须严格递增，乱序的关键帧并入前一个 GOP
+        if (!key_frames.empty() && packet->pts <= key_frames.back().pts)
+        {
+            continue;
+        }
+        key_frames.push_back(KeyFrame{ packet->pts, packet->dts != AV_NOPTS_VALUE ? packet->dts : packet->pts });
+    }
+    if (key_frames.empty())
+    {
+        DANEJOE_CLOG(ERROR, DECODE, "GopParallelDecoder", "No key frames found in {}", m_file_path);
+        return AVError(AVERROR_INVALIDDATA);
+    }
+    std::size_t gop_count = key_frames.size();
+    std::size_t range_count = std::min(gop_count, m_options.workers * m_options.ranges_per_worker);
+    m_ranges.clear();
+    for (std::size_t i = 0; i < range_count; i++)
+    {
+        std::size_t first_gop = i * gop_count / range_count;
+        std::size_t last_gop = (i + 1) * gop_count / range_count;
+        Range range;
+        range.gops = last_gop - first_gop;
+        // 第一个区间从文件开头顺序解码，不定位
+        if (i > 0)
+        {
+            range.seek_timestamp = key_frames[first_gop].dts;
+            range.begin_pts = key_frames[first_gop].pts;
+        }
+        if (last_gop < gop_count)
+        {
+            range.end_pts = key_frames[last_gop].pts;
+        }
+        m_ranges.push_back(range);
+    }
+    m_stats.ranges = m_ranges.size();
+    m_stats.gops = gop_count;
+    return AVError(0);
+}
+
+AVError GopParallelDecoder::decode_range(MediaDecoder& decoder, const Range& range, const std::function<bool(AVFramePtr&)>& emit)
+{
+    SeekBackoff backoff(decoder, range.seek_timestamp);
+    while (true)
+    {
+        // 第一个区间总是最先被领取，领取它的解码器刚打开、位于文件开头，不必定位
+        if (range.seek_timestamp != AV_NOPTS_VALUE)
+        {
+            AVError error = decoder.seek_timestamp(backoff.target());
+            if (error.failed())
+            {
+                return error;
+            }
+        }
+        uint64_t decoded_frames = 0;
+        Clock::time_point decode_begin = Clock::now();
+        double decode_ms = 0.;
+        bool is_landed_late = false;
+        bool is_stopped = false;
+        while (!m_is_aborted.load(std::memory_order_relaxed))
+        {
+            AVFramePtr frame;
+            AVError error = decoder.decode_frame(frame);
+            if (error == AVERROR_EOF)
+            {
+                break;
+            }
+            if (error.failed())
+            {
+                return error;
+            }
+            decoded_frames++;
+            int64_t pts = frame_pts(frame.get());
+            // 索引不精确的容器可能定位到区间起点之后，第一帧就越过起点时向前退
+            if (decoded_frames == 1 && range.seek_timestamp != AV_NOPTS_VALUE && pts != AV_NOPTS_VALUE && pts > range.begin_pts && backoff.can_retreat())
+            {
+                is_landed_late = true;
+                break;
+            }
+            if (pts != AV_NOPTS_VALUE && pts >= range.end_pts)
+            {
+                break;
+            }
+            // 开放式 GOP 开头引用上一 GOP 的帧，由上一区间输出
+            if (pts == AV_NOPTS_VALUE || pts < range.begin_pts)
+            {
+                continue;
+            }
+            decode_ms += elapsed_ms(decode_begin);
+            bool is_continue = emit(frame);
+            decode_begin = Clock::now();
+            if (!is_continue)
+            {
+                is_stopped = true;
+                break;
+            }
+        }
+        decode_ms += elapsed_ms(decode_begin);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.decoded_frames += decoded_frames;
+            m_stats.decode_ms += decode_ms;
+        }
+        if (is_landed_late && !is_stopped)
+        {
+            backoff.retreat();
+            DANEJOE_CLOG_RATE_LIMITED(DEBUG, DECODE, "GopParallelDecoder", 1000, "Seek landed after range begin {}, retrying from {}", range.begin_pts, backoff.target());
+            continue;
+        }
+        return AVError(0);
+    }
+}
+
+void GopParallelDecoder::decode_worker(const FrameCallback& callback)
+{
+    DaneJoe::TraceRecorder::get_instance().set_thread_name("gop_decode");
+    MediaDecoder decoder;
+    AVError error = decoder.open(m_file_path, m_options.decoder_options);
+    if (error.failed())
+    {
+        abort(error);
+        return;
+    }
+    while (!m_is_aborted.load(std::memory_order_relaxed))
+    {
+        std::size_t range_index = m_next_range.fetch_add(1, std::memory_order_relaxed);
+        if (range_index >= m_ranges.size())
+        {
+            break;
+        }
+        DANEJOE_TRACE_SCOPE_ARG(DECODE, "gop_range", range_index);
+        std::function<bool(AVFramePtr&)> emit;
+        if (m_options.order == Order::GLOBAL)
+        {
+            DaneJoe::BoundedQueue<AVFramePtr>& queue = *m_range_queues[range_index];
+            emit = [&queue](AVFramePtr& frame) { return queue.push(std::move(frame)); };
+        }
+        else
+        {
+            emit = [this, &callback, range_index](AVFramePtr& frame)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_stats.frames++;
+                    }
+                    return callback(range_index, frame);
+                };
+        }
+        error = decode_range(decoder, m_ranges[range_index], emit);
+        if (m_options.order == Order::GLOBAL)
+        {
+            m_range_queues[range_index]->finish();
+        }
+        if (error.failed())
+        {
+            DANEJOE_CLOG(WARN, DECODE, "GopParallelDecoder", "Decoding range {} of {} failed: {}", range_index, m_file_path, error.message());
+            abort(error);
+            return;
+        }
+    }
+}
+
+void GopParallelDecoder::abort(AVError error)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_is_aborted.exchange(true))
+        {
+            return;
+        }
+        m_error = error;
+    }
+    for (auto& queue : m_range_queues)
+    {
+        queue->close();
+    }
+}
+
+AVError GopParallelDecoder::run(const FrameCallback& callback)
+{
+    Clock::time_point begin = Clock::now();
+    m_stats = Stats();
+    m_error = AVError(0);
+    m_is_aborted = false;
+    m_next_range = 0;
+    m_range_queues.clear();
+    AVError error = build_ranges();
+    m_stats.scan_ms = elapsed_ms(begin);
+    if (error.failed())
+    {
+        return error;
+    }
+    if (m_options.order == Order::GLOBAL)
+    {
+        for (std::size_t i = 0; i < m_ranges.size(); i++)
+        {
+            m_range_queues.push_back(std::make_unique<DaneJoe::BoundedQueue<AVFramePtr>>(m_options.reorder_frames));
+        }
+    }
+    {
+        // 区间按下标递增领取，正在等待交付的区间总有线程在解码，全局有序交付不会死锁
+        std::vector<std::jthread> workers;
+        std::size_t worker_count = std::min(m_options.workers, m_ranges.size());
+        for (std::size_t i = 0; i < worker_count; i++)
+        {
+            workers.emplace_back(&GopParallelDecoder::decode_worker, this, std::cref(callback));
+        }
+        if (m_options.order == Order::GLOBAL)
+        {
+            for (std::size_t range_index = 0; range_index < m_range_queues.size() && !m_is_aborted.load(); range_index++)
+            {
+                while (std::optional<AVFramePtr> frame = m_range_queues[range_index]->pop())
+                {
+                    m_stats.frames++;
+                    if (!callback(range_index, *frame))
+                    {
+                        abort(AVError(0));
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    m_stats.wall_ms = elapsed_ms(begin);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_error;
+}
+
+int run_gop_parallel_benchmark(const std::vector<std::string>& inputs, std::size_t max_workers, bool is_per_range)
+{
+    std::vector<std::string> file_paths = collect_media_files(inputs);
+    if (file_paths.empty())
+    {
+        DANEJOE_CLOG(ERROR, APP, "GopParallelBenchmark", "Invalid arguments");
+        return -1;
+    }
+    const std::string& file_path = file_paths.front();
+    if (max_workers == 0)
+    {
+        max_workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // 逐帧分析负载：平均亮度；按顺序折叠成摘要，顺序或内容不一致时摘要不同
+    auto mean_luma = [](const AVFramePtr& frame)
+        {
+            uint64_t sum = 0;
+            for (int y = 0; y < frame->height; y++)
+            {
+                const uint8_t* row = frame->data[0] + static_cast<std::ptrdiff_t>(y) * frame->linesize[0];
+                for (int x = 0; x < frame->width; x++)
+                {
+                    sum += row[x];
+                }
+            }
+            return frame->width > 0 && frame->height > 0 ? sum / (static_cast<uint64_t>(frame->width) * frame->height) : 0;
+        };
+    auto fold = [](uint64_t digest, int64_t pts, uint64_t luma)
+        {
+            return (digest ^ static_cast<uint64_t>(pts) ^ (luma << 48)) * 1099511628211ull;
+        };
+
+    uint64_t expected_digest = 14695981039346656037ull;
+    uint64_t expected_frames = 0;
+    double baseline_ms = 0.;
+    {
+        MediaDecoder decoder;
+        AVError error = decoder.open(file_path, GopParallelDecoder::Options().decoder_options);
+        if (error.failed())
+        {
+            DANEJOE_CLOG(ERROR, APP, "GopParallelBenchmark", "Failed to open {}: {}", file_path, error.message());
+            return -1;
+        }
+        Clock::time_point begin = Clock::now();
+        AVFramePtr frame;
+        while (decoder.decode_frame(frame).ok())
+        {
+            expected_digest = fold(expected_digest, frame_pts(frame.get()), mean_luma(frame));
+            expected_frames++;
+        }
+        baseline_ms = elapsed_ms(begin);
+    }
+    std::cout << "file: " << file_path << ", order: " << (is_per_range ? "per-range" : "global") << "\n";
+    std::cout << std::setw(10) << "workers" << std::setw(8) << "ranges" << std::setw(10) << "frames" << std::setw(10) << "fps"
+        << std::setw(10) << "speedup" << std::setw(12) << "scan ms" << std::setw(12) << "overdecode" << std::setw(8) << "match" << "\n";
+    auto print_row = [&](const std::string& workers, std::size_t ranges, uint64_t frames, double wall_ms, double scan_ms, double overdecode, const char* match)
+        {
+            std::cout << std::fixed << std::setprecision(1)
+                << std::setw(10) << workers
+                << std::setw(8) << ranges
+                << std::setw(10) << frames
+                << std::setw(10) << (wall_ms > 0. ? frames * 1000. / wall_ms : 0.)
+                << std::setw(10) << std::setprecision(2) << (wall_ms > 0. ? baseline_ms / wall_ms : 0.)
+                << std::setw(12) << std::setprecision(1) << scan_ms
+                << std::setw(11) << std::setprecision(1) << overdecode * 100. << "%"
+                << std::setw(8) << match
+                << "\n";
+        };
+    print_row("serial", 1, expected_frames, baseline_ms, 0., 0., "-");
+    bool is_consistent = true;
+    for (std::size_t workers = 1; ; workers = std::min(workers * 2, max_workers))
+    {
+        GopParallelDecoder::Options options;
+        options.workers = workers;
+        options.order = is_per_range ? GopParallelDecoder::Order::PER_RANGE : GopParallelDecoder::Order::GLOBAL;
+        GopParallelDecoder decoder(file_path, options);
+        uint64_t digest = 14695981039346656037ull;
+        std::atomic<uint64_t> luma_total = 0;
+        AVError error = decoder.run([&](std::size_t, AVFramePtr& frame)
+            {
+                uint64_t luma = mean_luma(frame);
+                if (is_per_range)
+                {
+                    luma_total.fetch_add(luma, std::memory_order_relaxed);
+                }
+                else
+                {
+                    digest = fold(digest, frame_pts(frame.get()), luma);
+                }
+                return true;
+            });
+        if (error.failed())
+        {
+            DANEJOE_CLOG(ERROR, APP, "GopParallelBenchmark", "Parallel decoding failed: {}", error.message());
+            return -1;
+        }
+        const GopParallelDecoder::Stats& stats = decoder.get_stats();
+        bool is_match = stats.frames == expected_frames && (is_per_range || digest == expected_digest);
+        is_consistent = is_consistent && is_match;
+        double overdecode = stats.frames > 0 ? static_cast<double>(stats.decoded_frames) / stats.frames - 1. : 0.;
+        print_row(std::to_string(workers), stats.ranges, stats.frames, stats.wall_ms, stats.scan_ms, overdecode, is_match ? "yes" : "no");
+        if (workers >= max_workers)
+        {
+            break;
+        }
+    }
+    if (!is_consistent)
+    {
+        std::cout << "parallel output differs from sequential decoding\n";
+        return 1;
+    }
+    return 0;
+}
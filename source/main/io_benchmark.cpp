@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#if __has_include(<sys/resource.h>)
+#include <sys/resource.h>
+#define DANEJOE_HAS_RUSAGE 1
+#endif
+
+#include "main/io_benchmark.hpp"
+#include "main/batch_processor.hpp"
+#include "codec/i_av_io.hpp"
+#include "codec/av_read_ahead_io.hpp"
+#include "codec/av_format_context_ptr.hpp"
+#include "codec/av_packet_ptr.hpp"
+#include "util/util_log.hpp"
+
+namespace
+{
+    /**
+     * @struct IOCounters
+     * @brief 进程级 I/O 计数快照
+     */
+    struct IOCounters
+    {
+        /// @brief read 类系统调用次数（不可用时为 -1）
+        int64_t read_syscalls = -1;
+        /// @brief 次缺页
+        int64_t minor_faults = 0;
+        /// @brief 主缺页
+        int64_t major_faults = 0;
+    };
+
+    IOCounters sample_counters()
+    {
+        IOCounters counters;
+        std::ifstream proc_io("/proc/self/io");
+        std::string line;
+        while (std::getline(proc_io, line))
+        {
+            if (line.rfind("syscr:", 0) == 0)
+            {
+                counters.read_syscalls = std::stoll(line.substr(6));
+            }
+        }
+#if defined(DANEJOE_HAS_RUSAGE)
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+        {
+            counters.minor_faults = usage.ru_minflt;
+            counters.major_faults = usage.ru_majflt;
+        }
+#endif
+        return counters;
+    }
+
+    /**
+     * @struct RoundResult
+     * @brief 一轮解复用结果
+     */
+    struct RoundResult
+    {
+        double seconds = 0.;
+        uint64_t bytes = 0;
+        uint64_t packets = 0;
+        IOCounters counters;
+        /// @brief 预读层统计（各文件累加）
+        AVReadAheadIO::Stats read_ahead;
+    };
+
+    /**
+     * @brief 丢弃文件的页缓存，模拟冷读
+     */
+    void drop_file_cache(const std::string& file_path)
+    {
+        int fd = open(file_path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+
+    void accumulate(AVReadAheadIO::Stats& total, const AVReadAheadIO::Stats& stats)
+    {
+        uint64_t completed = total.reads_completed + stats.reads_completed;
+        if (completed > 0)
+        {
+            total.average_latency_ms = (total.average_latency_ms * total.reads_completed + stats.average_latency_ms * stats.reads_completed) / completed;
+        }
+        total.reads_issued += stats.reads_issued;
+        total.reads_completed = completed;
+        total.reads_cancelled += stats.reads_cancelled;
+        total.hits += stats.hits;
+        total.misses += stats.misses;
+        total.seeks += stats.seeks;
+        total.max_latency_ms = std::max(total.max_latency_ms, stats.max_latency_ms);
+        total.window_blocks = std::max(total.window_blocks, stats.window_blocks);
+        total.is_io_uring = stats.is_io_uring;
+    }
+
+    /**
+     * @brief 解复用单个文件的全部数据包
+     */
+    void demux_file(const std::string& file_path, AVIOBackend backend, RoundResult& result)
+    {
+        std::unique_ptr<IAVIO> io = create_av_io(backend);
+        AVFormatContextPtr format_context(nullptr);
+        AVError error = io ? io->open(file_path) : AVError(0);
+        if (error.ok())
+        {
+            error = io ? format_context.open_input(io->get(), file_path, nullptr, nullptr) : format_context.open_input(file_path, nullptr, nullptr);
+        }
+        if (error.ok())
+        {
+            error = format_context.find_stream_info(nullptr);
+        }
+        AVPacketPtr packet;
+        if (error.ok())
+        {
+            error = packet.ensure_allocated();
+        }
+        if (error.failed())
+        {
+            DANEJOE_CLOG(WARN, APP, "IOBenchmark", "Failed to open {}: {}", file_path, error.message());
+            return;
+        }
+        while (format_context.read_frame(packet).ok())
+        {
+            result.bytes += packet->size;
+            result.packets++;
+            packet.unref();
+        }
+        // 格式上下文须先于自定义 AVIOContext 关闭
+        format_context.close_input();
+        if (auto* read_ahead = dynamic_cast<AVReadAheadIO*>(io.get()))
+        {
+            accumulate(result.read_ahead, read_ahead->get_stats());
+        }
+    }
+
+    RoundResult run_round(const std::vector<std::string>& file_paths, AVIOBackend backend, bool is_cold)
+    {
+        if (is_cold)
+        {
+            for (const auto& file_path : file_paths)
+            {
+                drop_file_cache(file_path);
+            }
+        }
+        RoundResult result;
+        IOCounters before = sample_counters();
+        auto begin = std::chrono::steady_clock::now();
+        for (const auto& file_path : file_paths)
+        {
+            demux_file(file_path, backend, result);
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        IOCounters after = sample_counters();
+        result.counters.read_syscalls = before.read_syscalls < 0 ? -1 : after.read_syscalls - before.read_syscalls;
+        result.counters.minor_faults = after.minor_faults - before.minor_faults;
+        result.counters.major_faults = after.major_faults - before.major_faults;
+        return result;
+    }
+}
+
+int run_io_benchmark(const std::vector<std::string>& inputs, int rounds, bool is_cold)
+{
+    std::vector<std::string> file_paths = collect_media_files(inputs);
+    if (file_paths.empty() || rounds <= 0)
+    {
+        DANEJOE_CLOG(ERROR, APP, "IOBenchmark", "Invalid arguments");
+        return -1;
+    }
+    const std::vector<std::pair<std::string, AVIOBackend>> backends = {
+        { "default", AVIOBackend::DEFAULT },
+        { "mmap", AVIOBackend::MMAP },
+        { "readahead", AVIOBackend::READ_AHEAD },
+    };
+    if (!is_cold)
+    {
+        // 预热页缓存
+        run_round(file_paths, AVIOBackend::DEFAULT, false);
+    }
+
+    std::cout << "files: " << file_paths.size() << ", rounds: " << rounds << ", cache: " << (is_cold ? "cold" : "warm") << "\n";
+    std::cout << std::setw(10) << "backend" << std::setw(10) << "seconds" << std::setw(10) << "MiB/s"
+        << std::setw(12) << "packets/s" << std::setw(14) << "read syscalls" << std::setw(12) << "minor flt"
+        << std::setw(12) << "major flt" << "\n";
+    for (const auto& [name, backend] : backends)
+    {
+        RoundResult best;
+        for (int round = 0; round < rounds; round++)
+        {
+            RoundResult result = run_round(file_paths, backend, is_cold);
+            if (round == 0 || result.seconds < best.seconds)
+            {
+                best = result;
+            }
+        }
+        double seconds = std::max(best.seconds, 1e-9);
+        std::cout << std::fixed << std::setprecision(3)
+            << std::setw(10) << name
+            << std::setw(10) << best.seconds
+            << std::setw(10) << std::setprecision(1) << best.bytes / 1048576. / seconds
+            << std::setw(12) << best.packets / seconds
+            << std::setw(14) << best.counters.read_syscalls
+            << std::setw(12) << best.counters.minor_faults
+            << std::setw(12) << best.counters.major_faults
+            << "\n";
+        if (backend == AVIOBackend::READ_AHEAD)
+        {
+            const AVReadAheadIO::Stats& stats = best.read_ahead;
+            std::cout << std::setprecision(2)
+                << "  readahead(" << (stats.is_io_uring ? "io_uring" : "thread pool") << "): hit rate " << stats.hit_rate() * 100. << "%"
+                << ", read latency avg " << stats.average_latency_ms << " ms / max " << stats.max_latency_ms << " ms"
+                << ", reads " << stats.reads_issued << " (cancelled " << stats.reads_cancelled << ")"
+                << ", window " << stats.window_blocks << " MiB\n";
+        }
+    }
+    return 0;
+}
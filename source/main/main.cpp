@@ -2,6 +2,8 @@
 #include <memory>
 #include <cstdint>
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include <QApplication>
 #include <QImage>
@@ -11,22 +13,187 @@
 #include <QDebug>
 
 #include "logger/logger_manager.hpp"
+#include "util/util_log.hpp"
+#include "util/util_command_line.hpp"
+#include "util/util_trace_recorder.hpp"
 #include "view/main_window.hpp"
+#include "view/video_wall_window.hpp"
+#include "main/multi_stream_benchmark.hpp"
+#include "main/batch_processor.hpp"
+#include "main/thumbnail_extractor.hpp"
+#include "main/io_benchmark.hpp"
+#include "main/startup_benchmark.hpp"
+#include "main/playback_preloader.hpp"
+#include "main/playlist_decoder.hpp"
+#include "main/playback_rate.hpp"
+#include "main/reverse_decoder.hpp"
+#include "main/frame_stepper.hpp"
+#include "main/filter_stage.hpp"
+#include "main/transcoder.hpp"
+#include "main/gop_parallel_decoder.hpp"
+#include "main/frame_hash_verifier.hpp"
+#include "main/packet_demuxer.hpp"
+#include "main/frame_pacer.hpp"
+#include "main/timer_benchmark.hpp"
 
-#define LOG_LEVEL 0
 #define CLEAR_LOG_FILE 1
 
+/// @brief 未指定文件时播放的默认视频
+constexpr const char* DEFAULT_VIDEO_PATH = "/home/danejoe001/personal_code/code_cpp_project/cpp_project_multimedia/resource/400_300_25.mp4";
+
 void init_logger();
 
 int main(int argc, char* argv[])
 {
     init_logger();
 
+    /// @brief 第一个位置参数为运行模式，其余位置参数为输入文件
+    DaneJoe::CommandLine command_line(argc, argv);
+    const auto& arguments = command_line.positional();
+    std::string mode = arguments.empty() ? "" : arguments.front();
+    std::vector<std::string> inputs(arguments.begin() + (arguments.empty() ? 0 : 1), arguments.end());
+
+    /// @brief --trace=<file> 记录本次运行的追踪事件，退出时写出（.json 直接导出，否则为二进制）
+    std::unique_ptr<DaneJoe::TraceSession> trace_session;
+    if (command_line.has("trace"))
+    {
+        trace_session = std::make_unique<DaneJoe::TraceSession>(command_line.get("trace", "trace.bin"));
+    }
+    if (mode == "trace-convert")
+    {
+        if (inputs.size() != 2)
+        {
+            DANEJOE_CLOG(ERROR, APP, "Main", "Usage: trace-convert <trace.bin> <trace.json>");
+            return -1;
+        }
+        return DaneJoe::TraceRecorder::convert_to_chrome_json(inputs[0], inputs[1]) ? 0 : -1;
+    }
+
+    /// @brief 无界面模式
+    if (mode == "wall-bench")
+    {
+        return run_multi_stream_benchmark(inputs, command_line.get_int("streams", 16), command_line.get_int("seconds", 5));
+    }
+    if (mode == "threading-bench")
+    {
+        return run_threading_benchmark(inputs, command_line.get_int("streams", 4), command_line.get_int("seconds", 5));
+    }
+    if (mode == "batch-bench")
+    {
+        return run_batch_benchmark(inputs, command_line.get_int("repeat", 1));
+    }
+    if (mode == "thumbnails")
+    {
+        ThumbnailExtractor::Options options;
+        options.sample_count = command_line.get_int("samples", options.sample_count);
+        options.thumbnail_width = command_line.get_int("width", options.thumbnail_width);
+        options.output_directory = command_line.get("output", options.output_directory);
+        return run_thumbnail_batch(inputs, options, command_line.get_int("workers", 0));
+    }
+    if (mode == "io-bench")
+    {
+        return run_io_benchmark(inputs, command_line.get_int("rounds", 3), command_line.has("cold"));
+    }
+    if (mode == "open-bench")
+    {
+        return run_open_benchmark(inputs, command_line.get_int("rounds", 3), command_line.get_int("threads", 0));
+    }
+    if (mode == "playlist-bench")
+    {
+        return run_playlist_benchmark(inputs, command_line.get_int("preroll", 8));
+    }
+    if (mode == "rate-bench")
+    {
+        return run_rate_benchmark(inputs, command_line.get_int("seconds", 4));
+    }
+    if (mode == "reverse-bench")
+    {
+        return run_reverse_benchmark(inputs, command_line.get_int("segment-frames", 64));
+    }
+    if (mode == "step-bench")
+    {
+        return run_step_benchmark(inputs, command_line.get_int("steps", 120), command_line.get_int("cache-mb", 256));
+    }
+    if (mode == "filter-bench")
+    {
+        return run_filter_benchmark(inputs, command_line.get("vf", "null"));
+    }
+    if (mode == "gop-bench")
+    {
+        return run_gop_parallel_benchmark(inputs, command_line.get_int("workers", 0), command_line.has("per-range"));
+    }
+    if (mode == "framehash")
+    {
+        return run_frame_hash(inputs, command_line.get("write"), command_line.get("golden"), command_line.get_int("workers", 0));
+    }
+    if (mode == "demux-bench")
+    {
+        return run_demux_benchmark(inputs, command_line.get_double("speed", 1.));
+    }
+    if (mode == "pacing-bench")
+    {
+        return run_pacing_benchmark(inputs, command_line.get_double("refresh", 60.), command_line.get_int("seconds", 10));
+    }
+    if (mode == "timer-bench")
+    {
+        return run_timer_benchmark(command_line.get_int("count", 1000), command_line.get_int("period", 4000), command_line.get_int("spin", 100));
+    }
+    if (mode == "transcode")
+    {
+        Transcoder::Options options;
+        options.codec_name = command_line.get("codec", options.codec_name);
+        options.filter_description = command_line.get("vf");
+        options.start_ms = command_line.get_int("start", options.start_ms);
+        options.duration_ms = command_line.get_int("duration", options.duration_ms);
+        options.bit_rate = command_line.get_int("bitrate", options.bit_rate);
+        options.encoder_workers = command_line.get_int("workers", options.encoder_workers);
+        options.encoder_threads = command_line.get_int("threads", options.encoder_threads);
+        options.segment_frames = command_line.get_int("segment-frames", options.segment_frames);
+        return run_transcode(inputs, command_line.get("output", "export.mkv"), options);
+    }
+    if (mode == "ttff-bench")
+    {
+        StartupBenchmarkOptions options;
+        options.rounds = command_line.get_int("rounds", options.rounds);
+        options.probe_size = command_line.get_int("probesize", options.probe_size);
+        options.analyze_duration_us = command_line.get_int("analyzeduration", options.analyze_duration_us);
+        options.is_present = command_line.has("present");
+        return run_startup_benchmark(inputs, options);
+    }
+
+    /// @brief 播放模式：先启动解码预加载，再创建 QApplication 与窗口，二者并行
+    std::unique_ptr<PlaybackPreloader> preloader;
+    if (mode != "wall")
+    {
+        preloader = std::make_unique<PlaybackPreloader>();
+        // 指定多个文件时按播放列表无缝播放
+        preloader->get_rate_control()->set_rate(command_line.get_double("rate", 1.));
+        // --vf=<滤镜描述> 在解码与显示之间插入滤镜阶段（单文件正向播放）
+        preloader->set_filter(command_line.get("vf", ""));
+        std::vector<std::string> playlist = mode == "play" && !inputs.empty() ? inputs : std::vector<std::string>{ DEFAULT_VIDEO_PATH };
+        // --reverse 从第一个文件的结尾倒放
+        if (command_line.has("reverse"))
+        {
+            preloader->start_reverse(playlist.front(), command_line.get_int("segment-frames", 64));
+        }
+        else
+        {
+            preloader->start(playlist);
+        }
+    }
+
     QApplication a(argc, argv);
+    if (mode == "wall")
+    {
+        VideoWallWindow video_wall;
+        video_wall.init(inputs, command_line.get_int("workers", 0), command_line.has("compositor"));
+        video_wall.show();
+        return a.exec();
+    }
     MainWindow main_window;
-    main_window.init();
+    main_window.init(std::move(preloader));
     main_window.show();
-    DANEJOE_LOG_DEBUG("default", "Main", "After show");
+    DANEJOE_CLOG(DEBUG, APP, "Main", "After show");
     return a.exec();
 }
 
@@ -34,25 +201,30 @@ int main(int argc, char* argv[])
 void init_logger()
 {
     DaneJoe::ILogger::LoggerConfig config;
-#if LOG_LEVEL == 0
-    config.file_level = DaneJoe::ILogger::LogLevel::TRACE;
-    config.console_level = DaneJoe::ILogger::LogLevel::TRACE;
-#elif LOG_LEVEL == 1
-    config.file_level = DaneJoe::ILogger::LogLevel::DEBUG;
-    config.console_level = DaneJoe::ILogger::LogLevel::DEBUG;
-#elif LOG_LEVEL == 2
-    config.file_level = DaneJoe::ILogger::LogLevel::INFO;
-    config.console_level = DaneJoe::ILogger::LogLevel::INFO;
-#elif LOG_LEVEL == 3
-    config.file_level = DaneJoe::ILogger::LogLevel::WARN;
-    config.console_level = DaneJoe::ILogger::LogLevel::WARN;
-#elif LOG_LEVEL == 4
-    config.file_level = DaneJoe::ILogger::LogLevel::ERROR;
-    config.console_level = DaneJoe::ILogger::LogLevel::ERROR;
-#elif LOG_LEVEL == 5
-    config.file_level = DaneJoe::ILogger::LogLevel::FATAL;
-    config.console_level = DaneJoe::ILogger::LogLevel::FATAL;
-#endif
+    /// @note 运行时级别取各分类编译期阈值中的最小值，单独调低阈值的分类编译进程序的日志才不会被日志器丢弃
+    DaneJoe::ILogger::LogLevel level = DaneJoe::ILogger::LogLevel::FATAL;
+    switch (DaneJoe::Log::min_threshold())
+    {
+    case 0:
+        level = DaneJoe::ILogger::LogLevel::TRACE;
+        break;
+    case 1:
+        level = DaneJoe::ILogger::LogLevel::DEBUG;
+        break;
+    case 2:
+        level = DaneJoe::ILogger::LogLevel::INFO;
+        break;
+    case 3:
+        level = DaneJoe::ILogger::LogLevel::WARN;
+        break;
+    case 4:
+        level = DaneJoe::ILogger::LogLevel::ERROR;
+        break;
+    default:
+        break;
+    }
+    config.file_level = level;
+    config.console_level = level;
 
     DaneJoe::ManageLogger::get_instance().get_logger("default")->set_config(config);
 
@@ -0,0 +1,414 @@
+#include <algorithm>
+
+#include "main/media_decoder.hpp"
+#include "main/packet_demuxer.hpp"
+#include "main/stream_info_cache.hpp"
+#include "codec/av_codec_context_pool.hpp"
+#include "codec/av_shared_execute.hpp"
+#include "util/util_log.hpp"
+#include "codec/av_common.hpp"
+#include "util/util_startup_metrics.hpp"
+#include "util/util_trace_recorder.hpp"
+
+using Stage = DaneJoe::StartupMetrics::Stage;
+
+namespace
+{
+    /// @brief 定位落在目标之后时，第一次多退的步长（毫秒）
+    constexpr int64_t SEEK_BACKOFF_MS = 500;
+}
+
+MediaDecoder::MediaDecoder() {}
+
+MediaDecoder::~MediaDecoder()
+{
+    close();
+}
+
+AVError MediaDecoder::open(const std::string& file_path)
+{
+    return open(file_path, Options());
+}
+
+AVError MediaDecoder::open(const std::string& file_path, const Options& options)
+{
+    DaneJoe::StartupMetrics& metrics = DaneJoe::StartupMetrics::get_instance();
+    metrics.mark(Stage::OPEN_BEGIN);
+    close();
+    m_file_path = file_path;
+    /// @brief 探测参数，未设置的项保持 FFmpeg 默认值
+    AVDictionary* format_options = nullptr;
+    if (options.probe_size > 0)
+    {
+        av_dict_set_int(&format_options, "probesize", options.probe_size, 0);
+    }
+    if (options.analyze_duration_us > 0)
+    {
+        av_dict_set_int(&format_options, "analyzeduration", options.analyze_duration_us, 0);
+    }
+    /// @brief 打开输入流并读取标头
+    AVError error;
+    m_io = create_av_io(options.io_backend);
+    if (m_io)
+    {
+        error = m_io->open(file_path);
+        if (error.ok())
+        {
+            error = m_format_context.open_input(m_io->get(), file_path, nullptr, &format_options);
+        }
+    }
+    else
+    {
+        error = m_format_context.open_input(file_path, nullptr, &format_options);
+    }
+    av_dict_free(&format_options);
+    if (error.failed())
+    {
+        DANEJOE_CLOG(ERROR, DECODE, "MediaDecoder", "Failed to open {}: {}", file_path, error.message());
+        close();
+        return error;
+    }
+    metrics.mark(Stage::INPUT_OPENED);
+    error = load_stream_info(options);
+    if (error.failed())
+    {
+        DANEJOE_CLOG(ERROR, DECODE, "MediaDecoder", "Failed to find stream info: {}", error.message());
+        close();
+        return error;
+    }
+    metrics.mark(Stage::STREAM_INFO_READY);
+    const AVCodec* codec = nullptr;
+    m_video_stream_index = av_find_best_stream(m_format_context.get(), AVMEDIA_TYPE_VIDEO, -1, -1, &codec, 0);
+    if (m_video_stream_index < 0 || !codec)
+    {
+        DANEJOE_CLOG(ERROR, DECODE, "MediaDecoder", "No decodable video stream in {}", file_path);
+        error = m_video_stream_index < 0 ? AVError(m_video_stream_index) : AVError(AVERROR_DECODER_NOT_FOUND);
+        close();
+        return error;
+    }
+    AVStream* stream = m_format_context->streams[m_video_stream_index];
+    if (options.is_use_context_pool)
+    {
+        /// @brief 参数相同的已打开上下文直接复用
+        error = AVCodecContextPool::get_instance().acquire(codec, stream->codecpar, stream->time_base, options.thread_count, options.is_use_shared_thread_pool, m_codec_context, m_codec_pool_key);
+        if (error.failed())
+        {
+            DANEJOE_CLOG(ERROR, DECODE, "MediaDecoder", "Failed to open codec: {}", error.message());
+            m_codec_pool_key.clear();
+            close();
+            return error;
+        }
+        m_codec_context->skip_frame = options.skip_frame;
+    }
+    else
+    {
+        /// @brief 创建解码器上下文并复制解码参数
+        m_codec_context.alloc_context3(codec);
+        if (!m_codec_context)
+        {
+            close();
+            return AVError(AVERROR(ENOMEM));
+        }
+        error = m_codec_context.parameters_to_context(stream->codecpar);
+        if (error.failed())
+        {
+            DANEJOE_CLOG(ERROR, DECODE, "MediaDecoder", "Failed to copy codec parameters: {}", error.message());
+            close();
+            return error;
+        }
+        m_codec_context->thread_count = options.thread_count;
+        m_codec_context->skip_frame = options.skip_frame;
+        m_codec_context->pkt_timebase = stream->time_base;
+        if (options.is_use_shared_thread_pool)
+        {
+            prepare_shared_execute(m_codec_context.get());
+        }
+        error = m_codec_context.open2(codec, nullptr);
+        if (error.failed())
+        {
+            DANEJOE_CLOG(ERROR, DECODE, "MediaDecoder", "Failed to open codec: {}", error.message());
+            close();
+            return error;
+        }
+        if (options.is_use_shared_thread_pool)
+        {
+            install_shared_execute(m_codec_context.get());
+        }
+    }
+    error = m_packet.ensure_allocated();
+    if (error.ok())
+    {
+        error = m_frame.ensure_allocated();
+    }
+    if (error.failed())
+    {
+        close();
+        return error;
+    }
+    m_is_draining = false;
+    metrics.mark(Stage::DECODER_OPENED);
+    DANEJOE_CLOG(TRACE, DECODE, "MediaDecoder", "Opened {} with decoder {}", file_path, codec->name);
+    return AVError(0);
+}
+
+AVError MediaDecoder::load_stream_info(const Options& options)
+{
+    if (options.is_use_stream_info_cache && StreamInfoCache::get_instance().apply(m_file_path, m_format_context.get()))
+    {
+        DANEJOE_CLOG(TRACE, DECODE, "MediaDecoder", "Stream info cache hit for {}", m_file_path);
+        return AVError(0);
+    }
+    /// @brief 探测流信息,不调用不能获取duration
+    AVError error = m_format_context.find_stream_info(nullptr);
+    if (error.ok() && options.is_use_stream_info_cache)
+    {
+        StreamInfoCache::get_instance().store(m_file_path, m_format_context.get());
+    }
+    return error;
+}
+
+AVError MediaDecoder::feed_packet()
+{
+    if (m_is_draining)
+    {
+        return AVError(AVERROR_EOF);
+    }
+    while (true)
+    {
+        AVError error;
+        {
+            DANEJOE_TRACE_SCOPE(DEMUX, "read_frame");
+            error = m_demuxer ? m_demuxer->pop(m_video_stream_index, m_packet) : m_format_context.read_frame(m_packet);
+        }
+        if (error == AVERROR_EOF)
+        {
+            /// @brief 文件读完后送入空包，取出解码器中缓存的剩余帧
+            m_is_draining = true;
+            return m_codec_context.send_packet(nullptr);
+        }
+        if (error.failed())
+        {
+            return error;
+        }
+        /// @brief 跳过非视频流数据包
+        if (m_packet->stream_index != m_video_stream_index)
+        {
+            m_packet.unref();
+            continue;
+        }
+        {
+            DANEJOE_TRACE_SCOPE_ARG(DECODE, "send_packet", m_packet->pts);
+            error = m_codec_context.send_packet(m_packet);
+        }
+        m_packet.unref();
+        /// @note 损坏的数据包只丢弃该包，继续读取
+        if (error.failed() && error != AVERROR(EAGAIN))
+        {
+            DANEJOE_CLOG_RATE_LIMITED(WARN, DECODE, "MediaDecoder", 1000, "send_packet failed: {}", error.message());
+            continue;
+        }
+        return AVError(0);
+    }
+}
+
+AVError MediaDecoder::receive_next_frame()
+{
+    if (!is_open())
+    {
+        return AVError(AVERROR(EINVAL));
+    }
+    while (true)
+    {
+        AVError error;
+        {
+            DANEJOE_TRACE_SCOPE(DECODE, "receive_frame");
+            error = m_codec_context.receive_frame(m_frame);
+        }
+        if (error.ok())
+        {
+            DaneJoe::StartupMetrics::get_instance().mark(Stage::FIRST_FRAME_DECODED);
+            return error;
+        }
+        /// @note EAGAIN 表示需要更多数据才能继续解码
+        if (error != AVERROR(EAGAIN))
+        {
+            return error;
+        }
+        error = feed_packet();
+        if (error.failed())
+        {
+            return error;
+        }
+    }
+}
+
+AVError MediaDecoder::decode_frame(AVFrameView& frame_view)
+{
+    AVError error = receive_next_frame();
+    if (error.failed())
+    {
+        return error;
+    }
+    /// @brief 接管解码缓冲，m_frame 结构体留待下次复用
+    frame_view = AVFrameView(m_frame);
+    frame_view.set_time_base(time_base());
+    return frame_view.get_error();
+}
+
+AVError MediaDecoder::decode_frame(AVFramePtr& frame)
+{
+    AVError error = frame.ensure_allocated();
+    if (error.failed())
+    {
+        return error;
+    }
+    error = receive_next_frame();
+    if (error.failed())
+    {
+        return error;
+    }
+    frame.unref();
+    av_frame_move_ref(frame.get(), m_frame.get());
+    frame->time_base = time_base();
+    return AVError(0);
+}
+
+AVError MediaDecoder::seek(int64_t timestamp_ms)
+{
+    if (!is_open())
+    {
+        return AVError(AVERROR(EINVAL));
+    }
+    return seek_timestamp(start_pts() + av_rescale_q(timestamp_ms, AVRational{ 1, 1000 }, time_base()));
+}
+
+AVError MediaDecoder::seek_timestamp(int64_t timestamp)
+{
+    if (!is_open())
+    {
+        return AVError(AVERROR(EINVAL));
+    }
+    AVError error = m_demuxer ? m_demuxer->seek(m_video_stream_index, timestamp, AVSEEK_FLAG_BACKWARD) : m_format_context.seek_frame(m_video_stream_index, timestamp, AVSEEK_FLAG_BACKWARD);
+    if (error.failed())
+    {
+        DANEJOE_CLOG(WARN, DECODE, "MediaDecoder", "seek to timestamp {} failed: {}", timestamp, error.message());
+        return error;
+    }
+    m_codec_context.flush_buffers();
+    m_is_draining = false;
+    return AVError(0);
+}
+
+void MediaDecoder::set_demuxer(PacketDemuxer* demuxer)
+{
+    m_demuxer = demuxer;
+}
+
+void MediaDecoder::close()
+{
+    m_demuxer = nullptr;
+    if (!m_codec_pool_key.empty())
+    {
+        AVCodecContextPool::get_instance().release(m_codec_pool_key, std::move(m_codec_context));
+        m_codec_pool_key.clear();
+    }
+    m_codec_context.reset();
+    m_format_context.close_input();
+    m_io.reset();
+    m_video_stream_index = -1;
+    m_is_draining = false;
+}
+
+bool MediaDecoder::is_open()const
+{
+    return m_format_context && m_codec_context && m_video_stream_index >= 0;
+}
+
+const std::string& MediaDecoder::file_path()const
+{
+    return m_file_path;
+}
+
+int MediaDecoder::video_stream_index()const
+{
+    return m_video_stream_index;
+}
+
+AVRational MediaDecoder::time_base()const
+{
+    if (m_video_stream_index < 0)
+    {
+        return AVRational{ 0, 1 };
+    }
+    return m_format_context->streams[m_video_stream_index]->time_base;
+}
+
+int64_t MediaDecoder::start_pts()const
+{
+    if (m_video_stream_index < 0)
+    {
+        return 0;
+    }
+    int64_t start_time = m_format_context->streams[m_video_stream_index]->start_time;
+    return start_time != AV_NOPTS_VALUE ? start_time : 0;
+}
+
+double MediaDecoder::frame_rate()const
+{
+    if (m_video_stream_index < 0)
+    {
+        return 0.;
+    }
+    return AVRationalInfo(m_format_context->streams[m_video_stream_index]->avg_frame_rate).get_double();
+}
+
+int64_t MediaDecoder::duration_ms()const
+{
+    if (!m_format_context || m_format_context->duration == AV_NOPTS_VALUE)
+    {
+        return 0;
+    }
+    return m_format_context->duration / (AV_TIME_BASE / 1000);
+}
+
+int64_t MediaDecoder::bytes_read()const
+{
+    if (!m_format_context || !m_format_context->pb)
+    {
+        return 0;
+    }
+    return m_format_context->pb->bytes_read;
+}
+
+AVFormatContextPtr& MediaDecoder::format_context()
+{
+    return m_format_context;
+}
+
+AVCodecContextPtr& MediaDecoder::codec_context()
+{
+    return m_codec_context;
+}
+
+SeekBackoff::SeekBackoff(const MediaDecoder& decoder, int64_t target) :
+    m_origin(decoder.start_pts()),
+    m_target(std::max(target, m_origin)),
+    m_step(std::max<int64_t>(av_rescale_q(SEEK_BACKOFF_MS, AVRational{ 1, 1000 }, decoder.time_base()), 1))
+{
+}
+
+int64_t SeekBackoff::target()const
+{
+    return m_target;
+}
+
+bool SeekBackoff::can_retreat()const
+{
+    return m_target > m_origin;
+}
+
+void SeekBackoff::retreat()
+{
+    m_target = std::max(m_origin, m_target - m_step);
+    m_step *= 2;
+}
@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#if __has_include(<sys/resource.h>)
+#include <sys/resource.h>
+#define DANEJOE_HAS_RUSAGE 1
+#endif
+
+#include "main/multi_stream_benchmark.hpp"
+#include "main/decode_worker_pool.hpp"
+#include "main/frame_queue.hpp"
+#include "main/media_decoder.hpp"
+#include "util/util_task_scheduler.hpp"
+#include "util/util_log.hpp"
+
+namespace
+{
+    /**
+     * @brief 以指定线程数运行一轮
+     * @return 总解码帧率
+     */
+    double run_round(const std::vector<std::string>& file_paths, std::size_t stream_count, std::size_t worker_count, int seconds)
+    {
+        std::vector<std::shared_ptr<FrameQueue>> frame_queues;
+        DecodeWorkerPool decode_pool(worker_count);
+        for (std::size_t i = 0; i < stream_count; i++)
+        {
+            frame_queues.push_back(std::make_shared<FrameQueue>(8));
+            decode_pool.add_stream(file_paths[i % file_paths.size()], frame_queues.back(), true);
+        }
+        auto begin = std::chrono::steady_clock::now();
+        auto end = begin + std::chrono::seconds(seconds);
+        decode_pool.start();
+        // 模拟渲染端：尽快取走并丢弃所有帧
+        while (std::chrono::steady_clock::now() < end)
+        {
+            bool is_popped = false;
+            for (auto& frame_queue : frame_queues)
+            {
+                while (frame_queue->try_pop().has_value())
+                {
+                    is_popped = true;
+                }
+            }
+            if (!is_popped)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+        uint64_t frames = decode_pool.total_frames_decoded();
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        for (auto& frame_queue : frame_queues)
+        {
+            frame_queue->close();
+        }
+        decode_pool.stop();
+        return elapsed > 0 ? frames / elapsed : 0.;
+    }
+
+    /**
+     * @struct ThreadingResult
+     * @brief 一种线程模型的运行结果
+     */
+    struct ThreadingResult
+    {
+        double fps = 0.;
+        /// @brief 运行期间进程的最大线程数
+        int peak_threads = 0;
+        /// @brief 主动上下文切换次数（等待锁、条件变量等）
+        int64_t voluntary_switches = 0;
+        /// @brief 被动上下文切换次数（时间片用完被抢占）
+        int64_t involuntary_switches = 0;
+    };
+
+    int current_thread_count()
+    {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line))
+        {
+            if (line.rfind("Threads:", 0) == 0)
+            {
+                return std::stoi(line.substr(8));
+            }
+        }
+        return 0;
+    }
+
+    void sample_context_switches(int64_t& voluntary, int64_t& involuntary)
+    {
+        voluntary = 0;
+        involuntary = 0;
+#if defined(DANEJOE_HAS_RUSAGE)
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+        {
+            voluntary = usage.ru_nvcsw;
+            involuntary = usage.ru_nivcsw;
+        }
+#endif
+    }
+
+    ThreadingResult run_threading_round(const std::vector<std::string>& file_paths, std::size_t stream_count, bool is_shared, int seconds)
+    {
+        ThreadingResult result;
+        std::atomic<uint64_t> frames = 0;
+        std::atomic<bool> is_stopped = false;
+        int64_t voluntary_before = 0;
+        int64_t involuntary_before = 0;
+        sample_context_switches(voluntary_before, involuntary_before);
+        auto begin = std::chrono::steady_clock::now();
+        {
+            std::vector<std::jthread> streams;
+            for (std::size_t i = 0; i < stream_count; i++)
+            {
+                streams.emplace_back([&, file_path = file_paths[i % file_paths.size()]]()
+                    {
+                        MediaDecoder decoder;
+                        MediaDecoder::Options options;
+                        options.is_use_shared_thread_pool = is_shared;
+                        if (decoder.open(file_path, options).failed())
+                        {
+                            return;
+                        }
+                        while (!is_stopped.load(std::memory_order_relaxed))
+                        {
+                            AVFrameView frame_view;
+                            AVError error = decoder.decode_frame(frame_view);
+                            if (error == AVERROR_EOF)
+                            {
+                                if (decoder.seek(0).failed())
+                                {
+                                    return;
+                                }
+                                continue;
+                            }
+                            if (error.failed())
+                            {
+                                return;
+                            }
+                            frames.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    });
+            }
+            auto end = begin + std::chrono::seconds(seconds);
+            while (std::chrono::steady_clock::now() < end)
+            {
+                result.peak_threads = std::max(result.peak_threads, current_thread_count());
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            is_stopped.store(true, std::memory_order_relaxed);
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        int64_t voluntary_after = 0;
+        int64_t involuntary_after = 0;
+        sample_context_switches(voluntary_after, involuntary_after);
+        result.fps = elapsed > 0 ? frames.load() / elapsed : 0.;
+        result.voluntary_switches = voluntary_after - voluntary_before;
+        result.involuntary_switches = involuntary_after - involuntary_before;
+        return result;
+    }
+}
+
+int run_multi_stream_benchmark(const std::vector<std::string>& file_paths, std::size_t stream_count, int seconds)
+{
+    if (file_paths.empty() || stream_count == 0 || seconds <= 0)
+    {
+        DANEJOE_CLOG(ERROR, APP, "MultiStreamBenchmark", "Invalid arguments");
+        return -1;
+    }
+    std::size_t core_count = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::size_t> worker_counts;
+    for (std::size_t count = 1; count < core_count; count *= 2)
+    {
+        worker_counts.push_back(count);
+    }
+    worker_counts.push_back(core_count);
+
+    std::cout << "streams: " << stream_count << ", cores: " << core_count << ", seconds per round: " << seconds << "\n";
+    std::cout << std::setw(8) << "workers" << std::setw(14) << "decoded fps" << std::setw(14) << "fps/worker" << std::setw(10) << "speedup" << "\n";
+    double baseline_fps = 0.;
+    for (std::size_t worker_count : worker_counts)
+    {
+        double fps = run_round(file_paths, stream_count, worker_count, seconds);
+        if (baseline_fps <= 0.)
+        {
+            baseline_fps = fps;
+        }
+        std::cout << std::fixed << std::setprecision(1)
+            << std::setw(8) << worker_count
+            << std::setw(14) << fps
+            << std::setw(14) << fps / worker_count
+            << std::setw(10) << std::setprecision(2) << (baseline_fps > 0. ? fps / baseline_fps : 0.)
+            << "\n";
+    }
+    return 0;
+}
+
+int run_threading_benchmark(const std::vector<std::string>& file_paths, std::size_t stream_count, int seconds)
+{
+    if (file_paths.empty() || stream_count == 0 || seconds <= 0)
+    {
+        DANEJOE_CLOG(ERROR, APP, "MultiStreamBenchmark", "Invalid arguments");
+        return -1;
+    }
+    std::cout << "streams: " << stream_count << ", cores: " << std::max(1u, std::thread::hardware_concurrency())
+        << ", shared pool workers: " << DaneJoe::TaskScheduler::get_instance().worker_count()
+        << ", seconds per round: " << seconds << "\n";
+    std::cout << std::setw(10) << "threading" << std::setw(14) << "decoded fps" << std::setw(10) << "threads"
+        << std::setw(16) << "voluntary cs/s" << std::setw(18) << "involuntary cs/s" << "\n";
+    for (bool is_shared : { false, true })
+    {
+        ThreadingResult result = run_threading_round(file_paths, stream_count, is_shared, seconds);
+        std::cout << std::fixed << std::setprecision(1)
+            << std::setw(10) << (is_shared ? "shared" : "ffmpeg")
+            << std::setw(14) << result.fps
+            << std::setw(10) << result.peak_threads
+            << std::setw(16) << static_cast<double>(result.voluntary_switches) / seconds
+            << std::setw(18) << static_cast<double>(result.involuntary_switches) / seconds
+            << "\n";
+    }
+    return 0;
+}
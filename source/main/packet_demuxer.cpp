@@ -0,0 +1,416 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include "main/packet_demuxer.hpp"
+#include "main/batch_processor.hpp"
+#include "util/util_log.hpp"
+#include "util/util_trace_recorder.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double elapsed_ms(Clock::time_point begin)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    }
+
+    const char* media_type_name(AVMediaType media_type)
+    {
+        const char* name = av_get_media_type_string(media_type);
+        return name ? name : "unknown";
+    }
+}
+
+PacketDemuxer::PacketDemuxer(AVFormatContextPtr& format_context, const std::vector<int>& stream_indices, const Options& options) :
+    m_format_context(format_context), m_options(options)
+{
+    for (int stream_index : stream_indices)
+    {
+        if (!m_format_context || stream_index < 0 || stream_index >= static_cast<int>(m_format_context->nb_streams) || find_queue(stream_index))
+        {
+            continue;
+        }
+        const AVStream* stream = m_format_context->streams[stream_index];
+        StreamQueue queue;
+        queue.stream_index = stream_index;
+        queue.media_type = stream->codecpar->codec_type;
+        queue.time_base = stream->time_base;
+        switch (queue.media_type)
+        {
+        case AVMEDIA_TYPE_VIDEO:
+            queue.budget = m_options.video_budget;
+            if (stream->avg_frame_rate.num > 0 && stream->avg_frame_rate.den > 0)
+            {
+                queue.fallback_seconds = av_q2d(av_inv_q(stream->avg_frame_rate));
+            }
+            break;
+        case AVMEDIA_TYPE_AUDIO:
+            queue.budget = m_options.audio_budget;
+            if (stream->codecpar->frame_size > 0 && stream->codecpar->sample_rate > 0)
+            {
+                queue.fallback_seconds = static_cast<double>(stream->codecpar->frame_size) / stream->codecpar->sample_rate;
+            }
+            break;
+        default:
+            queue.budget = m_options.other_budget;
+            break;
+        }
+        m_queues.push_back(std::move(queue));
+    }
+}
+
+PacketDemuxer::~PacketDemuxer()
+{
+    stop();
+}
+
+void PacketDemuxer::start()
+{
+    if (m_thread.joinable() || m_queues.empty())
+    {
+        return;
+    }
+    m_thread = std::jthread(&PacketDemuxer::run, this);
+}
+
+void PacketDemuxer::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_is_stopped = true;
+    }
+    m_packet_condition.notify_all();
+    m_space_condition.notify_all();
+    m_seek_condition.notify_all();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+void PacketDemuxer::run()
+{
+    DaneJoe::TraceRecorder::get_instance().set_thread_name("demux");
+    AVPacketPtr packet;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            bool is_starvation_read = false;
+            Clock::time_point wait_begin = Clock::now();
+            bool is_blocked = false;
+            m_space_condition.wait(lock, [&]()
+                {
+                    if (m_is_stopped || (!m_is_seek_pending && can_read(is_starvation_read)))
+                    {
+                        return true;
+                    }
+                    is_blocked = true;
+                    return false;
+                });
+            if (m_is_stopped)
+            {
+                return;
+            }
+            // 文件结尾之后的等待只是在等定位，不计入阻塞
+            if (is_blocked && !m_is_eof)
+            {
+                m_stats.blocked_ms += elapsed_ms(wait_begin);
+            }
+            if (is_starvation_read)
+            {
+                m_stats.starvation_reads++;
+            }
+            m_is_reading = true;
+        }
+        AVError error = packet.ensure_allocated();
+        if (error.ok())
+        {
+            DANEJOE_TRACE_SCOPE(DEMUX, "read_frame");
+            error = m_format_context.read_frame(packet);
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_is_reading = false;
+        if (m_is_seek_pending)
+        {
+            // 定位前读出的数据包作废
+            packet.unref();
+            lock.unlock();
+            m_seek_condition.notify_all();
+            continue;
+        }
+        if (error.failed())
+        {
+            if (error != AVERROR_EOF)
+            {
+                m_error = error;
+                DANEJOE_CLOG(WARN, DECODE, "PacketDemuxer", "read_frame failed: {}", error.message());
+            }
+            m_is_eof = true;
+            for (StreamQueue& queue : m_queues)
+            {
+                queue.is_end = true;
+            }
+            lock.unlock();
+            m_packet_condition.notify_all();
+            continue;
+        }
+        m_stats.packets_read++;
+        StreamQueue* queue = find_queue(packet->stream_index);
+        if (!queue)
+        {
+            m_stats.packets_dropped++;
+            packet.unref();
+            continue;
+        }
+        queue->bytes += packet->size;
+        queue->seconds += packet_seconds(*queue, packet);
+        m_total_bytes += packet->size;
+        queue->packets.push_back(std::move(packet));
+        lock.unlock();
+        // 各流的消费者共用一个条件变量
+        m_packet_condition.notify_all();
+    }
+}
+
+AVError PacketDemuxer::pop(int stream_index, AVPacketPtr& packet)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    StreamQueue* queue = find_queue(stream_index);
+    if (!queue)
+    {
+        return AVError(AVERROR(EINVAL));
+    }
+    if (queue->packets.empty() && !queue->is_end && !m_is_stopped)
+    {
+        // 第一个数据包读出之前的等待是启动延迟，不算欠载
+        if (m_stats.packets_read > 0)
+        {
+            queue->underruns++;
+        }
+        m_packet_condition.wait(lock, [&]()
+            {
+                return m_is_stopped || queue->is_end || !queue->packets.empty();
+            });
+    }
+    if (m_is_stopped)
+    {
+        return AVError(AVERROR_EXIT);
+    }
+    if (queue->packets.empty())
+    {
+        return m_error.failed() ? m_error : AVError(AVERROR_EOF);
+    }
+    packet = std::move(queue->packets.front());
+    queue->packets.pop_front();
+    queue->bytes -= packet->size;
+    m_total_bytes -= packet->size;
+    queue->seconds = queue->packets.empty() ? 0. : std::max(queue->seconds - packet_seconds(*queue, packet), 0.);
+    lock.unlock();
+    m_space_condition.notify_one();
+    return AVError(0);
+}
+
+AVError PacketDemuxer::seek(int stream_index, int64_t timestamp, int flags)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_is_stopped)
+    {
+        return AVError(AVERROR_EXIT);
+    }
+    m_is_seek_pending = true;
+    m_seek_condition.wait(lock, [&]()
+        {
+            return !m_is_reading || m_is_stopped;
+        });
+    AVError error = m_is_stopped ? AVError(AVERROR_EXIT) : m_format_context.seek_frame(stream_index, timestamp, flags);
+    if (error.ok())
+    {
+        for (StreamQueue& queue : m_queues)
+        {
+            queue.packets.clear();
+            queue.bytes = 0;
+            queue.seconds = 0.;
+            queue.is_end = false;
+        }
+        m_total_bytes = 0;
+        m_is_eof = false;
+        m_error = AVError(0);
+    }
+    m_is_seek_pending = false;
+    lock.unlock();
+    m_space_condition.notify_all();
+    return error;
+}
+
+PacketDemuxer::Stats PacketDemuxer::get_stats()const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.streams.reserve(m_queues.size());
+    for (const StreamQueue& queue : m_queues)
+    {
+        StreamGauge gauge;
+        gauge.stream_index = queue.stream_index;
+        gauge.media_type = queue.media_type;
+        gauge.packets = queue.packets.size();
+        gauge.bytes = queue.bytes;
+        gauge.buffered_seconds = queue.seconds;
+        gauge.max_seconds = queue.budget.max_seconds;
+        gauge.is_over_budget = is_over_budget(queue);
+        gauge.underruns = queue.underruns;
+        gauge.is_end = queue.is_end;
+        stats.streams.push_back(gauge);
+    }
+    return stats;
+}
+
+bool PacketDemuxer::can_read(bool& is_starvation_read)const
+{
+    is_starvation_read = false;
+    if (m_is_eof || m_total_bytes >= m_options.hard_max_bytes)
+    {
+        return false;
+    }
+    bool is_any_over_budget = false;
+    const StreamQueue* lowest = nullptr;
+    for (const StreamQueue& queue : m_queues)
+    {
+        is_any_over_budget = is_any_over_budget || is_over_budget(queue);
+        if (!lowest || queue.seconds < lowest->seconds)
+        {
+            lowest = &queue;
+        }
+    }
+    if (!is_any_over_budget)
+    {
+        return true;
+    }
+    // 有队列已满时由最缺数据的流决定是否继续读取：它低于低水位说明其数据包还在文件后方
+    is_starvation_read = lowest && !is_over_budget(*lowest) && lowest->seconds < lowest->budget.low_seconds;
+    return is_starvation_read;
+}
+
+double PacketDemuxer::packet_seconds(const StreamQueue& queue, AVPacketPtr& packet)
+{
+    if (packet->duration > 0 && queue.time_base.num > 0 && queue.time_base.den > 0)
+    {
+        return packet->duration * av_q2d(queue.time_base);
+    }
+    return queue.fallback_seconds;
+}
+
+PacketDemuxer::StreamQueue* PacketDemuxer::find_queue(int stream_index)
+{
+    auto it = std::find_if(m_queues.begin(), m_queues.end(), [stream_index](const StreamQueue& queue)
+        {
+            return queue.stream_index == stream_index;
+        });
+    return it != m_queues.end() ? &*it : nullptr;
+}
+
+bool PacketDemuxer::is_over_budget(const StreamQueue& queue)
+{
+    return queue.bytes >= queue.budget.max_bytes || queue.seconds >= queue.budget.max_seconds;
+}
+
+int run_demux_benchmark(const std::vector<std::string>& inputs, double speed)
+{
+    std::vector<std::string> file_paths = collect_media_files(inputs);
+    if (file_paths.empty() || speed <= 0.)
+    {
+        DANEJOE_CLOG(ERROR, APP, "DemuxBench", "Usage: demux-bench <input> [--speed=1]");
+        return -1;
+    }
+    const std::string& file_path = file_paths.front();
+    AVFormatContextPtr format_context;
+    AVError error = format_context.open_input(file_path, nullptr, nullptr);
+    if (error.ok())
+    {
+        error = format_context.find_stream_info(nullptr);
+    }
+    if (error.failed())
+    {
+        DANEJOE_CLOG(ERROR, APP, "DemuxBench", "Failed to open {}: {}", file_path, error.message());
+        return -1;
+    }
+    std::vector<int> stream_indices;
+    for (AVMediaType media_type : { AVMEDIA_TYPE_VIDEO, AVMEDIA_TYPE_AUDIO })
+    {
+        int stream_index = av_find_best_stream(format_context.get(), media_type, -1, -1, nullptr, 0);
+        if (stream_index >= 0)
+        {
+            stream_indices.push_back(stream_index);
+        }
+    }
+    if (stream_indices.empty())
+    {
+        DANEJOE_CLOG(ERROR, APP, "DemuxBench", "No audio or video stream in {}", file_path);
+        return -1;
+    }
+
+    PacketDemuxer demuxer(format_context, stream_indices, PacketDemuxer::Options());
+    Clock::time_point begin = Clock::now();
+    std::atomic<std::size_t> running = stream_indices.size();
+    std::vector<std::jthread> consumers;
+    for (int stream_index : stream_indices)
+    {
+        const AVStream* stream = format_context->streams[stream_index];
+        consumers.emplace_back([&demuxer, &running, stream, stream_index, begin, speed]()
+            {
+                // 按数据包时间戳以 speed 倍速取包，模拟实时消费的解码器
+                int64_t start_pts = stream->start_time;
+                AVPacketPtr packet;
+                while (demuxer.pop(stream_index, packet).ok())
+                {
+                    int64_t pts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+                    if (pts != AV_NOPTS_VALUE)
+                    {
+                        if (start_pts == AV_NOPTS_VALUE)
+                        {
+                            start_pts = pts;
+                        }
+                        double due_seconds = (pts - start_pts) * av_q2d(stream->time_base) / speed;
+                        std::this_thread::sleep_until(begin + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(due_seconds)));
+                    }
+                    packet.unref();
+                }
+                running--;
+            });
+    }
+    demuxer.start();
+
+    auto print_gauges = [](const PacketDemuxer::Stats& stats)
+        {
+            for (const PacketDemuxer::StreamGauge& gauge : stats.streams)
+            {
+                std::cout << "  #" << gauge.stream_index << " " << std::setw(6) << media_type_name(gauge.media_type)
+                    << std::setw(8) << gauge.packets << " pkts"
+                    << std::setw(10) << gauge.bytes / 1024 << " KiB"
+                    << std::setw(8) << gauge.buffered_seconds << "/" << gauge.max_seconds << " s"
+                    << std::setw(8) << gauge.underruns << " underruns"
+                    << (gauge.is_over_budget ? "  over" : "")
+                    << (gauge.is_end ? "  end" : "")
+                    << "\n";
+            }
+        };
+    std::cout << std::fixed << std::setprecision(2) << "input: " << file_path << " (speed " << speed << "x)\n";
+    while (running > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        std::cout << "t=" << elapsed_ms(begin) / 1000. << "s\n";
+        print_gauges(demuxer.get_stats());
+    }
+    consumers.clear();
+    PacketDemuxer::Stats stats = demuxer.get_stats();
+    demuxer.stop();
+    std::cout << "packets: " << stats.packets_read << ", dropped: " << stats.packets_dropped
+        << ", starvation reads: " << stats.starvation_reads << ", demux blocked: " << stats.blocked_ms << " ms"
+        << ", wall: " << elapsed_ms(begin) << " ms\n";
+    print_gauges(stats);
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <stdexcept>
+
+#include "main/playback_preloader.hpp"
+#include "main/decode_mp4.hpp"
+#include "main/playlist_decoder.hpp"
+#include "main/reverse_decoder.hpp"
+#include "util/util_log.hpp"
+
+PlaybackPreloader::PlaybackPreloader(std::size_t frame_queue_capacity) :
+    m_frame_queue(std::make_shared<FrameQueue>(frame_queue_capacity)),
+    m_rate_control(std::make_shared<PlaybackRateControl>())
+{
+}
+
+PlaybackPreloader::~PlaybackPreloader()
+{
+    // 关闭队列使阻塞在 push 上的解码线程退出，jthread 析构时等待
+    m_frame_queue->close();
+}
+
+void PlaybackPreloader::set_filter(const std::string& filter_description)
+{
+    m_filter_description = filter_description;
+}
+
+void PlaybackPreloader::start(const std::string& file_path)
+{
+    if (m_decode_thread.joinable())
+    {
+        DANEJOE_CLOG(WARN, DECODE, "PlaybackPreloader", "Already started");
+        return;
+    }
+    // 先启动解码线程，再在主线程做其它初始化，二者重叠执行
+    m_file_path = file_path;
+    m_decode_thread = std::jthread(decode_mp4, file_path, std::weak_ptr<FrameQueue>(m_frame_queue), m_rate_control, m_filter_description);
+    init_video_system();
+    DANEJOE_CLOG(TRACE, DECODE, "PlaybackPreloader", "Started preloading {}", file_path);
+}
+
+void PlaybackPreloader::start(const std::vector<std::string>& playlist)
+{
+    if (playlist.size() <= 1)
+    {
+        start(playlist.empty() ? std::string() : playlist.front());
+        return;
+    }
+    if (m_decode_thread.joinable())
+    {
+        DANEJOE_CLOG(WARN, DECODE, "PlaybackPreloader", "Already started");
+        return;
+    }
+    m_decode_thread = std::jthread([playlist, frame_queue = std::weak_ptr<FrameQueue>(m_frame_queue), rate_control = m_rate_control]()
+        {
+            PlaylistDecoder::Options options;
+            options.rate_control = rate_control;
+            options.decoder_options.is_use_stream_info_cache = true;
+            options.decoder_options.is_use_context_pool = true;
+            PlaylistDecoder playlist_decoder(playlist, options);
+            AVError error = playlist_decoder.run(frame_queue);
+            if (error.failed())
+            {
+                DANEJOE_CLOG(ERROR, DECODE, "PlaybackPreloader", "Playlist failed: {}", error.message());
+            }
+        });
+    init_video_system();
+    DANEJOE_CLOG(TRACE, DECODE, "PlaybackPreloader", "Started preloading playlist of {} files", playlist.size());
+}
+
+void PlaybackPreloader::start_reverse(const std::string& file_path, std::size_t max_segment_frames)
+{
+    if (m_decode_thread.joinable())
+    {
+        DANEJOE_CLOG(WARN, DECODE, "PlaybackPreloader", "Already started");
+        return;
+    }
+    m_decode_thread = std::jthread([file_path, max_segment_frames, frame_queue = std::weak_ptr<FrameQueue>(m_frame_queue), rate_control = m_rate_control]()
+        {
+            ReverseDecoder::Options options;
+            options.max_segment_frames = max_segment_frames;
+            options.rate_control = rate_control;
+            options.decoder_options.is_use_stream_info_cache = true;
+            ReverseDecoder reverse_decoder(file_path, options);
+            AVError error = reverse_decoder.run(frame_queue);
+            if (error.failed())
+            {
+                DANEJOE_CLOG(ERROR, DECODE, "PlaybackPreloader", "Reverse playback failed: {}", error.message());
+            }
+        });
+    init_video_system();
+    DANEJOE_CLOG(TRACE, DECODE, "PlaybackPreloader", "Started reverse preloading {}", file_path);
+}
+
+void PlaybackPreloader::init_video_system()
+{
+    try
+    {
+        m_video_system = std::make_unique<SDLVideoSystem>();
+    }
+    catch (const std::exception& exception)
+    {
+        // 渲染器创建时会再次尝试并报告错误
+        DANEJOE_CLOG(WARN, RENDER, "PlaybackPreloader", "Early SDL init failed: {}", exception.what());
+    }
+}
+
+std::shared_ptr<FrameQueue> PlaybackPreloader::get_frame_queue()
+{
+    return m_frame_queue;
+}
+
+std::shared_ptr<PlaybackRateControl> PlaybackPreloader::get_rate_control()
+{
+    return m_rate_control;
+}
+
+const std::string& PlaybackPreloader::get_file_path()const
+{
+    return m_file_path;
+}
@@ -0,0 +1,491 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "main/playback_rate.hpp"
+#include "main/batch_processor.hpp"
+#include "main/decode_mp4.hpp"
+#include "util/util_log.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief 速率档位
+    constexpr std::array<double, 7> RATE_STEPS = { 0.25, 0.5, 1., 2., 4., 8., 16. };
+    /// @brief 实测速度需要超出请求速率的余量
+    constexpr double SPEED_HEADROOM = 1.2;
+    /// @brief 一次速度测量至少累计的解码耗时（秒）
+    constexpr double SPEED_WINDOW_SECONDS = 0.5;
+    /// @brief 实测速度的有效期
+    constexpr auto SPEED_EXPIRY = std::chrono::seconds(10);
+    /// @brief 实际速率的统计窗口
+    constexpr auto ACHIEVED_WINDOW = std::chrono::seconds(2);
+    /// @brief 呈现落后时钟超过该墙钟时长时时钟回退
+    constexpr double MAX_PRESENT_LAG_SECONDS = 0.25;
+    /// @brief 重定位后追赶呈现位置的最长时间
+    constexpr auto CATCH_UP_TIMEOUT = std::chrono::seconds(1);
+
+    /**
+     * @brief 帧时间（秒），无时间戳时为空；与 AVFrameView::seconds 一致，供同时处理两种帧类型的模板使用
+     */
+    std::optional<double> frame_seconds(const AVFrameView& frame_view)
+    {
+        return frame_view.seconds();
+    }
+
+    std::optional<double> frame_seconds(const AVFramePtr& frame)
+    {
+        int64_t pts = frame_pts(frame.get());
+        if (pts == AV_NOPTS_VALUE || frame->time_base.den == 0)
+        {
+            return std::nullopt;
+        }
+        return pts * av_q2d(frame->time_base);
+    }
+}
+
+AVDiscard to_av_discard(DecodeStrategy strategy)
+{
+    switch (strategy)
+    {
+    case DecodeStrategy::SKIP_NON_REFERENCE: return AVDISCARD_NONREF;
+    case DecodeStrategy::KEYFRAMES_ONLY: return AVDISCARD_NONKEY;
+    default: return AVDISCARD_DEFAULT;
+    }
+}
+
+const char* decode_strategy_name(DecodeStrategy strategy)
+{
+    switch (strategy)
+    {
+    case DecodeStrategy::ALL_FRAMES: return "all";
+    case DecodeStrategy::SKIP_NON_REFERENCE: return "nonref";
+    case DecodeStrategy::KEYFRAMES_ONLY: return "keyframes";
+    default: return "unknown";
+    }
+}
+
+PlaybackRateControl::PlaybackRateControl() :PlaybackRateControl(Options()) {}
+
+PlaybackRateControl::PlaybackRateControl(const Options& options) :m_options(options) {}
+
+void PlaybackRateControl::set_rate(double rate)
+{
+    rate = std::clamp(rate, MIN_RATE, MAX_RATE);
+    if (m_rate.exchange(rate, std::memory_order_relaxed) != rate)
+    {
+        DANEJOE_CLOG(INFO, DECODE, "PlaybackRateControl", "Playback rate set to {}x", rate);
+    }
+}
+
+void PlaybackRateControl::step_rate(int steps)
+{
+    double rate = m_rate.load(std::memory_order_relaxed);
+    // 从最接近当前速率的档位开始移动
+    auto nearest = std::min_element(RATE_STEPS.begin(), RATE_STEPS.end(), [rate](double left, double right)
+        {
+            return std::abs(std::log2(left / rate)) < std::abs(std::log2(right / rate));
+        });
+    int index = std::clamp(static_cast<int>(nearest - RATE_STEPS.begin()) + steps, 0, static_cast<int>(RATE_STEPS.size()) - 1);
+    set_rate(RATE_STEPS[index]);
+}
+
+double PlaybackRateControl::rate()const
+{
+    return m_rate.load(std::memory_order_relaxed);
+}
+
+const PlaybackRateControl::Options& PlaybackRateControl::options()const
+{
+    return m_options;
+}
+
+void PlaybackRateControl::set_strategy(DecodeStrategy strategy)
+{
+    m_strategy.store(strategy, std::memory_order_relaxed);
+}
+
+DecodeStrategy PlaybackRateControl::strategy()const
+{
+    return m_strategy.load(std::memory_order_relaxed);
+}
+
+void PlaybackRateControl::request_resync(double media_seconds)
+{
+    // 先写目标再发布次数，显示端读到新次数时目标已可见
+    m_resync_target.store(media_seconds, std::memory_order_relaxed);
+    m_resync_generation.fetch_add(1, std::memory_order_release);
+}
+
+uint64_t PlaybackRateControl::resync_generation()const
+{
+    return m_resync_generation.load(std::memory_order_acquire);
+}
+
+double PlaybackRateControl::resync_target()const
+{
+    return m_resync_target.load(std::memory_order_relaxed);
+}
+
+void PlaybackRateControl::record_presented(double media_seconds, Clock::time_point now)
+{
+    m_presented_seconds.store(media_seconds, std::memory_order_relaxed);
+    m_is_presented.store(true, std::memory_order_release);
+    m_presented_frames.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // 时间倒退（重定位或时钟回退到更早的帧）时重新统计
+    if (!m_present_window.empty() && media_seconds < m_present_window.back().second)
+    {
+        m_present_window.clear();
+    }
+    m_present_window.emplace_back(now, media_seconds);
+    while (m_present_window.size() > 2 && now - m_present_window.front().first > ACHIEVED_WINDOW)
+    {
+        m_present_window.pop_front();
+    }
+}
+
+void PlaybackRateControl::record_dropped(uint64_t count)
+{
+    m_dropped_frames.fetch_add(count, std::memory_order_relaxed);
+}
+
+std::optional<double> PlaybackRateControl::presented_seconds()const
+{
+    if (!m_is_presented.load(std::memory_order_acquire))
+    {
+        return std::nullopt;
+    }
+    return m_presented_seconds.load(std::memory_order_relaxed);
+}
+
+PlaybackRateControl::Report PlaybackRateControl::get_report()
+{
+    Report report;
+    report.requested_rate = rate();
+    report.strategy = strategy();
+    report.presented_frames = m_presented_frames.load(std::memory_order_relaxed);
+    report.dropped_frames = m_dropped_frames.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_present_window.size() >= 2)
+    {
+        double wall_seconds = std::chrono::duration<double>(m_present_window.back().first - m_present_window.front().first).count();
+        double media_seconds = m_present_window.back().second - m_present_window.front().second;
+        report.achieved_rate = wall_seconds > 0. ? media_seconds / wall_seconds : 0.;
+    }
+    return report;
+}
+
+DecodeRateAdapter::DecodeRateAdapter(std::shared_ptr<PlaybackRateControl> control) :m_control(std::move(control)) {}
+
+DecodeStrategy DecodeRateAdapter::select_strategy(double rate, Clock::time_point now)const
+{
+    const PlaybackRateControl::Options& options = m_control->options();
+    DecodeStrategy limit = DecodeStrategy::ALL_FRAMES;
+    if (rate > options.keyframe_only_rate)
+    {
+        limit = DecodeStrategy::KEYFRAMES_ONLY;
+    }
+    else if (rate > options.skip_non_reference_rate)
+    {
+        limit = DecodeStrategy::SKIP_NON_REFERENCE;
+    }
+    // 阈值允许的策略中选跳帧最少、且未被实测证明跟不上的一个
+    for (std::size_t i = static_cast<std::size_t>(limit); i + 1 < m_speeds.size(); i++)
+    {
+        const SpeedSample& sample = m_speeds[i];
+        if (!sample.is_valid || now - sample.measured_at > SPEED_EXPIRY || sample.speed >= rate * SPEED_HEADROOM)
+        {
+            return static_cast<DecodeStrategy>(i);
+        }
+    }
+    return DecodeStrategy::KEYFRAMES_ONLY;
+}
+
+void DecodeRateAdapter::resync(MediaDecoder& decoder, double timeline_shift_seconds)
+{
+    std::optional<double> presented = m_control->presented_seconds();
+    if (!presented || !m_last_frame_seconds)
+    {
+        return;
+    }
+    // 积压没有超过新速率下的超前上限（例如重新测量低跳帧策略）时不需要定位
+    double lookahead = m_control->options().lookahead_seconds * std::max(m_control->rate(), 1.);
+    if (*m_last_frame_seconds + timeline_shift_seconds - *presented <= lookahead)
+    {
+        return;
+    }
+    const AVStream* stream = decoder.format_context()->streams[decoder.video_stream_index()];
+    double start_seconds = stream->start_time != AV_NOPTS_VALUE ? stream->start_time * av_q2d(stream->time_base) : 0.;
+    double target_seconds = *presented - timeline_shift_seconds - start_seconds;
+    // 呈现位置不在当前文件内（如播放列表仍在显示上一个文件）时不定位
+    if (target_seconds < 0. || decoder.seek(std::llround(target_seconds * 1000.)).failed())
+    {
+        return;
+    }
+    m_last_frame_seconds.reset();
+    m_control->request_resync(*presented);
+    DANEJOE_CLOG(DEBUG, DECODE, "DecodeRateAdapter", "Resynced decoder to {}s", *presented);
+}
+
+AVError DecodeRateAdapter::decode_frame(MediaDecoder& decoder, AVFrameView& frame_view, double timeline_shift_seconds)
+{
+    return decode_with_strategy(decoder, frame_view, timeline_shift_seconds);
+}
+
+AVError DecodeRateAdapter::decode_frame(MediaDecoder& decoder, AVFramePtr& frame, double timeline_shift_seconds)
+{
+    return decode_with_strategy(decoder, frame, timeline_shift_seconds);
+}
+
+template<class Frame>
+AVError DecodeRateAdapter::decode_with_strategy(MediaDecoder& decoder, Frame& frame_view, double timeline_shift_seconds)
+{
+    if (!m_control || !decoder.is_open())
+    {
+        return decoder.decode_frame(frame_view);
+    }
+    Clock::time_point begin = Clock::now();
+    DecodeStrategy strategy = select_strategy(m_control->rate(), begin);
+    if (strategy != m_strategy)
+    {
+        bool is_downgrade = strategy < m_strategy;
+        DANEJOE_CLOG(DEBUG, DECODE, "DecodeRateAdapter", "Decode strategy {} -> {} at {}x",
+            decode_strategy_name(m_strategy), decode_strategy_name(strategy), m_control->rate());
+        m_strategy = strategy;
+        m_control->set_strategy(strategy);
+        m_window_media_seconds = 0.;
+        m_window_wall_seconds = 0.;
+        if (is_downgrade)
+        {
+            resync(decoder, timeline_shift_seconds);
+        }
+        begin = Clock::now();
+    }
+    // 每次都写入，播放列表切换文件后新的解码器同样生效
+    decoder.codec_context()->skip_frame = to_av_discard(m_strategy);
+    AVError error = decoder.decode_frame(frame_view);
+    Clock::time_point end = Clock::now();
+    if (error.failed())
+    {
+        return error;
+    }
+    m_window_wall_seconds += std::chrono::duration<double>(end - begin).count();
+    std::optional<double> seconds = frame_seconds(frame_view);
+    if (seconds && m_last_frame_seconds && *seconds > *m_last_frame_seconds)
+    {
+        m_window_media_seconds += *seconds - *m_last_frame_seconds;
+    }
+    if (seconds)
+    {
+        m_last_frame_seconds = seconds;
+    }
+    if (m_window_wall_seconds >= SPEED_WINDOW_SECONDS)
+    {
+        SpeedSample& sample = m_speeds[static_cast<std::size_t>(m_strategy)];
+        sample.speed = m_window_media_seconds / m_window_wall_seconds;
+        sample.measured_at = end;
+        sample.is_valid = true;
+        m_window_media_seconds = 0.;
+        m_window_wall_seconds = 0.;
+    }
+    return error;
+}
+
+void DecodeRateAdapter::throttle(const AVFrameView& frame_view, const std::function<bool()>& is_running)
+{
+    if (!m_control)
+    {
+        return;
+    }
+    std::optional<double> seconds = frame_seconds(frame_view);
+    if (!seconds)
+    {
+        return;
+    }
+    while (is_running())
+    {
+        std::optional<double> presented = m_control->presented_seconds();
+        double lookahead = m_control->options().lookahead_seconds * std::max(m_control->rate(), 1.);
+        // 尚未开始呈现时不限制，预加载可以填满队列
+        if (!presented || *seconds - *presented <= lookahead)
+        {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+PlaybackClock::PlaybackClock(std::shared_ptr<PlaybackRateControl> control) :m_control(std::move(control)) {}
+
+double PlaybackClock::media_seconds(Clock::time_point now)const
+{
+    return m_anchor_media_seconds + std::chrono::duration<double>(now - m_anchor_time).count() * m_anchor_rate;
+}
+
+void PlaybackClock::anchor(double media_seconds, double rate, Clock::time_point now)
+{
+    m_anchor_media_seconds = media_seconds;
+    m_anchor_rate = rate;
+    m_anchor_time = now;
+    m_is_anchored = true;
+}
+
+std::optional<AVFrameView> PlaybackClock::take_due_frame(FrameQueue& frame_queue, Clock::time_point now, Clock::duration lookahead)
+{
+    double rate = m_control ? m_control->rate() : 1.;
+    if (m_is_anchored && rate != m_anchor_rate)
+    {
+        anchor(media_seconds(now), rate, now);
+    }
+    if (m_control)
+    {
+        uint64_t generation = m_control->resync_generation();
+        if (generation != m_resync_generation)
+        {
+            m_resync_generation = generation;
+            m_resync_target = m_control->resync_target();
+            m_is_resyncing = true;
+            m_pending.reset();
+        }
+    }
+    std::optional<AVFrameView> due;
+    uint64_t dropped = 0;
+    while (true)
+    {
+        if (!m_pending)
+        {
+            m_pending = frame_queue.try_pop();
+            if (!m_pending)
+            {
+                break;
+            }
+        }
+        std::optional<double> seconds = frame_seconds(*m_pending);
+        if (m_is_resyncing)
+        {
+            // 定位后解码的第一帧不晚于目标位置，在此之前出队的都是定位前解码的旧帧
+            if (seconds && *seconds > m_resync_target + 1e-3)
+            {
+                m_pending.reset();
+                dropped++;
+                continue;
+            }
+            m_is_resyncing = false;
+            m_catch_up_deadline = now + CATCH_UP_TIMEOUT;
+        }
+        if (!m_is_anchored)
+        {
+            anchor(seconds.value_or(0.), rate, now);
+        }
+        if (seconds && *seconds > media_seconds(now + lookahead))
+        {
+            break;
+        }
+        if (due)
+        {
+            dropped++;
+        }
+        due = std::move(m_pending);
+        m_pending.reset();
+    }
+    if (due)
+    {
+        double seconds = frame_seconds(*due).value_or(media_seconds(now));
+        if ((media_seconds(now) - seconds) / rate > MAX_PRESENT_LAG_SECONDS)
+        {
+            if (m_catch_up_deadline && now < *m_catch_up_deadline)
+            {
+                // 重定位后仍在追赶，落后的帧不显示，时钟保持不变
+                due.reset();
+                dropped++;
+            }
+            else
+            {
+                // 解码跟不上，时钟退回到该帧
+                anchor(seconds, rate, now);
+            }
+        }
+        if (due)
+        {
+            m_catch_up_deadline.reset();
+            if (m_control)
+            {
+                m_control->record_presented(seconds, now);
+            }
+        }
+    }
+    if (dropped > 0 && m_control)
+    {
+        m_control->record_dropped(dropped);
+    }
+    return due;
+}
+
+void PlaybackClock::pause()
+{
+    m_is_anchored = false;
+    m_catch_up_deadline.reset();
+}
+
+int run_rate_benchmark(const std::vector<std::string>& inputs, int seconds)
+{
+    std::vector<std::string> file_paths = collect_media_files(inputs);
+    if (file_paths.empty() || seconds <= 0)
+    {
+        DANEJOE_CLOG(ERROR, APP, "RateBenchmark", "Invalid arguments");
+        return -1;
+    }
+    const std::string& file_path = file_paths.front();
+    std::cout << "file: " << file_path << ", seconds per rate: " << seconds << "\n";
+    std::cout << std::setw(10) << "requested" << std::setw(10) << "achieved" << std::setw(12) << "strategy"
+        << std::setw(11) << "presented" << std::setw(9) << "dropped" << std::setw(9) << "fps" << "\n";
+    for (double rate : RATE_STEPS)
+    {
+        auto control = std::make_shared<PlaybackRateControl>();
+        control->set_rate(rate);
+        auto frame_queue = std::make_shared<FrameQueue>(64);
+        PlaybackClock clock(control);
+        std::optional<double> first_seconds;
+        double last_seconds = 0.;
+        Clock::time_point first_time;
+        Clock::time_point last_time;
+        {
+            std::jthread decode_thread(decode_mp4, file_path, std::weak_ptr<FrameQueue>(frame_queue), control, std::string());
+            Clock::time_point deadline = Clock::now() + std::chrono::seconds(seconds);
+            while (Clock::now() < deadline)
+            {
+                Clock::time_point now = Clock::now();
+                std::optional<AVFrameView> frame = clock.take_due_frame(*frame_queue, now);
+                if (frame && frame->pts() != AV_NOPTS_VALUE)
+                {
+                    double frame_time = frame->pts() * av_q2d(frame->time_base());
+                    if (!first_seconds)
+                    {
+                        first_seconds = frame_time;
+                        first_time = now;
+                    }
+                    last_seconds = frame_time;
+                    last_time = now;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+            frame_queue->close();
+        }
+        PlaybackRateControl::Report report = control->get_report();
+        double wall_seconds = first_seconds ? std::chrono::duration<double>(last_time - first_time).count() : 0.;
+        double achieved = wall_seconds > 0. ? (last_seconds - *first_seconds) / wall_seconds : 0.;
+        std::cout << std::fixed << std::setprecision(2)
+            << std::setw(9) << rate << "x"
+            << std::setw(9) << achieved << "x"
+            << std::setw(12) << decode_strategy_name(report.strategy)
+            << std::setw(11) << report.presented_frames
+            << std::setw(9) << report.dropped_frames
+            << std::setw(9) << std::setprecision(1) << (wall_seconds > 0. ? report.presented_frames / wall_seconds : 0.)
+            << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <thread>
+
+#include "main/playlist_decoder.hpp"
+#include "main/batch_processor.hpp"
+#include "util/util_log.hpp"
+#include "util/util_trace_recorder.hpp"
+
+namespace
+{
+    /// @brief 播放列表时间轴的时间基（微秒）
+    constexpr AVRational TIMELINE_TIME_BASE = { 1, AV_TIME_BASE };
+}
+
+PlaylistDecoder::PlaylistDecoder(std::vector<std::string> playlist, const Options& options) :
+    m_playlist(std::move(playlist)), m_options(options)
+{
+}
+
+PlaylistDecoder::PreparedItem PlaylistDecoder::prepare_item(std::size_t index, const std::string& file_path, const Options& options)
+{
+    PreparedItem item;
+    item.index = index;
+    item.decoder = std::make_unique<MediaDecoder>();
+    item.error = item.decoder->open(file_path, options.decoder_options);
+    while (item.error.ok() && static_cast<int>(item.frames.size()) < options.preroll_frames)
+    {
+        AVFrameView frame;
+        AVError error = item.decoder->decode_frame(frame);
+        if (error == AVERROR_EOF)
+        {
+            item.is_eof = true;
+            break;
+        }
+        if (error.failed())
+        {
+            item.error = error;
+            break;
+        }
+        item.frames.push_back(std::move(frame));
+    }
+    return item;
+}
+
+AVError PlaylistDecoder::run(std::weak_ptr<FrameQueue> frame_queue)
+{
+    using Clock = std::chrono::steady_clock;
+    m_transitions.clear();
+    if (m_playlist.empty())
+    {
+        return AVError(AVERROR(EINVAL));
+    }
+    /// @brief 当前文件在时间轴上的起点
+    int64_t offset_us = 0;
+    std::size_t played_count = 0;
+    std::size_t last_played_index = 0;
+    std::optional<Clock::time_point> last_push_time;
+    bool is_current_preloaded = false;
+    PreparedItem current = prepare_item(0, m_playlist[0], m_options);
+    DecodeRateAdapter rate_adapter(m_options.rate_control);
+    for (std::size_t index = 0; index < m_playlist.size(); index++)
+    {
+        // 当前文件开始推送前就启动下一个文件的预加载，二者并行
+        std::future<PreparedItem> next;
+        if (m_options.is_preload && index + 1 < m_playlist.size())
+        {
+            next = std::async(std::launch::async, &PlaylistDecoder::prepare_item, index + 1, std::cref(m_playlist[index + 1]), std::cref(m_options));
+        }
+        if (current.error.failed())
+        {
+            DANEJOE_CLOG(WARN, DECODE, "PlaylistDecoder", "Skipping {}: {}", m_playlist[index], current.error.message());
+        }
+        else
+        {
+            MediaDecoder& decoder = *current.decoder;
+            AVRational time_base = decoder.time_base();
+            const AVStream* stream = decoder.format_context()->streams[decoder.video_stream_index()];
+            /// @brief 文件内时间原点与声明时长，声明时长未知时以最后一帧的结束时间为准
+            int64_t origin = stream->start_time;
+            int64_t declared_us = stream->duration != AV_NOPTS_VALUE && stream->duration > 0
+                ? av_rescale_q(stream->duration, time_base, TIMELINE_TIME_BASE)
+                : decoder.duration_ms() * 1000;
+            int64_t fallback_duration_us = decoder.frame_rate() > 0. ? std::llround(AV_TIME_BASE / decoder.frame_rate()) : 0;
+            int64_t end_us = 0;
+            bool is_first_frame = true;
+            bool is_stopped = false;
+            while (true)
+            {
+                AVFrameView frame;
+                if (!current.frames.empty())
+                {
+                    frame = std::move(current.frames.front());
+                    current.frames.pop_front();
+                }
+                else if (current.is_eof)
+                {
+                    break;
+                }
+                else
+                {
+                    // 输出时间轴 = 文件内时间 + offset，换算回解码器时间时减去该差值
+                    double timeline_shift_seconds = offset_us / 1e6 - (origin != AV_NOPTS_VALUE ? origin * av_q2d(time_base) : 0.);
+                    AVError error = rate_adapter.decode_frame(decoder, frame, timeline_shift_seconds);
+                    if (error == AVERROR_EOF)
+                    {
+                        break;
+                    }
+                    if (error.failed())
+                    {
+                        DANEJOE_CLOG(WARN, DECODE, "PlaylistDecoder", "Decoding {} stopped: {}", m_playlist[index], error.message());
+                        break;
+                    }
+                }
+                if (origin == AV_NOPTS_VALUE)
+                {
+                    origin = frame.pts() != AV_NOPTS_VALUE ? frame.pts() : 0;
+                }
+                int64_t local_us = frame.pts() != AV_NOPTS_VALUE ? av_rescale_q(frame.pts() - origin, time_base, TIMELINE_TIME_BASE) : end_us;
+                int64_t duration_us = frame.duration() > 0 ? av_rescale_q(frame.duration(), time_base, TIMELINE_TIME_BASE) : fallback_duration_us;
+                // 编辑列表裁掉的首尾帧不显示，保证切换点恰好是声明的结束时间
+                if (local_us < 0 || (declared_us > 0 && local_us >= declared_us))
+                {
+                    continue;
+                }
+                end_us = std::max(end_us, local_us + duration_us);
+                frame.set_timing(offset_us + local_us, duration_us, TIMELINE_TIME_BASE);
+                auto frame_queue_shared_ptr = frame_queue.lock();
+                if (!frame_queue_shared_ptr || !frame_queue_shared_ptr->is_running())
+                {
+                    is_stopped = true;
+                    break;
+                }
+                rate_adapter.throttle(frame, [&frame_queue_shared_ptr]() { return frame_queue_shared_ptr->is_running(); });
+                {
+                    DANEJOE_TRACE_SCOPE_ARG(QUEUE_WAIT, "push", offset_us + local_us);
+                    frame_queue_shared_ptr->push(std::move(frame));
+                }
+                Clock::time_point now = Clock::now();
+                if (is_first_frame && last_push_time)
+                {
+                    Transition transition;
+                    transition.from_index = last_played_index;
+                    transition.to_index = index;
+                    transition.handover_ms = offset_us / 1000.;
+                    transition.gap_ms = std::chrono::duration<double, std::milli>(now - *last_push_time).count();
+                    transition.is_preloaded = is_current_preloaded;
+                    m_transitions.push_back(transition);
+                    DANEJOE_CLOG(DEBUG, DECODE, "PlaylistDecoder", "Switched to {} at {}ms, gap {}ms", m_playlist[index], transition.handover_ms, transition.gap_ms);
+                }
+                is_first_frame = false;
+                last_push_time = now;
+            }
+            if (!is_first_frame)
+            {
+                played_count++;
+                last_played_index = index;
+            }
+            if (is_stopped)
+            {
+                DANEJOE_CLOG(INFO, DECODE, "PlaylistDecoder", "frame_queue is not running");
+                break;
+            }
+            offset_us += declared_us > 0 ? declared_us : end_us;
+        }
+        if (index + 1 >= m_playlist.size())
+        {
+            break;
+        }
+        if (next.valid())
+        {
+            current = next.get();
+            is_current_preloaded = true;
+        }
+        else
+        {
+            // 不预加载时在切换点才打开下一个文件，等价于重建解码流程
+            current = prepare_item(index + 1, m_playlist[index + 1], m_options);
+            is_current_preloaded = false;
+        }
+    }
+    return played_count > 0 ? AVError(0) : AVError(AVERROR_INVALIDDATA);
+}
+
+const std::vector<PlaylistDecoder::Transition>& PlaylistDecoder::get_transitions()const
+{
+    return m_transitions;
+}
+
+int run_playlist_benchmark(const std::vector<std::string>& inputs, int preroll_frames)
+{
+    std::vector<std::string> file_paths = collect_media_files(inputs);
+    if (file_paths.size() < 2)
+    {
+        DANEJOE_CLOG(ERROR, APP, "PlaylistBenchmark", "At least two files are required");
+        return -1;
+    }
+    std::cout << "files: " << file_paths.size() << ", preroll frames: " << preroll_frames << "\n";
+    std::cout << std::setw(10) << "mode" << std::setw(10) << "seconds" << std::setw(10) << "frames"
+        << std::setw(13) << "transitions" << std::setw(14) << "avg gap ms" << std::setw(14) << "max gap ms" << "\n";
+    int exit_code = 0;
+    for (bool is_preload : { false, true })
+    {
+        PlaylistDecoder::Options options;
+        options.is_preload = is_preload;
+        options.preroll_frames = preroll_frames;
+        PlaylistDecoder playlist_decoder(file_paths, options);
+        auto frame_queue = std::make_shared<FrameQueue>(16);
+        std::atomic<bool> is_done = false;
+        uint64_t frame_count = 0;
+        auto begin = std::chrono::steady_clock::now();
+        {
+            // 消费端尽快排空队列，切换时的断流直接体现为两次入队之间的间隔
+            std::jthread consumer([&]()
+                {
+                    while (true)
+                    {
+                        if (frame_queue->try_pop().has_value())
+                        {
+                            frame_count++;
+                            continue;
+                        }
+                        if (is_done.load(std::memory_order_acquire))
+                        {
+                            break;
+                        }
+                        std::this_thread::yield();
+                    }
+                });
+            AVError error = playlist_decoder.run(frame_queue);
+            is_done.store(true, std::memory_order_release);
+            if (error.failed())
+            {
+                DANEJOE_CLOG(ERROR, APP, "PlaylistBenchmark", "Playlist failed: {}", error.message());
+                exit_code = -1;
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        const auto& transitions = playlist_decoder.get_transitions();
+        double total_gap_ms = 0.;
+        double max_gap_ms = 0.;
+        for (const auto& transition : transitions)
+        {
+            total_gap_ms += transition.gap_ms;
+            max_gap_ms = std::max(max_gap_ms, transition.gap_ms);
+        }
+        std::cout << std::fixed << std::setprecision(3)
+            << std::setw(10) << (is_preload ? "preload" : "restart")
+            << std::setw(10) << seconds
+            << std::setw(10) << frame_count
+            << std::setw(13) << transitions.size()
+            << std::setw(14) << (transitions.empty() ? 0. : total_gap_ms / transitions.size())
+            << std::setw(14) << max_gap_ms
+            << "\n";
+    }
+    return exit_code;
+}
@@ -0,0 +1,349 @@
+#include <algorithm>
+
+#include "main/present_thread.hpp"
+#include "util/util_log.hpp"
+#include "util/util_trace_recorder.hpp"
+
+namespace
+{
+    /// @brief 没有输出在播放时轮询 SDL 事件的周期
+    constexpr std::chrono::milliseconds EVENT_POLL_INTERVAL(20);
+}
+
+PresentThread::PresentThread()
+{
+    m_thread = std::jthread(&PresentThread::run, this);
+}
+
+PresentThread::~PresentThread()
+{
+    close();
+    if (m_thread.joinable())
+    {
+        m_thread.join();
+    }
+}
+
+PresentThread::OutputId PresentThread::add_output(std::unique_ptr<IFrameRenderer> renderer, std::string window_name, DaneJoe::Size<int> window_size, void* window,
+    std::shared_ptr<FrameQueue> frame_queue, std::shared_ptr<PlaybackRateControl> rate_control)
+{
+    auto output = std::make_shared<Output>();
+    output->renderer = std::move(renderer);
+    output->window_name = std::move(window_name);
+    output->window = window;
+    output->window_size = window_size;
+    output->frame_queue = std::move(frame_queue);
+    output->rate_control = std::move(rate_control);
+    OutputId id = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        id = m_next_id++;
+        output->id = id;
+        m_output_map.emplace(id, output);
+        m_added_outputs.push_back(std::move(output));
+    }
+    m_condition.notify_one();
+    return id;
+}
+
+void PresentThread::remove_output(OutputId id)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = m_output_map.find(id);
+    if (it == m_output_map.end())
+    {
+        return;
+    }
+    std::shared_ptr<Output> output = std::move(it->second);
+    m_output_map.erase(it);
+    output->is_removed = true;
+    m_condition.notify_one();
+    // 原生窗口随控件销毁，须等呈现线程先释放关联到它的 SDL 窗口
+    m_released_condition.wait(lock, [this, &output]() { return output->is_released || m_is_stopped; });
+}
+
+void PresentThread::set_paused(OutputId id, bool is_paused)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_output_map.find(id);
+        if (it == m_output_map.end())
+        {
+            return;
+        }
+        it->second->is_paused = is_paused;
+    }
+    m_condition.notify_one();
+}
+
+void PresentThread::show_frame(OutputId id, AVFrameView&& frame_view)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_output_map.find(id);
+        if (it == m_output_map.end())
+        {
+            return;
+        }
+        it->second->step_frame = std::move(frame_view);
+    }
+    m_condition.notify_one();
+}
+
+void PresentThread::update_window_size(OutputId id, DaneJoe::Size<int> window_size)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_output_map.find(id);
+        if (it == m_output_map.end())
+        {
+            return;
+        }
+        it->second->window_size = window_size;
+    }
+    m_condition.notify_one();
+}
+
+bool PresentThread::is_exit()const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_is_exit;
+}
+
+void PresentThread::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_is_closed = true;
+    }
+    m_condition.notify_one();
+}
+
+FramePacer::Report PresentThread::get_report(OutputId id)const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_output_map.find(id);
+    if (it == m_output_map.end())
+    {
+        return FramePacer::Report();
+    }
+    return it->second->report;
+}
+
+void PresentThread::run()
+{
+    DaneJoe::TraceRecorder::get_instance().set_thread_name("present");
+    Work work;
+    while (take_work(work))
+    {
+        for (auto& output : work.removed)
+        {
+            release_output(*output);
+        }
+        for (auto& output : work.added)
+        {
+            if (init_output(*output))
+            {
+                m_outputs.push_back(std::move(output));
+            }
+            else
+            {
+                release_output(*output);
+            }
+        }
+        // SDL 事件队列是全局的，由任一渲染器取完即可
+        if (!m_outputs.empty() && m_outputs.front()->renderer->is_exit())
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_is_exit = true;
+        }
+        for (auto& output_work : work.outputs)
+        {
+            IFrameRenderer& renderer = *output_work.output->renderer;
+            if (output_work.window_size)
+            {
+                renderer.update_window_size(*output_work.window_size);
+            }
+            if (output_work.step_frame && !renderer.draw(*output_work.step_frame))
+            {
+                DANEJOE_CLOG(ERROR, RENDER, "PresentThread", "Failed to draw step frame");
+            }
+        }
+        present_next_frame(work.outputs);
+    }
+    // 渲染器与 SDL 窗口都在本线程上释放
+    std::vector<std::shared_ptr<Output>> outputs = std::move(m_outputs);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        outputs.insert(outputs.end(), m_added_outputs.begin(), m_added_outputs.end());
+        m_added_outputs.clear();
+    }
+    for (auto& output : outputs)
+    {
+        release_output(*output);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_is_stopped = true;
+    }
+    m_released_condition.notify_all();
+}
+
+bool PresentThread::take_work(Work& work)
+{
+    work = Work();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto has_work = [this]()
+        {
+            if (m_is_closed || !m_added_outputs.empty())
+            {
+                return true;
+            }
+            return std::any_of(m_outputs.begin(), m_outputs.end(), [](const std::shared_ptr<Output>& output)
+                {
+                    return output->is_removed || !output->is_paused || output->step_frame.has_value() || output->window_size.has_value();
+                });
+        };
+    // 所有输出都暂停时只等待控制，并按轮询周期醒来处理 SDL 事件
+    m_condition.wait_for(lock, EVENT_POLL_INTERVAL, has_work);
+    if (m_is_closed)
+    {
+        return false;
+    }
+    for (auto& output : m_added_outputs)
+    {
+        (output->is_removed ? work.removed : work.added).push_back(std::move(output));
+    }
+    m_added_outputs.clear();
+    std::erase_if(m_outputs, [&work](const std::shared_ptr<Output>& output)
+        {
+            if (output->is_removed)
+            {
+                work.removed.push_back(output);
+            }
+            return output->is_removed;
+        });
+    for (auto& output : m_outputs)
+    {
+        work.outputs.push_back({ output.get(), std::move(output->step_frame), output->window_size, output->is_paused });
+        output->step_frame.reset();
+        output->window_size.reset();
+    }
+    return true;
+}
+
+bool PresentThread::init_output(Output& output)
+{
+    DaneJoe::Size<int> window_size;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        window_size = output.window_size.value_or(DaneJoe::Size<int>{ 0, 0 });
+        output.window_size.reset();
+    }
+    if (!output.renderer || !output.frame_queue ||
+        !output.renderer->set_window(output.window_name, window_size, output.window) || !output.renderer->init())
+    {
+        DANEJOE_CLOG(ERROR, RENDER, "PresentThread", "init renderer failed");
+        return false;
+    }
+    if (!m_refresh_clock)
+    {
+        // 刷新率未知时按 60Hz 的网格调度
+        m_refresh_clock = std::make_unique<RefreshClock>(output.renderer->refresh_rate());
+        DANEJOE_CLOG(INFO, RENDER, "PresentThread", "Refresh rate {}Hz, vsync {}", m_refresh_clock->refresh_hz(), output.renderer->is_vsync());
+    }
+    output.frame_pacer = std::make_unique<FramePacer>(output.rate_control, m_refresh_clock->interval());
+    return true;
+}
+
+void PresentThread::release_output(Output& output)
+{
+    output.frame_pacer.reset();
+    output.renderer.reset();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        output.is_released = true;
+    }
+    m_released_condition.notify_all();
+}
+
+void PresentThread::present_next_frame(const std::vector<OutputWork>& outputs)
+{
+    std::vector<Output*> active_outputs;
+    for (const auto& output_work : outputs)
+    {
+        Output& output = *output_work.output;
+        if (output_work.is_paused)
+        {
+            if (!output.is_pacer_paused)
+            {
+                output.frame_pacer->pause();
+                output.is_pacer_paused = true;
+            }
+            continue;
+        }
+        output.is_pacer_paused = false;
+        active_outputs.push_back(&output);
+    }
+    if (active_outputs.empty())
+    {
+        return;
+    }
+    Clock::time_point target = m_refresh_clock->next_refresh(Clock::now());
+    // 先为下一次刷新给每个输出选帧，再等到该刷新时刻依次绘制
+    std::vector<std::optional<AVFrameView>> frames;
+    frames.reserve(active_outputs.size());
+    bool has_frame = false;
+    for (Output* output : active_outputs)
+    {
+        frames.push_back(output->frame_pacer->take_frame(*output->frame_queue, target));
+        has_frame = has_frame || frames.back().has_value();
+        // 两帧之间的刷新没有到期的帧属于正常情况，只有队列也为空时才说明解码跟不上
+        if (!frames.back() && output->frame_queue->size() == 0)
+        {
+            DANEJOE_CLOG_RATE_LIMITED(DEBUG, RENDER, "PresentThread", 1000, "Frame queue is empty");
+        }
+    }
+    // 多个输出轮流绘制时每次 present 阻塞到刷新会互相拖慢，只有单个输出才由 vsync 对齐刷新
+    bool is_vsync = active_outputs.size() == 1 && active_outputs.front()->renderer->is_vsync();
+    if (!has_frame || !is_vsync)
+    {
+        m_present_timer.sleep_until(target);
+    }
+    for (std::size_t i = 0; i < active_outputs.size(); i++)
+    {
+        if (!frames[i])
+        {
+            continue;
+        }
+        Output& output = *active_outputs[i];
+        // 直接借用队列中的帧视图绘制，帧在本次刷新结束时归还缓冲
+        bool is_draw = false;
+        {
+            DANEJOE_TRACE_SCOPE(PRESENT, "draw");
+            is_draw = output.renderer->draw(*frames[i]);
+        }
+        if (!is_draw)
+        {
+            DANEJOE_CLOG_RATE_LIMITED(ERROR, RENDER, "PresentThread", 1000, "Failed to draw");
+            continue;
+        }
+        Clock::time_point now = Clock::now();
+        Clock::time_point present_time = target;
+        if (is_vsync)
+        {
+            // present 返回时刻即实际刷新时刻
+            present_time = m_refresh_clock->observe(now);
+        }
+        else if (now - target > m_refresh_clock->interval() / 2)
+        {
+            present_time = m_refresh_clock->next_refresh(now);
+        }
+        output.frame_pacer->record_presented(*frames[i], target, present_time);
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (Output* output : active_outputs)
+    {
+        output->report = output->frame_pacer->get_report();
+    }
+}
@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "main/reverse_decoder.hpp"
+#include "main/batch_processor.hpp"
+#include "util/util_log.hpp"
+#include "util/util_trace_recorder.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    /// @brief 输出时间轴的时间基（微秒）
+    constexpr AVRational TIMELINE_TIME_BASE = { 1, 1000000 };
+}
+
+ReverseDecoder::ReverseDecoder(std::string file_path, const Options& options) :
+    m_file_path(std::move(file_path)), m_options(options)
+{
+    m_options.max_segment_frames = std::max<std::size_t>(m_options.max_segment_frames, 1);
+}
+
+std::optional<int64_t> ReverseDecoder::frame_time_us(const AVFrameView& frame_view)
+{
+    if (frame_view.pts() == AV_NOPTS_VALUE)
+    {
+        return std::nullopt;
+    }
+    return av_rescale_q(frame_view.pts() - m_decoder.start_pts(), frame_view.time_base(), TIMELINE_TIME_BASE);
+}
+
+ReverseDecoder::Segment ReverseDecoder::decode_segment(int64_t end_us)
+{
+    DANEJOE_TRACE_SCOPE_ARG(DECODE, "reverse_segment", end_us);
+    Segment segment;
+    Clock::time_point begin = Clock::now();
+    SeekBackoff backoff(m_decoder, m_decoder.start_pts() + av_rescale_q_rnd(end_us - 1, TIMELINE_TIME_BASE, m_decoder.time_base(), AV_ROUND_DOWN));
+    while (true)
+    {
+        segment.error = m_decoder.seek_timestamp(backoff.target());
+        if (segment.error.failed())
+        {
+            return segment;
+        }
+        /// @brief 只保留段内靠后的 max_segment_frames 帧
+        std::deque<std::pair<int64_t, AVFrameView>> kept;
+        std::optional<int64_t> key_time_us;
+        std::optional<int64_t> first_time_us;
+        bool is_evicted = false;
+        while (true)
+        {
+            AVFrameView frame_view;
+            AVError error = m_decoder.decode_frame(frame_view);
+            if (error == AVERROR_EOF)
+            {
+                break;
+            }
+            if (error.failed())
+            {
+                segment.error = error;
+                return segment;
+            }
+            segment.decoded_frames++;
+            std::optional<int64_t> time_us = frame_time_us(frame_view);
+            if (!time_us)
+            {
+                continue;
+            }
+            if (*time_us >= end_us)
+            {
+                break;
+            }
+            if (!first_time_us)
+            {
+                first_time_us = time_us;
+            }
+            if (!key_time_us && frame_view.is_key_frame())
+            {
+                key_time_us = time_us;
+            }
+            kept.emplace_back(*time_us, std::move(frame_view));
+            if (kept.size() > m_options.max_segment_frames)
+            {
+                kept.pop_front();
+                is_evicted = true;
+            }
+        }
+        // 开放 GOP 中排在关键帧之前的帧依赖上一段，不在本段输出；没有关键帧标记时以第一帧为准
+        if (!key_time_us)
+        {
+            key_time_us = first_time_us;
+        }
+        while (key_time_us && !kept.empty() && kept.front().first < *key_time_us)
+        {
+            kept.pop_front();
+        }
+        if (kept.empty() && backoff.can_retreat())
+        {
+            // 定位落在了段结束时间上或之后（索引不精确的容器），继续向前退
+            backoff.retreat();
+            continue;
+        }
+        segment.frames.reserve(kept.size());
+        segment.times_us.reserve(kept.size());
+        for (auto& [time_us, frame_view] : kept)
+        {
+            segment.times_us.push_back(time_us);
+            segment.frames.push_back(std::move(frame_view));
+        }
+        // 超出缓存被丢弃的较早部分作为下一段，从同一关键帧重新解码
+        segment.begin_us = segment.times_us.empty() ? 0 : (is_evicted ? segment.times_us.front() : *key_time_us);
+        segment.is_start = segment.begin_us <= 0 || segment.begin_us >= end_us;
+        break;
+    }
+    segment.decode_ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    return segment;
+}
+
+AVError ReverseDecoder::run(std::weak_ptr<FrameQueue> frame_queue, int64_t start_ms)
+{
+    m_stats = Stats();
+    AVError error = m_decoder.open(m_file_path, m_options.decoder_options);
+    if (error.failed())
+    {
+        return error;
+    }
+    int64_t origin_us = start_ms >= 0 ? start_ms * 1000 : m_decoder.duration_ms() * 1000;
+    if (origin_us <= 0)
+    {
+        DANEJOE_CLOG(ERROR, DECODE, "ReverseDecoder", "Unknown duration of {}", m_file_path);
+        return AVError(AVERROR(EINVAL));
+    }
+    if (m_decoder.frame_rate() > 0.)
+    {
+        m_fallback_duration_us = std::llround(AV_TIME_BASE / m_decoder.frame_rate());
+    }
+    DecodeRateAdapter rate_adapter(m_options.rate_control);
+    Segment segment = decode_segment(origin_us);
+    while (true)
+    {
+        if (segment.error.failed())
+        {
+            DANEJOE_CLOG(WARN, DECODE, "ReverseDecoder", "Reverse decoding {} stopped: {}", m_file_path, segment.error.message());
+            return segment.error;
+        }
+        m_stats.segments++;
+        m_stats.decoded_frames += segment.decoded_frames;
+        m_stats.decode_ms += segment.decode_ms;
+        // 推送当前段期间只有预取线程使用解码器
+        std::future<Segment> next;
+        if (!segment.is_start && m_options.is_prefetch)
+        {
+            next = std::async(std::launch::async, &ReverseDecoder::decode_segment, this, segment.begin_us);
+        }
+        for (std::size_t i = segment.frames.size(); i-- > 0;)
+        {
+            AVFrameView& frame_view = segment.frames[i];
+            int64_t duration_us = frame_view.duration() > 0 ? av_rescale_q(frame_view.duration(), frame_view.time_base(), TIMELINE_TIME_BASE) : m_fallback_duration_us;
+            // 倒放时间轴：帧结束时间离起点越近，输出越早
+            frame_view.set_timing(origin_us - (segment.times_us[i] + duration_us), duration_us, TIMELINE_TIME_BASE);
+            auto frame_queue_shared_ptr = frame_queue.lock();
+            if (!frame_queue_shared_ptr || !frame_queue_shared_ptr->is_running())
+            {
+                DANEJOE_CLOG(INFO, DECODE, "ReverseDecoder", "frame_queue is not running");
+                return AVError(0);
+            }
+            rate_adapter.throttle(frame_view, [&frame_queue_shared_ptr]() { return frame_queue_shared_ptr->is_running(); });
+            {
+                DANEJOE_TRACE_SCOPE_ARG(QUEUE_WAIT, "push", segment.times_us[i]);
+                frame_queue_shared_ptr->push(std::move(frame_view));
+            }
+            m_stats.emitted_frames++;
+        }
+        if (segment.is_start)
+        {
+            break;
+        }
+        if (next.valid())
+        {
+            Clock::time_point wait_begin = Clock::now();
+            segment = next.get();
+            m_stats.prefetch_wait_ms += std::chrono::duration<double, std::milli>(Clock::now() - wait_begin).count();
+        }
+        else
+        {
+            segment = decode_segment(segment.begin_us);
+        }
+    }
+    return AVError(0);
+}
+
+const ReverseDecoder::Stats& ReverseDecoder::get_stats()const
+{
+    return m_stats;
+}
+
+int run_reverse_benchmark(const std::vector<std::string>& inputs, std::size_t max_segment_frames)
+{
+    std::vector<std::string> file_paths = collect_media_files(inputs);
+    if (file_paths.empty() || max_segment_frames == 0)
+    {
+        DANEJOE_CLOG(ERROR, APP, "ReverseBenchmark", "Invalid arguments");
+        return -1;
+    }
+    const std::string& file_path = file_paths.front();
+    double source_fps = 0.;
+    {
+        MediaDecoder probe;
+        if (probe.open(file_path).ok())
+        {
+            source_fps = probe.frame_rate();
+        }
+    }
+    std::cout << "file: " << file_path << ", source fps: " << source_fps << ", segment frames: " << max_segment_frames << "\n";
+    std::cout << std::setw(12) << "prefetch" << std::setw(10) << "frames" << std::setw(10) << "fps" << std::setw(10) << "realtime"
+        << std::setw(10) << "segments" << std::setw(12) << "amplify" << std::setw(12) << "wait ms" << "\n";
+    int exit_code = 0;
+    for (bool is_prefetch : { false, true })
+    {
+        ReverseDecoder::Options options;
+        options.max_segment_frames = max_segment_frames;
+        options.is_prefetch = is_prefetch;
+        ReverseDecoder reverse_decoder(file_path, options);
+        auto frame_queue = std::make_shared<FrameQueue>(16);
+        std::atomic<bool> is_done = false;
+        // 消费端立即取走，测量倒放能达到的最高帧率
+        std::jthread consumer([&frame_queue, &is_done]()
+            {
+                while (!is_done.load(std::memory_order_acquire) || frame_queue->size() > 0)
+                {
+                    if (!frame_queue->try_pop())
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        Clock::time_point begin = Clock::now();
+        AVError error = reverse_decoder.run(frame_queue);
+        double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        is_done.store(true, std::memory_order_release);
+        consumer.join();
+        if (error.failed())
+        {
+            DANEJOE_CLOG(ERROR, APP, "ReverseBenchmark", "Reverse decoding failed: {}", error.message());
+            exit_code = -1;
+            continue;
+        }
+        const ReverseDecoder::Stats& stats = reverse_decoder.get_stats();
+        double fps = seconds > 0. ? stats.emitted_frames / seconds : 0.;
+        std::cout << std::fixed << std::setprecision(1)
+            << std::setw(12) << (is_prefetch ? "on" : "off")
+            << std::setw(10) << stats.emitted_frames
+            << std::setw(10) << fps
+            << std::setw(9) << std::setprecision(2) << (source_fps > 0. ? fps / source_fps : 0.) << "x"
+            << std::setw(10) << stats.segments
+            << std::setw(11) << (stats.emitted_frames > 0 ? static_cast<double>(stats.decoded_frames) / stats.emitted_frames : 0.) << "x"
+            << std::setw(12) << std::setprecision(1) << stats.prefetch_wait_ms
+            << "\n";
+    }
+    return exit_code;
+}
@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+#include "main/startup_benchmark.hpp"
+#include "main/batch_processor.hpp"
+#include "main/media_decoder.hpp"
+#include "main/stream_info_cache.hpp"
+#include "codec/av_codec_context_pool.hpp"
+#include "renderer/sdl_frame_renderer.hpp"
+#include "util/util_startup_metrics.hpp"
+#include "util/util_log.hpp"
+
+namespace
+{
+    using Stage = DaneJoe::StartupMetrics::Stage;
+    constexpr std::size_t STAGE_COUNT = static_cast<std::size_t>(Stage::COUNT);
+
+    /**
+     * @enum CacheMode
+     * @brief 流信息缓存使用方式
+     */
+    enum class CacheMode
+    {
+        /// @brief 不使用
+        NONE,
+        /// @brief 每次打开前清空，测量探测加写盘的开销
+        COLD,
+        /// @brief 预先写入，测量命中时的耗时
+        WARM,
+    };
+
+    /**
+     * @struct Configuration
+     * @brief 一种打开配置
+     */
+    struct Configuration
+    {
+        std::string name;
+        MediaDecoder::Options options;
+        CacheMode cache_mode = CacheMode::NONE;
+    };
+
+    /**
+     * @struct StageSamples
+     * @brief 各阶段耗时样本（毫秒）
+     */
+    struct StageSamples
+    {
+        std::array<std::vector<double>, STAGE_COUNT> samples;
+        int failures = 0;
+    };
+
+    double median(std::vector<double> values)
+    {
+        if (values.empty())
+        {
+            return 0.;
+        }
+        std::size_t middle = values.size() / 2;
+        std::nth_element(values.begin(), values.begin() + middle, values.end());
+        return values[middle];
+    }
+
+    /**
+     * @brief 打开文件并取出第一帧，记录各阶段耗时
+     */
+    bool measure_once(const std::string& file_path, const MediaDecoder::Options& options, SDLFrameRenderer* renderer, StageSamples& result)
+    {
+        DaneJoe::StartupMetrics& metrics = DaneJoe::StartupMetrics::get_instance();
+        metrics.reset();
+        MediaDecoder decoder;
+        AVError error = decoder.open(file_path, options);
+        AVFrameView frame_view;
+        if (error.ok())
+        {
+            error = decoder.decode_frame(frame_view);
+        }
+        if (error.ok() && renderer && !renderer->draw(frame_view))
+        {
+            error = AVError(AVERROR_EXTERNAL);
+        }
+        if (error.failed())
+        {
+            DANEJOE_CLOG(WARN, APP, "StartupBenchmark", "Failed to get first frame of {}: {}", file_path, error.message());
+            result.failures++;
+            return false;
+        }
+        for (std::size_t i = static_cast<std::size_t>(Stage::INPUT_OPENED); i < STAGE_COUNT; i++)
+        {
+            std::optional<double> elapsed = metrics.elapsed_ms(static_cast<Stage>(i));
+            if (elapsed)
+            {
+                result.samples[i].push_back(*elapsed);
+            }
+        }
+        return true;
+    }
+}
+
+int run_startup_benchmark(const std::vector<std::string>& inputs, const StartupBenchmarkOptions& options)
+{
+    std::vector<std::string> file_paths = collect_media_files(inputs);
+    if (file_paths.empty() || options.rounds <= 0)
+    {
+        DANEJOE_CLOG(ERROR, APP, "StartupBenchmark", "Invalid arguments");
+        return -1;
+    }
+    std::unique_ptr<SDLFrameRenderer> renderer;
+    if (options.is_present)
+    {
+        try
+        {
+            renderer = std::make_unique<SDLFrameRenderer>("ttff-bench", DaneJoe::Size<int>(640, 360), nullptr);
+        }
+        catch (const std::exception& exception)
+        {
+            DANEJOE_CLOG(ERROR, APP, "StartupBenchmark", "Failed to create SDL window: {}", exception.what());
+            return -1;
+        }
+    }
+
+    std::vector<Configuration> configurations(4);
+    configurations[0].name = "default";
+    configurations[1].name = "tuned";
+    configurations[1].options.probe_size = options.probe_size;
+    configurations[1].options.analyze_duration_us = options.analyze_duration_us;
+    configurations[2].name = "cache-cold";
+    configurations[2].options.is_use_stream_info_cache = true;
+    configurations[2].cache_mode = CacheMode::COLD;
+    configurations[3].name = "cache-warm";
+    configurations[3].options.is_use_stream_info_cache = true;
+    configurations[3].cache_mode = CacheMode::WARM;
+
+    // 基准使用独立的缓存文件，结束后恢复
+    StreamInfoCache& cache = StreamInfoCache::get_instance();
+    std::string cache_path = cache.path();
+    cache.set_path((std::filesystem::temp_directory_path() / "danejoe_ttff_bench.cache").string());
+    cache.clear();
+
+    // 预热：页缓存与解码器的首次初始化不计入
+    for (const auto& file_path : file_paths)
+    {
+        StageSamples ignored;
+        measure_once(file_path, MediaDecoder::Options(), renderer.get(), ignored);
+    }
+
+    Stage final_stage = renderer ? Stage::FIRST_FRAME_PRESENTED : Stage::FIRST_FRAME_DECODED;
+    std::cout << "files: " << file_paths.size() << ", rounds: " << options.rounds
+        << ", probesize: " << options.probe_size << ", analyzeduration: " << options.analyze_duration_us << "us"
+        << ", until: " << DaneJoe::StartupMetrics::stage_name(final_stage) << "\n";
+    std::cout << std::setw(12) << "config" << std::setw(10) << "ttff ms" << std::setw(10) << "max ms";
+    for (std::size_t i = static_cast<std::size_t>(Stage::INPUT_OPENED); i <= static_cast<std::size_t>(final_stage); i++)
+    {
+        std::cout << std::setw(13) << DaneJoe::StartupMetrics::stage_name(static_cast<Stage>(i));
+    }
+    std::cout << std::setw(10) << "failed" << "\n";
+
+    int exit_code = 0;
+    for (const auto& configuration : configurations)
+    {
+        cache.clear();
+        if (configuration.cache_mode == CacheMode::WARM)
+        {
+            for (const auto& file_path : file_paths)
+            {
+                StageSamples ignored;
+                measure_once(file_path, configuration.options, renderer.get(), ignored);
+            }
+        }
+        StageSamples result;
+        for (int round = 0; round < options.rounds; round++)
+        {
+            for (const auto& file_path : file_paths)
+            {
+                if (configuration.cache_mode == CacheMode::COLD)
+                {
+                    cache.clear();
+                }
+                measure_once(file_path, configuration.options, renderer.get(), result);
+            }
+        }
+        const std::vector<double>& ttff = result.samples[static_cast<std::size_t>(final_stage)];
+        std::cout << std::fixed << std::setprecision(2)
+            << std::setw(12) << configuration.name
+            << std::setw(10) << median(ttff)
+            << std::setw(10) << (ttff.empty() ? 0. : *std::max_element(ttff.begin(), ttff.end()));
+        for (std::size_t i = static_cast<std::size_t>(Stage::INPUT_OPENED); i <= static_cast<std::size_t>(final_stage); i++)
+        {
+            std::cout << std::setw(13) << median(result.samples[i]);
+        }
+        std::cout << std::setw(10) << result.failures << "\n";
+        if (result.failures > 0)
+        {
+            exit_code = -1;
+        }
+    }
+    StreamInfoCache::Stats stats = cache.get_stats();
+    std::cout << "stream info cache: hits " << stats.hits << ", misses " << stats.misses
+        << ", invalidations " << stats.invalidations << ", stores " << stats.stores << "\n";
+
+    cache.clear();
+    cache.set_path(cache_path);
+    return exit_code;
+}
+
+int run_open_benchmark(const std::vector<std::string>& inputs, int rounds, int thread_count)
+{
+    std::vector<std::string> file_paths = collect_media_files(inputs);
+    if (file_paths.empty() || rounds <= 0)
+    {
+        DANEJOE_CLOG(ERROR, APP, "StartupBenchmark", "Invalid arguments");
+        return -1;
+    }
+    AVCodecContextPool& pool = AVCodecContextPool::get_instance();
+    // 池容量覆盖全部文件，测量纯复用收益
+    pool.set_capacity(std::max<std::size_t>(file_paths.size(), 8));
+
+    // 预热页缓存与解码器的一次性初始化
+    for (const auto& file_path : file_paths)
+    {
+        StageSamples ignored;
+        MediaDecoder::Options options;
+        options.thread_count = thread_count;
+        measure_once(file_path, options, nullptr, ignored);
+    }
+
+    std::cout << "files: " << file_paths.size() << ", rounds: " << rounds << ", threads: " << thread_count << "\n";
+    std::cout << std::setw(10) << "mode" << std::setw(10) << "open ms" << std::setw(12) << "decoder ms"
+        << std::setw(14) << "1st frame ms" << std::setw(12) << "opens/s" << std::setw(10) << "hit rate" << std::setw(10) << "failed" << "\n";
+    int exit_code = 0;
+    for (bool is_pooled : { false, true })
+    {
+        pool.clear();
+        AVCodecContextPool::Stats before = pool.get_stats();
+        MediaDecoder::Options options;
+        options.thread_count = thread_count;
+        options.is_use_context_pool = is_pooled;
+        StageSamples result;
+        std::vector<double> decoder_open_ms;
+        auto begin = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; round++)
+        {
+            for (const auto& file_path : file_paths)
+            {
+                if (!measure_once(file_path, options, nullptr, result))
+                {
+                    continue;
+                }
+                DaneJoe::StartupMetrics& metrics = DaneJoe::StartupMetrics::get_instance();
+                decoder_open_ms.push_back(*metrics.elapsed_ms(Stage::DECODER_OPENED) - *metrics.elapsed_ms(Stage::STREAM_INFO_READY));
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        AVCodecContextPool::Stats after = pool.get_stats();
+        uint64_t hits = after.hits - before.hits;
+        uint64_t lookups = hits + after.misses - before.misses;
+        std::size_t opens = decoder_open_ms.size();
+        std::cout << std::fixed << std::setprecision(3)
+            << std::setw(10) << (is_pooled ? "pooled" : "fresh")
+            << std::setw(10) << median(result.samples[static_cast<std::size_t>(Stage::DECODER_OPENED)])
+            << std::setw(12) << median(decoder_open_ms)
+            << std::setw(14) << median(result.samples[static_cast<std::size_t>(Stage::FIRST_FRAME_DECODED)])
+            << std::setw(12) << std::setprecision(1) << opens / std::max(seconds, 1e-9)
+            << std::setw(9) << (lookups > 0 ? hits * 100. / lookups : 0.) << "%"
+            << std::setw(10) << result.failures << "\n";
+        if (result.failures > 0)
+        {
+            exit_code = -1;
+        }
+    }
+    pool.clear();
+    return exit_code;
+}
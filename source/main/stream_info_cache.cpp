@@ -0,0 +1,546 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include <unistd.h>
+
+extern "C"
+{
+#include <libavutil/mem.h>
+}
+
+#include "main/stream_info_cache.hpp"
+#include "util/util_log.hpp"
+
+namespace
+{
+    /// @brief 缓存文件格式标识与版本，字段变化时递增版本，旧文件整体作废
+    constexpr const char* CACHE_MAGIC = "danejoe-stream-info";
+    constexpr int CACHE_VERSION = 1;
+    /// @brief 最多保留的文件数，超出时淘汰最久未使用的
+    constexpr std::size_t MAX_ENTRIES = 512;
+    /// @brief 首次 store 到写盘的延迟，期间的 store 合并为一次写盘
+    constexpr std::chrono::seconds SAVE_DELAY(1);
+
+    /**
+     * @brief 按 XDG 基础目录规范取用户缓存目录下的缓存文件
+     * @return $XDG_CACHE_HOME/danejoe/stream_info.cache，未设置时为 $HOME/.cache/danejoe/stream_info.cache；
+     *         两者都不可用时为空，只在内存中缓存
+     */
+    std::string default_cache_path()
+    {
+        std::filesystem::path directory;
+        const char* cache_home = std::getenv("XDG_CACHE_HOME");
+        const char* home = std::getenv("HOME");
+        // 规范要求 XDG_CACHE_HOME 为绝对路径，相对路径视为未设置
+        if (cache_home && std::filesystem::path(cache_home).is_absolute())
+        {
+            directory = cache_home;
+        }
+        else if (home && *home)
+        {
+            directory = std::filesystem::path(home) / ".cache";
+        }
+        else
+        {
+            return {};
+        }
+        return (directory / "danejoe" / "stream_info.cache").string();
+    }
+
+    /**
+     * @brief 文件标识
+     */
+    struct FileIdentity
+    {
+        std::string key;
+        int64_t file_size = 0;
+        int64_t modify_time_ns = 0;
+    };
+
+    bool get_file_identity(const std::string& file_path, FileIdentity& identity)
+    {
+        std::error_code error_code;
+        std::filesystem::path path = std::filesystem::weakly_canonical(file_path, error_code);
+        if (error_code)
+        {
+            return false;
+        }
+        auto file_size = std::filesystem::file_size(path, error_code);
+        if (error_code)
+        {
+            return false;
+        }
+        auto modify_time = std::filesystem::last_write_time(path, error_code);
+        if (error_code)
+        {
+            return false;
+        }
+        identity.key = path.string();
+        identity.file_size = static_cast<int64_t>(file_size);
+        identity.modify_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(modify_time.time_since_epoch()).count();
+        // 路径独占一行的剩余部分，含换行的路径不缓存
+        return !identity.key.empty() && identity.key.find('\n') == std::string::npos;
+    }
+
+    std::string to_hex(const std::vector<uint8_t>& data)
+    {
+        if (data.empty())
+        {
+            return "-";
+        }
+        static constexpr char digits[] = "0123456789abcdef";
+        std::string text;
+        text.reserve(data.size() * 2);
+        for (uint8_t byte : data)
+        {
+            text.push_back(digits[byte >> 4]);
+            text.push_back(digits[byte & 0x0f]);
+        }
+        return text;
+    }
+
+    bool from_hex(const std::string& text, std::vector<uint8_t>& data)
+    {
+        data.clear();
+        if (text == "-")
+        {
+            return true;
+        }
+        if (text.size() % 2 != 0)
+        {
+            return false;
+        }
+        auto nibble = [](char c) -> int
+            {
+                if (c >= '0' && c <= '9') return c - '0';
+                if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+                return -1;
+            };
+        data.reserve(text.size() / 2);
+        for (std::size_t i = 0; i < text.size(); i += 2)
+        {
+            int high = nibble(text[i]);
+            int low = nibble(text[i + 1]);
+            if (high < 0 || low < 0)
+            {
+                return false;
+            }
+            data.push_back(static_cast<uint8_t>(high << 4 | low));
+        }
+        return true;
+    }
+}
+
+StreamInfoCache& StreamInfoCache::get_instance()
+{
+    static StreamInfoCache instance;
+    return instance;
+}
+
+StreamInfoCache::StreamInfoCache() :m_path(default_cache_path()) {}
+
+StreamInfoCache::~StreamInfoCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_is_stopping = true;
+    }
+    m_save_condition.notify_all();
+    if (m_saver.joinable())
+    {
+        m_saver.join();
+    }
+    // 退出前写入尚未落盘的记录
+    flush();
+}
+
+void StreamInfoCache::set_path(const std::string& path)
+{
+    // 尚未落盘的记录写回旧路径
+    flush();
+    std::lock_guard<std::mutex> save_lock(m_save_mutex);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_path = path;
+    m_entries.clear();
+    m_is_loaded = false;
+    m_is_dirty = false;
+}
+
+std::string StreamInfoCache::path()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_path;
+}
+
+bool StreamInfoCache::apply(const std::string& file_path, AVFormatContext* format_context)
+{
+    if (!format_context)
+    {
+        return false;
+    }
+    FileIdentity identity;
+    if (!get_file_identity(file_path, identity))
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ensure_loaded();
+    auto it = m_entries.find(identity.key);
+    if (it == m_entries.end())
+    {
+        m_stats.misses++;
+        return false;
+    }
+    Entry& entry = it->second;
+    bool is_valid = entry.file_size == identity.file_size && entry.modify_time_ns == identity.modify_time_ns
+        && entry.stream_count == format_context->nb_streams && !entry.streams.empty();
+    // 容器头已给出的字段须与记录一致，防止同名文件被替换后误用
+    for (std::size_t i = 0; is_valid && i < entry.streams.size(); i++)
+    {
+        const StreamEntry& cached = entry.streams[i];
+        if (cached.index < 0 || static_cast<unsigned int>(cached.index) >= format_context->nb_streams)
+        {
+            is_valid = false;
+            break;
+        }
+        const AVStream* stream = format_context->streams[cached.index];
+        const AVCodecParameters* parameters = stream->codecpar;
+        is_valid = parameters->codec_type == AVMEDIA_TYPE_VIDEO
+            && (parameters->codec_id == AV_CODEC_ID_NONE || parameters->codec_id == cached.codec_id)
+            && av_cmp_q(stream->time_base, cached.time_base) == 0;
+    }
+    if (!is_valid)
+    {
+        DANEJOE_CLOG(DEBUG, IO, "StreamInfoCache", "Stale entry for {}", identity.key);
+        m_entries.erase(it);
+        m_stats.invalidations++;
+        m_stats.misses++;
+        return false;
+    }
+
+    for (const StreamEntry& cached : entry.streams)
+    {
+        AVStream* stream = format_context->streams[cached.index];
+        AVCodecParameters* parameters = stream->codecpar;
+        parameters->codec_id = static_cast<AVCodecID>(cached.codec_id);
+        parameters->codec_tag = cached.codec_tag;
+        parameters->format = cached.format;
+        parameters->width = cached.width;
+        parameters->height = cached.height;
+        parameters->profile = cached.profile;
+        parameters->level = cached.level;
+        parameters->sample_aspect_ratio = cached.sample_aspect_ratio;
+        parameters->bit_rate = cached.bit_rate;
+        parameters->video_delay = cached.video_delay;
+        parameters->field_order = static_cast<AVFieldOrder>(cached.field_order);
+        parameters->color_range = static_cast<AVColorRange>(cached.color_range);
+        parameters->color_primaries = static_cast<AVColorPrimaries>(cached.color_primaries);
+        parameters->color_trc = static_cast<AVColorTransferCharacteristic>(cached.color_trc);
+        parameters->color_space = static_cast<AVColorSpace>(cached.color_space);
+        parameters->chroma_location = static_cast<AVChromaLocation>(cached.chroma_location);
+        // 容器头已有附加数据时保留原值，只补齐探测阶段才能得到的（如裸流的参数集）
+        if (parameters->extradata_size == 0 && !cached.extradata.empty())
+        {
+            auto* extradata = static_cast<uint8_t*>(av_mallocz(cached.extradata.size() + AV_INPUT_BUFFER_PADDING_SIZE));
+            if (extradata)
+            {
+                std::copy(cached.extradata.begin(), cached.extradata.end(), extradata);
+                parameters->extradata = extradata;
+                parameters->extradata_size = static_cast<int>(cached.extradata.size());
+            }
+        }
+        stream->sample_aspect_ratio = cached.sample_aspect_ratio;
+        stream->avg_frame_rate = cached.avg_frame_rate;
+        stream->r_frame_rate = cached.r_frame_rate;
+        stream->start_time = cached.start_time;
+        stream->duration = cached.duration;
+        stream->nb_frames = cached.nb_frames;
+    }
+    format_context->start_time = entry.start_time;
+    format_context->duration = entry.duration;
+    format_context->bit_rate = entry.bit_rate;
+    entry.last_used = ++m_sequence;
+    m_stats.hits++;
+    return true;
+}
+
+void StreamInfoCache::store(const std::string& file_path, const AVFormatContext* format_context)
+{
+    if (!format_context)
+    {
+        return;
+    }
+    FileIdentity identity;
+    if (!get_file_identity(file_path, identity))
+    {
+        return;
+    }
+    Entry entry;
+    entry.file_size = identity.file_size;
+    entry.modify_time_ns = identity.modify_time_ns;
+    entry.stream_count = format_context->nb_streams;
+    entry.start_time = format_context->start_time;
+    entry.duration = format_context->duration;
+    entry.bit_rate = format_context->bit_rate;
+    for (unsigned int i = 0; i < format_context->nb_streams; i++)
+    {
+        const AVStream* stream = format_context->streams[i];
+        const AVCodecParameters* parameters = stream->codecpar;
+        if (parameters->codec_type != AVMEDIA_TYPE_VIDEO)
+        {
+            continue;
+        }
+        StreamEntry cached;
+        cached.index = static_cast<int>(i);
+        cached.codec_id = parameters->codec_id;
+        cached.codec_tag = parameters->codec_tag;
+        cached.format = parameters->format;
+        cached.width = parameters->width;
+        cached.height = parameters->height;
+        cached.profile = parameters->profile;
+        cached.level = parameters->level;
+        cached.sample_aspect_ratio = parameters->sample_aspect_ratio;
+        cached.bit_rate = parameters->bit_rate;
+        cached.video_delay = parameters->video_delay;
+        cached.field_order = parameters->field_order;
+        cached.color_range = parameters->color_range;
+        cached.color_primaries = parameters->color_primaries;
+        cached.color_trc = parameters->color_trc;
+        cached.color_space = parameters->color_space;
+        cached.chroma_location = parameters->chroma_location;
+        cached.time_base = stream->time_base;
+        cached.avg_frame_rate = stream->avg_frame_rate;
+        cached.r_frame_rate = stream->r_frame_rate;
+        cached.start_time = stream->start_time;
+        cached.duration = stream->duration;
+        cached.nb_frames = stream->nb_frames;
+        if (parameters->extradata && parameters->extradata_size > 0)
+        {
+            cached.extradata.assign(parameters->extradata, parameters->extradata + parameters->extradata_size);
+        }
+        entry.streams.push_back(std::move(cached));
+    }
+    if (entry.streams.empty())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ensure_loaded();
+    entry.last_used = ++m_sequence;
+    m_entries[identity.key] = std::move(entry);
+    while (m_entries.size() > MAX_ENTRIES)
+    {
+        auto oldest = std::min_element(m_entries.begin(), m_entries.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.second.last_used < rhs.second.last_used; });
+        m_entries.erase(oldest);
+    }
+    m_stats.stores++;
+    // 只标记待写盘，由后台线程延迟合并写盘，打开文件的线程不做磁盘写入
+    if (m_path.empty())
+    {
+        return;
+    }
+    m_is_dirty = true;
+    if (!m_saver.joinable())
+    {
+        m_saver = std::jthread(&StreamInfoCache::run_saver, this);
+    }
+    m_save_condition.notify_one();
+}
+
+void StreamInfoCache::clear()
+{
+    std::lock_guard<std::mutex> save_lock(m_save_mutex);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_is_loaded = true;
+    m_is_dirty = false;
+    if (!m_path.empty())
+    {
+        std::error_code error_code;
+        std::filesystem::remove(m_path, error_code);
+    }
+}
+
+StreamInfoCache::Stats StreamInfoCache::get_stats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void StreamInfoCache::ensure_loaded()
+{
+    if (m_is_loaded)
+    {
+        return;
+    }
+    m_is_loaded = true;
+    if (m_path.empty())
+    {
+        return;
+    }
+    std::ifstream file(m_path);
+    if (!file)
+    {
+        return;
+    }
+    std::string line;
+    std::string magic;
+    int version = 0;
+    if (!std::getline(file, line) || !(std::istringstream(line) >> magic >> version) || magic != CACHE_MAGIC || version != CACHE_VERSION)
+    {
+        DANEJOE_CLOG(WARN, IO, "StreamInfoCache", "Ignoring incompatible cache file {}", m_path);
+        return;
+    }
+    // 每个文件一行 file 记录，后跟 stream_count 行 stream 记录
+    Entry* current = nullptr;
+    std::size_t remaining_streams = 0;
+    while (std::getline(file, line))
+    {
+        std::istringstream stream(line);
+        std::string tag;
+        stream >> tag;
+        if (tag == "file")
+        {
+            Entry entry;
+            std::size_t stream_records = 0;
+            std::string key;
+            stream >> entry.file_size >> entry.modify_time_ns >> entry.stream_count
+                >> entry.start_time >> entry.duration >> entry.bit_rate >> stream_records;
+            if (!stream || !std::getline(stream >> std::ws, key) || key.empty())
+            {
+                current = nullptr;
+                continue;
+            }
+            entry.last_used = ++m_sequence;
+            current = &(m_entries[key] = std::move(entry));
+            remaining_streams = stream_records;
+        }
+        else if (tag == "stream" && current && remaining_streams > 0)
+        {
+            StreamEntry cached;
+            std::string extradata;
+            stream >> cached.index >> cached.codec_id >> cached.codec_tag >> cached.format
+                >> cached.width >> cached.height >> cached.profile >> cached.level
+                >> cached.sample_aspect_ratio.num >> cached.sample_aspect_ratio.den
+                >> cached.bit_rate >> cached.video_delay >> cached.field_order
+                >> cached.color_range >> cached.color_primaries >> cached.color_trc
+                >> cached.color_space >> cached.chroma_location
+                >> cached.time_base.num >> cached.time_base.den
+                >> cached.avg_frame_rate.num >> cached.avg_frame_rate.den
+                >> cached.r_frame_rate.num >> cached.r_frame_rate.den
+                >> cached.start_time >> cached.duration >> cached.nb_frames >> extradata;
+            if (!stream || !from_hex(extradata, cached.extradata))
+            {
+                // 记录损坏时整条作废，apply 会因流数量为空而未命中
+                current->streams.clear();
+                current = nullptr;
+                continue;
+            }
+            current->streams.push_back(std::move(cached));
+            remaining_streams--;
+        }
+    }
+    std::erase_if(m_entries, [](const auto& item) { return item.second.streams.empty(); });
+    DANEJOE_CLOG(DEBUG, IO, "StreamInfoCache", "Loaded {} entries from {}", m_entries.size(), m_path);
+}
+
+void StreamInfoCache::flush()
+{
+    // 写盘期间持有 m_save_mutex，clear 与 set_path 不会被之后完成的写盘覆盖
+    std::lock_guard<std::mutex> save_lock(m_save_mutex);
+    std::string cache_path;
+    std::map<std::string, Entry> entries;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_is_dirty || m_path.empty())
+        {
+            return;
+        }
+        m_is_dirty = false;
+        cache_path = m_path;
+        entries = m_entries;
+    }
+    std::filesystem::path path(cache_path);
+    std::error_code error_code;
+    if (path.has_parent_path())
+    {
+        std::filesystem::create_directories(path.parent_path(), error_code);
+    }
+    // 临时文件名带进程号与随机后缀，多个进程同时写盘时互不覆盖
+    std::random_device random_device;
+    std::ostringstream suffix;
+    suffix << "." << getpid() << "." << std::hex << random_device() << random_device() << ".tmp";
+    std::filesystem::path temp_path = path;
+    temp_path += suffix.str();
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        if (!file)
+        {
+            DANEJOE_CLOG(WARN, IO, "StreamInfoCache", "Failed to write {}", temp_path.string());
+            return;
+        }
+        file << CACHE_MAGIC << " " << CACHE_VERSION << "\n";
+        for (const auto& [key, entry] : entries)
+        {
+            file << "file " << entry.file_size << " " << entry.modify_time_ns << " " << entry.stream_count
+                << " " << entry.start_time << " " << entry.duration << " " << entry.bit_rate
+                << " " << entry.streams.size() << " " << key << "\n";
+            for (const StreamEntry& cached : entry.streams)
+            {
+                file << "stream " << cached.index << " " << cached.codec_id << " " << cached.codec_tag << " " << cached.format
+                    << " " << cached.width << " " << cached.height << " " << cached.profile << " " << cached.level
+                    << " " << cached.sample_aspect_ratio.num << " " << cached.sample_aspect_ratio.den
+                    << " " << cached.bit_rate << " " << cached.video_delay << " " << cached.field_order
+                    << " " << cached.color_range << " " << cached.color_primaries << " " << cached.color_trc
+                    << " " << cached.color_space << " " << cached.chroma_location
+                    << " " << cached.time_base.num << " " << cached.time_base.den
+                    << " " << cached.avg_frame_rate.num << " " << cached.avg_frame_rate.den
+                    << " " << cached.r_frame_rate.num << " " << cached.r_frame_rate.den
+                    << " " << cached.start_time << " " << cached.duration << " " << cached.nb_frames
+                    << " " << to_hex(cached.extradata) << "\n";
+            }
+        }
+        if (!file.flush())
+        {
+            DANEJOE_CLOG(WARN, IO, "StreamInfoCache", "Failed to write {}", temp_path.string());
+            file.close();
+            std::filesystem::remove(temp_path, error_code);
+            return;
+        }
+    }
+    // 改名是原子的，进程中途退出不会留下半个缓存文件
+    std::filesystem::rename(temp_path, path, error_code);
+    if (error_code)
+    {
+        DANEJOE_CLOG(WARN, IO, "StreamInfoCache", "Failed to replace {}: {}", cache_path, error_code.message());
+        std::filesystem::remove(temp_path, error_code);
+    }
+}
+
+void StreamInfoCache::run_saver()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_save_condition.wait(lock, [this]() { return m_is_stopping || m_is_dirty; });
+        if (m_is_stopping)
+        {
+            return;
+        }
+        // 批量打开文件时 store 连续发生，延迟一段时间合并成一次写盘
+        if (m_save_condition.wait_for(lock, SAVE_DELAY, [this]() { return m_is_stopping; }))
+        {
+            return;
+        }
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
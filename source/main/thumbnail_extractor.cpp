@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libswscale/swscale.h>
+}
+
+#include "main/thumbnail_extractor.hpp"
+#include "main/batch_processor.hpp"
+#include "main/media_decoder.hpp"
+#include "codec/av_frame_ptr.hpp"
+#include "codec/av_frame_view.hpp"
+#include "codec/av_packet_ptr.hpp"
+#include "codec/av_codec_context_ptr.hpp"
+#include "util/util_image_scale.hpp"
+#include "util/util_log.hpp"
+
+namespace
+{
+    /// @brief 缩略图与预览条的像素格式（MJPEG 编码器要求全范围 YUV）
+    constexpr AVPixelFormat THUMBNAIL_FORMAT = AV_PIX_FMT_YUVJ420P;
+
+    /**
+     * @brief 缩小一帧到指定宽度（保持宽高比）
+     * @details 4:2:0 输入先逐级减半直到再减半会小于目标尺寸，剩余的非整数倍缩放交给 swscale，
+     *          swscale 此时只需处理很小的图像。其它格式直接由 swscale 完成转换与缩放。
+     */
+    AVFramePtr downscale_frame(const AVFrameView& frame, int thumbnail_width)
+    {
+        int target_width = std::max(2, thumbnail_width & ~1);
+        int target_height = std::max(2, static_cast<int>(static_cast<int64_t>(frame.size().y) * target_width / std::max(1, frame.size().x)) & ~1);
+        AVFramePtr thumbnail(target_width, target_height, THUMBNAIL_FORMAT);
+        if (!thumbnail.get())
+        {
+            return thumbnail;
+        }
+
+        std::array<const uint8_t*, 3> planes = { frame.data(0), frame.data(1), frame.data(2) };
+        std::array<int, 3> strides = { frame.linesize(0), frame.linesize(1), frame.linesize(2) };
+        int width = frame.size().x;
+        int height = frame.size().y;
+        AVPixelFormat format = frame.format();
+        std::array<std::vector<uint8_t>, 3> buffers;
+        bool is_420 = format == AV_PIX_FMT_YUV420P || format == AV_PIX_FMT_YUVJ420P;
+        while (is_420 && width / 2 >= target_width && height / 2 >= target_height)
+        {
+            // 宽高对齐到 4，保证减半后亮度与色度平面尺寸仍然匹配
+            width &= ~3;
+            height &= ~3;
+            for (int plane = 0; plane < 3; plane++)
+            {
+                int plane_width = plane == 0 ? width : width / 2;
+                int plane_height = plane == 0 ? height : height / 2;
+                std::vector<uint8_t> halved(static_cast<std::size_t>(plane_width / 2) * (plane_height / 2));
+                DaneJoe::halve_plane(planes[plane], strides[plane], plane_width, plane_height, halved.data(), plane_width / 2);
+                buffers[plane] = std::move(halved);
+                planes[plane] = buffers[plane].data();
+                strides[plane] = plane_width / 2;
+            }
+            width /= 2;
+            height /= 2;
+        }
+        SwsContext* sws_context = sws_getContext(width, height, format, target_width, target_height, THUMBNAIL_FORMAT, SWS_AREA, nullptr, nullptr, nullptr);
+        if (!sws_context)
+        {
+            thumbnail.reset();
+            return thumbnail;
+        }
+        sws_scale(sws_context, planes.data(), strides.data(), 0, height, thumbnail->data, thumbnail->linesize);
+        sws_freeContext(sws_context);
+        return thumbnail;
+    }
+
+    /**
+     * @brief 横向拼接缩略图
+     */
+    AVFramePtr compose_strip(std::vector<AVFramePtr>& thumbnails)
+    {
+        int tile_width = thumbnails.front()->width;
+        int tile_height = thumbnails.front()->height;
+        AVFramePtr strip(tile_width * static_cast<int>(thumbnails.size()), tile_height, THUMBNAIL_FORMAT);
+        if (!strip.get())
+        {
+            return strip;
+        }
+        for (std::size_t i = 0; i < thumbnails.size(); i++)
+        {
+            for (int plane = 0; plane < 3; plane++)
+            {
+                int shift = plane == 0 ? 0 : 1;
+                int row_bytes = tile_width >> shift;
+                uint8_t* target = strip->data[plane] + i * row_bytes;
+                const uint8_t* source = thumbnails[i]->data[plane];
+                for (int y = 0; y < (tile_height >> shift); y++)
+                {
+                    std::memcpy(target + y * strip->linesize[plane], source + y * thumbnails[i]->linesize[plane], row_bytes);
+                }
+            }
+        }
+        return strip;
+    }
+
+    /**
+     * @brief 以 MJPEG 编码一帧并写入文件
+     */
+    AVError write_jpeg(AVFramePtr& frame, const std::string& output_path)
+    {
+        const AVCodec* encoder = avcodec_find_encoder(AV_CODEC_ID_MJPEG);
+        AVCodecContextPtr codec_context;
+        codec_context.alloc_context3(encoder);
+        if (!encoder || !codec_context)
+        {
+            return AVError(AVERROR_ENCODER_NOT_FOUND);
+        }
+        codec_context->width = frame->width;
+        codec_context->height = frame->height;
+        codec_context->pix_fmt = THUMBNAIL_FORMAT;
+        codec_context->time_base = AVRational{ 1, 25 };
+        codec_context->thread_count = 1;
+        AVError error = codec_context.open2(encoder, nullptr);
+        AVPacketPtr packet;
+        if (error.ok())
+        {
+            error = packet.ensure_allocated();
+        }
+        if (error.ok())
+        {
+            frame->pts = 0;
+            error = codec_context.send_frame(frame);
+        }
+        if (error.ok())
+        {
+            codec_context.send_frame(nullptr);
+            error = codec_context.receive_packet(packet);
+        }
+        if (error.failed())
+        {
+            return error;
+        }
+        std::ofstream output(output_path, std::ios::binary);
+        output.write(reinterpret_cast<const char*>(packet->data), packet->size);
+        return output ? AVError(0) : AVError(AVERROR(EIO));
+    }
+}
+
+ThumbnailExtractor::ThumbnailExtractor(DaneJoe::TaskScheduler& scheduler, const Options& options) :
+    m_scheduler(scheduler), m_options(options)
+{}
+
+std::vector<ThumbnailExtractor::Result> ThumbnailExtractor::run(const std::vector<std::string>& file_paths)
+{
+    std::vector<Result> results(file_paths.size());
+    DaneJoe::TaskGroup group;
+    for (std::size_t index = 0; index < file_paths.size(); index++)
+    {
+        m_scheduler.submit(group, [this, &group, &results, &file_paths, index]()
+            {
+                Result& result = results[index];
+                result.file_path = file_paths[index];
+                std::error_code error_code;
+                auto file_size = std::filesystem::file_size(result.file_path, error_code);
+                result.file_size = error_code ? 0 : static_cast<int64_t>(file_size);
+
+                MediaDecoder decoder;
+                MediaDecoder::Options decoder_options;
+                decoder_options.thread_count = 1;
+                decoder_options.skip_frame = AVDISCARD_NONKEY;
+                result.error = decoder.open(result.file_path, decoder_options);
+                if (result.error.failed())
+                {
+                    return;
+                }
+                int sample_count = std::max(1, m_options.sample_count);
+                int64_t duration_ms = decoder.duration_ms();
+                std::vector<AVFramePtr> thumbnails;
+                for (int i = 0; i < sample_count; i++)
+                {
+                    // 采样点取各等分区间的中点；时长未知时只取第一个关键帧
+                    int64_t timestamp_ms = duration_ms * (2 * i + 1) / (2 * sample_count);
+                    if (duration_ms <= 0 && i > 0)
+                    {
+                        break;
+                    }
+                    if (timestamp_ms > 0 && decoder.seek(timestamp_ms).failed())
+                    {
+                        break;
+                    }
+                    AVFrameView frame_view;
+                    if (decoder.decode_frame(frame_view).failed())
+                    {
+                        break;
+                    }
+                    AVFramePtr thumbnail = downscale_frame(frame_view, m_options.thumbnail_width);
+                    if (thumbnail.get())
+                    {
+                        thumbnails.push_back(std::move(thumbnail));
+                    }
+                }
+                result.bytes_read = decoder.bytes_read();
+                decoder.close();
+                if (thumbnails.empty())
+                {
+                    result.error = AVError(AVERROR_INVALIDDATA);
+                    return;
+                }
+                std::ostringstream name;
+                name << std::setw(4) << std::setfill('0') << index << "_" << std::filesystem::path(result.file_path).stem().string() << ".jpg";
+                result.output_path = (std::filesystem::path(m_options.output_directory) / name.str()).string();
+                // 拼接与编码交给其它空闲线程，当前线程继续处理下一个文件
+                m_scheduler.submit(group, [&result, thumbnails = std::move(thumbnails)]() mutable
+                    {
+                        AVFramePtr strip = compose_strip(thumbnails);
+                        result.error = strip.get() ? write_jpeg(strip, result.output_path) : AVError(AVERROR(ENOMEM));
+                        result.thumbnails = result.error.ok() ? static_cast<int>(thumbnails.size()) : 0;
+                    }, DaneJoe::TaskPriority::HIGH);
+            }, DaneJoe::TaskPriority::LOW);
+    }
+    m_scheduler.wait(group);
+    return results;
+}
+
+int run_thumbnail_batch(const std::vector<std::string>& inputs, const ThumbnailExtractor::Options& options, std::size_t worker_count)
+{
+    std::vector<std::string> file_paths = collect_media_files(inputs);
+    if (file_paths.empty())
+    {
+        DANEJOE_CLOG(ERROR, APP, "Thumbnail", "No input files");
+        return -1;
+    }
+    std::error_code error_code;
+    std::filesystem::create_directories(options.output_directory, error_code);
+
+    // 未指定线程数时使用进程共享的调度器，与解码器的分片任务共用同一组线程
+    std::unique_ptr<DaneJoe::TaskScheduler> own_scheduler;
+    if (worker_count > 0)
+    {
+        own_scheduler = std::make_unique<DaneJoe::TaskScheduler>(worker_count);
+    }
+    DaneJoe::TaskScheduler& scheduler = own_scheduler ? *own_scheduler : DaneJoe::TaskScheduler::get_instance();
+    ThumbnailExtractor extractor(scheduler, options);
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<ThumbnailExtractor::Result> results = extractor.run(file_paths);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::size_t succeeded = 0;
+    int64_t thumbnails = 0;
+    int64_t bytes_read = 0;
+    int64_t file_bytes = 0;
+    for (const auto& result : results)
+    {
+        if (result.error.failed())
+        {
+            std::cout << "failed " << result.file_path << ": " << result.error.message() << "\n";
+            continue;
+        }
+        succeeded++;
+        thumbnails += result.thumbnails;
+        bytes_read += result.bytes_read;
+        file_bytes += result.file_size;
+    }
+    std::cout << std::fixed << std::setprecision(2)
+        << "files: " << succeeded << "/" << file_paths.size()
+        << ", thumbnails: " << thumbnails
+        << ", workers: " << scheduler.worker_count()
+        << ", seconds: " << seconds << "\n"
+        << "files/s: " << (seconds > 0. ? succeeded / seconds : 0.)
+        << ", thumbnails/s: " << (seconds > 0. ? thumbnails / seconds : 0.) << "\n"
+        << "KiB read per thumbnail: " << (thumbnails > 0 ? bytes_read / 1024. / thumbnails : 0.)
+        << ", read " << (file_bytes > 0 ? bytes_read * 100. / file_bytes : 0.) << "% of input bytes\n";
+    return succeeded == file_paths.size() ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if __has_include(<sys/resource.h>)
+#include <sys/resource.h>
+#define DANEJOE_HAS_RUSAGE 1
+#endif
+
+#include "main/timer_benchmark.hpp"
+#include "util/util_precise_timer.hpp"
+#include "util/util_log.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @struct ThreadUsage
+     * @brief 调用线程的 CPU 时间与主动上下文切换次数
+     */
+    struct ThreadUsage
+    {
+        double cpu_seconds = 0.;
+        int64_t voluntary_switches = 0;
+    };
+
+    ThreadUsage sample_thread_usage()
+    {
+        ThreadUsage usage;
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+        timespec cpu_time;
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_time) == 0)
+        {
+            usage.cpu_seconds = cpu_time.tv_sec + cpu_time.tv_nsec / 1e9;
+        }
+#endif
+#if defined(DANEJOE_HAS_RUSAGE) && defined(RUSAGE_THREAD)
+        rusage thread_usage;
+        if (getrusage(RUSAGE_THREAD, &thread_usage) == 0)
+        {
+            usage.voluntary_switches = thread_usage.ru_nvcsw;
+        }
+#endif
+        return usage;
+    }
+
+    /**
+     * @brief 原先 SDLVideoWidget::sleep 的等待方式：每毫秒醒来检查一次
+     */
+    void legacy_sleep_until(Clock::time_point deadline)
+    {
+        do
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        } while (Clock::now() < deadline);
+    }
+
+    /**
+     * @struct TimerResult
+     * @brief 一种等待方式的测量结果
+     */
+    struct TimerResult
+    {
+        std::string name;
+        /// @brief 唤醒误差（微秒，实际唤醒时间 - 截止时间），已排序
+        std::vector<double> errors_us;
+        double cpu_percent = 0.;
+        double switches_per_wait = 0.;
+
+        double percentile(double ratio)const
+        {
+            if (errors_us.empty())
+            {
+                return 0.;
+            }
+            std::size_t index = static_cast<std::size_t>(ratio * (errors_us.size() - 1) + 0.5);
+            return errors_us[std::min(index, errors_us.size() - 1)];
+        }
+    };
+
+    TimerResult measure(const std::string& name, const std::function<void(Clock::time_point)>& sleep_until, int count, std::chrono::microseconds period)
+    {
+        TimerResult result;
+        result.name = name;
+        result.errors_us.reserve(count);
+        ThreadUsage usage_before = sample_thread_usage();
+        Clock::time_point begin = Clock::now();
+        Clock::time_point deadline = begin;
+        for (int i = 0; i < count; i++)
+        {
+            deadline += period;
+            sleep_until(deadline);
+            Clock::time_point wake = Clock::now();
+            result.errors_us.push_back(std::chrono::duration<double, std::micro>(wake - deadline).count());
+            // 唤醒过晚时从当前时间重新排期，避免后续截止时间已过期而不等待
+            if (wake - deadline > period)
+            {
+                deadline = wake;
+            }
+        }
+        double wall_seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        ThreadUsage usage_after = sample_thread_usage();
+        result.cpu_percent = wall_seconds > 0. ? (usage_after.cpu_seconds - usage_before.cpu_seconds) / wall_seconds * 100. : 0.;
+        result.switches_per_wait = count > 0 ? static_cast<double>(usage_after.voluntary_switches - usage_before.voluntary_switches) / count : 0.;
+        std::sort(result.errors_us.begin(), result.errors_us.end());
+        return result;
+    }
+}
+
+int run_timer_benchmark(int count, int period_us, int spin_us)
+{
+    if (count <= 0 || period_us <= 0 || spin_us < 0)
+    {
+        DANEJOE_CLOG(ERROR, APP, "TimerBench", "Usage: timer-bench [--count=1000] [--period=4000] [--spin=100]");
+        return -1;
+    }
+    std::chrono::microseconds period(period_us);
+    std::chrono::microseconds spin(spin_us);
+    std::vector<TimerResult> results;
+    results.push_back(measure("legacy sleep_for(1ms)", legacy_sleep_until, count, period));
+    for (DaneJoe::PreciseTimer::Backend backend : { DaneJoe::PreciseTimer::Backend::SLEEP_UNTIL, DaneJoe::PreciseTimer::Backend::ABSOLUTE_NANOSLEEP, DaneJoe::PreciseTimer::Backend::TIMERFD })
+    {
+        if (!DaneJoe::PreciseTimer::is_supported(backend))
+        {
+            continue;
+        }
+        std::vector<std::chrono::microseconds> spins = { std::chrono::microseconds(0) };
+        if (spin.count() > 0)
+        {
+            spins.push_back(spin);
+        }
+        for (std::chrono::microseconds backend_spin : spins)
+        {
+            DaneJoe::PreciseTimer::Options options;
+            options.backend = backend;
+            options.spin = backend_spin;
+            DaneJoe::PreciseTimer timer(options);
+            std::string name = DaneJoe::PreciseTimer::backend_name(backend);
+            if (backend_spin.count() > 0)
+            {
+                name += " + spin " + std::to_string(backend_spin.count()) + "us";
+            }
+            results.push_back(measure(name, [&timer](Clock::time_point deadline) { timer.sleep_until(deadline); }, count, period));
+        }
+    }
+    std::cout << "waits: " << count << ", period: " << period_us << " us\n";
+    std::cout << std::setw(28) << "timer" << std::setw(10) << "p50 us" << std::setw(10) << "p90 us" << std::setw(10) << "p99 us"
+        << std::setw(10) << "p99.9 us" << std::setw(10) << "max us" << std::setw(8) << "cpu%" << std::setw(12) << "wakes/wait" << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    for (const TimerResult& result : results)
+    {
+        std::cout << std::setw(28) << result.name
+            << std::setw(10) << result.percentile(0.5)
+            << std::setw(10) << result.percentile(0.9)
+            << std::setw(10) << result.percentile(0.99)
+            << std::setw(10) << result.percentile(0.999)
+            << std::setw(10) << (result.errors_us.empty() ? 0. : result.errors_us.back())
+            << std::setw(8) << result.cpu_percent
+            << std::setw(12) << result.switches_per_wait
+            << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,661 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+extern "C"
+{
+#include <libavutil/pixdesc.h>
+}
+
+#include "main/transcoder.hpp"
+#include "main/batch_processor.hpp"
+#include "codec/av_video_filter.hpp"
+#include "util/util_log.hpp"
+#include "util/util_trace_recorder.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    /// @brief 阶段下标
+    constexpr std::size_t DECODE_STAGE = 0;
+    constexpr std::size_t FILTER_STAGE = 1;
+    constexpr std::size_t ENCODE_STAGE = 2;
+    constexpr std::size_t MUX_STAGE = 3;
+
+    /**
+     * @brief 编码器支持的像素格式（为空表示未声明限制）
+     */
+    std::vector<AVPixelFormat> supported_pixel_formats(const AVCodec* codec)
+    {
+        std::vector<AVPixelFormat> formats;
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(61, 13, 100)
+        const void* configs = nullptr;
+        int count = 0;
+        if (avcodec_get_supported_config(nullptr, codec, AV_CODEC_CONFIG_PIX_FORMAT, 0, &configs, &count) >= 0 && configs)
+        {
+            const AVPixelFormat* list = static_cast<const AVPixelFormat*>(configs);
+            formats.assign(list, list + count);
+        }
+#else
+        for (const AVPixelFormat* list = codec->pix_fmts; list && *list != AV_PIX_FMT_NONE; list++)
+        {
+            formats.push_back(*list);
+        }
+#endif
+        return formats;
+    }
+
+    double to_ms(Clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
+double Transcoder::StageStats::utilization(double wall_ms)const
+{
+    return wall_ms > 0. && lanes > 0 ? busy_ms / (wall_ms * lanes) : 0.;
+}
+
+double Transcoder::Report::fps()const
+{
+    return wall_ms > 0. ? frames * 1000. / wall_ms : 0.;
+}
+
+Transcoder::Transcoder(std::string input_path, std::string output_path, const Options& options) :
+    m_input_path(std::move(input_path)), m_output_path(std::move(output_path)), m_options(options)
+{
+    m_options.encoder_workers = std::max<std::size_t>(m_options.encoder_workers, 1);
+    m_options.segment_frames = std::max<std::size_t>(m_options.segment_frames, 1);
+}
+
+Transcoder::~Transcoder()
+{
+    if (m_stream_parameters)
+    {
+        avcodec_parameters_free(&m_stream_parameters);
+    }
+    if (m_output)
+    {
+        if (!(m_output->oformat->flags & AVFMT_NOFILE))
+        {
+            avio_closep(&m_output->pb);
+        }
+        avformat_free_context(m_output);
+        m_output = nullptr;
+    }
+}
+
+const Transcoder::Report& Transcoder::get_report()const
+{
+    return m_report;
+}
+
+void Transcoder::add_busy(std::size_t stage, Clock::duration duration)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_busy[stage] += duration;
+}
+
+void Transcoder::abort(AVError error)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_is_aborted)
+        {
+            return;
+        }
+        m_is_aborted = true;
+        m_error = error;
+    }
+    DANEJOE_CLOG(ERROR, DECODE, "Transcoder", "Transcoding {} failed: {}", m_input_path, error.message());
+    m_mux_condition.notify_all();
+    if (m_decoded_queue)
+    {
+        m_decoded_queue->close();
+    }
+    for (auto& queue : m_encode_queues)
+    {
+        queue->close();
+    }
+}
+
+AVError Transcoder::prepare()
+{
+    AVError error = m_decoder.open(m_input_path, m_options.decoder_options);
+    if (error.failed())
+    {
+        return error;
+    }
+    m_codec = avcodec_find_encoder_by_name(m_options.codec_name.c_str());
+    if (!m_codec || m_codec->type != AVMEDIA_TYPE_VIDEO)
+    {
+        DANEJOE_CLOG(ERROR, DECODE, "Transcoder", "Video encoder {} not found", m_options.codec_name);
+        return AVError(AVERROR_ENCODER_NOT_FOUND);
+    }
+    // 编码时间基取帧率的倒数，分母不超过 65535（MPEG-4 的限制）
+    if (m_decoder.frame_rate() > 0.)
+    {
+        m_frame_rate = av_d2q(m_decoder.frame_rate(), 65535);
+        m_encoder_time_base = av_inv_q(m_frame_rate);
+    }
+    // 编码器不接受解码输出的像素格式时在滤镜末尾转换；格式已受支持时 format 滤镜直接透传
+    std::vector<AVPixelFormat> formats = supported_pixel_formats(m_codec);
+    AVPixelFormat decoded_format = m_decoder.codec_context()->pix_fmt;
+    bool is_format_supported = formats.empty() || std::find(formats.begin(), formats.end(), decoded_format) != formats.end();
+    m_filter_description = m_options.filter_description;
+    if (!formats.empty() && (!m_filter_description.empty() || !is_format_supported))
+    {
+        std::string format_filter = "format=pix_fmts=";
+        for (std::size_t i = 0; i < formats.size(); i++)
+        {
+            format_filter += (i > 0 ? "|" : "") + std::string(av_get_pix_fmt_name(formats[i]));
+        }
+        m_filter_description += (m_filter_description.empty() ? "" : ",") + format_filter;
+    }
+    error = avformat_alloc_output_context2(&m_output, nullptr, nullptr, m_output_path.c_str());
+    if (error.failed() || !m_output)
+    {
+        DANEJOE_CLOG(ERROR, DECODE, "Transcoder", "Unknown output format for {}", m_output_path);
+        return error.failed() ? error : AVError(AVERROR(EINVAL));
+    }
+    if (!(m_output->oformat->flags & AVFMT_NOFILE))
+    {
+        error = avio_open(&m_output->pb, m_output_path.c_str(), AVIO_FLAG_WRITE);
+        if (error.failed())
+        {
+            return error;
+        }
+    }
+    if (m_options.start_ms > 0)
+    {
+        error = m_decoder.seek(m_options.start_ms);
+        if (error.failed())
+        {
+            return error;
+        }
+    }
+    if (!m_filter_description.empty())
+    {
+        m_decoded_queue = std::make_unique<DaneJoe::BoundedQueue<AVFramePtr>>(m_options.queue_capacity);
+    }
+    // 并行编码时每个编码线程的队列要能容纳一整段，上游才能继续填充下一个编码线程
+    std::size_t encode_capacity = m_options.encoder_workers > 1 ? m_options.segment_frames + 1 : m_options.queue_capacity;
+    for (std::size_t i = 0; i < m_options.encoder_workers; i++)
+    {
+        m_encode_queues.push_back(std::make_unique<DaneJoe::BoundedQueue<EncodeItem>>(encode_capacity));
+    }
+    return AVError(0);
+}
+
+AVError Transcoder::run()
+{
+    Clock::time_point begin = Clock::now();
+    AVError error = prepare();
+    if (error.failed())
+    {
+        return error;
+    }
+    {
+        std::vector<std::jthread> threads;
+        auto start_stage = [this, &threads](auto stage)
+            {
+                threads.emplace_back([this, stage]()
+                    {
+                        AVError stage_error = stage();
+                        if (stage_error.failed())
+                        {
+                            abort(stage_error);
+                        }
+                    });
+            };
+        start_stage([this]() { return mux_stage(); });
+        for (std::size_t worker = 0; worker < m_options.encoder_workers; worker++)
+        {
+            start_stage([this, worker]() { return encode_stage(worker); });
+        }
+        if (m_decoded_queue)
+        {
+            start_stage([this]() { return filter_stage(); });
+        }
+        start_stage([this]() { return decode_stage(); });
+    }
+    m_report.wall_ms = to_ms(Clock::now() - begin);
+    m_report.frames = m_dispatched_frames;
+    m_report.stages.push_back(StageStats{ "decode", 1, to_ms(m_busy[DECODE_STAGE]) });
+    if (m_decoded_queue)
+    {
+        m_report.stages.push_back(StageStats{ "filter", 1, to_ms(m_busy[FILTER_STAGE]) });
+    }
+    m_report.stages.push_back(StageStats{ "encode", m_options.encoder_workers, to_ms(m_busy[ENCODE_STAGE]) });
+    m_report.stages.push_back(StageStats{ "mux", 1, to_ms(m_busy[MUX_STAGE]) });
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_error;
+}
+
+AVError Transcoder::decode_stage()
+{
+    DaneJoe::TraceRecorder::get_instance().set_thread_name("transcode_decode");
+    int64_t start_pts = m_decoder.start_pts() + av_rescale_q(m_options.start_ms, AVRational{ 1, 1000 }, m_decoder.time_base());
+    int64_t end_pts = m_options.duration_ms > 0 ? start_pts + av_rescale_q(m_options.duration_ms, AVRational{ 1, 1000 }, m_decoder.time_base()) : INT64_MAX;
+    while (true)
+    {
+        AVFramePtr frame;
+        Clock::time_point decode_begin = Clock::now();
+        AVError error = m_decoder.decode_frame(frame);
+        add_busy(DECODE_STAGE, Clock::now() - decode_begin);
+        if (error == AVERROR_EOF)
+        {
+            break;
+        }
+        if (error.failed())
+        {
+            return error;
+        }
+        int64_t pts = frame_pts(frame.get());
+        // 定位落在片段起点之前的关键帧，起点之前的帧只用于参考
+        if (pts != AV_NOPTS_VALUE && pts < start_pts)
+        {
+            continue;
+        }
+        if (pts != AV_NOPTS_VALUE && pts >= end_pts)
+        {
+            break;
+        }
+        bool is_pushed = m_decoded_queue ? m_decoded_queue->push(std::move(frame)) : dispatch(std::move(frame));
+        if (!is_pushed)
+        {
+            return AVError(0);
+        }
+    }
+    if (m_decoded_queue)
+    {
+        m_decoded_queue->finish();
+    }
+    else
+    {
+        finish_dispatch();
+    }
+    return AVError(0);
+}
+
+AVError Transcoder::filter_stage()
+{
+    DaneJoe::TraceRecorder::get_instance().set_thread_name("transcode_filter");
+    AVVideoFilter filter(AVVideoFilter::Options{ m_filter_description });
+    while (true)
+    {
+        std::optional<AVFramePtr> frame = m_decoded_queue->pop();
+        if (!frame && m_decoded_queue->is_closed())
+        {
+            return AVError(0);
+        }
+        Clock::time_point filter_begin = Clock::now();
+        AVError error;
+        {
+            DANEJOE_TRACE_SCOPE(FILTER, "send_frame");
+            error = frame ? filter.send_frame(*frame) : filter.send_eof();
+        }
+        add_busy(FILTER_STAGE, Clock::now() - filter_begin);
+        if (error.failed())
+        {
+            return error;
+        }
+        while (true)
+        {
+            AVFramePtr filtered;
+            filter_begin = Clock::now();
+            {
+                DANEJOE_TRACE_SCOPE(FILTER, "receive_frame");
+                error = filter.receive_frame(filtered);
+            }
+            add_busy(FILTER_STAGE, Clock::now() - filter_begin);
+            if (error == AVERROR(EAGAIN) || error == AVERROR_EOF)
+            {
+                break;
+            }
+            if (error.failed())
+            {
+                return error;
+            }
+            if (!dispatch(std::move(filtered)))
+            {
+                return AVError(0);
+            }
+        }
+        if (!frame)
+        {
+            break;
+        }
+    }
+    finish_dispatch();
+    return AVError(0);
+}
+
+bool Transcoder::dispatch(AVFramePtr&& frame)
+{
+    // 解码器标记的帧类型会被编码器当作强制类型，交由编码器自行决定
+    frame->pict_type = AV_PICTURE_TYPE_NONE;
+    int64_t pts = frame_pts(frame.get());
+    int64_t encoder_pts = 0;
+    if (pts != AV_NOPTS_VALUE && frame->time_base.den != 0)
+    {
+        encoder_pts = av_rescale_q(pts, frame->time_base, m_encoder_time_base);
+        if (m_first_encoder_pts == AV_NOPTS_VALUE)
+        {
+            m_first_encoder_pts = encoder_pts;
+        }
+        encoder_pts -= m_first_encoder_pts;
+    }
+    // 可变帧率按帧率取整后可能重复，编码器要求严格递增
+    if (m_last_encoder_pts != AV_NOPTS_VALUE && encoder_pts <= m_last_encoder_pts)
+    {
+        encoder_pts = m_last_encoder_pts + 1;
+    }
+    m_last_encoder_pts = encoder_pts;
+    frame->pts = encoder_pts;
+    frame->time_base = m_encoder_time_base;
+    std::size_t workers = m_options.encoder_workers;
+    int64_t segment = workers > 1 ? static_cast<int64_t>(m_dispatched_frames / m_options.segment_frames) : 0;
+    if (workers > 1 && m_dispatched_frames > 0 && m_dispatched_frames % m_options.segment_frames == 0)
+    {
+        if (!m_encode_queues[(segment - 1) % workers]->push(EncodeItem{ AVFramePtr(), segment - 1, true }))
+        {
+            return false;
+        }
+    }
+    if (!m_encode_queues[segment % workers]->push(EncodeItem{ std::move(frame), segment, false }))
+    {
+        return false;
+    }
+    m_dispatched_frames++;
+    return true;
+}
+
+void Transcoder::finish_dispatch()
+{
+    std::size_t workers = m_options.encoder_workers;
+    int64_t segment_count = 0;
+    if (m_dispatched_frames > 0)
+    {
+        segment_count = workers > 1 ? static_cast<int64_t>((m_dispatched_frames - 1) / m_options.segment_frames + 1) : 1;
+        m_encode_queues[(segment_count - 1) % workers]->push(EncodeItem{ AVFramePtr(), segment_count - 1, true });
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_segment_count = segment_count;
+    }
+    m_mux_condition.notify_all();
+    for (auto& queue : m_encode_queues)
+    {
+        queue->finish();
+    }
+}
+
+AVError Transcoder::open_encoder(AVCodecContextPtr& encoder, const AVFramePtr& first_frame, int64_t segment)
+{
+    encoder.alloc_context3(m_codec);
+    if (!encoder)
+    {
+        return AVError(AVERROR(ENOMEM));
+    }
+    encoder->width = first_frame->width;
+    encoder->height = first_frame->height;
+    encoder->pix_fmt = static_cast<AVPixelFormat>(first_frame->format);
+    encoder->sample_aspect_ratio = first_frame->sample_aspect_ratio;
+    encoder->time_base = m_encoder_time_base;
+    encoder->framerate = m_frame_rate;
+    encoder->bit_rate = m_options.bit_rate;
+    encoder->thread_count = m_options.encoder_threads;
+    if (m_options.encoder_workers > 1)
+    {
+        // 各段独立编码：段内关键帧间隔不超过段长，不使用 B 帧，段之间的解码时间戳保持递增
+        encoder->gop_size = static_cast<int>(m_options.segment_frames);
+        encoder->max_b_frames = 0;
+    }
+    if (m_output->oformat->flags & AVFMT_GLOBALHEADER)
+    {
+        encoder->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+    AVError error = encoder.open2(m_codec, nullptr);
+    if (error.failed())
+    {
+        return error;
+    }
+    if (segment == 0)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stream_parameters = avcodec_parameters_alloc();
+        if (!m_stream_parameters)
+        {
+            return AVError(AVERROR(ENOMEM));
+        }
+        error = avcodec_parameters_from_context(m_stream_parameters, encoder.get());
+        if (error.failed())
+        {
+            return error;
+        }
+        m_mux_condition.notify_all();
+    }
+    return AVError(0);
+}
+
+AVError Transcoder::drain_encoder(AVCodecContextPtr& encoder, int64_t segment)
+{
+    while (true)
+    {
+        AVPacketPtr packet;
+        AVError error = packet.ensure_allocated();
+        if (error.failed())
+        {
+            return error;
+        }
+        error = encoder.receive_packet(packet);
+        if (error == AVERROR(EAGAIN) || error == AVERROR_EOF)
+        {
+            return AVError(0);
+        }
+        if (error.failed())
+        {
+            return error;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_segments[segment].packets.push_back(std::move(packet));
+        }
+        m_mux_condition.notify_all();
+    }
+}
+
+AVError Transcoder::encode_stage(std::size_t worker)
+{
+    DaneJoe::TraceRecorder::get_instance().set_thread_name("transcode_encode_" + std::to_string(worker));
+    DaneJoe::BoundedQueue<EncodeItem>& queue = *m_encode_queues[worker];
+    AVCodecContextPtr encoder;
+    int64_t segment = -1;
+    while (std::optional<EncodeItem> item = queue.pop())
+    {
+        Clock::time_point encode_begin = Clock::now();
+        AVError error;
+        if (item->is_segment_end)
+        {
+            if (encoder)
+            {
+                DANEJOE_TRACE_SCOPE_ARG(ENCODE, "flush", item->segment);
+                error = encoder.send_frame(static_cast<const AVFrame*>(nullptr));
+                if (error.ok())
+                {
+                    error = drain_encoder(encoder, item->segment);
+                }
+                encoder.reset();
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_segments[item->segment].is_complete = true;
+                m_busy[ENCODE_STAGE] += Clock::now() - encode_begin;
+            }
+            m_mux_condition.notify_all();
+            if (error.failed())
+            {
+                return error;
+            }
+            continue;
+        }
+        if (item->segment != segment)
+        {
+            segment = item->segment;
+            error = open_encoder(encoder, item->frame, segment);
+            if (error.failed())
+            {
+                return error;
+            }
+        }
+        {
+            DANEJOE_TRACE_SCOPE_ARG(ENCODE, "encode", item->frame->pts);
+            error = encoder.send_frame(item->frame);
+            if (error.ok())
+            {
+                error = drain_encoder(encoder, segment);
+            }
+        }
+        add_busy(ENCODE_STAGE, Clock::now() - encode_begin);
+        if (error.failed())
+        {
+            return error;
+        }
+    }
+    return AVError(0);
+}
+
+AVError Transcoder::mux_stage()
+{
+    DaneJoe::TraceRecorder::get_instance().set_thread_name("transcode_mux");
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_mux_condition.wait(lock, [this]() { return m_is_aborted || m_stream_parameters || m_segment_count == 0; });
+        if (m_is_aborted)
+        {
+            return AVError(0);
+        }
+        if (!m_stream_parameters)
+        {
+            DANEJOE_CLOG(ERROR, DECODE, "Transcoder", "No frames in the requested range of {}", m_input_path);
+            return AVError(AVERROR(EINVAL));
+        }
+    }
+    AVStream* stream = avformat_new_stream(m_output, nullptr);
+    if (!stream)
+    {
+        return AVError(AVERROR(ENOMEM));
+    }
+    AVError error = avcodec_parameters_copy(stream->codecpar, m_stream_parameters);
+    if (error.failed())
+    {
+        return error;
+    }
+    stream->time_base = m_encoder_time_base;
+    stream->avg_frame_rate = m_frame_rate;
+    Clock::time_point mux_begin = Clock::now();
+    error = avformat_write_header(m_output, nullptr);
+    add_busy(MUX_STAGE, Clock::now() - mux_begin);
+    if (error.failed())
+    {
+        return error;
+    }
+    // 按段的顺序写出，后面的段先编完时其数据包留在 m_segments 中等待
+    int64_t next_segment = 0;
+    while (true)
+    {
+        std::deque<AVPacketPtr> packets;
+        bool is_complete = false;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_mux_condition.wait(lock, [this, next_segment]()
+                {
+                    if (m_is_aborted || (m_segment_count >= 0 && next_segment >= m_segment_count))
+                    {
+                        return true;
+                    }
+                    auto iterator = m_segments.find(next_segment);
+                    return iterator != m_segments.end() && (!iterator->second.packets.empty() || iterator->second.is_complete);
+                });
+            if (m_is_aborted)
+            {
+                return AVError(0);
+            }
+            if (m_segment_count >= 0 && next_segment >= m_segment_count)
+            {
+                break;
+            }
+            auto iterator = m_segments.find(next_segment);
+            packets.swap(iterator->second.packets);
+            is_complete = iterator->second.is_complete;
+            if (is_complete)
+            {
+                m_segments.erase(iterator);
+            }
+        }
+        mux_begin = Clock::now();
+        for (AVPacketPtr& packet : packets)
+        {
+            DANEJOE_TRACE_SCOPE_ARG(MUX, "write_frame", next_segment);
+            packet->stream_index = stream->index;
+            av_packet_rescale_ts(packet.get(), m_encoder_time_base, stream->time_base);
+            m_report.output_bytes += packet->size;
+            m_report.packets++;
+            error = av_interleaved_write_frame(m_output, packet.get());
+            if (error.failed())
+            {
+                return error;
+            }
+        }
+        add_busy(MUX_STAGE, Clock::now() - mux_begin);
+        if (is_complete)
+        {
+            next_segment++;
+        }
+    }
+    mux_begin = Clock::now();
+    error = av_write_trailer(m_output);
+    add_busy(MUX_STAGE, Clock::now() - mux_begin);
+    m_report.segments = static_cast<uint64_t>(next_segment);
+    if (!(m_output->oformat->flags & AVFMT_NOFILE))
+    {
+        avio_closep(&m_output->pb);
+    }
+    return error;
+}
+
+int run_transcode(const std::vector<std::string>& inputs, const std::string& output_path, const Transcoder::Options& options)
+{
+    std::vector<std::string> file_paths = collect_media_files(inputs);
+    if (file_paths.empty() || output_path.empty())
+    {
+        DANEJOE_CLOG(ERROR, APP, "Transcode", "Usage: transcode <input> --output=<file> [--codec=mpeg4|ffv1] [--start=ms] [--duration=ms] [--vf=filters] [--workers=N]");
+        return -1;
+    }
+    const std::string& file_path = file_paths.front();
+    Transcoder transcoder(file_path, output_path, options);
+    AVError error = transcoder.run();
+    if (error.failed())
+    {
+        DANEJOE_CLOG(ERROR, APP, "Transcode", "Transcoding failed: {}", error.message());
+        return -1;
+    }
+    const Transcoder::Report& report = transcoder.get_report();
+    std::cout << "input: " << file_path << "\noutput: " << output_path << " (" << options.codec_name << ", "
+        << options.encoder_workers << " encoder workers, " << report.segments << " segments)\n";
+    std::cout << std::fixed << std::setprecision(1)
+        << "frames: " << report.frames << ", packets: " << report.packets
+        << ", bytes: " << report.output_bytes << ", wall: " << report.wall_ms << " ms, fps: " << report.fps() << "\n";
+    std::cout << std::setw(10) << "stage" << std::setw(8) << "lanes" << std::setw(12) << "busy ms" << std::setw(14) << "utilization" << "\n";
+    for (const Transcoder::StageStats& stage : report.stages)
+    {
+        std::cout << std::setw(10) << stage.name
+            << std::setw(8) << stage.lanes
+            << std::setw(12) << stage.busy_ms
+            << std::setw(13) << stage.utilization(report.wall_ms) * 100. << "%"
+            << "\n";
+    }
+    return 0;
+}
@@ -1,29 +1,44 @@
-#include "logger/logger_manager.hpp"
+#include "util/util_log.hpp"
 #include "renderer/i_frame_renderer.hpp"
 
 IFrameRenderer::IFrameRenderer() {}
 
 IFrameRenderer::~IFrameRenderer() {}
 
-void IFrameRenderer::Frame::init_info()
+bool IFrameRenderer::set_window_size(const DaneJoe::Size<int>& size)
 {
-    switch (fmt)
+    if (size.quadrant() != DaneJoe::Size<int>::Quadrant::FIRST)
     {
-    case FrameFmt::YUV420P:
-        pitch = size.x;break;
-    case FrameFmt::RGBA8888:
-        pitch = size.x * 4;
-        pixel_size = 4;
-        break;
-    case FrameFmt::RGB888:
-        pitch = size.x * 3;
-        pixel_size = 3;
-        break;
-    case FrameFmt::ARGB8888:
-        pitch = size.x * 4;
-        pixel_size = 4;
-        break;
-    default:
-        break;
+        DANEJOE_CLOG(ERROR, RENDER, "IFrameRenderer", "set_window_size failed:window size error");
+        return false;
     }
-}
\ No newline at end of file
+    publish_config([&](RenderConfig& config)
+        {
+            config.window_size = size;
+            config.viewport_pos = { 0,0 };
+            config.viewport_size = size;
+        });
+    return true;
+}
+
+double IFrameRenderer::refresh_rate()
+{
+    return 0.;
+}
+
+bool IFrameRenderer::is_vsync()
+{
+    return false;
+}
+
+IFrameRenderer::RenderConfig IFrameRenderer::get_config()
+{
+    std::lock_guard<std::mutex> lock(m_config_write_mutex);
+    return m_pending_config;
+}
+
+const IFrameRenderer::RenderConfig& IFrameRenderer::acquire_config()
+{
+    m_config.update();
+    return m_config.read();
+}
@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <cmath>
+
+#include "renderer/sdl_compositor_renderer.hpp"
+#include "util/util_log.hpp"
+#include "util/util_startup_metrics.hpp"
+#include "util/util_trace_recorder.hpp"
+
+SDLCompositorRenderer::SDLCompositorRenderer() {}
+
+SDLCompositorRenderer::~SDLCompositorRenderer()
+{
+    // 纹理必须先于渲染器释放
+    m_tiles.clear();
+    m_atlas.reset();
+    m_renderer.reset();
+}
+
+bool SDLCompositorRenderer::set_window(std::string window_name, DaneJoe::Size<int> window_size, void* window)
+{
+    SDL_Window* new_window = nullptr;
+    if (window == nullptr)
+    {
+        new_window = SDL_CreateWindow(window_name.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, window_size.x, window_size.y, SDL_WINDOW_SHOWN);
+    }
+    else
+    {
+        new_window = SDL_CreateWindowFrom(window);
+    }
+    if (!new_window)
+    {
+        DANEJOE_CLOG(ERROR, RENDER, "SDLCompositorRenderer", "SDL_CreateWindow failed:{}", SDL_GetError());
+        return false;
+    }
+    m_window.reset(new_window);
+    m_window_size = window_size;
+    return true;
+}
+
+bool SDLCompositorRenderer::init(std::size_t tile_count, bool is_vsync)
+{
+    if (!m_window)
+    {
+        DANEJOE_CLOG(ERROR, RENDER, "SDLCompositorRenderer", "window is null");
+        return false;
+    }
+    if (tile_count == 0)
+    {
+        DANEJOE_CLOG(ERROR, RENDER, "SDLCompositorRenderer", "tile count is zero");
+        return false;
+    }
+    Uint32 flags = SDL_RENDERER_ACCELERATED | (is_vsync ? SDL_RENDERER_PRESENTVSYNC : 0);
+    SDL_Renderer* renderer = SDL_CreateRenderer(m_window.get(), -1, flags);
+    if (!renderer)
+    {
+        DANEJOE_CLOG(WARN, RENDER, "SDLCompositorRenderer", "Failed to create renderer by hardware acceleration");
+        renderer = SDL_CreateRenderer(m_window.get(), -1, SDL_RENDERER_SOFTWARE);
+    }
+    if (!renderer)
+    {
+        DANEJOE_CLOG(ERROR, RENDER, "SDLCompositorRenderer", "SDL_CreateRenderer failed:{}", SDL_GetError());
+        return false;
+    }
+    m_renderer.reset(renderer);
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(m_renderer.get(), &info) == 0)
+    {
+        m_max_texture_size = { info.max_texture_width, info.max_texture_height };
+    }
+    m_tiles.clear();
+    m_tiles.resize(tile_count);
+    m_taken_frames.clear();
+    m_taken_frames.resize(tile_count);
+    m_columns = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(tile_count)))));
+    m_rows = static_cast<int>((tile_count + m_columns - 1) / m_columns);
+    m_atlas.reset();
+    m_tile_size = { 0,0 };
+    m_is_atlas_mode = true;
+    std::lock_guard<std::mutex> lock(m_tile_mutex);
+    m_pending_frames.clear();
+    m_pending_frames.resize(tile_count);
+    return true;
+}
+
+bool SDLCompositorRenderer::update_window_size(DaneJoe::Size<int> window_size)
+{
+    if (window_size.quadrant() != DaneJoe::Size<int>::Quadrant::FIRST)
+    {
+        DANEJOE_CLOG_RATE_LIMITED(ERROR, RENDER, "SDLCompositorRenderer", 1000, "update_window_size failed:window size error");
+        return false;
+    }
+    if (!m_window || m_window_size == window_size)
+    {
+        return m_window != nullptr;
+    }
+    m_window_size = window_size;
+    SDL_SetWindowSize(m_window.get(), window_size.x, window_size.y);
+    SDL_Rect viewport = { 0, 0, window_size.x, window_size.y };
+    SDL_RenderSetViewport(m_renderer.get(), &viewport);
+    return true;
+}
+
+bool SDLCompositorRenderer::submit(std::size_t tile_index, AVFrameView&& frame)
+{
+    if (!frame)
+    {
+        return false;
+    }
+    // 图集按 IYUV 组织，其它格式需在上游转换
+    if (frame.format() != AV_PIX_FMT_YUV420P && frame.format() != AV_PIX_FMT_YUVJ420P)
+    {
+        DANEJOE_CLOG_RATE_LIMITED(WARN, RENDER, "SDLCompositorRenderer", 1000, "unsupport format: {}", static_cast<int>(frame.format()));
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_tile_mutex);
+    if (tile_index >= m_pending_frames.size())
+    {
+        DANEJOE_CLOG_RATE_LIMITED(ERROR, RENDER, "SDLCompositorRenderer", 1000, "tile index {} out of range", tile_index);
+        return false;
+    }
+    std::optional<AVFrameView>& pending_frame = m_pending_frames[tile_index];
+    if (pending_frame.has_value())
+    {
+        m_stats.dropped_frames++;
+    }
+    pending_frame = std::move(frame);
+    return true;
+}
+
+bool SDLCompositorRenderer::ensure_atlas()
+{
+    // 分块尺寸取各路帧的最大值并对齐到偶数，保证色度平面的偏移合法
+    DaneJoe::Size<int> tile_size = m_tile_size;
+    for (const auto& tile : m_tiles)
+    {
+        if (tile.frame)
+        {
+            tile_size.x = std::max(tile_size.x, (tile.frame.size().x + 1) & ~1);
+            tile_size.y = std::max(tile_size.y, (tile.frame.size().y + 1) & ~1);
+        }
+    }
+    if (m_atlas && tile_size == m_tile_size)
+    {
+        return true;
+    }
+    if (tile_size.x <= 0 || tile_size.y <= 0)
+    {
+        // 尚未收到任何帧
+        return true;
+    }
+    DaneJoe::Size<int> atlas_size = { tile_size.x * m_columns, tile_size.y * m_rows };
+    if (m_max_texture_size.x > 0 && (atlas_size.x > m_max_texture_size.x || atlas_size.y > m_max_texture_size.y))
+    {
+        DANEJOE_CLOG(WARN, RENDER, "SDLCompositorRenderer", "Atlas {}x{} exceeds max texture size, using per-tile textures", atlas_size.x, atlas_size.y);
+        m_is_atlas_mode = false;
+        m_atlas.reset();
+        return true;
+    }
+    SDL_Texture* atlas = SDL_CreateTexture(m_renderer.get(), SDL_PIXELFORMAT_IYUV, SDL_TEXTUREACCESS_STREAMING, atlas_size.x, atlas_size.y);
+    if (!atlas)
+    {
+        DANEJOE_CLOG_RATE_LIMITED(ERROR, RENDER, "SDLCompositorRenderer", 1000, "create atlas failed: {}", SDL_GetError());
+        return false;
+    }
+    m_atlas.reset(atlas);
+    m_tile_size = tile_size;
+    m_render_stats.atlas_rebuilds++;
+    // 新图集内容未定义，所有已有帧需要重新上传
+    for (auto& tile : m_tiles)
+    {
+        tile.is_dirty = static_cast<bool>(tile.frame);
+    }
+    return true;
+}
+
+SDL_Rect SDLCompositorRenderer::atlas_rect(std::size_t tile_index, DaneJoe::Size<int> frame_size)const
+{
+    int column = static_cast<int>(tile_index) % m_columns;
+    int row = static_cast<int>(tile_index) / m_columns;
+    return SDL_Rect{ column * m_tile_size.x, row * m_tile_size.y, frame_size.x, frame_size.y };
+}
+
+SDL_Rect SDLCompositorRenderer::window_rect(std::size_t tile_index)const
+{
+    int column = static_cast<int>(tile_index) % m_columns;
+    int row = static_cast<int>(tile_index) / m_columns;
+    int cell_width = m_window_size.x / m_columns;
+    int cell_height = m_window_size.y / m_rows;
+    return SDL_Rect{ column * cell_width, row * cell_height, cell_width, cell_height };
+}
+
+bool SDLCompositorRenderer::upload_tile(std::size_t tile_index)
+{
+    Tile& tile = m_tiles[tile_index];
+    const AVFrameView& frame = tile.frame;
+    SDL_Texture* texture = m_atlas.get();
+    SDL_Rect rect = { 0, 0, frame.size().x, frame.size().y };
+    if (m_is_atlas_mode)
+    {
+        rect = atlas_rect(tile_index, frame.size());
+    }
+    else
+    {
+        if (!tile.texture || tile.texture_size != frame.size())
+        {
+            tile.texture.reset(SDL_CreateTexture(m_renderer.get(), SDL_PIXELFORMAT_IYUV, SDL_TEXTUREACCESS_STREAMING, frame.size().x, frame.size().y));
+            tile.texture_size = frame.size();
+        }
+        texture = tile.texture.get();
+    }
+    if (!texture)
+    {
+        return false;
+    }
+    // 局部更新：只写入该分块对应的区域
+    int ret = SDL_UpdateYUVTexture(texture, &rect,
+        frame.data(0), frame.linesize(0),
+        frame.data(1), frame.linesize(1),
+        frame.data(2), frame.linesize(2));
+    if (ret < 0)
+    {
+        DANEJOE_CLOG_RATE_LIMITED(ERROR, RENDER, "SDLCompositorRenderer", 1000, "UpdateYUVTexture failed: {}", SDL_GetError());
+        return false;
+    }
+    tile.is_dirty = false;
+    m_render_stats.tile_uploads++;
+    return true;
+}
+
+bool SDLCompositorRenderer::present()
+{
+    if (!m_renderer)
+    {
+        DANEJOE_CLOG_RATE_LIMITED(ERROR, RENDER, "SDLCompositorRenderer", 1000, "renderer is null");
+        return false;
+    }
+    // 锁内只交换待显示帧，纹理上传与提交不阻塞 submit
+    {
+        std::lock_guard<std::mutex> lock(m_tile_mutex);
+        m_pending_frames.swap(m_taken_frames);
+    }
+    for (std::size_t i = 0; i < m_tiles.size() && i < m_taken_frames.size(); i++)
+    {
+        if (m_taken_frames[i].has_value())
+        {
+            m_tiles[i].frame = std::move(*m_taken_frames[i]);
+            m_tiles[i].is_dirty = true;
+            m_taken_frames[i].reset();
+        }
+    }
+    if (m_is_atlas_mode && !ensure_atlas())
+    {
+        return false;
+    }
+    {
+        DANEJOE_TRACE_SCOPE(UPLOAD, "upload_tiles");
+        for (std::size_t i = 0; i < m_tiles.size(); i++)
+        {
+            if (m_tiles[i].is_dirty)
+            {
+                upload_tile(i);
+            }
+        }
+    }
+    DANEJOE_TRACE_SCOPE(PRESENT, "present");
+    SDL_RenderClear(m_renderer.get());
+    for (std::size_t i = 0; i < m_tiles.size(); i++)
+    {
+        const Tile& tile = m_tiles[i];
+        if (!tile.frame)
+        {
+            continue;
+        }
+        SDL_Rect dest_area = window_rect(i);
+        if (m_is_atlas_mode)
+        {
+            SDL_Rect src_area = atlas_rect(i, tile.frame.size());
+            SDL_RenderCopy(m_renderer.get(), m_atlas.get(), &src_area, &dest_area);
+        }
+        else if (tile.texture)
+        {
+            SDL_RenderCopy(m_renderer.get(), tile.texture.get(), nullptr, &dest_area);
+        }
+    }
+    // 所有分块合成完毕后只提交一次
+    SDL_RenderPresent(m_renderer.get());
+    m_render_stats.presents++;
+    DaneJoe::StartupMetrics::get_instance().mark(DaneJoe::StartupMetrics::Stage::FIRST_FRAME_PRESENTED);
+    std::lock_guard<std::mutex> lock(m_tile_mutex);
+    m_stats.presents = m_render_stats.presents;
+    m_stats.tile_uploads = m_render_stats.tile_uploads;
+    m_stats.atlas_rebuilds = m_render_stats.atlas_rebuilds;
+    return true;
+}
+
+std::size_t SDLCompositorRenderer::tile_count()const
+{
+    std::lock_guard<std::mutex> lock(m_tile_mutex);
+    return m_pending_frames.size();
+}
+
+SDLCompositorRenderer::Stats SDLCompositorRenderer::get_stats()const
+{
+    std::lock_guard<std::mutex> lock(m_tile_mutex);
+    return m_stats;
+}
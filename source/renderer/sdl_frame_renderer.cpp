@@ -4,6 +4,9 @@
 #include <iostream>
 
 #include "renderer/sdl_frame_renderer.hpp"
+#include "util/util_log.hpp"
+#include "util/util_startup_metrics.hpp"
+#include "util/util_trace_recorder.hpp"
 
 
 std::atomic<int> SDLVideoSystem::m_init_times = 0;
@@ -16,7 +19,7 @@ SDLVideoSystem::SDLVideoSystem()
         int check_video_init = SDL_InitSubSystem(SDL_INIT_VIDEO);
         if (check_video_init < 0)
         {
-            DANEJOE_LOG_ERROR("default", "SDLVideoSystem", "SDL_Init failed:{}", SDL_GetError());
+            DANEJOE_CLOG(ERROR, RENDER, "SDLVideoSystem", "SDL_Init failed:{}", SDL_GetError());
             // 操作失败时减少原子计数
             m_init_times.fetch_sub(1, std::memory_order_acq_rel);
             throw std::runtime_error("SDL_Init failed!");
@@ -63,14 +66,14 @@ SDLFrameRenderer::SDLFrameRenderer(std::string window_name, DaneJoe::Size<int> w
 {
     if (!window)
     {
-        DANEJOE_LOG_WARN("default", "SDLFrameRenderer", "window is nullptr");
+        DANEJOE_CLOG(WARN, RENDER, "SDLFrameRenderer", "window is nullptr");
     }
     // 确保窗口大小合法
-    m_window_size = window_size.quadrant() == DaneJoe::Size<int>::Quadrant::FIRST ? window_size : m_default_size;
+    DaneJoe::Size<int> size = window_size.quadrant() == DaneJoe::Size<int>::Quadrant::FIRST ? window_size : m_default_size;
     // 设置缩放质量
     SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "1");
     // 创建窗口
-    set_window(window_name, m_window_size, window);
+    set_window(window_name, size, window);
     init();
 }
 
@@ -80,46 +83,88 @@ bool SDLFrameRenderer::init()
 {
     if (!m_window)
     {
-        DANEJOE_LOG_ERROR("default", "SDLFrameRenderer", "window is null");
+        DANEJOE_CLOG(ERROR, RENDER, "SDLFrameRenderer", "window is null");
         return false;
     }
     // 初始化锁
     std::lock_guard<std::mutex> lock(m_sdl_init_mutex);
-    // 创建渲染器
-    SDL_Renderer* renderer = SDL_CreateRenderer(m_window.get(), -1, SDL_RENDERER_ACCELERATED);
+    // 创建渲染器；请求垂直同步时呈现与刷新对齐，避免撕裂并由呈现调度器按刷新选帧
+    Uint32 flags = SDL_RENDERER_ACCELERATED | (m_is_request_vsync ? SDL_RENDERER_PRESENTVSYNC : 0);
+    SDL_Renderer* renderer = SDL_CreateRenderer(m_window.get(), -1, flags);
     if (!renderer)
     {
-        DANEJOE_LOG_WARN("default", "SDLFrameRenderer", "Failed to create renderer by hardware acceleration");
+        DANEJOE_CLOG(WARN, RENDER, "SDLFrameRenderer", "Failed to create renderer by hardware acceleration");
         // 使用软解码
         renderer = SDL_CreateRenderer(m_window.get(), -1, SDL_RENDERER_SOFTWARE);
     }
     if (!renderer)
     {
-        DANEJOE_LOG_ERROR("default", "SDLFrameRenderer", "SDL_CreateRenderer failed:{}", SDL_GetError());
+        DANEJOE_CLOG(ERROR, RENDER, "SDLFrameRenderer", "SDL_CreateRenderer failed:{}", SDL_GetError());
         return false;
     }
     m_renderer.reset(renderer);
-    SDL_Rect viewport = { 0, 0, m_window_size.x, m_window_size.y };
-    SDL_RenderSetViewport(m_renderer.get(), &viewport);
+    SDL_RendererInfo info;
+    m_is_vsync = SDL_GetRendererInfo(m_renderer.get(), &info) == 0 && (info.flags & SDL_RENDERER_PRESENTVSYNC);
+    if (m_is_request_vsync && !m_is_vsync)
+    {
+        DANEJOE_CLOG(WARN, RENDER, "SDLFrameRenderer", "Renderer has no vsync, presentation is paced by timer");
+    }
+    m_texture.reset();
+    // 新渲染器需要在下一次绘制时重新应用配置
+    m_applied_config = RenderConfig();
+    m_is_config_applied = false;
     return true;
 }
 
 bool SDLFrameRenderer::is_exit()
 {
+    // 不阻塞地取完事件队列，呈现线程每次循环调用
     SDL_Event event;
-    SDL_WaitEventTimeout(&event, 2);
-    if (event.type == SDL_QUIT)
+    bool is_quit = false;
+    while (SDL_PollEvent(&event))
     {
-        DANEJOE_LOG_TRACE("default", "SDLFrameRenderer", "SDL_Event:SDL_QUIT");
-        return true;
+        if (event.type == SDL_QUIT)
+        {
+            DANEJOE_CLOG(TRACE, RENDER, "SDLFrameRenderer", "SDL_Event:SDL_QUIT");
+            is_quit = true;
+        }
     }
-    return false;
+    return is_quit;
 }
 
 void SDLFrameRenderer::set_fmt(FrameFmt fmt)
 {
-    std::lock_guard<std::mutex> lock(m_set_pixel_fmt_mutex);
-    m_pixel_format = fmt_convert(fmt);
+    publish_config([fmt](RenderConfig& config)
+        {
+            config.has_fmt = true;
+            config.fmt = fmt;
+        });
+}
+
+double SDLFrameRenderer::refresh_rate()
+{
+    if (!m_window)
+    {
+        return 0.;
+    }
+    int display_index = SDL_GetWindowDisplayIndex(m_window.get());
+    SDL_DisplayMode mode;
+    if (display_index < 0 || SDL_GetCurrentDisplayMode(display_index, &mode) != 0)
+    {
+        DANEJOE_CLOG(WARN, RENDER, "SDLFrameRenderer", "SDL_GetCurrentDisplayMode failed:{}", SDL_GetError());
+        return 0.;
+    }
+    return mode.refresh_rate > 0 ? static_cast<double>(mode.refresh_rate) : 0.;
+}
+
+bool SDLFrameRenderer::is_vsync()
+{
+    return m_is_vsync;
+}
+
+void SDLFrameRenderer::set_vsync(bool is_vsync)
+{
+    m_is_request_vsync = is_vsync;
 }
 
 SDL_PixelFormatEnum SDLFrameRenderer::fmt_convert(FrameFmt fmt)
@@ -139,134 +184,103 @@ SDL_PixelFormatEnum SDLFrameRenderer::fmt_convert(FrameFmt fmt)
     }
 }
 
-bool SDLFrameRenderer::draw(
-    uint8_t* y,
-    int y_pitch,
-    uint8_t* u,
-    int u_pitch,
-    uint8_t* v,
-    int v_pitch,
-    int width,
-    int height)
+SDL_PixelFormatEnum SDLFrameRenderer::fmt_convert(AVPixelFormat fmt)
 {
-    if (!m_window)
-    {
-        DANEJOE_LOG_ERROR("default", "SDLFrameRenderer", "window is null");
-        return false;
-    }
-    if (!m_renderer)
-    {
-        DANEJOE_LOG_ERROR("default", "SDLFrameRenderer", "renderer is null");
-        return false;
-    }
-    if (!y || !u || !v || width <= 0 || height <= 0)
-    {
-        DANEJOE_LOG_ERROR("default", "SDLFrameRenderer", "invalid param");
-        return false;
-    }
-    if (!m_texture)
-    {
-        SDL_Texture* texture = SDL_CreateTexture(m_renderer.get(), SDL_PIXELFORMAT_YV12, SDL_TEXTUREACCESS_STREAMING, width, height);
-        m_texture.reset(texture);
-    }
-    if (!m_texture)
+    switch (fmt)
     {
-        DANEJOE_LOG_ERROR("default", "SDLFrameRenderer", "create texture failed");
-        return false;
-    }
-    auto ret = SDL_UpdateYUVTexture(m_texture.get(),
-        nullptr,
-        y,
-        y_pitch,
-        u,
-        u_pitch,
-        v,
-        v_pitch);
-    if (ret < 0)
-    {
-        DANEJOE_LOG_ERROR("default", "Texture", "UpdateYUVTexture failed: {}", SDL_GetError());
-        return false;
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUVJ420P:
+        return SDL_PIXELFORMAT_IYUV;
+    case AV_PIX_FMT_NV12:
+        return SDL_PIXELFORMAT_NV12;
+    case AV_PIX_FMT_NV21:
+        return SDL_PIXELFORMAT_NV21;
+    case AV_PIX_FMT_RGB24:
+        return SDL_PIXELFORMAT_RGB24;
+    case AV_PIX_FMT_BGR24:
+        return SDL_PIXELFORMAT_BGR24;
+    case AV_PIX_FMT_RGBA:
+        return SDL_PIXELFORMAT_RGBA32;
+    case AV_PIX_FMT_BGRA:
+        return SDL_PIXELFORMAT_BGRA32;
+    case AV_PIX_FMT_ARGB:
+        return SDL_PIXELFORMAT_ARGB32;
+    default:
+        return SDL_PIXELFORMAT_UNKNOWN;
     }
-    // 清理渲染器
-    SDL_RenderClear(m_renderer.get());
-    // 复制纹理到渲染器
-
-    SDL_Rect dest_area = { 0, 0, m_window_size.x, m_window_size.y };
-    SDL_Rect src_area = { 0, 0, width, height };
-    SDL_RenderCopy(m_renderer.get(), m_texture.get(), &src_area, &dest_area);
-
-    // 显示渲染器
-    SDL_RenderPresent(m_renderer.get());
-    return true;
 }
 
-bool SDLFrameRenderer::draw(AVFramePtr frame)
+bool SDLFrameRenderer::draw(const AVFrameView& frame)
 {
     if (!frame)
     {
-        DANEJOE_LOG_ERROR("default", "SDLFrameRenderer", "check_frame failed");
+        DANEJOE_CLOG_RATE_LIMITED(ERROR, RENDER, "SDLFrameRenderer", 1000, "check_frame failed");
         return false;
     }
-    switch (frame->format)
+    if (!m_window)
     {
-    case AV_PIX_FMT_YUV420P:
-        return draw(frame->data[0],
-            frame->linesize[0],
-            frame->data[1],
-            frame->linesize[1],
-            frame->data[2],
-            frame->linesize[2],
-            frame->width,
-            frame->height);
-    default:
-        DANEJOE_LOG_WARN("default", "SDLFrameRenderer", "unsupport format");
+        DANEJOE_CLOG(ERROR, RENDER, "SDLFrameRenderer", "window is null");
         return false;
     }
-    return true;
-
-}
-
-bool SDLFrameRenderer::draw(std::shared_ptr<Frame> frame)
-{
-    if (!frame)
+    if (!m_renderer)
     {
-        DANEJOE_LOG_ERROR("default", "SDLFrameRenderer", "check_frame failed");
+        DANEJOE_CLOG(ERROR, RENDER, "SDLFrameRenderer", "renderer is null");
         return false;
     }
-    if (!m_window)
+    // 无等待读取配置快照，仅在版本变化时重建GPU状态
+    const RenderConfig& config = acquire_config();
+    if (!m_is_config_applied || config.version != m_applied_config.version)
     {
-        DANEJOE_LOG_ERROR("default", "SDLFrameRenderer", "window is null");
-        return false;
+        apply_config(config);
     }
-    if (!m_renderer)
+    // 当帧格式或者帧大小改变时，重新创建Texture
+    if (!update_texture(frame))
     {
-        DANEJOE_LOG_ERROR("default", "SDLFrameRenderer", "renderer is null");
         return false;
     }
-    std::scoped_lock lock(m_draw_mutex, m_sdl_init_mutex, m_set_pixel_fmt_mutex, m_set_window_mutex);
-    // 当帧格式或者窗口大小改变时，重新创建Texture
-    update_texture(frame);
+    // 直接从解码缓冲上传纹理，不经过中间拷贝
+    {
+        DANEJOE_TRACE_SCOPE_ARG(UPLOAD, "upload_texture", frame.pts());
+        if (!upload_texture(frame))
+        {
+            return false;
+        }
+    }
+    DANEJOE_TRACE_SCOPE_ARG(PRESENT, "present", frame.pts());
     // 清理渲染器
     SDL_RenderClear(m_renderer.get());
     // 复制纹理到渲染器
-    SDL_Rect src_area = { 0, 0, frame->size.x, frame->size.y };
-    SDL_Rect dest_area = { 0, 0, m_window_size.x, m_window_size.y };
+    SDL_Rect src_area = { 0, 0, frame.size().x, frame.size().y };
+    SDL_Rect dest_area = { 0, 0, m_applied_config.viewport_size.x, m_applied_config.viewport_size.y };
     SDL_RenderCopy(m_renderer.get(), m_texture.get(), &src_area, &dest_area);
     // 显示渲染器
     SDL_RenderPresent(m_renderer.get());
+    DaneJoe::StartupMetrics::get_instance().mark(DaneJoe::StartupMetrics::Stage::FIRST_FRAME_PRESENTED);
     return true;
 }
 
 bool SDLFrameRenderer::set_window(std::string window_name, DaneJoe::Size<int> window_size, void* window)
 {
     SDL_Window* new_window = nullptr;
-    m_window_size = window_size;
     m_window_name = window_name;
+    // 窗口与渲染器的创建只在初始化阶段发生，不与绘制路径竞争
+    std::lock_guard<std::mutex> lock(m_sdl_init_mutex);
+    // 视频子系统在之后调用 SDL 的线程上初始化
+    if (!m_video_system)
+    {
+        try
+        {
+            m_video_system.emplace();
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+    }
     // 当传递的窗口指针为空时创建新的窗口
-    std::lock_guard<std::mutex> lock(m_set_window_mutex);
     if (window == nullptr)
     {
-        new_window = SDL_CreateWindow(m_window_name.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, m_window_size.x, m_window_size.y, SDL_WINDOW_SHOWN);
+        new_window = SDL_CreateWindow(m_window_name.c_str(), SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, window_size.x, window_size.y, SDL_WINDOW_SHOWN);
     }
     else
     {
@@ -274,95 +288,107 @@ bool SDLFrameRenderer::set_window(std::string window_name, DaneJoe::Size<int> wi
     }
     if (!new_window)
     {
-        DANEJOE_LOG_ERROR("default", "SDLFrameRenderer", "SDL_CreateWindow failed:{}", SDL_GetError());
+        DANEJOE_CLOG(ERROR, RENDER, "SDLFrameRenderer", "SDL_CreateWindow failed:{}", SDL_GetError());
         return false;
     }
     m_window.reset(new_window);
-    return true;
+    m_is_config_applied = false;
+    return set_window_size(window_size);
 }
 
 bool SDLFrameRenderer::update_window_size(DaneJoe::Size<int> window_size)
 {
     if (!m_window)
     {
-        DANEJOE_LOG_ERROR("default", "SDLFrameRenderer", "update_window_size failed:window not init");
+        DANEJOE_CLOG(ERROR, RENDER, "SDLFrameRenderer", "update_window_size failed:window not init");
         return false;
     }
     if (window_size.quadrant() != DaneJoe::Size<int>::Quadrant::FIRST)
     {
-        DANEJOE_LOG_ERROR("default", "SDLFrameRenderer", "update_window_size failed:window size error");
+        DANEJOE_CLOG(ERROR, RENDER, "SDLFrameRenderer", "update_window_size failed:window size error");
         return false;
     }
-    if (m_window_size == window_size)
+    if (get_config().window_size == window_size)
     {
         return true;
     }
-    std::lock_guard<std::mutex> lock(m_set_window_mutex);
-    SDL_Rect viewport = { 0, 0, window_size.x, window_size.y };
-    SDL_RenderSetViewport(m_renderer.get(), &viewport);
+    // 仅发布新配置，实际的SDL调用在绘制线程下一次绘制时执行
+    return set_window_size(window_size);
+}
 
-    m_window_size = window_size;
-    SDL_SetWindowSize(m_window.get(), window_size.x, window_size.y);
-    return true;
+void SDLFrameRenderer::apply_config(const RenderConfig& config)
+{
+    if (!m_is_config_applied || config.window_size != m_applied_config.window_size)
+    {
+        SDL_SetWindowSize(m_window.get(), config.window_size.x, config.window_size.y);
+    }
+    SDL_Rect viewport = { config.viewport_pos.x, config.viewport_pos.y, config.viewport_size.x, config.viewport_size.y };
+    SDL_RenderSetViewport(m_renderer.get(), &viewport);
+    if (config.has_fmt && (!m_applied_config.has_fmt || config.fmt != m_applied_config.fmt))
+    {
+        // 帧格式变化时丢弃旧纹理，由 update_texture 按新格式重建
+        m_texture.reset();
+    }
+    m_applied_config = config;
+    m_is_config_applied = true;
 }
 
-bool SDLFrameRenderer::update_texture(std::shared_ptr<Frame> frame)
+bool SDLFrameRenderer::update_texture(const AVFrameView& frame)
 {
-    if (!frame)
+    SDL_PixelFormatEnum frame_format = fmt_convert(frame.format());
+    if (frame_format == SDL_PIXELFORMAT_UNKNOWN)
     {
-        DANEJOE_LOG_ERROR("default", "SDLFrameRenderer", "Failed to reset texture: frame is null");
+        DANEJOE_CLOG_RATE_LIMITED(WARN, RENDER, "SDLFrameRenderer", 1000, "unsupport format: {}", static_cast<int>(frame.format()));
         return false;
     }
     // 判断纹理是否初始化
     if (!m_texture ||
         // 判断像素格式是否一致
-        fmt_convert(frame->fmt) != m_pixel_format ||
+        frame_format != m_pixel_format ||
         // 判断宽高是否一致
-        frame->size != m_texture_size)
+        frame.size() != m_texture_size)
     {
         // 更新纹理宽高
-        m_texture_size = frame->size;
+        m_texture_size = frame.size();
         // 更新像素格式
-        m_pixel_format = fmt_convert(frame->fmt);
+        m_pixel_format = frame_format;
         // 创建纹理
-        SDL_Texture* texture = SDL_CreateTexture(m_renderer.get(), fmt_convert(frame->fmt), SDL_TEXTUREACCESS_STREAMING, frame->size.x, frame->size.y);
-#ifdef YUV_TEXTURE
-        {
-            // 更新纹理
-            int check_update_texture = 0;
-            if (frame->fmt == FrameFmt::YUV420P)
-            {
-                int width = frame->size.x;
-                int height = frame->size.y;
-                const uint8_t* y_plane = frame->data.data();
-                const uint8_t* u_plane = y_plane + width * height;
-                const uint8_t* v_plane = u_plane + (width / 2) * (height / 2);
-                int y_pitch = width;
-                int u_pitch = width / 2;
-                int v_pitch = width / 2;
-                check_update_texture = SDL_UpdateYUVTexture(
-                    m_texture.get(), nullptr,
-                    y_plane, y_pitch,
-                    u_plane, u_pitch,
-                    v_plane, v_pitch
-                );
-            }
-            else
-            {
-                check_update_texture = SDL_UpdateTexture(m_texture.get(), nullptr, frame->data.data(), frame->pitch);
-            }
-            if (check_update_texture != 0)
-            {
-                DANEJOE_LOG_ERROR("default", "SDLFrameRenderer", "SDL_UpdateTexture error:{}", SDL_GetError());
-                return false;
-            }
-        }
-#endif
+        SDL_Texture* texture = SDL_CreateTexture(m_renderer.get(), frame_format, SDL_TEXTUREACCESS_STREAMING, m_texture_size.x, m_texture_size.y);
         if (!texture)
         {
+            DANEJOE_CLOG(ERROR, RENDER, "SDLFrameRenderer", "create texture failed: {}", SDL_GetError());
             return false;
         }
         m_texture.reset(texture);
     }
     return true;
-}
\ No newline at end of file
+}
+
+bool SDLFrameRenderer::upload_texture(const AVFrameView& frame)
+{
+    int check_update_texture = 0;
+    switch (m_pixel_format)
+    {
+    case SDL_PIXELFORMAT_IYUV:
+        check_update_texture = SDL_UpdateYUVTexture(m_texture.get(), nullptr,
+            frame.data(0), frame.linesize(0),
+            frame.data(1), frame.linesize(1),
+            frame.data(2), frame.linesize(2));
+        break;
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        check_update_texture = SDL_UpdateNVTexture(m_texture.get(), nullptr,
+            frame.data(0), frame.linesize(0),
+            frame.data(1), frame.linesize(1));
+        break;
+    default:
+        check_update_texture = SDL_UpdateTexture(m_texture.get(), nullptr, frame.data(0), frame.linesize(0));
+        break;
+    }
+    if (check_update_texture != 0)
+    {
+        DANEJOE_CLOG_RATE_LIMITED(ERROR, RENDER, "SDLFrameRenderer", 1000, "SDL_UpdateTexture error:{}", SDL_GetError());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,95 @@
+#include <exception>
+
+#include "util/util_command_line.hpp"
+
+namespace DaneJoe
+{
+    CommandLine::CommandLine(int argc, char* argv[])
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string argument = argv[i];
+            if (argument.size() > 2 && argument.starts_with("--"))
+            {
+                std::size_t separator = argument.find('=');
+                if (separator == std::string::npos)
+                {
+                    m_names.push_back(argument.substr(2));
+                    m_values.push_back("");
+                }
+                else
+                {
+                    m_names.push_back(argument.substr(2, separator - 2));
+                    m_values.push_back(argument.substr(separator + 1));
+                }
+            }
+            else
+            {
+                m_positional.push_back(argument);
+            }
+        }
+    }
+
+    bool CommandLine::has(const std::string& name)const
+    {
+        for (const auto& option_name : m_names)
+        {
+            if (option_name == name)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string CommandLine::get(const std::string& name, const std::string& default_value)const
+    {
+        for (std::size_t i = 0; i < m_names.size(); i++)
+        {
+            if (m_names[i] == name && !m_values[i].empty())
+            {
+                return m_values[i];
+            }
+        }
+        return default_value;
+    }
+
+    long long CommandLine::get_int(const std::string& name, long long default_value)const
+    {
+        std::string value = get(name);
+        if (value.empty())
+        {
+            return default_value;
+        }
+        try
+        {
+            return std::stoll(value);
+        }
+        catch (const std::exception&)
+        {
+            return default_value;
+        }
+    }
+
+    double CommandLine::get_double(const std::string& name, double default_value)const
+    {
+        std::string value = get(name);
+        if (value.empty())
+        {
+            return default_value;
+        }
+        try
+        {
+            return std::stod(value);
+        }
+        catch (const std::exception&)
+        {
+            return default_value;
+        }
+    }
+
+    const std::vector<std::string>& CommandLine::positional()const
+    {
+        return m_positional;
+    }
+}
@@ -0,0 +1,52 @@
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DANEJOE_HALVE_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DANEJOE_HALVE_NEON 1
+#endif
+
+#include <cstddef>
+
+#include "util/util_image_scale.hpp"
+
+void DaneJoe::halve_plane(const uint8_t* source, int source_stride, int source_width, int source_height, uint8_t* target, int target_stride)
+{
+    int target_width = source_width / 2;
+    int target_height = source_height / 2;
+    for (int y = 0; y < target_height; y++)
+    {
+        const uint8_t* row0 = source + static_cast<std::ptrdiff_t>(2 * y) * source_stride;
+        const uint8_t* row1 = row0 + source_stride;
+        uint8_t* output = target + static_cast<std::ptrdiff_t>(y) * target_stride;
+        int x = 0;
+#if defined(DANEJOE_HALVE_SSE2)
+        const __m128i low_byte_mask = _mm_set1_epi16(0x00FF);
+        for (; x + 16 <= target_width; x += 16)
+        {
+            // 先做纵向平均，再把奇偶列拆开做横向平均
+            __m128i vertical0 = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 2 * x)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 2 * x)));
+            __m128i vertical1 = _mm_avg_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 2 * x + 16)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 2 * x + 16)));
+            __m128i even = _mm_packus_epi16(_mm_and_si128(vertical0, low_byte_mask), _mm_and_si128(vertical1, low_byte_mask));
+            __m128i odd = _mm_packus_epi16(_mm_srli_epi16(vertical0, 8), _mm_srli_epi16(vertical1, 8));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + x), _mm_avg_epu8(even, odd));
+        }
+#elif defined(DANEJOE_HALVE_NEON)
+        for (; x + 16 <= target_width; x += 16)
+        {
+            // vld2q 直接按奇偶列解交织
+            uint8x16x2_t top = vld2q_u8(row0 + 2 * x);
+            uint8x16x2_t bottom = vld2q_u8(row1 + 2 * x);
+            uint8x16_t vertical_even = vrhaddq_u8(top.val[0], bottom.val[0]);
+            uint8x16_t vertical_odd = vrhaddq_u8(top.val[1], bottom.val[1]);
+            vst1q_u8(output + x, vrhaddq_u8(vertical_even, vertical_odd));
+        }
+#endif
+        for (; x < target_width; x++)
+        {
+            output[x] = static_cast<uint8_t>((row0[2 * x] + row0[2 * x + 1] + row1[2 * x] + row1[2 * x + 1] + 2) >> 2);
+        }
+    }
+}
@@ -0,0 +1,187 @@
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DANEJOE_HASH_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DANEJOE_HASH_NEON 1
+#endif
+
+#include <cstddef>
+#include <cstring>
+
+#include "util/util_plane_hash.hpp"
+
+namespace
+{
+    constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ull;
+    constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ull;
+    constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ull;
+    /// @brief 每组字节数
+    constexpr std::size_t STRIPE_BYTES = 32;
+    /// @brief 累加器路数
+    constexpr std::size_t LANE_COUNT = 4;
+    /// @brief 每组之后密钥的增量
+    constexpr uint64_t KEY_STEP = PRIME64_5;
+
+    /**
+     * @struct HashState
+     * @brief 累加器与当前密钥
+     */
+    struct HashState
+    {
+        uint64_t accumulators[LANE_COUNT] = { 0, 0, 0, 0 };
+        uint64_t keys[LANE_COUNT] = { PRIME64_1, PRIME64_2, PRIME64_3, PRIME64_4 };
+    };
+
+#if defined(DANEJOE_HASH_SSE2)
+    /**
+     * @struct Accumulator
+     * @brief SSE2 路径：4 路累加器放在两个寄存器中
+     */
+    struct Accumulator
+    {
+        __m128i accumulator01;
+        __m128i accumulator23;
+        __m128i key01;
+        __m128i key23;
+        __m128i key_step = _mm_set1_epi64x(static_cast<long long>(KEY_STEP));
+
+        explicit Accumulator(const HashState& state) :
+            accumulator01(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state.accumulators))),
+            accumulator23(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state.accumulators + 2))),
+            key01(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state.keys))),
+            key23(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state.keys + 2)))
+        {}
+        void add(const uint8_t* stripe)
+        {
+            __m128i data01 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(stripe));
+            __m128i data23 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(stripe + 16));
+            __m128i mixed01 = _mm_xor_si128(data01, key01);
+            __m128i mixed23 = _mm_xor_si128(data23, key23);
+            // _mm_mul_epu32 取各 64 位的低 32 位相乘，右移后即为 低 32 位 × 高 32 位
+            accumulator01 = _mm_add_epi64(accumulator01, _mm_add_epi64(_mm_mul_epu32(mixed01, _mm_srli_epi64(mixed01, 32)), data01));
+            accumulator23 = _mm_add_epi64(accumulator23, _mm_add_epi64(_mm_mul_epu32(mixed23, _mm_srli_epi64(mixed23, 32)), data23));
+            key01 = _mm_add_epi64(key01, key_step);
+            key23 = _mm_add_epi64(key23, key_step);
+        }
+        void store(HashState& state)const
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(state.accumulators), accumulator01);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(state.accumulators + 2), accumulator23);
+        }
+    };
+#elif defined(DANEJOE_HASH_NEON)
+    /**
+     * @struct Accumulator
+     * @brief NEON 路径：4 路累加器放在两个寄存器中
+     */
+    struct Accumulator
+    {
+        uint64x2_t accumulator01;
+        uint64x2_t accumulator23;
+        uint64x2_t key01;
+        uint64x2_t key23;
+        uint64x2_t key_step = vdupq_n_u64(KEY_STEP);
+
+        explicit Accumulator(const HashState& state) :
+            accumulator01(vld1q_u64(state.accumulators)),
+            accumulator23(vld1q_u64(state.accumulators + 2)),
+            key01(vld1q_u64(state.keys)),
+            key23(vld1q_u64(state.keys + 2))
+        {}
+        void add(const uint8_t* stripe)
+        {
+            uint64x2_t data01 = vreinterpretq_u64_u8(vld1q_u8(stripe));
+            uint64x2_t data23 = vreinterpretq_u64_u8(vld1q_u8(stripe + 16));
+            uint64x2_t mixed01 = veorq_u64(data01, key01);
+            uint64x2_t mixed23 = veorq_u64(data23, key23);
+            accumulator01 = vaddq_u64(accumulator01, vaddq_u64(vmull_u32(vmovn_u64(mixed01), vshrn_n_u64(mixed01, 32)), data01));
+            accumulator23 = vaddq_u64(accumulator23, vaddq_u64(vmull_u32(vmovn_u64(mixed23), vshrn_n_u64(mixed23, 32)), data23));
+            key01 = vaddq_u64(key01, key_step);
+            key23 = vaddq_u64(key23, key_step);
+        }
+        void store(HashState& state)const
+        {
+            vst1q_u64(state.accumulators, accumulator01);
+            vst1q_u64(state.accumulators + 2, accumulator23);
+        }
+    };
+#else
+    /**
+     * @struct Accumulator
+     * @brief 标量路径
+     */
+    struct Accumulator
+    {
+        HashState state;
+
+        explicit Accumulator(const HashState& initial_state) :state(initial_state) {}
+        void add(const uint8_t* stripe)
+        {
+            for (std::size_t lane = 0; lane < LANE_COUNT; lane++)
+            {
+                uint64_t data;
+                std::memcpy(&data, stripe + lane * 8, sizeof(data));
+                uint64_t mixed = data ^ state.keys[lane];
+                state.accumulators[lane] += (mixed & 0xFFFFFFFFull) * (mixed >> 32) + data;
+                state.keys[lane] += KEY_STEP;
+            }
+        }
+        void store(HashState& target)const
+        {
+            std::memcpy(target.accumulators, state.accumulators, sizeof(state.accumulators));
+        }
+    };
+#endif
+
+    uint64_t rotate_left(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    uint64_t avalanche(uint64_t hash)
+    {
+        hash ^= hash >> 33;
+        hash *= PRIME64_2;
+        hash ^= hash >> 29;
+        hash *= PRIME64_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+}
+
+uint64_t DaneJoe::hash_plane(const uint8_t* data, int stride, int row_bytes, int rows)
+{
+    HashState state;
+    if (data && row_bytes > 0 && rows > 0)
+    {
+        Accumulator accumulator(state);
+        std::size_t width = static_cast<std::size_t>(row_bytes);
+        for (int y = 0; y < rows; y++)
+        {
+            const uint8_t* row = data + static_cast<std::ptrdiff_t>(y) * stride;
+            std::size_t x = 0;
+            for (; x + STRIPE_BYTES <= width; x += STRIPE_BYTES)
+            {
+                accumulator.add(row + x);
+            }
+            // 行尾不足一组时补零成一组，行长参与最终混合
+            if (x < width)
+            {
+                uint8_t tail[STRIPE_BYTES] = {};
+                std::memcpy(tail, row + x, width - x);
+                accumulator.add(tail);
+            }
+        }
+        accumulator.store(state);
+    }
+    uint64_t hash = PRIME64_5 + static_cast<uint64_t>(row_bytes > 0 ? row_bytes : 0) * PRIME64_1 + static_cast<uint64_t>(rows > 0 ? rows : 0);
+    for (std::size_t lane = 0; lane < LANE_COUNT; lane++)
+    {
+        hash ^= avalanche(state.accumulators[lane]);
+        hash = rotate_left(hash, 27) * PRIME64_1 + PRIME64_4;
+    }
+    return avalanche(hash);
+}
@@ -0,0 +1,197 @@
+#include <cerrno>
+#include <cstdint>
+#include <ctime>
+#include <thread>
+
+#if __has_include(<sys/timerfd.h>)
+#include <sys/timerfd.h>
+#include <unistd.h>
+#define DANEJOE_HAS_TIMERFD 1
+#endif
+
+#if __has_include(<sys/prctl.h>)
+#include <sys/prctl.h>
+#endif
+
+#if defined(__linux__) && defined(TIMER_ABSTIME)
+#define DANEJOE_HAS_CLOCK_NANOSLEEP 1
+#endif
+
+#include "util/util_precise_timer.hpp"
+#include "util/util_log.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+#if defined(DANEJOE_HAS_CLOCK_NANOSLEEP) || defined(DANEJOE_HAS_TIMERFD)
+    /**
+     * @brief steady_clock 时间点转为 CLOCK_MONOTONIC 的 timespec
+     */
+    timespec to_timespec(Clock::time_point time_point)
+    {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time_point.time_since_epoch()).count();
+        timespec result;
+        result.tv_sec = static_cast<time_t>(ns / 1000000000);
+        result.tv_nsec = static_cast<long>(ns % 1000000000);
+        return result;
+    }
+#endif
+
+    /**
+     * @brief 把调用线程的 timer slack 降到 1ns（每个线程只设置一次）
+     */
+    void reduce_timer_slack()
+    {
+#if defined(PR_SET_TIMERSLACK)
+        thread_local bool is_reduced = false;
+        if (!is_reduced)
+        {
+            is_reduced = true;
+            prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+        }
+#endif
+    }
+
+    void cpu_relax()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+}
+
+DaneJoe::PreciseTimer::PreciseTimer() :PreciseTimer(Options()) {}
+
+DaneJoe::PreciseTimer::PreciseTimer(const Options& options) :m_options(options)
+{
+    if (!is_supported(m_options.backend))
+    {
+        DANEJOE_CLOG(WARN, APP, "PreciseTimer", "{} is not supported, falling back to {}", backend_name(m_options.backend), backend_name(Backend::SLEEP_UNTIL));
+        m_options.backend = Backend::SLEEP_UNTIL;
+    }
+#if defined(DANEJOE_HAS_TIMERFD)
+    if (m_options.backend == Backend::TIMERFD)
+    {
+        m_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        if (m_timer_fd < 0)
+        {
+            DANEJOE_CLOG(WARN, APP, "PreciseTimer", "timerfd_create failed: errno {}", errno);
+            m_options.backend = Backend::SLEEP_UNTIL;
+        }
+    }
+#endif
+}
+
+DaneJoe::PreciseTimer::~PreciseTimer()
+{
+#if defined(DANEJOE_HAS_TIMERFD)
+    if (m_timer_fd >= 0)
+    {
+        close(m_timer_fd);
+    }
+#endif
+}
+
+void DaneJoe::PreciseTimer::sleep_until(Clock::time_point deadline)
+{
+    Clock::time_point wake_time = deadline - m_options.spin;
+    // 信号中断时重新等待，直到到达内核等待的截止时间
+    while (Clock::now() < wake_time)
+    {
+        wait_kernel(wake_time);
+    }
+    while (Clock::now() < deadline)
+    {
+        cpu_relax();
+    }
+}
+
+void DaneJoe::PreciseTimer::sleep_for(Clock::duration duration)
+{
+    sleep_until(Clock::now() + duration);
+}
+
+DaneJoe::PreciseTimer::Backend DaneJoe::PreciseTimer::backend()const
+{
+    return m_options.backend;
+}
+
+bool DaneJoe::PreciseTimer::is_supported(Backend backend)
+{
+    switch (backend)
+    {
+    case Backend::SLEEP_UNTIL:
+        return true;
+    case Backend::ABSOLUTE_NANOSLEEP:
+#if defined(DANEJOE_HAS_CLOCK_NANOSLEEP)
+        return true;
+#else
+        return false;
+#endif
+    case Backend::TIMERFD:
+#if defined(DANEJOE_HAS_TIMERFD)
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+const char* DaneJoe::PreciseTimer::backend_name(Backend backend)
+{
+    switch (backend)
+    {
+    case Backend::SLEEP_UNTIL:
+        return "sleep_until";
+    case Backend::ABSOLUTE_NANOSLEEP:
+        return "clock_nanosleep";
+    case Backend::TIMERFD:
+        return "timerfd";
+    }
+    return "unknown";
+}
+
+void DaneJoe::PreciseTimer::wait_kernel(Clock::time_point wake_time)
+{
+    switch (m_options.backend)
+    {
+#if defined(DANEJOE_HAS_CLOCK_NANOSLEEP)
+    case Backend::ABSOLUTE_NANOSLEEP:
+    {
+        reduce_timer_slack();
+        timespec deadline = to_timespec(wake_time);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr);
+        return;
+    }
+#endif
+#if defined(DANEJOE_HAS_TIMERFD)
+    case Backend::TIMERFD:
+    {
+        reduce_timer_slack();
+        itimerspec spec = {};
+        spec.it_value = to_timespec(wake_time);
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0)
+        {
+            // 全零表示停止定时器，不会到期
+            spec.it_value.tv_nsec = 1;
+        }
+        if (timerfd_settime(m_timer_fd, TFD_TIMER_ABSTIME, &spec, nullptr) == 0)
+        {
+            uint64_t expirations = 0;
+            ssize_t result = read(m_timer_fd, &expirations, sizeof(expirations));
+            (void)result;
+            return;
+        }
+        DANEJOE_CLOG_RATE_LIMITED(WARN, APP, "PreciseTimer", 1000, "timerfd_settime failed: errno {}", errno);
+        break;
+    }
+#endif
+    default:
+        break;
+    }
+    std::this_thread::sleep_until(wake_time);
+}
@@ -0,0 +1,101 @@
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+#include "util/util_startup_metrics.hpp"
+#include "util/util_log.hpp"
+
+DaneJoe::StartupMetrics& DaneJoe::StartupMetrics::get_instance()
+{
+    static StartupMetrics instance;
+    return instance;
+}
+
+void DaneJoe::StartupMetrics::reset()
+{
+    for (auto& stage_ns : m_stage_ns)
+    {
+        stage_ns.store(0, std::memory_order_relaxed);
+    }
+}
+
+void DaneJoe::StartupMetrics::mark(Stage stage)
+{
+    auto& stage_ns = m_stage_ns[static_cast<std::size_t>(stage)];
+    // 已记录过时只有这一次原子读
+    if (stage_ns.load(std::memory_order_relaxed) != 0)
+    {
+        return;
+    }
+    if (stage != Stage::OPEN_BEGIN && m_stage_ns[static_cast<std::size_t>(Stage::OPEN_BEGIN)].load(std::memory_order_acquire) == 0)
+    {
+        return;
+    }
+    int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t expected = 0;
+    if (!stage_ns.compare_exchange_strong(expected, now_ns, std::memory_order_acq_rel))
+    {
+        return;
+    }
+    if (stage == Stage::FIRST_FRAME_PRESENTED)
+    {
+        DANEJOE_CLOG(INFO, APP, "StartupMetrics", "Time to first frame: {}", summary());
+    }
+}
+
+std::optional<double> DaneJoe::StartupMetrics::elapsed_ms(Stage stage)const
+{
+    int64_t begin_ns = m_stage_ns[static_cast<std::size_t>(Stage::OPEN_BEGIN)].load(std::memory_order_acquire);
+    int64_t stage_ns = m_stage_ns[static_cast<std::size_t>(stage)].load(std::memory_order_acquire);
+    if (begin_ns == 0 || stage_ns == 0)
+    {
+        return std::nullopt;
+    }
+    return (stage_ns - begin_ns) / 1e6;
+}
+
+std::string DaneJoe::StartupMetrics::summary()const
+{
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(2);
+    for (std::size_t i = static_cast<std::size_t>(Stage::INPUT_OPENED); i < static_cast<std::size_t>(Stage::COUNT); i++)
+    {
+        Stage stage = static_cast<Stage>(i);
+        std::optional<double> elapsed = elapsed_ms(stage);
+        if (i > static_cast<std::size_t>(Stage::INPUT_OPENED))
+        {
+            stream << ", ";
+        }
+        stream << stage_name(stage) << " ";
+        if (elapsed)
+        {
+            stream << *elapsed << "ms";
+        }
+        else
+        {
+            stream << "-";
+        }
+    }
+    return stream.str();
+}
+
+const char* DaneJoe::StartupMetrics::stage_name(Stage stage)
+{
+    switch (stage)
+    {
+    case Stage::OPEN_BEGIN:
+        return "open";
+    case Stage::INPUT_OPENED:
+        return "input";
+    case Stage::STREAM_INFO_READY:
+        return "stream_info";
+    case Stage::DECODER_OPENED:
+        return "decoder";
+    case Stage::FIRST_FRAME_DECODED:
+        return "decoded";
+    case Stage::FIRST_FRAME_PRESENTED:
+        return "presented";
+    default:
+        return "unknown";
+    }
+}
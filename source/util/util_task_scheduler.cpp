@@ -0,0 +1,365 @@
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+#include "util/util_task_scheduler.hpp"
+#include "util/util_log.hpp"
+
+namespace
+{
+    /// @brief 当前线程所属的调度器（非工作线程为空）
+    thread_local const DaneJoe::TaskScheduler* t_scheduler = nullptr;
+    /// @brief 当前工作线程下标
+    thread_local std::size_t t_worker_index = 0;
+
+    /**
+     * @struct ParallelForState
+     * @brief parallel_for 各通道共享的领取状态
+     * @details 由 shared_ptr 持有：调用方返回后仍在队列中的辅助任务只会领取失败，不会访问 func。
+     */
+    struct ParallelForState
+    {
+        /// @brief 通道数
+        std::size_t count = 0;
+        /// @brief 通道函数（仅在成功领取通道后访问）
+        const std::function<void(std::size_t)>* func = nullptr;
+        /// @brief 下一个待领取的通道
+        std::atomic<std::size_t> next = 0;
+        /// @brief 已执行完的通道数
+        std::atomic<std::size_t> done = 0;
+        /// @brief 完成通知锁
+        std::mutex mutex;
+        /// @brief 完成通知条件变量
+        std::condition_variable condition;
+    };
+
+    /**
+     * @brief 领取并执行通道直到全部被领取
+     */
+    void run_parallel_for_lanes(ParallelForState& state)
+    {
+        for (std::size_t lane = state.next.fetch_add(1, std::memory_order_acq_rel); lane < state.count; lane = state.next.fetch_add(1, std::memory_order_acq_rel))
+        {
+            try
+            {
+                (*state.func)(lane);
+            }
+            catch (const std::exception& e)
+            {
+                DANEJOE_CLOG(ERROR, APP, "TaskScheduler", "parallel_for lane {} threw: {}", lane, e.what());
+            }
+            catch (...)
+            {
+                DANEJOE_CLOG(ERROR, APP, "TaskScheduler", "parallel_for lane {} threw", lane);
+            }
+            state.done.fetch_add(1, std::memory_order_acq_rel);
+        }
+    }
+}
+
+DaneJoe::CancellationToken::CancellationToken() :
+    m_is_cancelled(std::make_shared<std::atomic<bool>>(false))
+{}
+
+void DaneJoe::CancellationToken::cancel()
+{
+    m_is_cancelled->store(true, std::memory_order_release);
+}
+
+bool DaneJoe::CancellationToken::is_cancelled()const
+{
+    return m_is_cancelled->load(std::memory_order_acquire);
+}
+
+DaneJoe::TaskGroup::TaskGroup(CancellationToken token) :m_token(std::move(token)) {}
+
+void DaneJoe::TaskGroup::cancel()
+{
+    m_token.cancel();
+}
+
+bool DaneJoe::TaskGroup::is_cancelled()const
+{
+    return m_token.is_cancelled();
+}
+
+const DaneJoe::CancellationToken& DaneJoe::TaskGroup::token()const
+{
+    return m_token;
+}
+
+std::size_t DaneJoe::TaskGroup::pending()const
+{
+    return m_pending.load(std::memory_order_acquire);
+}
+
+DaneJoe::TaskScheduler::TaskScheduler(std::size_t worker_count)
+{
+    if (worker_count == 0)
+    {
+        worker_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // 每个工作线程一个队列，外加一个注入队列
+    for (std::size_t i = 0; i < worker_count + 1; i++)
+    {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (std::size_t i = 0; i < worker_count; i++)
+    {
+        m_workers.emplace_back(&TaskScheduler::worker_loop, this, i);
+    }
+    DANEJOE_CLOG(TRACE, APP, "TaskScheduler", "Started {} workers", worker_count);
+}
+
+DaneJoe::TaskScheduler& DaneJoe::TaskScheduler::get_instance()
+{
+    static TaskScheduler instance;
+    return instance;
+}
+
+DaneJoe::TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_idle_mutex);
+        m_is_stopped = true;
+    }
+    m_idle_condition.notify_all();
+    for (auto& worker : m_workers)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+}
+
+void DaneJoe::TaskScheduler::submit(Task task, TaskPriority priority)
+{
+    push(std::move(task), priority);
+}
+
+void DaneJoe::TaskScheduler::submit(TaskGroup& group, Task task, TaskPriority priority)
+{
+    /// @brief 任务结束（包括抛出异常）时归还任务组计数，计数在锁内归零，保证等待方返回后不再访问任务组
+    struct PendingGuard
+    {
+        TaskGroup& group;
+        ~PendingGuard()
+        {
+            std::lock_guard<std::mutex> lock(group.m_mutex);
+            if (group.m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                group.m_condition.notify_all();
+            }
+        }
+    };
+    group.m_pending.fetch_add(1, std::memory_order_acq_rel);
+    push([this, &group, task = std::move(task)]() mutable
+        {
+            PendingGuard guard{ group };
+            if (group.is_cancelled())
+            {
+                m_cancelled.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                task();
+            }
+        }, priority);
+}
+
+void DaneJoe::TaskScheduler::wait(TaskGroup& group)
+{
+    while (group.pending() > 0)
+    {
+        if (try_run_one())
+        {
+            continue;
+        }
+        // 短超时：期间可能有新任务入队，醒来后继续帮忙执行
+        std::unique_lock<std::mutex> lock(group.m_mutex);
+        group.m_condition.wait_for(lock, std::chrono::milliseconds(1), [&group]()
+            {
+                return group.pending() == 0;
+            });
+    }
+    std::lock_guard<std::mutex> lock(group.m_mutex);
+}
+
+void DaneJoe::TaskScheduler::parallel_for(std::size_t count, const std::function<void(std::size_t)>& func)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    auto state = std::make_shared<ParallelForState>();
+    state->count = count;
+    state->func = &func;
+    // 辅助任务只领取本次调用的通道，不会在调用线程上执行无关任务
+    std::size_t helper_count = std::min(count - 1, worker_count());
+    for (std::size_t i = 0; i < helper_count; i++)
+    {
+        submit([state]()
+            {
+                run_parallel_for_lanes(*state);
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->condition.notify_all();
+            }, TaskPriority::HIGH);
+    }
+    std::exception_ptr exception;
+    for (std::size_t lane = state->next.fetch_add(1, std::memory_order_acq_rel); lane < count; lane = state->next.fetch_add(1, std::memory_order_acq_rel))
+    {
+        try
+        {
+            func(lane);
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+            state->done.fetch_add(1, std::memory_order_acq_rel);
+            break;
+        }
+        state->done.fetch_add(1, std::memory_order_acq_rel);
+    }
+    // 抛出异常时停止领取；只需等待已被辅助任务领取的通道，它们引用了调用方栈上的 func
+    std::size_t claimed = std::min(state->next.exchange(count, std::memory_order_acq_rel), count);
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->condition.wait(lock, [&state, claimed]()
+            {
+                return state->done.load(std::memory_order_acquire) >= claimed;
+            });
+    }
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+void DaneJoe::TaskScheduler::push(Task task, TaskPriority priority)
+{
+    std::size_t queue_index = is_worker_thread() ? t_worker_index : m_queues.size() - 1;
+    {
+        std::lock_guard<std::mutex> lock(m_queues[queue_index]->mutex);
+        m_queues[queue_index]->tasks[static_cast<std::size_t>(priority)].push_back(std::move(task));
+    }
+    m_queued.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(m_idle_mutex);
+    }
+    m_idle_condition.notify_one();
+}
+
+bool DaneJoe::TaskScheduler::pop(Task& task, bool& is_stolen)
+{
+    if (m_queued.load(std::memory_order_acquire) == 0)
+    {
+        return false;
+    }
+    std::size_t worker_count = m_workers.size();
+    std::size_t local_index = is_worker_thread() ? t_worker_index : m_queues.size() - 1;
+    for (std::size_t priority = 0; priority < PRIORITY_COUNT; priority++)
+    {
+        // 本地队列：取最新提交的任务
+        {
+            WorkQueue& queue = *m_queues[local_index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            auto& tasks = queue.tasks[priority];
+            if (!tasks.empty())
+            {
+                task = std::move(tasks.back());
+                tasks.pop_back();
+                is_stolen = false;
+                m_queued.fetch_sub(1, std::memory_order_acq_rel);
+                return true;
+            }
+        }
+        // 注入队列与其他线程队列：取最早提交的任务
+        for (std::size_t offset = 0; offset < m_queues.size(); offset++)
+        {
+            std::size_t victim_index = (local_index + 1 + offset) % m_queues.size();
+            if (victim_index == local_index)
+            {
+                continue;
+            }
+            WorkQueue& queue = *m_queues[victim_index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            auto& tasks = queue.tasks[priority];
+            if (!tasks.empty())
+            {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+                is_stolen = victim_index < worker_count;
+                m_queued.fetch_sub(1, std::memory_order_acq_rel);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool DaneJoe::TaskScheduler::try_run_one()
+{
+    Task task;
+    bool is_stolen = false;
+    if (!pop(task, is_stolen))
+    {
+        return false;
+    }
+    try
+    {
+        task();
+    }
+    catch (const std::exception& e)
+    {
+        DANEJOE_CLOG(ERROR, APP, "TaskScheduler", "Task threw: {}", e.what());
+    }
+    catch (...)
+    {
+        DANEJOE_CLOG(ERROR, APP, "TaskScheduler", "Task threw a non-standard exception");
+    }
+    m_executed.fetch_add(1, std::memory_order_relaxed);
+    if (is_stolen)
+    {
+        m_stolen.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void DaneJoe::TaskScheduler::worker_loop(std::size_t worker_index)
+{
+    t_scheduler = this;
+    t_worker_index = worker_index;
+    while (!m_is_stopped.load(std::memory_order_acquire))
+    {
+        if (try_run_one())
+        {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_idle_mutex);
+        m_idle_condition.wait(lock, [this]()
+            {
+                return m_is_stopped.load(std::memory_order_acquire) || m_queued.load(std::memory_order_acquire) > 0;
+            });
+    }
+    t_scheduler = nullptr;
+}
+
+std::size_t DaneJoe::TaskScheduler::worker_count()const
+{
+    return m_workers.size();
+}
+
+bool DaneJoe::TaskScheduler::is_worker_thread()const
+{
+    return t_scheduler == this;
+}
+
+DaneJoe::TaskScheduler::Stats DaneJoe::TaskScheduler::get_stats()const
+{
+    Stats stats;
+    stats.executed = m_executed.load(std::memory_order_relaxed);
+    stats.stolen = m_stolen.load(std::memory_order_relaxed);
+    stats.cancelled = m_cancelled.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,410 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+
+#include "util/util_trace_recorder.hpp"
+#include "util/util_log.hpp"
+
+namespace
+{
+    /// @brief 二进制追踪文件头
+    constexpr char TRACE_FILE_MAGIC[8] = { 'D', 'J', 'T', 'R', 'A', 'C', 'E', '1' };
+
+    /**
+     * @struct FileRecord
+     * @brief 二进制文件中的记录，名称以字符串表下标保存
+     */
+    struct FileRecord
+    {
+        int64_t begin_ns;
+        int64_t end_ns;
+        int64_t arg;
+        uint32_t thread_id;
+        uint16_t name_index;
+        uint8_t track;
+        uint8_t reserved;
+    };
+    static_assert(sizeof(FileRecord) == 32);
+
+    /// @brief 当前线程名称，取得缓冲时登记
+    thread_local std::string t_thread_name;
+
+    /**
+     * @struct TraceData
+     * @brief 导出所需的全部数据
+     */
+    struct TraceData
+    {
+        std::vector<std::string> names;
+        std::vector<std::pair<uint32_t, std::string>> thread_names;
+        std::vector<FileRecord> records;
+    };
+
+    template <typename T>
+    void write_value(std::ofstream& file, const T& value)
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool read_value(std::ifstream& file, T& value)
+    {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    void write_string(std::ofstream& file, const std::string& value)
+    {
+        write_value(file, static_cast<uint16_t>(value.size()));
+        file.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+    bool read_string(std::ifstream& file, std::string& value)
+    {
+        uint16_t size = 0;
+        if (!read_value(file, size))
+        {
+            return false;
+        }
+        value.resize(size);
+        return static_cast<bool>(file.read(value.data(), size));
+    }
+
+    std::string escape_json(const std::string& value)
+    {
+        std::string result;
+        result.reserve(value.size());
+        for (char c : value)
+        {
+            if (c == '"' || c == '\\')
+            {
+                result.push_back('\\');
+                result.push_back(c);
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char buffer[8];
+                std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                result += buffer;
+            }
+            else
+            {
+                result.push_back(c);
+            }
+        }
+        return result;
+    }
+
+    bool write_chrome_json(const TraceData& data, const std::string& json_path)
+    {
+        std::ofstream file(json_path, std::ios::trunc);
+        if (!file)
+        {
+            DANEJOE_CLOG(ERROR, APP, "TraceRecorder", "Failed to open {}", json_path);
+            return false;
+        }
+        int64_t origin_ns = INT64_MAX;
+        for (const auto& record : data.records)
+        {
+            origin_ns = std::min(origin_ns, record.begin_ns);
+        }
+        // 时间戳以微秒为单位，保留到纳秒
+        file << std::fixed << std::setprecision(3);
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool is_first = true;
+        auto separator = [&]() -> std::ofstream&
+            {
+                if (!is_first)
+                {
+                    file << ",\n";
+                }
+                is_first = false;
+                return file;
+            };
+        separator() << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"danejoe player\"}}";
+        for (const auto& [thread_id, thread_name] : data.thread_names)
+        {
+            std::string name = thread_name.empty() ? "thread " + std::to_string(thread_id) : thread_name;
+            separator() << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << thread_id
+                << ",\"args\":{\"name\":\"" << escape_json(name) << "\"}}";
+        }
+        for (const auto& record : data.records)
+        {
+            const std::string& name = record.name_index < data.names.size() ? data.names[record.name_index] : "unknown";
+            separator() << "{\"ph\":\"X\",\"name\":\"" << escape_json(name)
+                << "\",\"cat\":\"" << DaneJoe::TraceRecorder::track_name(static_cast<DaneJoe::TraceTrack>(record.track))
+                << "\",\"pid\":1,\"tid\":" << record.thread_id
+                << ",\"ts\":" << (record.begin_ns - origin_ns) / 1e3
+                << ",\"dur\":" << (record.end_ns - record.begin_ns) / 1e3
+                << ",\"args\":{\"arg\":" << record.arg << "}}";
+        }
+        file << "\n]}\n";
+        return static_cast<bool>(file);
+    }
+}
+
+DaneJoe::TraceRecorder& DaneJoe::TraceRecorder::get_instance()
+{
+    static TraceRecorder instance;
+    return instance;
+}
+
+void DaneJoe::TraceRecorder::set_enabled(bool is_enabled)
+{
+    m_is_enabled.store(is_enabled, std::memory_order_relaxed);
+}
+
+void DaneJoe::TraceRecorder::set_buffer_capacity(std::size_t capacity)
+{
+    m_buffer_capacity.store(std::max<std::size_t>(capacity, 2), std::memory_order_relaxed);
+}
+
+void DaneJoe::TraceRecorder::set_thread_name(const std::string& name)
+{
+    t_thread_name = name;
+    ThreadBuffer* buffer = thread_buffer_owner().buffer;
+    if (buffer)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_thread_names[buffer->thread_id] = name;
+    }
+}
+
+DaneJoe::TraceRecorder::ThreadBufferOwner::~ThreadBufferOwner()
+{
+    if (buffer)
+    {
+        TraceRecorder::get_instance().release_thread_buffer(buffer);
+    }
+}
+
+DaneJoe::TraceRecorder::ThreadBufferOwner& DaneJoe::TraceRecorder::thread_buffer_owner()
+{
+    thread_local ThreadBufferOwner owner;
+    return owner;
+}
+
+DaneJoe::TraceRecorder::ThreadBuffer& DaneJoe::TraceRecorder::thread_buffer()
+{
+    ThreadBufferOwner& owner = thread_buffer_owner();
+    if (!owner.buffer)
+    {
+        uint32_t thread_id = m_next_thread_id.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_thread_names[thread_id] = t_thread_name;
+        if (!m_free_buffers.empty())
+        {
+            // 复用已退出线程的缓冲，新记录带新的线程编号，旧记录保留到被覆盖为止
+            owner.buffer = m_free_buffers.back();
+            m_free_buffers.pop_back();
+        }
+        else
+        {
+            auto buffer = std::make_shared<ThreadBuffer>();
+            buffer->records.resize(m_buffer_capacity.load(std::memory_order_relaxed));
+            owner.buffer = buffer.get();
+            m_buffers.push_back(std::move(buffer));
+        }
+        owner.buffer->thread_id = thread_id;
+    }
+    return *owner.buffer;
+}
+
+void DaneJoe::TraceRecorder::release_thread_buffer(ThreadBuffer* buffer)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_free_buffers.push_back(buffer);
+}
+
+void DaneJoe::TraceRecorder::record(TraceTrack track, const char* name, int64_t begin_ns, int64_t end_ns, int64_t arg)
+{
+    if (!is_enabled())
+    {
+        return;
+    }
+    ThreadBuffer& buffer = thread_buffer();
+    // 只有本线程写入，先写记录再发布计数
+    uint64_t write_count = buffer.write_count.load(std::memory_order_relaxed);
+    TraceRecord& record = buffer.records[write_count % buffer.records.size()];
+    record.begin_ns = begin_ns;
+    record.end_ns = end_ns;
+    record.arg = arg;
+    record.name = name;
+    record.thread_id = buffer.thread_id;
+    record.track = track;
+    buffer.write_count.store(write_count + 1, std::memory_order_release);
+}
+
+std::vector<DaneJoe::TraceRecord> DaneJoe::TraceRecorder::collect()
+{
+    std::vector<TraceRecord> records;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& buffer : m_buffers)
+    {
+        uint64_t write_count = buffer->write_count.load(std::memory_order_acquire);
+        uint64_t capacity = buffer->records.size();
+        // 缓冲已回绕时跳过下一个写入位置，它可能正被覆盖
+        uint64_t begin = write_count > capacity ? write_count - capacity + 1 : 0;
+        begin = std::max(begin, buffer->clear_count.load(std::memory_order_acquire));
+        for (uint64_t i = begin; i < write_count; i++)
+        {
+            records.push_back(buffer->records[i % capacity]);
+        }
+    }
+    std::sort(records.begin(), records.end(), [](const TraceRecord& left, const TraceRecord& right) { return left.begin_ns < right.begin_ns; });
+    return records;
+}
+
+void DaneJoe::TraceRecorder::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& buffer : m_buffers)
+    {
+        buffer->clear_count.store(buffer->write_count.load(std::memory_order_acquire), std::memory_order_release);
+    }
+}
+
+bool DaneJoe::TraceRecorder::save_binary(const std::string& file_path)
+{
+    std::vector<TraceRecord> records = collect();
+    std::vector<std::pair<uint32_t, std::string>> thread_names;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        thread_names.assign(m_thread_names.begin(), m_thread_names.end());
+    }
+    std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        DANEJOE_CLOG(ERROR, APP, "TraceRecorder", "Failed to open {}", file_path);
+        return false;
+    }
+    // 名称按指针去重后写入字符串表
+    std::unordered_map<const char*, uint16_t> name_indices;
+    std::vector<const char*> names;
+    for (const auto& record : records)
+    {
+        if (name_indices.emplace(record.name, static_cast<uint16_t>(names.size())).second)
+        {
+            names.push_back(record.name);
+        }
+    }
+    file.write(TRACE_FILE_MAGIC, sizeof(TRACE_FILE_MAGIC));
+    write_value(file, static_cast<uint32_t>(names.size()));
+    for (const char* name : names)
+    {
+        write_string(file, name ? name : "");
+    }
+    write_value(file, static_cast<uint32_t>(thread_names.size()));
+    for (const auto& [thread_id, thread_name] : thread_names)
+    {
+        write_value(file, thread_id);
+        write_string(file, thread_name);
+    }
+    write_value(file, static_cast<uint64_t>(records.size()));
+    for (const auto& record : records)
+    {
+        FileRecord file_record{ record.begin_ns, record.end_ns, record.arg, record.thread_id, name_indices[record.name], static_cast<uint8_t>(record.track), 0 };
+        write_value(file, file_record);
+    }
+    DANEJOE_CLOG(INFO, APP, "TraceRecorder", "Saved {} trace records to {}", records.size(), file_path);
+    return static_cast<bool>(file);
+}
+
+bool DaneJoe::TraceRecorder::save_chrome_json(const std::string& file_path)
+{
+    TraceData data;
+    std::unordered_map<const char*, uint16_t> name_indices;
+    for (const auto& record : collect())
+    {
+        auto [it, is_inserted] = name_indices.emplace(record.name, static_cast<uint16_t>(data.names.size()));
+        if (is_inserted)
+        {
+            data.names.emplace_back(record.name ? record.name : "");
+        }
+        data.records.push_back(FileRecord{ record.begin_ns, record.end_ns, record.arg, record.thread_id, it->second, static_cast<uint8_t>(record.track), 0 });
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        data.thread_names.assign(m_thread_names.begin(), m_thread_names.end());
+    }
+    return write_chrome_json(data, file_path);
+}
+
+bool DaneJoe::TraceRecorder::convert_to_chrome_json(const std::string& binary_path, const std::string& json_path)
+{
+    std::ifstream file(binary_path, std::ios::binary);
+    char magic[sizeof(TRACE_FILE_MAGIC)] = {};
+    if (!file || !file.read(magic, sizeof(magic)) || std::memcmp(magic, TRACE_FILE_MAGIC, sizeof(magic)) != 0)
+    {
+        DANEJOE_CLOG(ERROR, APP, "TraceRecorder", "{} is not a trace file", binary_path);
+        return false;
+    }
+    TraceData data;
+    uint32_t name_count = 0;
+    bool is_valid = read_value(file, name_count);
+    for (uint32_t i = 0; is_valid && i < name_count; i++)
+    {
+        is_valid = read_string(file, data.names.emplace_back());
+    }
+    uint32_t thread_count = 0;
+    is_valid = is_valid && read_value(file, thread_count);
+    for (uint32_t i = 0; is_valid && i < thread_count; i++)
+    {
+        auto& [thread_id, thread_name] = data.thread_names.emplace_back();
+        is_valid = read_value(file, thread_id) && read_string(file, thread_name);
+    }
+    uint64_t record_count = 0;
+    is_valid = is_valid && read_value(file, record_count);
+    for (uint64_t i = 0; is_valid && i < record_count; i++)
+    {
+        is_valid = read_value(file, data.records.emplace_back());
+    }
+    if (!is_valid)
+    {
+        DANEJOE_CLOG(ERROR, APP, "TraceRecorder", "Trace file {} is truncated", binary_path);
+        return false;
+    }
+    return write_chrome_json(data, json_path);
+}
+
+const char* DaneJoe::TraceRecorder::track_name(TraceTrack track)
+{
+    switch (track)
+    {
+    case TraceTrack::DEMUX: return "demux";
+    case TraceTrack::DECODE: return "decode";
+    case TraceTrack::QUEUE_WAIT: return "queue_wait";
+    case TraceTrack::UPLOAD: return "upload";
+    case TraceTrack::PRESENT: return "present";
+    case TraceTrack::AUDIO_CALLBACK: return "audio_callback";
+    case TraceTrack::FILTER: return "filter";
+    case TraceTrack::ENCODE: return "encode";
+    case TraceTrack::MUX: return "mux";
+    default: return "unknown";
+    }
+}
+
+DaneJoe::TraceSession::TraceSession(const std::string& file_path) :m_file_path(file_path)
+{
+    TraceRecorder& recorder = TraceRecorder::get_instance();
+    recorder.set_thread_name("main");
+    recorder.set_enabled(true);
+}
+
+DaneJoe::TraceSession::~TraceSession()
+{
+    TraceRecorder& recorder = TraceRecorder::get_instance();
+    recorder.set_enabled(false);
+    bool is_json = m_file_path.size() >= 5 && m_file_path.compare(m_file_path.size() - 5, 5, ".json") == 0;
+    if (is_json)
+    {
+        recorder.save_chrome_json(m_file_path);
+    }
+    else
+    {
+        recorder.save_binary(m_file_path);
+    }
+}
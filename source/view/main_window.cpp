@@ -1,13 +1,20 @@
-#include "main/decode_mp4.hpp"
+#include <QKeyEvent>
+#include <QMetaObject>
+
 #include "view/main_window.hpp"
 #include "view/sdl_video_widget.hpp"
-#include "logger/logger_manager.hpp"
+#include "util/util_log.hpp"
 
 MainWindow::MainWindow(QWidget* parent) :QMainWindow(parent)
 {
 }
 MainWindow::~MainWindow()
 {
+    // 等待进行中的单步，工作线程使用单步器
+    if (m_step_thread.joinable())
+    {
+        m_step_thread.join();
+    }
     if (m_video_widget)
     {
         delete m_video_widget;
@@ -15,12 +22,161 @@ MainWindow::~MainWindow()
     }
 }
 
-void MainWindow::init()
+void MainWindow::init(std::unique_ptr<PlaybackPreloader> preloader)
 {
+    m_preloader = std::move(preloader);
     m_video_widget = new SDLVideoWidget(this);
-    m_video_widget->init();
-    auto frame_queue = m_video_widget->get_frame_queue();
-    m_decode_thread = std::move(std::jthread(decode_mp4, "/home/danejoe001/personal_code/code_cpp_project/cpp_project_multimedia/resource/400_300_25.mp4", frame_queue));
-    DANEJOE_LOG_TRACE("default", "MainWindow", "init");
+    // 主窗口只有一个视频控件，呈现阻塞到刷新不会拖慢其他控件
+    m_video_widget->set_vsync(true);
+    // 解码线程已在预加载，控件直接使用其帧队列
+    m_video_widget->init(m_preloader->get_frame_queue(), m_preloader->get_rate_control());
+    DANEJOE_CLOG(TRACE, APP, "MainWindow", "init");
     setCentralWidget(m_video_widget);
-}
\ No newline at end of file
+}
+
+void MainWindow::keyPressEvent(QKeyEvent* event)
+{
+    switch (event->key())
+    {
+    case Qt::Key_Space:
+        if (m_video_widget)
+        {
+            m_video_widget->set_paused(!m_video_widget->is_paused());
+            m_is_step_positioned = false;
+            m_step_generation++;
+            return;
+        }
+        break;
+    case Qt::Key_Period:
+        if (step_frame(true))
+        {
+            return;
+        }
+        break;
+    case Qt::Key_Comma:
+        if (step_frame(false))
+        {
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+    std::shared_ptr<PlaybackRateControl> rate_control = m_preloader ? m_preloader->get_rate_control() : nullptr;
+    if (!rate_control)
+    {
+        QMainWindow::keyPressEvent(event);
+        return;
+    }
+    switch (event->key())
+    {
+    case Qt::Key_BracketRight:
+    case Qt::Key_Plus:
+        rate_control->step_rate(1);
+        break;
+    case Qt::Key_BracketLeft:
+    case Qt::Key_Minus:
+        rate_control->step_rate(-1);
+        break;
+    case Qt::Key_Backspace:
+        rate_control->set_rate(1.);
+        break;
+    default:
+        QMainWindow::keyPressEvent(event);
+        break;
+    }
+}
+
+bool MainWindow::step_frame(bool is_forward)
+{
+    if (!m_video_widget || !m_preloader || m_preloader->get_file_path().empty())
+    {
+        return false;
+    }
+    m_video_widget->set_paused(true);
+    // 单步器只由工作线程使用，上一次单步完成前忽略新的单步
+    if (m_is_stepping)
+    {
+        return true;
+    }
+    m_is_stepping = true;
+    std::optional<double> seek_seconds;
+    if (!m_is_step_positioned)
+    {
+        // 从暂停时呈现的帧开始单步
+        seek_seconds = m_preloader->get_rate_control()->presented_seconds().value_or(0.);
+    }
+    // 打开解码器、定位与解码整个 GOP 都在工作线程上进行，结果投递回 GUI 线程显示
+    m_step_thread = std::jthread([this, file_path = m_preloader->get_file_path(), is_forward, seek_seconds, generation = m_step_generation]()
+        {
+            auto result = std::make_shared<StepResult>(run_step(file_path, is_forward, seek_seconds));
+            QMetaObject::invokeMethod(this, [this, result, generation]() { finish_step(std::move(*result), generation); }, Qt::QueuedConnection);
+        });
+    return true;
+}
+
+MainWindow::StepResult MainWindow::run_step(const std::string& file_path, bool is_forward, std::optional<double> seek_seconds)
+{
+    StepResult result;
+    if (!m_frame_stepper.is_open())
+    {
+        AVError error = m_frame_stepper.open(file_path);
+        if (error.failed())
+        {
+            DANEJOE_CLOG(ERROR, APP, "MainWindow", "Failed to open frame stepper: {}", error.message());
+            return result;
+        }
+    }
+    AVFrameView frame_view;
+    if (seek_seconds)
+    {
+        AVError error = m_frame_stepper.seek(*seek_seconds, frame_view);
+        if (error.failed())
+        {
+            DANEJOE_CLOG(WARN, APP, "MainWindow", "Frame stepper seek failed: {}", error.message());
+            return result;
+        }
+        result.is_positioned = true;
+    }
+    AVError error = is_forward ? m_frame_stepper.step_forward(frame_view) : m_frame_stepper.step_back(frame_view);
+    if (error.failed())
+    {
+        if (error != AVERROR_EOF)
+        {
+            DANEJOE_CLOG(WARN, APP, "MainWindow", "Frame step failed: {}", error.message());
+        }
+        return result;
+    }
+    result.frame = std::move(frame_view);
+    return result;
+}
+
+void MainWindow::finish_step(StepResult result, uint64_t generation)
+{
+    m_is_stepping = false;
+    // 单步期间已恢复播放时丢弃结果
+    if (generation != m_step_generation || !m_video_widget)
+    {
+        return;
+    }
+    m_is_step_positioned = m_is_step_positioned || result.is_positioned;
+    if (!result.frame)
+    {
+        return;
+    }
+    m_video_widget->show_frame(std::move(*result.frame));
+    update_step_status();
+}
+
+void MainWindow::update_step_status()
+{
+    FrameStepper::Stats stats = m_frame_stepper.get_stats();
+    QString status = QString("Paused %1s (step %2 ms, cache hit %3%, %4 frames, %5/%6 MB)")
+        .arg(m_frame_stepper.current_seconds().value_or(0.), 0, 'f', 3)
+        .arg(stats.last_step_ms, 0, 'f', 1)
+        .arg(stats.cache.hit_rate() * 100., 0, 'f', 1)
+        .arg(stats.cache.entries)
+        .arg(stats.cache.bytes / (1024. * 1024.), 0, 'f', 1)
+        .arg(stats.cache.capacity_bytes / (1024. * 1024.), 0, 'f', 0);
+    setWindowTitle(status);
+}
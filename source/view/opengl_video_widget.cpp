@@ -1,4 +1,5 @@
 #include "view/opengl_video_widget.hpp"
+#include "util/util_log.hpp"
 
 // 顶点着色器 - 处理每个顶点的位置和纹理坐标
 const char* v_string = R"(
@@ -106,7 +107,7 @@ OpenGLVideoWidget::~OpenGLVideoWidget() {}
 
 void OpenGLVideoWidget::initializeGL()
 {
-    DANEJOE_LOG_TRACE("default", "QtOpenGL", "initializeGL");
+    DANEJOE_CLOG(TRACE, VIEW, "QtOpenGL", "initializeGL");
     /// @brief 初始化OpenGL函数(QOpenGLFunctions继承)
     initializeOpenGLFunctions();
 
@@ -131,10 +132,10 @@ void OpenGLVideoWidget::initializeGL()
 
 void OpenGLVideoWidget::paintGL()
 {
-    DANEJOE_LOG_TRACE("default", "QtOpenGL", "paintGL");
+    DANEJOE_CLOG(TRACE, VIEW, "QtOpenGL", "paintGL");
 }
 
 void OpenGLVideoWidget::resizeGL(int w, int h)
 {
-    DANEJOE_LOG_TRACE("default", "QtOpenGL", "resizeGL: width{} height{}", w, h);
+    DANEJOE_CLOG(TRACE, VIEW, "QtOpenGL", "resizeGL: width{} height{}", w, h);
 }
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include <algorithm>
+
+#include <QVBoxLayout>
+#include <QLabel>
+
+#include "view/sdl_compositor_widget.hpp"
+#include "util/util_log.hpp"
+
+SDLCompositorWidget::SDLCompositorWidget(QWidget* parent) :QWidget(parent) {}
+
+SDLCompositorWidget::~SDLCompositorWidget()
+{
+    close();
+}
+
+void SDLCompositorWidget::init(std::size_t stream_count, std::size_t frame_queue_capacity)
+{
+    if (m_is_init)
+    {
+        DANEJOE_CLOG(WARN, VIEW, "SDLCompositorWidget", "Already initialized");
+        return;
+    }
+    m_is_init = true;
+    for (std::size_t i = 0; i < stream_count; i++)
+    {
+        m_streams.push_back({ std::make_shared<FrameQueue>(frame_queue_capacity), std::chrono::steady_clock::now() });
+    }
+    m_sdl_label = new QLabel(this);
+    m_sdl_label->setStyleSheet("background-color: rgb(0, 0, 0);");
+    m_sdl_label->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    m_main_layout = new QVBoxLayout(this);
+    m_main_layout->addWidget(m_sdl_label);
+    m_main_layout->setSpacing(0);
+    m_main_layout->setContentsMargins(0, 0, 0, 0);
+    (void)m_sdl_label->winId();
+    // 按约 60Hz 在 GUI 线程上合成；渲染器不开启垂直同步，提交不会阻塞事件循环
+    m_timer_id = startTimer(1000 / 60, Qt::PreciseTimer);
+}
+
+void SDLCompositorWidget::init_renderer()
+{
+    if (m_renderer)
+    {
+        return;
+    }
+    m_renderer = std::make_unique<SDLCompositorRenderer>();
+    DaneJoe::Size<int> size = { m_sdl_label->width(), m_sdl_label->height() };
+    if (!m_renderer->set_window("sdl_compositor", size, (void*)m_sdl_label->winId()) ||
+        !m_renderer->init(m_streams.size()))
+    {
+        DANEJOE_CLOG(ERROR, VIEW, "SDLCompositorWidget", "init renderer failed");
+        m_renderer.reset();
+    }
+}
+
+std::weak_ptr<FrameQueue> SDLCompositorWidget::get_frame_queue(std::size_t stream_index)
+{
+    if (stream_index >= m_streams.size())
+    {
+        return {};
+    }
+    return m_streams[stream_index].frame_queue;
+}
+
+SDLCompositorRenderer::Stats SDLCompositorWidget::get_stats()const
+{
+    if (!m_renderer)
+    {
+        return {};
+    }
+    return m_renderer->get_stats();
+}
+
+void SDLCompositorWidget::timerEvent(QTimerEvent* event)
+{
+    if (!m_renderer)
+    {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < m_streams.size(); i++)
+    {
+        StreamState& stream = m_streams[i];
+        if (now < stream.next_due)
+        {
+            continue;
+        }
+        auto frame = stream.frame_queue->try_pop();
+        if (!frame.has_value())
+        {
+            continue;
+        }
+        // 按帧时长安排该路流的下一帧
+        std::chrono::nanoseconds interval = DEFAULT_FRAME_INTERVAL;
+        if (frame->duration() > 0 && frame->time_base().den > 0)
+        {
+            interval = std::chrono::nanoseconds(av_rescale_q(frame->duration(), frame->time_base(), AVRational{ 1, 1000000000 }));
+        }
+        stream.next_due = std::max(stream.next_due + interval, now);
+        m_renderer->submit(i, std::move(*frame));
+    }
+    m_renderer->present();
+}
+
+void SDLCompositorWidget::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    if (!m_renderer || !m_sdl_label)
+    {
+        return;
+    }
+    m_renderer->update_window_size({ m_sdl_label->width(), m_sdl_label->height() });
+}
+
+void SDLCompositorWidget::showEvent(QShowEvent* event)
+{
+    QWidget::showEvent(event);
+    init_renderer();
+}
+
+void SDLCompositorWidget::closeEvent(QCloseEvent* event)
+{
+    close();
+    QWidget::closeEvent(event);
+}
+
+void SDLCompositorWidget::close()
+{
+    if (m_timer_id > -1)
+    {
+        killTimer(m_timer_id);
+        m_timer_id = -1;
+    }
+    for (auto& stream : m_streams)
+    {
+        stream.frame_queue->close();
+    }
+}
@@ -12,27 +12,39 @@
 #include <QLabel>
 #include <QHBoxLayout>
 
-#include "logger/logger_manager.hpp"
+#include "util/util_log.hpp"
 #include "view/sdl_video_widget.hpp"
 #include "renderer/sdl_frame_renderer.hpp"
 #include "util/util_vector_2d.hpp"
-#include "codec/av_frame_ptr.hpp"
+#include "codec/av_frame_view.hpp"
+
+namespace
+{
+    /// @brief 轮询退出事件与刷新状态的周期（SDL 事件与呈现都由呈现线程处理）
+    constexpr std::chrono::milliseconds EVENT_POLL_INTERVAL(20);
+}
 
 SDLVideoWidget::SDLVideoWidget(QWidget* parent) :QWidget(parent)
 {
 
 }
 
-void SDLVideoWidget::init()
+void SDLVideoWidget::init(std::size_t frame_queue_capacity)
+{
+    init(std::make_shared<FrameQueue>(frame_queue_capacity));
+}
+
+void SDLVideoWidget::init(std::shared_ptr<FrameQueue> frame_queue, std::shared_ptr<PlaybackRateControl> rate_control)
 {
     if (m_is_init)
     {
-        DANEJOE_LOG_WARN("default", "SDLVideoWidget", "Already initialized");
+        DANEJOE_CLOG(WARN, VIEW, "SDLVideoWidget", "Already initialized");
         return;
     }
     m_is_init = true;
     // 初始化帧队列
-    m_frame_queue = std::make_shared<MpmcBoundedQueue<AVFramePtr>>(512);
+    m_frame_queue = std::move(frame_queue);
+    m_rate_control = rate_control ? std::move(rate_control) : std::make_shared<PlaybackRateControl>();
     // 创建一个QLabel，用于显示SDL渲染的图像
     m_sdl_label = new QLabel("sdl_label", this);
     m_sdl_label->setStyleSheet("background-color: rgb(0, 0, 0);color: rgb(255, 255, 255);");
@@ -46,57 +58,60 @@ void SDLVideoWidget::init()
     m_main_layout->setContentsMargins(0, 0, 0, 0);
     this->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
     (void)m_sdl_label->winId();
-    m_timer_id = startTimer(1000 / 25);
+    // 呈现在呈现线程上进行，GUI 定时器只轮询退出事件与刷新状态
+    m_timer_id = startTimer(EVENT_POLL_INTERVAL);
 }
 
 void SDLVideoWidget::init_renderer()
 {
-    if (m_renderer) return;
-    m_renderer = std::make_shared<SDLFrameRenderer>();
-    DaneJoe::Size<int> size = { m_sdl_label->size().width(), m_sdl_label->size().height() };
-    DANEJOE_LOG_TRACE("default", "SDLVideoWidget", "Label size: {}, {}", size.x, size.y);
-    bool is_set_window = m_renderer->set_window("sdl_window", size, (void*)m_sdl_label->winId());
-    if (!is_set_window)
+    if (m_output_id != 0) return;
+    if (!m_frame_queue)
     {
-        DANEJOE_LOG_ERROR("default", "SDLVideoWidget", "Failed to set window");
+        DANEJOE_CLOG(TRACE, VIEW, "SDLVideoWidget", "Frame queue is invalid");
         return;
     }
-    bool is_renderer_init = m_renderer->init();
-    if (!is_renderer_init)
+    auto renderer = std::make_unique<SDLFrameRenderer>();
+    renderer->set_vsync(m_is_request_vsync);
+    DaneJoe::Size<int> size = { m_sdl_label->size().width(), m_sdl_label->size().height() };
+    DANEJOE_CLOG(TRACE, VIEW, "SDLVideoWidget", "Label size: {}, {}", size.x, size.y);
+    if (!m_present_thread)
     {
-        DANEJOE_LOG_ERROR("default", "SDLVideoWidget", "init renderer failed");
-        return;
+        m_present_thread = std::make_shared<PresentThread>();
     }
+    // 关联 SDL 窗口、创建渲染器与之后的绘制都在呈现线程上，GUI 线程不调用 SDL
+    // 预加载的第一帧此时通常已在队列中，呈现线程初始化输出后在第一次刷新就提交
+    m_output_id = m_present_thread->add_output(std::move(renderer), "sdl_window", size, (void*)m_sdl_label->winId(), m_frame_queue, m_rate_control);
+    m_present_thread->set_paused(m_output_id, m_is_paused);
 }
 
-std::weak_ptr<MpmcBoundedQueue<AVFramePtr>> SDLVideoWidget::get_frame_queue()
+std::weak_ptr<FrameQueue> SDLVideoWidget::get_frame_queue()
 {
     return m_frame_queue;
 }
 
 void SDLVideoWidget::closeEvent(QCloseEvent* event)
 {
-    DANEJOE_LOG_TRACE("default", "SDLVideoWidget", "Into closeEvent");
+    DANEJOE_CLOG(TRACE, VIEW, "SDLVideoWidget", "Into closeEvent");
     close();
-    DANEJOE_LOG_TRACE("default", "SDLVideoWidget", "m_frame_queue closed after closeEvent");
+    DANEJOE_CLOG(TRACE, VIEW, "SDLVideoWidget", "m_frame_queue closed after closeEvent");
 }
 
 void SDLVideoWidget::resizeEvent(QResizeEvent* event)
 {
     auto s1 = m_sdl_label->contentsRect().size();
-    if (!m_renderer)
+    if (m_output_id == 0)
     {
-        DANEJOE_LOG_TRACE("default", "SDLVideoWidget", "Renderer is invalid");
+        DANEJOE_CLOG(TRACE, VIEW, "SDLVideoWidget", "Renderer is invalid");
         return;
     }
-    m_renderer->update_window_size({ s1.width(), s1.height() });
+    m_present_thread->update_window_size(m_output_id, { s1.width(), s1.height() });
     m_sdl_label->update();
 }
 
 void SDLVideoWidget::showEvent(QShowEvent* event)
 {
     // 延后创建 SDL 渲染器到窗口显示后（避免在控件未显示时使用不稳定的 winId()）
-    DANEJOE_LOG_TRACE("default", "SDLVideoWidget", "Into showEvent");
+    DANEJOE_CLOG(TRACE, VIEW, "SDLVideoWidget", "Into showEvent");
     QWidget::showEvent(event);
     // 只初始化一次
     init_renderer();
@@ -104,58 +119,116 @@ void SDLVideoWidget::showEvent(QShowEvent* event)
 
 void SDLVideoWidget::timerEvent(QTimerEvent* event)
 {
-    if (!m_renderer)
+    if (m_output_id == 0)
     {
-        DANEJOE_LOG_TRACE("default", "SDLVideoWidget", "Renderer is invalid");
+        DANEJOE_CLOG(TRACE, VIEW, "SDLVideoWidget", "Renderer is invalid");
         return;
     }
-    if (m_renderer->is_exit())
+    if (m_present_thread->is_exit())
     {
-        DANEJOE_LOG_INFO("default", "SDLVideoWidget", "Renderer is exit");
+        DANEJOE_CLOG(INFO, VIEW, "SDLVideoWidget", "Renderer is exit");
         this->close();
         return;
     }
-    if (!m_frame_queue)
+    if (m_is_paused)
     {
-        DANEJOE_LOG_TRACE("default", "SDLVideoWidget", "Frame queue is invalid");
         return;
     }
-    auto data = m_frame_queue->try_pop();
-    if (!data.has_value())
+    update_rate_status();
+}
+
+void SDLVideoWidget::set_paused(bool is_paused)
+{
+    if (m_is_paused == is_paused)
     {
-        DANEJOE_LOG_ERROR("default", "SDLVideoWidget", "Frame queue is empty");
         return;
     }
-    AVFramePtr frame = data.value();
-    // DANEJOE_LOG_TRACE("default", "SDLVideoWidget", "frame size: {}x{}", frame->width, frame->height);
-    bool is_draw = m_renderer->draw(frame);
-    if (!is_draw)
+    m_is_paused = is_paused;
+    if (m_output_id != 0)
     {
-        DANEJOE_LOG_ERROR("default", "SDLVideoWidget", "Faield to draw");
+        m_present_thread->set_paused(m_output_id, m_is_paused);
     }
 }
 
+bool SDLVideoWidget::is_paused()const
+{
+    return m_is_paused;
+}
+
+QString SDLVideoWidget::rate_status()const
+{
+    return m_rate_status;
+}
+
+void SDLVideoWidget::set_vsync(bool is_vsync)
+{
+    if (m_output_id != 0)
+    {
+        DANEJOE_CLOG(WARN, VIEW, "SDLVideoWidget", "set_vsync after the renderer is created has no effect");
+        return;
+    }
+    m_is_request_vsync = is_vsync;
+}
+
+void SDLVideoWidget::set_present_thread(std::shared_ptr<PresentThread> present_thread)
+{
+    if (m_output_id != 0)
+    {
+        DANEJOE_CLOG(WARN, VIEW, "SDLVideoWidget", "set_present_thread after the renderer is created has no effect");
+        return;
+    }
+    m_present_thread = std::move(present_thread);
+}
+
+bool SDLVideoWidget::show_frame(AVFrameView&& frame_view)
+{
+    if (m_output_id == 0)
+    {
+        DANEJOE_CLOG(TRACE, VIEW, "SDLVideoWidget", "Present thread is not running");
+        return false;
+    }
+    m_present_thread->show_frame(m_output_id, std::move(frame_view));
+    return true;
+}
+
 SDLVideoWidget::~SDLVideoWidget()
 {
-    DANEJOE_LOG_TRACE("default", "SDLVideoWidget", "Begin destructor");
+    DANEJOE_CLOG(TRACE, VIEW, "SDLVideoWidget", "Begin destructor");
     close();
-    DANEJOE_LOG_TRACE("default", "SDLVideoWidget", "m_frame_queue closed after destructor");
+    DANEJOE_CLOG(TRACE, VIEW, "SDLVideoWidget", "m_frame_queue closed after destructor");
 }
 
-void SDLVideoWidget::sleep(std::chrono::milliseconds ms)
+void SDLVideoWidget::update_rate_status()
 {
-    auto time = std::chrono::high_resolution_clock::now();
-    std::chrono::_V2::system_clock::time_point end_time = time + ms;
-    do
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_last_status_time < std::chrono::seconds(1))
+    {
+        return;
+    }
+    m_last_status_time = now;
+    PlaybackRateControl::Report report = m_rate_control->get_report();
+    FramePacer::Report pacing = m_output_id != 0 ? m_present_thread->get_report(m_output_id) : FramePacer::Report();
+    m_rate_status = QString("%1x (achieved %2x, %3, dropped %4, judder %5)")
+        .arg(report.requested_rate, 0, 'f', 2)
+        .arg(report.achieved_rate, 0, 'f', 2)
+        .arg(decode_strategy_name(report.strategy))
+        .arg(report.dropped_frames)
+        .arg(pacing.judder_score, 0, 'f', 3);
+    // 只有作为顶层主窗口的中心控件时才占用窗口标题，视频墙等容器通过 rate_status 自行组织标题
+    auto* main_window = qobject_cast<QMainWindow*>(window());
+    if (main_window && main_window->centralWidget() == this)
     {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        time = std::chrono::high_resolution_clock::now();
-    } while (time < end_time);
+        main_window->setWindowTitle(m_rate_status);
+    }
+    DANEJOE_CLOG(DEBUG, VIEW, "SDLVideoWidget", "Rate {}x, achieved {}x, strategy {}, presented {}, dropped {}",
+        report.requested_rate, report.achieved_rate, decode_strategy_name(report.strategy), report.presented_frames, report.dropped_frames);
+    DANEJOE_CLOG(DEBUG, VIEW, "SDLVideoWidget", "Pacing {}Hz, interval {}ms (stddev {}ms), judder {}, repeated {}, missed {}",
+        pacing.refresh_hz, pacing.mean_interval_ms, pacing.interval_stddev_ms, pacing.judder_score, pacing.repeated_refreshes, pacing.missed_refreshes);
 }
 
 void SDLVideoWidget::close()
 {
-    DANEJOE_LOG_TRACE("default", "SDLVideoWidget", "Into close");
+    DANEJOE_CLOG(TRACE, VIEW, "SDLVideoWidget", "Into close");
     // 1. 先停止定时器，防止timerEvent继续执行
     if (m_timer_id > -1)
     {
@@ -165,4 +238,11 @@ void SDLVideoWidget::close()
     {
         m_frame_queue->close();
     }
+    // 等待呈现线程释放渲染器与 SDL 窗口，之后原生窗口才能随控件销毁
+    if (m_output_id != 0)
+    {
+        m_present_thread->remove_output(m_output_id);
+        m_output_id = 0;
+    }
+    m_present_thread.reset();
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <cmath>
+
+#include <QGridLayout>
+#include <QString>
+
+#include "view/video_wall_window.hpp"
+#include "view/sdl_video_widget.hpp"
+#include "view/sdl_compositor_widget.hpp"
+#include "main/decode_worker_pool.hpp"
+#include "util/util_log.hpp"
+
+VideoWallWindow::VideoWallWindow(QWidget* parent) :QWidget(parent) {}
+
+VideoWallWindow::~VideoWallWindow()
+{
+    if (m_stats_timer_id > -1)
+    {
+        killTimer(m_stats_timer_id);
+    }
+    // 解码线程持有帧队列的弱引用，先停止线程池再让控件释放队列
+    if (m_decode_pool)
+    {
+        m_decode_pool->stop();
+    }
+}
+
+void VideoWallWindow::init(const std::vector<std::string>& file_paths, std::size_t worker_count, bool is_compositor)
+{
+    if (m_decode_pool)
+    {
+        DANEJOE_CLOG(WARN, VIEW, "VideoWallWindow", "Already initialized");
+        return;
+    }
+    m_decode_pool = std::make_unique<DecodeWorkerPool>(worker_count);
+    m_grid_layout = new QGridLayout(this);
+    m_grid_layout->setSpacing(1);
+    m_grid_layout->setContentsMargins(0, 0, 0, 0);
+    m_stream_count = file_paths.size();
+    if (is_compositor)
+    {
+        // 单窗口合成：所有流打包进同一渲染器，每次刷新只提交一次
+        m_compositor_widget = new SDLCompositorWidget(this);
+        m_compositor_widget->init(file_paths.size(), STREAM_QUEUE_CAPACITY);
+        m_grid_layout->addWidget(m_compositor_widget, 0, 0);
+        for (std::size_t i = 0; i < file_paths.size(); i++)
+        {
+            m_decode_pool->add_stream(file_paths[i], m_compositor_widget->get_frame_queue(i), true);
+        }
+    }
+    int columns = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(file_paths.size())))));
+    if (!is_compositor)
+    {
+        // 所有分块共用一个呈现线程：每次刷新只等待一次，SDL 调用也都在同一线程上
+        m_present_thread = std::make_shared<PresentThread>();
+    }
+    for (std::size_t i = 0; i < file_paths.size() && !is_compositor; i++)
+    {
+        auto video_widget = new SDLVideoWidget(this);
+        video_widget->set_present_thread(m_present_thread);
+        video_widget->init(STREAM_QUEUE_CAPACITY);
+        m_grid_layout->addWidget(video_widget, static_cast<int>(i) / columns, static_cast<int>(i) % columns);
+        m_decode_pool->add_stream(file_paths[i], video_widget->get_frame_queue(), true);
+        m_video_widgets.push_back(video_widget);
+    }
+    resize(1280, 720);
+    m_decode_pool->start();
+    m_stats_timer_id = startTimer(1000);
+    DANEJOE_CLOG(INFO, VIEW, "VideoWallWindow", "{} streams on {} decode workers", file_paths.size(), m_decode_pool->worker_count());
+}
+
+void VideoWallWindow::timerEvent(QTimerEvent* event)
+{
+    if (!m_decode_pool)
+    {
+        return;
+    }
+    uint64_t frames = m_decode_pool->total_frames_decoded();
+    uint64_t decoded_fps = frames - m_last_frames;
+    m_last_frames = frames;
+    std::size_t backpressured = 0;
+    for (const auto& stats : m_decode_pool->get_stream_stats())
+    {
+        backpressured += stats.is_backpressured ? 1 : 0;
+    }
+    setWindowTitle(QString("Video wall: %1 streams, %2 workers, %3 fps decoded, %4 back-pressured")
+        .arg(m_stream_count)
+        .arg(m_decode_pool->worker_count())
+        .arg(decoded_fps)
+        .arg(backpressured));
+}